@@ -60,7 +60,7 @@ QT += quickcontrols2
 # Compiler options
 #-------------------------------------------------------------------------------
 
-CONFIG += c++11
+CONFIG += c++17
 CONFIG += silent
 
 CONFIG(release, debug|release) {
@@ -111,6 +111,7 @@ macx* {
 }
 
 linux:!android {
+    LIBS += -lrt
     PKGCONFIG += libssl
     target.path = $$PREFIX/bin
     icon.path = $$PREFIX/share/pixmaps
@@ -138,26 +139,49 @@ HEADERS += \
     src/AppInfo.h \
     src/CSV/Export.h \
     src/CSV/Player.h \
+    src/DSP/Filter.h \
+    src/DSP/FilterBank.h \
+    src/DSP/SpectrumAnalyzer.h \
+    src/DSP/Statistics.h \
     src/DataTypes.h \
+    src/History/Block.h \
+    src/History/Series.h \
+    src/History/Store.h \
     src/IO/Checksum.h \
     src/IO/Console.h \
     src/IO/Drivers/BluetoothLE.h \
     src/IO/Drivers/Network.h \
+    src/IO/Drivers/Pipe.h \
+    src/IO/Drivers/Replay.h \
     src/IO/Drivers/Serial.h \
+    src/IO/Drivers/Synthetic.h \
+    src/IO/Drivers/TcpServer.h \
     src/IO/HAL_Driver.h \
     src/IO/Manager.h \
+    src/IO/Recorder.h \
+    src/IO/Trigger.h \
     src/JSON/Dataset.h \
+    src/JSON/Expression.h \
     src/JSON/Frame.h \
+    src/JSON/FrameDecoder.h \
     src/JSON/Generator.h \
     src/JSON/Group.h \
     src/MQTT/Client.h \
+    src/Misc/Alarms.h \
+    src/Misc/Headless.h \
+    src/Misc/Instrumentation.h \
     src/Misc/ModuleManager.h \
+    src/Misc/StartupTimeline.h \
     src/Misc/ThemeManager.h \
     src/Misc/TimerEvents.h \
     src/Misc/Translator.h \
     src/Misc/Utilities.h \
+    src/Plugins/MetricsServer.h \
     src/Plugins/Server.h \
+    src/Plugins/SharedMemory.h \
     src/Project/CodeEditor.h \
+    src/Project/CodeEditorProxy.h \
+    src/Project/FrameParser.h \
     src/Project/Model.h \
     src/UI/Dashboard.h \
     src/UI/DashboardWidget.h \
@@ -167,8 +191,11 @@ HEADERS += \
     src/UI/Widgets/Common/AnalogGauge.h \
     src/UI/Widgets/Common/AttitudeIndicator.h \
     src/UI/Widgets/Common/BaseWidget.h \
+    src/UI/Widgets/Common/Decimator.h \
     src/UI/Widgets/Common/ElidedLabel.h \
     src/UI/Widgets/Common/KLed.h \
+    src/UI/Widgets/Common/SlidingExtremum.h \
+    src/UI/Widgets/Common/SweepData.h \
     src/UI/Widgets/Compass.h \
     src/UI/Widgets/DataGroup.h \
     src/UI/Widgets/FFTPlot.h \
@@ -178,29 +205,53 @@ HEADERS += \
     src/UI/Widgets/LEDPanel.h \
     src/UI/Widgets/MultiPlot.h \
     src/UI/Widgets/Plot.h \
-    src/UI/Widgets/Terminal.h
+    src/UI/Widgets/Terminal.h \
+    src/UI/Widgets/Waterfall.h
 
 SOURCES += \
     src/CSV/Export.cpp \
     src/CSV/Player.cpp \
+    src/DSP/Filter.cpp \
+    src/DSP/FilterBank.cpp \
+    src/DSP/SpectrumAnalyzer.cpp \
+    src/DSP/Statistics.cpp \
+    src/History/Block.cpp \
+    src/History/Series.cpp \
+    src/History/Store.cpp \
     src/IO/Checksum.cpp \
     src/IO/Console.cpp \
     src/IO/Drivers/BluetoothLE.cpp \
     src/IO/Drivers/Network.cpp \
+    src/IO/Drivers/Pipe.cpp \
+    src/IO/Drivers/Replay.cpp \
     src/IO/Drivers/Serial.cpp \
+    src/IO/Drivers/Synthetic.cpp \
+    src/IO/Drivers/TcpServer.cpp \
     src/IO/Manager.cpp \
+    src/IO/Recorder.cpp \
+    src/IO/Trigger.cpp \
     src/JSON/Dataset.cpp \
+    src/JSON/Expression.cpp \
     src/JSON/Frame.cpp \
+    src/JSON/FrameDecoder.cpp \
     src/JSON/Generator.cpp \
     src/JSON/Group.cpp \
     src/MQTT/Client.cpp \
+    src/Misc/Alarms.cpp \
+    src/Misc/Headless.cpp \
+    src/Misc/Instrumentation.cpp \
     src/Misc/ModuleManager.cpp \
+    src/Misc/StartupTimeline.cpp \
     src/Misc/ThemeManager.cpp \
     src/Misc/TimerEvents.cpp \
     src/Misc/Translator.cpp \
     src/Misc/Utilities.cpp \
+    src/Plugins/MetricsServer.cpp \
     src/Plugins/Server.cpp \
+    src/Plugins/SharedMemory.cpp \
     src/Project/CodeEditor.cpp \
+    src/Project/CodeEditorProxy.cpp \
+    src/Project/FrameParser.cpp \
     src/Project/Model.cpp \
     src/UI/Dashboard.cpp \
     src/UI/DashboardWidget.cpp \
@@ -210,8 +261,11 @@ SOURCES += \
     src/UI/Widgets/Common/AnalogGauge.cpp \
     src/UI/Widgets/Common/AttitudeIndicator.cpp \
     src/UI/Widgets/Common/BaseWidget.cpp \
+    src/UI/Widgets/Common/Decimator.cpp \
     src/UI/Widgets/Common/ElidedLabel.cpp \
     src/UI/Widgets/Common/KLed.cpp \
+    src/UI/Widgets/Common/SlidingExtremum.cpp \
+    src/UI/Widgets/Common/SweepData.cpp \
     src/UI/Widgets/Compass.cpp \
     src/UI/Widgets/DataGroup.cpp \
     src/UI/Widgets/FFTPlot.cpp \
@@ -222,6 +276,7 @@ SOURCES += \
     src/UI/Widgets/MultiPlot.cpp \
     src/UI/Widgets/Plot.cpp \
     src/UI/Widgets/Terminal.cpp \
+    src/UI/Widgets/Waterfall.cpp \
     src/main.cpp
 
 #-------------------------------------------------------------------------------
@@ -251,3 +306,23 @@ OTHER_FILES += \
     deploy/windows/resources/* \
     .github/workflows/*.yml \
     updates.json
+
+#-------------------------------------------------------------------------------
+# Benchmarks (qmake CONFIG+=benchmark && make benchmark)
+#-------------------------------------------------------------------------------
+
+benchmark {
+    DEFINES += SERIAL_STUDIO_BENCHMARK
+    HEADERS += src/Misc/Benchmark.h
+    SOURCES += src/Misc/Benchmark.cpp
+
+    macx*: BENCHMARK_BINARY = $$OUT_PWD/$${TARGET}.app/Contents/MacOS/$${TARGET}
+    else:win32*: BENCHMARK_BINARY = $$OUT_PWD/release/$${TARGET}.exe
+    else: BENCHMARK_BINARY = $$OUT_PWD/$${TARGET}
+
+    benchmark_run.target = benchmark
+    benchmark_run.depends = first
+    benchmark_run.commands = $$shell_quote($$BENCHMARK_BINARY) --benchmark \
+                             --output $$shell_quote($$OUT_PWD/benchmark.json)
+    QMAKE_EXTRA_TARGETS += benchmark_run
+}
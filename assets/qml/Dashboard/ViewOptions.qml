@@ -24,6 +24,7 @@ import QtCore
 import QtQuick
 import QtQuick.Layouts
 import QtQuick.Controls
+import SerialStudio
 
 import "../Widgets" as Widgets
 
@@ -57,6 +58,22 @@ Widgets.Window {
     return Math.exp(minv + scale * (position - minp)).toFixed(0);
   }
 
+  function timeslider(position) {
+    if (position <= 0)
+      return 0
+
+    return Math.round(Math.exp(Math.log(3600) * (position - 1) / 99))
+  }
+
+  function timelabel(seconds) {
+    if (seconds <= 0)
+      return qsTr("Off")
+    if (seconds >= 120)
+      return qsTr("%1 min").arg((seconds / 60).toFixed(0))
+
+    return qsTr("%1 s").arg(seconds)
+  }
+
   //
   // Maps the points value to the slider position
   // https://stackoverflow.com/a/846249
@@ -78,6 +95,15 @@ Widgets.Window {
     property alias points: plotPoints.value
     property alias widgetSize: widgetSize.value
     property alias decimalPlaces: decimalPlaces.value
+    property alias paintBudget: paintBudget.value
+    property alias sweepMode: sweepMode.checked
+    property alias timeWindow: timeWindow.value
+    property alias fftWindow: fftWindow.currentIndex
+    property alias fftAverages: fftAverages.value
+    property alias fftOverlap: fftOverlap.value
+    property alias fftSampleRate: fftSampleRate.text
+    property alias statistics: statistics.checked
+    property alias statisticsWindow: statisticsWindow.text
   }
 
   //
@@ -170,6 +196,103 @@ Widgets.Window {
           visible: Cpp_UI_Dashboard.plotCount > 0 || Cpp_UI_Dashboard.multiPlotCount > 0
         }
 
+        //
+        // Plot the samples received during the last N seconds
+        //
+        Label {
+          text: qsTr("Time window:")
+          visible: Cpp_UI_Dashboard.plotCount > 0 || Cpp_UI_Dashboard.multiPlotCount > 0
+        } Slider {
+          id: timeWindow
+          to: 100
+          from: 0
+          value: 0
+          stepSize: 1
+          Layout.fillWidth: true
+          visible: Cpp_UI_Dashboard.plotCount > 0 || Cpp_UI_Dashboard.multiPlotCount > 0
+          onValueChanged: Cpp_UI_Dashboard.timeWindow = timeslider(value)
+        } Label {
+          text: timelabel(Cpp_UI_Dashboard.timeWindow)
+          visible: Cpp_UI_Dashboard.plotCount > 0 || Cpp_UI_Dashboard.multiPlotCount > 0
+        }
+
+        //
+        // Window function applied to the FFT segments
+        //
+        Label {
+          text: qsTr("FFT window:")
+          visible: Cpp_UI_Dashboard.fftCount > 0 || Cpp_UI_Dashboard.waterfallCount > 0
+        } ComboBox {
+          id: fftWindow
+          currentIndex: 2
+          Layout.fillWidth: true
+          visible: Cpp_UI_Dashboard.fftCount > 0 || Cpp_UI_Dashboard.waterfallCount > 0
+          model: Cpp_DSP_SpectrumAnalyzer.windowFunctions
+          onCurrentIndexChanged: Cpp_DSP_SpectrumAnalyzer.windowFunction = currentIndex
+        } Item {
+          visible: Cpp_UI_Dashboard.fftCount > 0 || Cpp_UI_Dashboard.waterfallCount > 0
+        }
+
+        //
+        // Number of FFT segments averaged (Welch's method)
+        //
+        Label {
+          text: qsTr("FFT averages:")
+          visible: Cpp_UI_Dashboard.fftCount > 0
+        } Slider {
+          id: fftAverages
+          to: 16
+          from: 1
+          value: 1
+          stepSize: 1
+          Layout.fillWidth: true
+          visible: Cpp_UI_Dashboard.fftCount > 0
+          onValueChanged: Cpp_DSP_SpectrumAnalyzer.averages = value
+        } Label {
+          text: Cpp_DSP_SpectrumAnalyzer.averages
+          visible: Cpp_UI_Dashboard.fftCount > 0
+        }
+
+        //
+        // Overlap between averaged FFT segments
+        //
+        Label {
+          text: qsTr("FFT overlap:")
+          visible: Cpp_UI_Dashboard.fftCount > 0 || Cpp_UI_Dashboard.waterfallCount > 0
+        } Slider {
+          id: fftOverlap
+          to: 75
+          from: 0
+          value: 50
+          stepSize: 25
+          Layout.fillWidth: true
+          visible: Cpp_UI_Dashboard.fftCount > 0 || Cpp_UI_Dashboard.waterfallCount > 0
+          onValueChanged: Cpp_DSP_SpectrumAnalyzer.overlap = value
+        } Label {
+          text: qsTr("%1 %").arg(Cpp_DSP_SpectrumAnalyzer.overlap)
+          visible: Cpp_UI_Dashboard.fftCount > 0 || Cpp_UI_Dashboard.waterfallCount > 0
+        }
+
+        //
+        // FFT sample rate (empty or 0 to use the measured frame rate)
+        //
+        Label {
+          text: qsTr("Sample rate:")
+          visible: Cpp_UI_Dashboard.fftCount > 0 || Cpp_UI_Dashboard.waterfallCount > 0
+        } TextField {
+          id: fftSampleRate
+          Layout.fillWidth: true
+          visible: Cpp_UI_Dashboard.fftCount > 0 || Cpp_UI_Dashboard.waterfallCount > 0
+          placeholderText: qsTr("Measured: %1 Hz").arg(Cpp_DSP_SpectrumAnalyzer.measuredSampleRate.toFixed(1))
+          onTextChanged: Cpp_DSP_SpectrumAnalyzer.sampleRate = text.length > 0 ? parseFloat(text) : 0
+          validator: DoubleValidator {
+            bottom: 0
+          }
+        } Label {
+          text: qsTr("Hz")
+          visible: Cpp_UI_Dashboard.fftCount > 0 || Cpp_UI_Dashboard.waterfallCount > 0
+        }
+
         //
         // Number of decimal places
         //
@@ -186,6 +309,77 @@ Widgets.Window {
           text: Cpp_UI_Dashboard.precision
         }
 
+        //
+        // Maximum paint time per widget, slower widgets are refreshed less often
+        //
+        Label {
+          text: qsTr("Paint budget:")
+        } Slider {
+          id: paintBudget
+          to: 50
+          from: 0
+          value: 10
+          stepSize: 1
+          Layout.fillWidth: true
+          onValueChanged: Cpp_UI_Dashboard.paintBudget = value
+        } Label {
+          text: Cpp_UI_Dashboard.paintBudget > 0 ? qsTr("%1 ms").arg(Cpp_UI_Dashboard.paintBudget) : qsTr("Off")
+        }
+
+        //
+        // Draw plots from left to right, like an oscilloscope
+        //
+        Label {
+          text: qsTr("Sweep mode:")
+          visible: Cpp_UI_Dashboard.plotCount > 0 || Cpp_UI_Dashboard.multiPlotCount > 0
+        } Switch {
+          id: sweepMode
+          checked: false
+          Layout.leftMargin: -app.spacing
+          visible: Cpp_UI_Dashboard.plotCount > 0 || Cpp_UI_Dashboard.multiPlotCount > 0
+          onCheckedChanged: Cpp_UI_Dashboard.sweepMode = checked
+        } Item {
+          visible: Cpp_UI_Dashboard.plotCount > 0 || Cpp_UI_Dashboard.multiPlotCount > 0
+        }
+
+        //
+        // Show running statistics (min, max, mean, etc.) in the data groups
+        //
+        Label {
+          text: qsTr("Statistics:")
+          visible: Cpp_UI_Dashboard.groupCount > 0
+        } Switch {
+          id: statistics
+          checked: true
+          Layout.leftMargin: -app.spacing
+          visible: Cpp_UI_Dashboard.groupCount > 0
+          onCheckedChanged: Cpp_DSP_Statistics.enabled = checked
+        } Item {
+          visible: Cpp_UI_Dashboard.groupCount > 0
+        }
+
+        //
+        // Calculate the mean & deviation over the last N samples (empty or 0
+        // to use all the samples of the session)
+        //
+        Label {
+          text: qsTr("Statistics window:")
+          visible: Cpp_UI_Dashboard.groupCount > 0 && statistics.checked
+        } TextField {
+          id: statisticsWindow
+          Layout.fillWidth: true
+          placeholderText: qsTr("Whole session")
+          visible: Cpp_UI_Dashboard.groupCount > 0 && statistics.checked
+          onTextChanged: Cpp_DSP_Statistics.windowSize = text.length > 0 ? parseInt(text) : 0
+          validator: IntValidator {
+            bottom: 0
+            top: 100 * 1000
+          }
+        } Label {
+          text: qsTr("samples")
+          visible: Cpp_UI_Dashboard.groupCount > 0 && statistics.checked
+        }
+
 
         //
         // Number of plot points slider
@@ -253,6 +447,17 @@ Widgets.Window {
         onCheckedChanged: Cpp_UI_Dashboard.setFFTVisible(index, checked)
       }
 
+      //
+      // Waterfall plots
+      //
+      ViewOptionsDelegate {
+        title: qsTr("Waterfall plots")
+        icon: "qrc:/icons/fft.svg"
+        count: Cpp_UI_Dashboard.waterfallCount
+        titles: Cpp_UI_Dashboard.waterfallTitles
+        onCheckedChanged: Cpp_UI_Dashboard.setWaterfallVisible(index, checked)
+      }
+
       //
       // Plots
       //
@@ -24,6 +24,7 @@ import QtCore
 import QtQuick
 import QtQuick.Layouts
 import QtQuick.Controls
+import SerialStudio
 
 import "../Widgets" as Widgets
 import "SetupPanes" as SetupPanes
@@ -69,6 +70,7 @@ Item {
     property alias manual: commManual.checked
     property alias tabIndex: tab.currentIndex
     property alias csvExport: csvLogging.checked
+    property alias rawRecording: rawRecording.checked
 
     //
     // MQTT settings
@@ -86,7 +88,23 @@ Item {
     //
     property alias language: settings.language
     property alias tcpPlugins: settings.tcpPlugins
+    property alias metricsPort: settings.metricsPort
+    property alias historyBudget: settings.historyBudget
+    property alias metricsEndpoint: settings.metricsEndpoint
+    property alias sharedMemory: settings.sharedMemory
+    property alias sharedMemoryName: settings.sharedMemoryName
     property alias windowShadows: settings.windowShadows
+    property alias instrumentation: diagnostics.instrumentation
+
+    //
+    // Trigger settings
+    //
+    property alias triggerMode: trigger.mode
+    property alias triggerLevel: trigger.level
+    property alias triggerPattern: trigger.pattern
+    property alias triggerCondition: trigger.condition
+    property alias triggerPreTrigger: trigger.preTrigger
+    property alias triggerPostTrigger: trigger.postTrigger
   }
 
   //
@@ -192,6 +210,19 @@ Item {
           }
         }
 
+        Switch {
+          id: rawRecording
+          text: qsTr("Record raw data")
+          Layout.alignment: Qt.AlignVCenter
+          checked: Cpp_IO_Recorder.enabled
+          Layout.maximumWidth: root.maxItemWidth
+
+          onCheckedChanged:  {
+            if (Cpp_IO_Recorder.enabled !== checked)
+              Cpp_IO_Recorder.enabled = checked
+          }
+        }
+
         Item {
           Layout.fillWidth: true
         }
@@ -239,6 +270,18 @@ Item {
           height: tab.height + 3
           width: implicitWidth + 2 * app.spacing
         }
+
+        TabButton {
+          text: qsTr("Diagnostics")
+          height: tab.height + 3
+          width: implicitWidth + 2 * app.spacing
+        }
+
+        TabButton {
+          text: qsTr("Trigger")
+          height: tab.height + 3
+          width: implicitWidth + 2 * app.spacing
+        }
       }
 
       //
@@ -281,6 +324,26 @@ Item {
             palette.base: Cpp_ThemeManager.setupPanelBackground
           }
         }
+
+        SetupPanes.Diagnostics {
+          id: diagnostics
+          Layout.fillWidth: true
+          Layout.fillHeight: true
+          background: TextField {
+            enabled: false
+            palette.base: Cpp_ThemeManager.setupPanelBackground
+          }
+        }
+
+        SetupPanes.Trigger {
+          id: trigger
+          Layout.fillWidth: true
+          Layout.fillHeight: true
+          background: TextField {
+            enabled: false
+            palette.base: Cpp_ThemeManager.setupPanelBackground
+          }
+        }
       }
     }
   }
@@ -28,9 +28,18 @@ Control {
   id: root
 
   //
-  // Start BLE scanning 2 seconds after the control is created
+  // Start BLE scanning 2 seconds after the control is shown for the first time
   //
-  Component.onCompleted: timer.start()
+  property bool scanRequested: false
+  function requestScan() {
+    if (visible && !scanRequested) {
+      scanRequested = true
+      timer.start()
+    }
+  }
+
+  onVisibleChanged: requestScan()
+  Component.onCompleted: requestScan()
   Timer {
     id: timer
     interval: 2000
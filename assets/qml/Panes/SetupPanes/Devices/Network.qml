@@ -37,6 +37,8 @@ Control {
   property alias socketType: _typeCombo.currentIndex
   property alias udpMulticastEnabled: _udpMulticast.checked
   property alias udpProcessDatagramsDirectly: _udpProcessDatagrams.checked
+  property alias tcpServerAddress: _tcpServerAddress.text
+  property alias tcpServerTagFrames: _tcpServerTagFrames.checked
 
   //
   // React to network manager events
@@ -103,11 +105,13 @@ Control {
         opacity: enabled ? 1 : 0.5
         enabled: !Cpp_IO_Manager.connected
         text: qsTr("Remote address") + ":"
+        visible: Cpp_IO_Network.socketTypeIndex !== 2
       } TextField {
         id: _address
         Layout.fillWidth: true
         opacity: enabled ? 1 : 0.5
         enabled: !Cpp_IO_Manager.connected
+        visible: Cpp_IO_Network.socketTypeIndex !== 2
         placeholderText: Cpp_IO_Network.defaultAddress
         palette.base: Cpp_ThemeManager.setupPanelBackground
         Component.onCompleted: text = Cpp_IO_Network.remoteAddress
@@ -120,6 +124,29 @@ Control {
         }
       }
 
+      //
+      // TCP server address
+      //
+      Label {
+        opacity: enabled ? 1 : 0.5
+        enabled: !Cpp_IO_Manager.connected
+        text: qsTr("Listen address") + ":"
+        visible: Cpp_IO_Network.socketTypeIndex === 2
+      } TextField {
+        id: _tcpServerAddress
+        Layout.fillWidth: true
+        opacity: enabled ? 1 : 0.5
+        enabled: !Cpp_IO_Manager.connected
+        placeholderText: qsTr("All interfaces")
+        visible: Cpp_IO_Network.socketTypeIndex === 2
+        palette.base: Cpp_ThemeManager.setupPanelBackground
+        Component.onCompleted: text = Cpp_IO_Network.tcpServerAddress
+        onTextChanged: {
+          if (Cpp_IO_Network.tcpServerAddress !== text)
+            Cpp_IO_Network.tcpServerAddress = text
+        }
+      }
+
       //
       // TCP port
       //
@@ -127,7 +154,8 @@ Control {
         text: qsTr("Port") + ":"
         opacity: enabled ? 1 : 0.5
         enabled: !Cpp_IO_Manager.connected
-        visible: Cpp_IO_Network.socketTypeIndex === 0
+        visible: Cpp_IO_Network.socketTypeIndex === 0 ||
+                 Cpp_IO_Network.socketTypeIndex === 2
       } TextField {
         id: _tcpPort
         Layout.fillWidth: true
@@ -150,7 +178,42 @@ Control {
         }
 
 
-        visible: Cpp_IO_Network.socketTypeIndex === 0
+        visible: Cpp_IO_Network.socketTypeIndex === 0 ||
+                 Cpp_IO_Network.socketTypeIndex === 2
+      }
+
+      //
+      // TCP server frame tagging checkbox
+      //
+      Label {
+        text: qsTr("Separate datasets per device") + ":"
+        opacity: _tcpServerTagFrames.enabled ? 1 : 0.5
+        visible: Cpp_IO_Network.socketTypeIndex === 2
+      } CheckBox {
+        id: _tcpServerTagFrames
+        opacity: enabled ? 1 : 0.5
+        Layout.alignment: Qt.AlignLeft
+        Layout.leftMargin: -app.spacing
+        enabled: !Cpp_IO_Manager.connected
+        checked: Cpp_IO_Network.tcpServerTagFrames
+        visible: Cpp_IO_Network.socketTypeIndex === 2
+        palette.base: Cpp_ThemeManager.setupPanelBackground
+
+        onCheckedChanged: {
+          if (Cpp_IO_Network.tcpServerTagFrames !== checked)
+            Cpp_IO_Network.tcpServerTagFrames = checked
+        }
+      }
+
+      //
+      // TCP server connection count
+      //
+      Label {
+        text: qsTr("Connected devices") + ":"
+        visible: Cpp_IO_Network.socketTypeIndex === 2
+      } Label {
+        text: Cpp_IO_Network.tcpServerConnections
+        visible: Cpp_IO_Network.socketTypeIndex === 2
       }
 
 
@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+import QtQuick
+import QtQuick.Layouts
+import QtQuick.Controls
+import SerialStudio
+
+Control {
+  id: root
+
+  //
+  // Access to properties
+  //
+  property alias path: _path.text
+
+  //
+  // Control layout
+  //
+  ColumnLayout {
+    anchors.fill: parent
+    anchors.margins: app.spacing
+
+    //
+    // Controls
+    //
+    GridLayout {
+      id: layout
+      columns: 2
+      Layout.fillWidth: true
+      rowSpacing: app.spacing
+      columnSpacing: app.spacing
+
+      //
+      // Pipe path
+      //
+      Label {
+        text: qsTr("Path") + ":"
+      } TextField {
+        id: _path
+        Layout.fillWidth: true
+        enabled: !Cpp_IO_Manager.connected
+        placeholderText: qsTr("Standard input")
+        palette.base: Cpp_ThemeManager.setupPanelBackground
+        Component.onCompleted: text = Cpp_IO_Pipe.path
+        onTextChanged: {
+          if (Cpp_IO_Pipe.path !== text)
+            Cpp_IO_Pipe.path = text
+        }
+      }
+    }
+
+    //
+    // Usage hint
+    //
+    Label {
+      opacity: 0.8
+      Layout.fillWidth: true
+      wrapMode: Label.WordWrap
+      text: qsTr("Reads a named pipe (FIFO), a PTY, a file or an inherited " +
+                 "file descriptor (fd:N). Leave empty to read the standard " +
+                 "input.")
+    }
+
+    //
+    // Vertical spacer
+    //
+    Item {
+      Layout.fillHeight: true
+    }
+  }
+}
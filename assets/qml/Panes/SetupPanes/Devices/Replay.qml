@@ -0,0 +1,185 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+import QtQuick
+import QtQuick.Layouts
+import QtQuick.Controls
+import SerialStudio
+
+Control {
+  id: root
+
+  //
+  // Access to properties
+  //
+  property alias filePath: _filePath.text
+  property alias speed: _speed.text
+  property alias fullSpeed: _fullSpeed.checked
+  property alias loop: _loop.checked
+
+  //
+  // Update the file path when it is selected with the file dialog
+  //
+  Connections {
+    target: Cpp_IO_Replay
+    function onFilePathChanged() {
+      if (_filePath.text !== Cpp_IO_Replay.filePath)
+        _filePath.text = Cpp_IO_Replay.filePath
+    }
+  }
+
+  //
+  // Control layout
+  //
+  ColumnLayout {
+    anchors.fill: parent
+    anchors.margins: app.spacing
+
+    //
+    // Controls
+    //
+    GridLayout {
+      id: layout
+      columns: 2
+      Layout.fillWidth: true
+      rowSpacing: app.spacing
+      columnSpacing: app.spacing
+
+      //
+      // Capture file
+      //
+      Label {
+        text: qsTr("Capture File") + ":"
+      } RowLayout {
+        spacing: app.spacing
+        Layout.fillWidth: true
+
+        TextField {
+          id: _filePath
+          Layout.fillWidth: true
+          enabled: !Cpp_IO_Manager.connected
+          placeholderText: qsTr("Select a raw data capture")
+          palette.base: Cpp_ThemeManager.setupPanelBackground
+          onTextChanged: {
+            if (Cpp_IO_Replay.filePath !== text)
+              Cpp_IO_Replay.filePath = text
+          }
+        }
+
+        Button {
+          text: "..."
+          implicitWidth: height
+          enabled: !Cpp_IO_Manager.connected
+          onClicked: Cpp_IO_Replay.selectFile()
+        }
+      }
+
+      //
+      // Replay speed
+      //
+      Label {
+        text: qsTr("Speed (x)") + ":"
+        opacity: _speed.enabled ? 1 : 0.5
+      } TextField {
+        id: _speed
+        Layout.fillWidth: true
+        opacity: enabled ? 1 : 0.5
+        enabled: !_fullSpeed.checked
+        placeholderText: Cpp_IO_Replay.speed
+        palette.base: Cpp_ThemeManager.setupPanelBackground
+        Component.onCompleted: text = Cpp_IO_Replay.speed
+        onTextChanged: {
+          if (text.length > 0 && Cpp_IO_Replay.speed !== parseFloat(text))
+            Cpp_IO_Replay.speed = parseFloat(text)
+        }
+
+        validator: DoubleValidator {
+          bottom: 0.01
+          top: 1000
+        }
+      }
+
+      //
+      // Full speed mode
+      //
+      Label {
+        text: qsTr("Full Speed") + ":"
+      } CheckBox {
+        id: _fullSpeed
+        Layout.alignment: Qt.AlignLeft
+        Layout.leftMargin: -app.spacing
+        checked: Cpp_IO_Replay.fullSpeed
+        palette.base: Cpp_ThemeManager.setupPanelBackground
+        onCheckedChanged: {
+          if (Cpp_IO_Replay.fullSpeed !== checked)
+            Cpp_IO_Replay.fullSpeed = checked
+        }
+      }
+
+      //
+      // Loop mode
+      //
+      Label {
+        text: qsTr("Loop") + ":"
+      } CheckBox {
+        id: _loop
+        Layout.alignment: Qt.AlignLeft
+        Layout.leftMargin: -app.spacing
+        checked: Cpp_IO_Replay.loop
+        palette.base: Cpp_ThemeManager.setupPanelBackground
+        onCheckedChanged: {
+          if (Cpp_IO_Replay.loop !== checked)
+            Cpp_IO_Replay.loop = checked
+        }
+      }
+    }
+
+    //
+    // Replay progress
+    //
+    ProgressBar {
+      from: 0
+      to: 1
+      Layout.fillWidth: true
+      visible: Cpp_IO_Manager.connected
+      value: Cpp_IO_Replay.progress
+    }
+
+    //
+    // Replay statistics
+    //
+    Label {
+      opacity: 0.8
+      Layout.fillWidth: true
+      visible: Cpp_IO_Manager.connected
+      elide: Label.ElideRight
+      text: qsTr("%1 chunks replayed").arg(Cpp_IO_Replay.replayedChunks)
+    }
+
+    //
+    // Vertical spacer
+    //
+    Item {
+      Layout.fillHeight: true
+    }
+  }
+}
@@ -37,6 +37,7 @@ Control {
   property alias flowControl: _flowCombo.currentIndex
   property alias stopBits: _stopBitsCombo.currentIndex
   property alias autoReconnect: _autoreconnect.checked
+  property alias readBufferSize: _readBufferSize.text
 
   //
   // Update listbox models when translation is changed
@@ -217,6 +218,85 @@ Control {
             Cpp_IO_Serial.flowControlIndex = currentIndex
         }
       }
+
+      //
+      // Spacer
+      //
+      Item {
+        Layout.minimumHeight: app.spacing / 2
+        Layout.maximumHeight: app.spacing / 2
+      } Item {
+        Layout.minimumHeight: app.spacing / 2
+        Layout.maximumHeight: app.spacing / 2
+      }
+
+      //
+      // Read buffer size
+      //
+      Label {
+        text: qsTr("Read Buffer") + ":"
+      } TextField {
+        id: _readBufferSize
+        Layout.fillWidth: true
+        placeholderText: qsTr("Unlimited")
+        palette.base: Cpp_ThemeManager.setupPanelBackground
+        Component.onCompleted: {
+          if (Cpp_IO_Serial.readBufferSize > 0)
+            text = Cpp_IO_Serial.readBufferSize
+        }
+
+        onTextChanged: {
+          var size = text.length > 0 ? parseInt(text) : 0
+          if (Cpp_IO_Serial.readBufferSize !== size)
+            Cpp_IO_Serial.readBufferSize = size
+        }
+
+        validator: IntValidator {
+          bottom: 0
+        }
+      }
+
+      //
+      // Low latency mode (only available on Linux)
+      //
+      Label {
+        text: qsTr("Low Latency") + ":"
+        opacity: _lowLatency.enabled ? 1 : 0.5
+        visible: Cpp_IO_Serial.lowLatencySupported
+      } CheckBox {
+        id: _lowLatency
+        opacity: enabled ? 1 : 0.5
+        Layout.alignment: Qt.AlignLeft
+        Layout.leftMargin: -app.spacing
+        enabled: !Cpp_IO_Manager.connected
+        checked: Cpp_IO_Serial.lowLatency
+        visible: Cpp_IO_Serial.lowLatencySupported
+        palette.base: Cpp_ThemeManager.setupPanelBackground
+        onCheckedChanged: {
+          if (Cpp_IO_Serial.lowLatency !== checked)
+            Cpp_IO_Serial.lowLatency = checked
+        }
+      }
+
+      //
+      // Dedicated reader thread
+      //
+      Label {
+        text: qsTr("Reader Thread") + ":"
+        opacity: _dedicatedReader.enabled ? 1 : 0.5
+      } CheckBox {
+        id: _dedicatedReader
+        opacity: enabled ? 1 : 0.5
+        Layout.alignment: Qt.AlignLeft
+        Layout.leftMargin: -app.spacing
+        enabled: !Cpp_IO_Manager.connected
+        checked: Cpp_IO_Serial.dedicatedReader
+        palette.base: Cpp_ThemeManager.setupPanelBackground
+        onCheckedChanged: {
+          if (Cpp_IO_Serial.dedicatedReader !== checked)
+            Cpp_IO_Serial.dedicatedReader = checked
+        }
+      }
     }
 
     //
@@ -0,0 +1,337 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+import QtQuick
+import QtQuick.Layouts
+import QtQuick.Controls
+import SerialStudio
+
+Control {
+  id: root
+
+  //
+  // Access to properties
+  //
+  property alias waveform: _waveform.currentIndex
+  property alias channels: _channels.text
+  property alias frameRate: _frameRate.text
+  property alias fullSpeed: _fullSpeed.checked
+  property alias frequency: _frequency.text
+  property alias noiseLevel: _noiseLevel.text
+  property alias padding: _padding.text
+  property alias crcEnabled: _crcEnabled.checked
+  property alias crcErrorRate: _crcErrorRate.text
+  property alias corruptFrameRate: _corruptFrameRate.text
+
+  //
+  // Update listbox models when translation is changed
+  //
+  Connections {
+    target: Cpp_Misc_Translator
+    function onLanguageChanged() {
+      var oldIndex = _waveform.currentIndex
+      _waveform.model = Cpp_IO_Synthetic.waveformList
+      _waveform.currentIndex = oldIndex
+    }
+  }
+
+  //
+  // Control layout
+  //
+  ColumnLayout {
+    anchors.fill: parent
+    anchors.margins: app.spacing
+
+    //
+    // Controls
+    //
+    GridLayout {
+      id: layout
+      columns: 2
+      Layout.fillWidth: true
+      rowSpacing: app.spacing
+      columnSpacing: app.spacing
+
+      //
+      // Waveform selector
+      //
+      Label {
+        text: qsTr("Waveform") + ":"
+      } ComboBox {
+        id: _waveform
+        Layout.fillWidth: true
+        model: Cpp_IO_Synthetic.waveformList
+        currentIndex: Cpp_IO_Synthetic.waveform
+        palette.base: Cpp_ThemeManager.setupPanelBackground
+        onCurrentIndexChanged: {
+          if (Cpp_IO_Synthetic.waveform !== currentIndex)
+            Cpp_IO_Synthetic.waveform = currentIndex
+        }
+      }
+
+      //
+      // Number of channels (only used when no project is loaded)
+      //
+      Label {
+        text: qsTr("Channels") + ":"
+        opacity: _channels.enabled ? 1 : 0.5
+      } TextField {
+        id: _channels
+        Layout.fillWidth: true
+        opacity: enabled ? 1 : 0.5
+        palette.base: Cpp_ThemeManager.setupPanelBackground
+        enabled: !Cpp_IO_Manager.connected && Cpp_IO_Synthetic.projectChannels === 0
+        placeholderText: Cpp_IO_Synthetic.projectChannels > 0 ?
+                           qsTr("%1 (from project)").arg(Cpp_IO_Synthetic.projectChannels) :
+                           Cpp_IO_Synthetic.channels
+        Component.onCompleted: text = Cpp_IO_Synthetic.channels
+        onTextChanged: {
+          if (text.length > 0 && Cpp_IO_Synthetic.channels !== parseInt(text))
+            Cpp_IO_Synthetic.channels = parseInt(text)
+        }
+
+        validator: IntValidator {
+          bottom: 1
+          top: 1024
+        }
+      }
+
+      //
+      // Frame rate
+      //
+      Label {
+        text: qsTr("Frame Rate (Hz)") + ":"
+        opacity: _frameRate.enabled ? 1 : 0.5
+      } TextField {
+        id: _frameRate
+        Layout.fillWidth: true
+        opacity: enabled ? 1 : 0.5
+        enabled: !_fullSpeed.checked
+        palette.base: Cpp_ThemeManager.setupPanelBackground
+        placeholderText: Cpp_IO_Synthetic.frameRate
+        Component.onCompleted: text = Cpp_IO_Synthetic.frameRate
+        onTextChanged: {
+          if (text.length > 0 && Cpp_IO_Synthetic.frameRate !== parseInt(text))
+            Cpp_IO_Synthetic.frameRate = parseInt(text)
+        }
+
+        validator: IntValidator {
+          bottom: 1
+          top: 1000000
+        }
+      }
+
+      //
+      // Full speed mode
+      //
+      Label {
+        text: qsTr("Full Speed") + ":"
+      } CheckBox {
+        id: _fullSpeed
+        Layout.alignment: Qt.AlignLeft
+        Layout.leftMargin: -app.spacing
+        checked: Cpp_IO_Synthetic.fullSpeed
+        palette.base: Cpp_ThemeManager.setupPanelBackground
+        onCheckedChanged: {
+          if (Cpp_IO_Synthetic.fullSpeed !== checked)
+            Cpp_IO_Synthetic.fullSpeed = checked
+        }
+      }
+
+      //
+      // Spacer
+      //
+      Item {
+        Layout.minimumHeight: app.spacing / 2
+        Layout.maximumHeight: app.spacing / 2
+      } Item {
+        Layout.minimumHeight: app.spacing / 2
+        Layout.maximumHeight: app.spacing / 2
+      }
+
+      //
+      // Signal frequency
+      //
+      Label {
+        text: qsTr("Frequency (Hz)") + ":"
+      } TextField {
+        id: _frequency
+        Layout.fillWidth: true
+        palette.base: Cpp_ThemeManager.setupPanelBackground
+        placeholderText: Cpp_IO_Synthetic.signalFrequency
+        Component.onCompleted: text = Cpp_IO_Synthetic.signalFrequency
+        onTextChanged: {
+          if (text.length > 0)
+            Cpp_IO_Synthetic.signalFrequency = parseFloat(text)
+        }
+
+        validator: DoubleValidator {
+          bottom: 0
+        }
+      }
+
+      //
+      // Noise level
+      //
+      Label {
+        text: qsTr("Noise Level") + ":"
+      } TextField {
+        id: _noiseLevel
+        Layout.fillWidth: true
+        palette.base: Cpp_ThemeManager.setupPanelBackground
+        placeholderText: Cpp_IO_Synthetic.noiseLevel
+        Component.onCompleted: text = Cpp_IO_Synthetic.noiseLevel
+        onTextChanged: {
+          if (text.length > 0)
+            Cpp_IO_Synthetic.noiseLevel = parseFloat(text)
+        }
+
+        validator: DoubleValidator {
+          bottom: 0
+        }
+      }
+
+      //
+      // Padding bytes
+      //
+      Label {
+        text: qsTr("Padding (bytes)") + ":"
+      } TextField {
+        id: _padding
+        Layout.fillWidth: true
+        placeholderText: "0"
+        palette.base: Cpp_ThemeManager.setupPanelBackground
+        Component.onCompleted: {
+          if (Cpp_IO_Synthetic.padding > 0)
+            text = Cpp_IO_Synthetic.padding
+        }
+
+        onTextChanged: {
+          var bytes = text.length > 0 ? parseInt(text) : 0
+          if (Cpp_IO_Synthetic.padding !== bytes)
+            Cpp_IO_Synthetic.padding = bytes
+        }
+
+        validator: IntValidator {
+          bottom: 0
+        }
+      }
+
+      //
+      // Spacer
+      //
+      Item {
+        Layout.minimumHeight: app.spacing / 2
+        Layout.maximumHeight: app.spacing / 2
+      } Item {
+        Layout.minimumHeight: app.spacing / 2
+        Layout.maximumHeight: app.spacing / 2
+      }
+
+      //
+      // CRC checkbox
+      //
+      Label {
+        text: qsTr("Append CRC-16") + ":"
+      } CheckBox {
+        id: _crcEnabled
+        Layout.alignment: Qt.AlignLeft
+        Layout.leftMargin: -app.spacing
+        checked: Cpp_IO_Synthetic.crcEnabled
+        palette.base: Cpp_ThemeManager.setupPanelBackground
+        onCheckedChanged: {
+          if (Cpp_IO_Synthetic.crcEnabled !== checked)
+            Cpp_IO_Synthetic.crcEnabled = checked
+        }
+      }
+
+      //
+      // CRC error rate
+      //
+      Label {
+        text: qsTr("CRC Errors (%)") + ":"
+        opacity: _crcErrorRate.enabled ? 1 : 0.5
+      } TextField {
+        id: _crcErrorRate
+        placeholderText: "0"
+        Layout.fillWidth: true
+        opacity: enabled ? 1 : 0.5
+        enabled: _crcEnabled.checked
+        palette.base: Cpp_ThemeManager.setupPanelBackground
+        Component.onCompleted: {
+          if (Cpp_IO_Synthetic.crcErrorRate > 0)
+            text = Cpp_IO_Synthetic.crcErrorRate
+        }
+
+        onTextChanged: Cpp_IO_Synthetic.crcErrorRate = text.length > 0 ? parseFloat(text) : 0
+
+        validator: DoubleValidator {
+          top: 100
+          bottom: 0
+        }
+      }
+
+      //
+      // Corrupt frame rate
+      //
+      Label {
+        text: qsTr("Corrupt Frames (%)") + ":"
+      } TextField {
+        id: _corruptFrameRate
+        placeholderText: "0"
+        Layout.fillWidth: true
+        palette.base: Cpp_ThemeManager.setupPanelBackground
+        Component.onCompleted: {
+          if (Cpp_IO_Synthetic.corruptFrameRate > 0)
+            text = Cpp_IO_Synthetic.corruptFrameRate
+        }
+
+        onTextChanged: Cpp_IO_Synthetic.corruptFrameRate = text.length > 0 ? parseFloat(text) : 0
+
+        validator: DoubleValidator {
+          top: 100
+          bottom: 0
+        }
+      }
+    }
+
+    //
+    // Generator statistics
+    //
+    Label {
+      opacity: 0.8
+      Layout.fillWidth: true
+      visible: Cpp_IO_Manager.connected
+      elide: Label.ElideRight
+      text: qsTr("%1 frames generated, %2 frames/s")
+              .arg(Cpp_IO_Synthetic.generatedFrames)
+              .arg(Cpp_IO_Synthetic.effectiveFrameRate.toFixed(0))
+    }
+
+    //
+    // Vertical spacer
+    //
+    Item {
+      Layout.fillHeight: true
+    }
+  }
+}
@@ -0,0 +1,342 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+import QtQuick
+import QtQuick.Layouts
+import QtQuick.Controls
+
+Control {
+  id: root
+
+  //
+  // Access to properties
+  //
+  property alias instrumentation: _instrumentation.checked
+
+  //
+  // Width of the numeric columns
+  //
+  readonly property int valueWidth: 64
+
+  //
+  // Formats the given time (in microseconds)
+  //
+  function formatTime(us) {
+    if (us >= 1000)
+      return (us / 1000).toFixed(1) + " ms"
+
+    return us.toFixed(1) + " µs"
+  }
+
+  //
+  // Layout
+  //
+  ScrollView {
+    id: view
+    clip: true
+    anchors.fill: parent
+    contentWidth: availableWidth
+    anchors.margins: app.spacing
+
+    ColumnLayout {
+      spacing: app.spacing
+      width: view.availableWidth
+
+      //
+      // Enable/disable instrumentation
+      //
+      RowLayout {
+        spacing: app.spacing
+        Layout.fillWidth: true
+
+        Label {
+          text: qsTr("Pipeline instrumentation") + ": "
+        } Switch {
+          id: _instrumentation
+          Layout.alignment: Qt.AlignLeft
+          checked: Cpp_Misc_Instrumentation.enabled
+          onCheckedChanged: {
+            if (checked !== Cpp_Misc_Instrumentation.enabled)
+              Cpp_Misc_Instrumentation.enabled = checked
+          }
+        }
+      }
+
+      //
+      // Trace capture controls
+      //
+      RowLayout {
+        spacing: app.spacing
+        Layout.fillWidth: true
+
+        Button {
+          Layout.fillWidth: true
+          text: Cpp_Misc_Instrumentation.capturing ? qsTr("Stop capture") :
+                                                     qsTr("Start capture")
+          onClicked: {
+            if (Cpp_Misc_Instrumentation.capturing)
+              Cpp_Misc_Instrumentation.stopCapture()
+            else
+              Cpp_Misc_Instrumentation.startCapture()
+          }
+        }
+
+        Button {
+          Layout.fillWidth: true
+          text: qsTr("Export trace")
+          opacity: enabled ? 1 : 0.5
+          enabled: Cpp_Misc_Instrumentation.capturedEvents > 0
+          onClicked: Cpp_Misc_Instrumentation.exportTrace()
+        }
+
+        Button {
+          text: qsTr("Reset")
+          onClicked: Cpp_Misc_Instrumentation.reset()
+        }
+      }
+
+      //
+      // Capture information label
+      //
+      Label {
+        opacity: 0.8
+        font.pixelSize: 12
+        Layout.fillWidth: true
+        wrapMode: Label.WrapAtWordBoundaryOrAnywhere
+        color: Cpp_ThemeManager.highlightedTextAlternative
+        text: qsTr("%1 events captured. Trace files can be opened with " +
+                   "Perfetto or chrome://tracing.")
+        .arg(Cpp_Misc_Instrumentation.capturedEvents)
+      }
+
+      //
+      // Pipeline stages header
+      //
+      RowLayout {
+        spacing: app.spacing
+        Layout.fillWidth: true
+        Layout.topMargin: app.spacing
+
+        Label {
+          font.bold: true
+          text: qsTr("Stage")
+          Layout.fillWidth: true
+        }
+
+        Label {
+          font.bold: true
+          text: qsTr("Rate")
+          Layout.preferredWidth: root.valueWidth
+        }
+
+        Label {
+          font.bold: true
+          text: qsTr("p99")
+          Layout.preferredWidth: root.valueWidth
+        }
+
+        Label {
+          font.bold: true
+          text: qsTr("Max")
+          Layout.preferredWidth: root.valueWidth
+        }
+      }
+
+      //
+      // Pipeline stage latencies
+      //
+      Repeater {
+        model: Cpp_Misc_Instrumentation.stages
+        delegate: RowLayout {
+          required property var modelData
+
+          spacing: app.spacing
+          Layout.fillWidth: true
+          opacity: Cpp_Misc_Instrumentation.enabled ? 1 : 0.5
+
+          Label {
+            Layout.fillWidth: true
+            elide: Label.ElideRight
+            text: modelData["name"]
+          }
+
+          Label {
+            font.family: app.monoFont
+            Layout.preferredWidth: root.valueWidth
+            text: modelData["rate"].toFixed(0) + " Hz"
+          }
+
+          Label {
+            font.family: app.monoFont
+            Layout.preferredWidth: root.valueWidth
+            text: root.formatTime(modelData["p99"])
+          }
+
+          Label {
+            font.family: app.monoFont
+            Layout.preferredWidth: root.valueWidth
+            text: root.formatTime(modelData["max"])
+          }
+        }
+      }
+
+      //
+      // Queues header
+      //
+      RowLayout {
+        spacing: app.spacing
+        Layout.fillWidth: true
+        Layout.topMargin: app.spacing
+
+        Label {
+          font.bold: true
+          text: qsTr("Queue")
+          Layout.fillWidth: true
+        }
+
+        Label {
+          font.bold: true
+          text: qsTr("Depth")
+          Layout.preferredWidth: root.valueWidth
+        }
+
+        Label {
+          font.bold: true
+          text: qsTr("Max")
+          Layout.preferredWidth: root.valueWidth
+        }
+      }
+
+      //
+      // Queue depths
+      //
+      Repeater {
+        model: Cpp_Misc_Instrumentation.queues
+        delegate: RowLayout {
+          required property var modelData
+
+          spacing: app.spacing
+          Layout.fillWidth: true
+          opacity: Cpp_Misc_Instrumentation.enabled ? 1 : 0.5
+
+          Label {
+            Layout.fillWidth: true
+            elide: Label.ElideRight
+            text: modelData["name"]
+          }
+
+          Label {
+            font.family: app.monoFont
+            text: modelData["depth"]
+            Layout.preferredWidth: root.valueWidth
+          }
+
+          Label {
+            font.family: app.monoFont
+            text: modelData["max"]
+            Layout.preferredWidth: root.valueWidth
+          }
+        }
+      }
+
+      //
+      // Dropped data header
+      //
+      Label {
+        font.bold: true
+        Layout.fillWidth: true
+        Layout.topMargin: app.spacing
+        text: qsTr("Discarded data")
+      }
+
+      //
+      // Dropped data counters
+      //
+      Repeater {
+        model: Cpp_Misc_Instrumentation.drops
+        delegate: RowLayout {
+          required property var modelData
+
+          spacing: app.spacing
+          Layout.fillWidth: true
+          opacity: Cpp_Misc_Instrumentation.enabled ? 1 : 0.5
+
+          Label {
+            Layout.fillWidth: true
+            elide: Label.ElideRight
+            text: modelData["name"]
+          }
+
+          Label {
+            font.family: app.monoFont
+            text: modelData["count"]
+            Layout.preferredWidth: root.valueWidth
+          }
+        }
+      }
+
+      //
+      // Startup metrics
+      //
+      Label {
+        font.bold: true
+        Layout.fillWidth: true
+        Layout.topMargin: app.spacing
+        text: qsTr("Startup")
+      }
+
+      RowLayout {
+        spacing: app.spacing
+        Layout.fillWidth: true
+
+        Label {
+          Layout.fillWidth: true
+          text: qsTr("Startup time")
+        }
+
+        Label {
+          font.family: app.monoFont
+          Layout.preferredWidth: root.valueWidth
+          text: Cpp_Misc_StartupTimeline.startupTime < 0 ? "—" :
+                Cpp_Misc_StartupTimeline.startupTime.toFixed(0) + " ms"
+        }
+      }
+
+      RowLayout {
+        spacing: app.spacing
+        Layout.fillWidth: true
+
+        Label {
+          Layout.fillWidth: true
+          text: qsTr("Time to first frame")
+        }
+
+        Label {
+          font.family: app.monoFont
+          Layout.preferredWidth: root.valueWidth
+          text: Cpp_Misc_StartupTimeline.timeToFirstFrame < 0 ? "—" :
+                Cpp_Misc_StartupTimeline.timeToFirstFrame.toFixed(0) + " ms"
+        }
+      }
+    }
+  }
+}
@@ -42,6 +42,7 @@ Control {
     property alias stopBits: serial.stopBits
     property alias flowControl: serial.flowControl
     property alias autoReconnect: serial.autoReconnect
+    property alias readBufferSize: serial.readBufferSize
     property alias address: network.address
     property alias tcpPort: network.tcpPort
     property alias socketType: network.socketType
@@ -49,6 +50,23 @@ Control {
     property alias udpRemotePort: network.udpRemotePort
     property alias udpMulticastEnabled: network.udpMulticastEnabled
     property alias udpProcessDatagramsDirectly: network.udpProcessDatagramsDirectly
+    property alias tcpServerAddress: network.tcpServerAddress
+    property alias tcpServerTagFrames: network.tcpServerTagFrames
+    property alias syntheticWaveform: synthetic.waveform
+    property alias syntheticChannels: synthetic.channels
+    property alias syntheticFrameRate: synthetic.frameRate
+    property alias syntheticFullSpeed: synthetic.fullSpeed
+    property alias syntheticFrequency: synthetic.frequency
+    property alias syntheticNoiseLevel: synthetic.noiseLevel
+    property alias syntheticPadding: synthetic.padding
+    property alias syntheticCrcEnabled: synthetic.crcEnabled
+    property alias syntheticCrcErrorRate: synthetic.crcErrorRate
+    property alias syntheticCorruptFrameRate: synthetic.corruptFrameRate
+    property alias replayFilePath: replay.filePath
+    property alias replaySpeed: replay.speed
+    property alias replayFullSpeed: replay.fullSpeed
+    property alias replayLoop: replay.loop
+    property alias pipePath: pipe.path
   }
 
   ColumnLayout {
@@ -113,6 +131,33 @@ Control {
           enabled: false
         }
       }
+
+      Devices.Synthetic {
+        id: synthetic
+        Layout.fillWidth: true
+        Layout.fillHeight: true
+        background: TextField {
+          enabled: false
+        }
+      }
+
+      Devices.Replay {
+        id: replay
+        Layout.fillWidth: true
+        Layout.fillHeight: true
+        background: TextField {
+          enabled: false
+        }
+      }
+
+      Devices.Pipe {
+        id: pipe
+        Layout.fillWidth: true
+        Layout.fillHeight: true
+        background: TextField {
+          enabled: false
+        }
+      }
     }
   }
 }
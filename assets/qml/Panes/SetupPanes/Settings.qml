@@ -23,6 +23,7 @@
 import QtQuick
 import QtQuick.Layouts
 import QtQuick.Controls
+import SerialStudio
 
 Control {
   id: root
@@ -31,6 +32,11 @@ Control {
   // Access to properties
   //
   property alias tcpPlugins: _tcpPlugins.checked
+  property alias metricsEndpoint: _metrics.checked
+  property alias metricsPort: _metricsPort.text
+  property alias sharedMemory: _sharedMemory.checked
+  property alias sharedMemoryName: _sharedMemoryName.text
+  property alias historyBudget: _historyBudget.text
   property alias language: _langCombo.currentIndex
   property alias windowShadows: _windowShadows.checked
 
@@ -99,6 +105,100 @@ Control {
         }
       }
 
+      //
+      // Prometheus metrics endpoint
+      //
+      Label {
+        text: qsTr("Metrics endpoint") + ": "
+      } Switch {
+        id: _metrics
+        Layout.leftMargin: -app.spacing
+        Layout.alignment: Qt.AlignLeft
+        checked: Cpp_Plugins_Metrics.enabled
+        onCheckedChanged: {
+          if (checked !== Cpp_Plugins_Metrics.enabled)
+            Cpp_Plugins_Metrics.enabled = checked
+        }
+      }
+
+      //
+      // Metrics endpoint port
+      //
+      Label {
+        text: qsTr("Metrics port") + ": "
+      } TextField {
+        id: _metricsPort
+        Layout.fillWidth: true
+        placeholderText: Cpp_Plugins_Metrics.port
+        Component.onCompleted: text = Cpp_Plugins_Metrics.port
+        onTextChanged: {
+          if (text.length > 0 && Cpp_Plugins_Metrics.port !== parseInt(text))
+            Cpp_Plugins_Metrics.port = parseInt(text)
+        }
+
+        validator: IntValidator {
+          bottom: 1
+          top: 65535
+        }
+      }
+
+      //
+      // Shared-memory output
+      //
+      Label {
+        text: qsTr("Shared memory output") + ": "
+      } Switch {
+        id: _sharedMemory
+        Layout.leftMargin: -app.spacing
+        Layout.alignment: Qt.AlignLeft
+        checked: Cpp_Plugins_SharedMemory.enabled
+        onCheckedChanged: {
+          if (checked !== Cpp_Plugins_SharedMemory.enabled)
+            Cpp_Plugins_SharedMemory.enabled = checked
+        }
+      }
+
+      //
+      // Shared-memory segment name
+      //
+      Label {
+        text: qsTr("Shared memory name") + ": "
+      } TextField {
+        id: _sharedMemoryName
+        Layout.fillWidth: true
+        placeholderText: Cpp_Plugins_SharedMemory.name
+        Component.onCompleted: text = Cpp_Plugins_SharedMemory.name
+        onTextChanged: {
+          if (text.length > 0 && Cpp_Plugins_SharedMemory.name !== text)
+            Cpp_Plugins_SharedMemory.name = text
+        }
+
+        validator: RegularExpressionValidator {
+          regularExpression: /[A-Za-z0-9_.-]+/
+        }
+      }
+
+      //
+      // Memory used by the telemetry history
+      //
+      Label {
+        text: qsTr("History memory (MiB)") + ": "
+      } TextField {
+        id: _historyBudget
+        Layout.fillWidth: true
+        placeholderText: Cpp_History_Store.memoryBudget
+        Component.onCompleted: text = Cpp_History_Store.memoryBudget
+        onTextChanged: {
+          if (text.length > 0 && Cpp_History_Store.memoryBudget !== parseInt(text))
+            Cpp_History_Store.memoryBudget = parseInt(text)
+        }
+
+        validator: IntValidator {
+          bottom: 0
+          top: 65536
+        }
+      }
+
       //
       // Custom window decorations
       //
@@ -129,6 +229,19 @@ Control {
                  "establishing a TCP connection on port 7777.").arg(Cpp_AppName)
     }
 
+    //
+    // Metrics label
+    //
+    Label {
+      opacity: 0.8
+      font.pixelSize: 12
+      Layout.fillWidth: true
+      visible: Cpp_Plugins_Metrics.enabled
+      wrapMode: Label.WrapAtWordBoundaryOrAnywhere
+      color: Cpp_ThemeManager.highlightedTextAlternative
+      text: qsTr("Prometheus metrics are available at %1").arg(Cpp_Plugins_Metrics.url)
+    }
+
     //
     // Vertical spacer
     //
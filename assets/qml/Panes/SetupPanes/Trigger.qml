@@ -0,0 +1,267 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+import QtQuick
+import QtQuick.Layouts
+import QtQuick.Controls
+import SerialStudio
+
+Control {
+  id: root
+
+  //
+  // Access to properties
+  //
+  property alias mode: _mode.currentIndex
+  property alias condition: _condition.currentIndex
+  property alias level: _level.text
+  property alias pattern: _pattern.text
+  property alias preTrigger: _preTrigger.text
+  property alias postTrigger: _postTrigger.text
+
+  //
+  // Convenience variables (state values match the IO::Trigger::State enum)
+  //
+  readonly property bool stopped: Cpp_IO_Trigger.state === 0
+  readonly property bool triggered: Cpp_IO_Trigger.state === 2
+  readonly property bool patternTrigger: _condition.currentIndex === 5
+
+  //
+  // Layout
+  //
+  ColumnLayout {
+    id: layout
+    anchors.fill: parent
+    anchors.margins: app.spacing
+
+    //
+    // Controls
+    //
+    GridLayout {
+      columns: 2
+      Layout.fillWidth: true
+      rowSpacing: app.spacing
+      columnSpacing: app.spacing
+
+      //
+      // Trigger mode
+      //
+      Label {
+        text: qsTr("Mode") + ":"
+      } ComboBox {
+        id: _mode
+        Layout.fillWidth: true
+        model: Cpp_IO_Trigger.availableModes()
+        currentIndex: Cpp_IO_Trigger.mode
+        onCurrentIndexChanged: {
+          if (currentIndex !== Cpp_IO_Trigger.mode)
+            Cpp_IO_Trigger.mode = currentIndex
+        }
+      }
+
+      //
+      // Trigger condition
+      //
+      Label {
+        text: qsTr("Condition") + ":"
+      } ComboBox {
+        id: _condition
+        Layout.fillWidth: true
+        model: Cpp_IO_Trigger.availableConditions()
+        currentIndex: Cpp_IO_Trigger.condition
+        onCurrentIndexChanged: {
+          if (currentIndex !== Cpp_IO_Trigger.condition)
+            Cpp_IO_Trigger.condition = currentIndex
+        }
+      }
+
+      //
+      // Source dataset
+      //
+      Label {
+        text: qsTr("Source") + ":"
+        visible: !root.patternTrigger
+      } ComboBox {
+        Layout.fillWidth: true
+        visible: !root.patternTrigger
+        model: Cpp_IO_Trigger.sources
+        currentIndex: Cpp_IO_Trigger.source
+        onCurrentIndexChanged: {
+          if (currentIndex >= 0 && currentIndex !== Cpp_IO_Trigger.source)
+            Cpp_IO_Trigger.source = currentIndex
+        }
+      }
+
+      //
+      // Trigger level
+      //
+      Label {
+        text: qsTr("Level") + ":"
+        visible: !root.patternTrigger
+      } TextField {
+        id: _level
+        Layout.fillWidth: true
+        visible: !root.patternTrigger
+        placeholderText: Cpp_IO_Trigger.level
+        Component.onCompleted: text = Cpp_IO_Trigger.level
+        onTextChanged: {
+          if (text.length > 0 && Cpp_IO_Trigger.level !== parseFloat(text))
+            Cpp_IO_Trigger.level = parseFloat(text)
+        }
+
+        validator: DoubleValidator {}
+      }
+
+      //
+      // Byte pattern
+      //
+      Label {
+        text: qsTr("Pattern") + ":"
+        visible: root.patternTrigger
+      } TextField {
+        id: _pattern
+        Layout.fillWidth: true
+        visible: root.patternTrigger
+        placeholderText: qsTr("e.g. ERROR or \\xFF\\x00")
+        Component.onCompleted: text = Cpp_IO_Trigger.pattern
+        onTextChanged: {
+          if (Cpp_IO_Trigger.pattern !== text)
+            Cpp_IO_Trigger.pattern = text
+        }
+      }
+
+      //
+      // Pre-trigger time
+      //
+      Label {
+        text: qsTr("Pre-trigger (ms)") + ":"
+      } TextField {
+        id: _preTrigger
+        Layout.fillWidth: true
+        placeholderText: Cpp_IO_Trigger.preTrigger
+        Component.onCompleted: text = Cpp_IO_Trigger.preTrigger
+        onTextChanged: {
+          if (text.length > 0 && Cpp_IO_Trigger.preTrigger !== parseInt(text))
+            Cpp_IO_Trigger.preTrigger = parseInt(text)
+        }
+
+        validator: IntValidator {
+          bottom: 0
+          top: 600000
+        }
+      }
+
+      //
+      // Post-trigger time
+      //
+      Label {
+        text: qsTr("Post-trigger (ms)") + ":"
+      } TextField {
+        id: _postTrigger
+        Layout.fillWidth: true
+        placeholderText: Cpp_IO_Trigger.postTrigger
+        Component.onCompleted: text = Cpp_IO_Trigger.postTrigger
+        onTextChanged: {
+          if (text.length > 0 && Cpp_IO_Trigger.postTrigger !== parseInt(text))
+            Cpp_IO_Trigger.postTrigger = parseInt(text)
+        }
+
+        validator: IntValidator {
+          bottom: 0
+          top: 600000
+        }
+      }
+    }
+
+    //
+    // Trigger controls
+    //
+    RowLayout {
+      spacing: app.spacing
+      Layout.fillWidth: true
+
+      Button {
+        Layout.fillWidth: true
+        text: root.stopped ? qsTr("Arm") : qsTr("Stop")
+        onClicked: {
+          if (root.stopped)
+            Cpp_IO_Trigger.arm()
+          else
+            Cpp_IO_Trigger.stop()
+        }
+      }
+
+      Button {
+        Layout.fillWidth: true
+        text: qsTr("Force")
+        opacity: enabled ? 1 : 0.5
+        enabled: Cpp_IO_Trigger.state === 1
+        onClicked: Cpp_IO_Trigger.force()
+      }
+
+      Button {
+        text: qsTr("Resume")
+        opacity: enabled ? 1 : 0.5
+        enabled: Cpp_UI_Dashboard.frozen
+        onClicked: Cpp_UI_Dashboard.frozen = false
+      }
+    }
+
+    //
+    // Trigger state label
+    //
+    Label {
+      opacity: 0.8
+      font.pixelSize: 12
+      Layout.fillWidth: true
+      wrapMode: Label.WrapAtWordBoundaryOrAnywhere
+      color: Cpp_ThemeManager.highlightedTextAlternative
+      text: {
+        var state = qsTr("Stopped")
+        if (root.triggered)
+          state = qsTr("Triggered, capturing...")
+        else if (!root.stopped)
+          state = qsTr("Armed, waiting for trigger...")
+
+        return qsTr("%1 %2 captures written.").arg(state).arg(Cpp_IO_Trigger.captureCount)
+      }
+    }
+
+    //
+    // Last capture button
+    //
+    Button {
+      Layout.fillWidth: true
+      opacity: enabled ? 1 : 0.5
+      text: qsTr("Open last capture")
+      enabled: Cpp_IO_Trigger.lastCapture.length > 0
+      onClicked: Cpp_Misc_Utilities.revealFile(Cpp_IO_Trigger.lastCapture)
+    }
+
+    //
+    // Vertical spacer
+    //
+    Item {
+      Layout.fillHeight: true
+    }
+  }
+}
@@ -56,8 +56,15 @@ Widgets.Window {
   //
   // Convenience variables
   //
-  readonly property bool fftSamplesVisible: fftCheck.checked
-  readonly property bool alarmVisible: widget.currentIndex === 2
+  readonly property bool fftSamplesVisible: fftCheck.checked || waterfallCheck.checked
+  readonly property bool barWidget: widget.currentIndex === 2
+  readonly property bool alarmVisible: barWidget ||
+                                       alarmMode.currentIndex === 1 ||
+                                       alarmMode.currentIndex === 3 ||
+                                       alarmMode.currentIndex === 4
+  readonly property bool alarmLowVisible: alarmMode.currentIndex === 2 ||
+                                          alarmMode.currentIndex === 3
+  readonly property bool alarmOptionsVisible: alarmMode.currentIndex > 0
   readonly property bool minMaxVisible: widget.currentIndex === 1 ||
                                         widget.currentIndex === 2 ||
                                         logPlot.checked ||
@@ -103,12 +110,71 @@ Widgets.Window {
     }
 
     //
-    // Frame index
+    // Expression (derived datasets)
+    //
+    Label {
+      text: qsTr("Expression:")
+    } TextField {
+      id: expression
+      Layout.fillWidth: true
+      text: Cpp_Project_Model.datasetExpression(group, dataset)
+      placeholderText: qsTr("Optional, e.g. hypot($1, $2, $3) or ${Voltage} * ${Current}")
+      onTextChanged: {
+        Cpp_Project_Model.setDatasetExpression(group, dataset, text)
+        expressionError.text = Cpp_Project_Model.datasetExpressionError(group, dataset)
+      }
+    }
+
+    //
+    // Expression syntax error
+    //
+    Item {
+      visible: expressionError.text.length > 0
+    } Label {
+      id: expressionError
+      Layout.fillWidth: true
+      wrapMode: Label.WordWrap
+      visible: text.length > 0
+      text: Cpp_Project_Model.datasetExpressionError(group, dataset)
+    }
+
+    //
+    // Filter chain
+    //
+    Label {
+      text: qsTr("Filter:")
+    } TextField {
+      Layout.fillWidth: true
+      text: Cpp_Project_Model.datasetFilter(group, dataset)
+      placeholderText: qsTr("Optional, e.g. median(5) | lowpass(2, 100)")
+      onTextChanged: {
+        Cpp_Project_Model.setDatasetFilter(group, dataset, text)
+        filterError.text = Cpp_Project_Model.datasetFilterError(group, dataset)
+      }
+    }
+
+    //
+    // Filter error
+    //
+    Item {
+      visible: filterError.text.length > 0
+    } Label {
+      id: filterError
+      Layout.fillWidth: true
+      wrapMode: Label.WordWrap
+      visible: text.length > 0
+      text: Cpp_Project_Model.datasetFilterError(group, dataset)
+    }
+
+    //
+    // Frame index (not used by derived datasets)
     //
     Label {
       text: qsTr("Frame index:")
+      visible: expression.text.length === 0
     } TextField {
       Layout.fillWidth: true
+      visible: expression.text.length === 0
       text: Cpp_Project_Model.datasetIndex(group, dataset)
       onTextChanged: Cpp_Project_Model.setDatasetIndex(group, dataset, text)
       validator: IntValidator {
@@ -172,6 +238,18 @@ Widgets.Window {
       onCheckedChanged: Cpp_Project_Model.setDatasetFftPlot(group, dataset, checked)
     }
 
+    //
+    // Waterfall (spectrogram) plot
+    //
+    Label {
+      text: qsTr("Waterfall plot:")
+    } Switch {
+      id: waterfallCheck
+      Layout.leftMargin: -app.spacing
+      checked: Cpp_Project_Model.datasetWaterfall(group, dataset)
+      onCheckedChanged: Cpp_Project_Model.setDatasetWaterfall(group, dataset, checked)
+    }
+
     //
     // Dataset widget (user selectable or group-level constant)
     //
@@ -251,11 +329,28 @@ Widgets.Window {
     }
 
     //
-    // Bar alarm level
+    // Alarm condition
+    //
+    Label {
+      text: qsTr("Alarm:")
+    } ComboBox {
+      id: alarmMode
+      Layout.fillWidth: true
+      model: Cpp_Project_Model.availableAlarmModes()
+      currentIndex: Cpp_Project_Model.datasetAlarmModeIndex(group, dataset)
+      onCurrentIndexChanged: {
+        if (currentIndex !== Cpp_Project_Model.datasetAlarmModeIndex(group, dataset))
+          Cpp_Project_Model.setDatasetAlarmMode(group, dataset, currentIndex)
+      }
+    }
+
+    //
+    // Alarm level (bar widgets, high limit or rate of change limit)
     //
     Label {
-      text: qsTr("Alarm level:")
       visible: root.alarmVisible
+      text: alarmMode.currentIndex === 4 ? qsTr("Alarm rate (units/s):") :
+                                           qsTr("Alarm level:")
     } TextField {
       id: alarm
       Layout.fillWidth: true
@@ -264,8 +359,55 @@ Widgets.Window {
       onTextChanged: Cpp_Project_Model.setDatasetWidgetAlarm(group, dataset, text)
 
       validator: DoubleValidator {
-        top: parseFloat(max.text)
-        bottom: parseFloat(min.text)
+        top: root.barWidget && alarmMode.currentIndex !== 4 ? parseFloat(max.text) : Infinity
+        bottom: root.barWidget && alarmMode.currentIndex !== 4 ? parseFloat(min.text) : -Infinity
+      }
+    }
+
+    //
+    // Low alarm level
+    //
+    Label {
+      text: qsTr("Low alarm level:")
+      visible: root.alarmLowVisible
+    } TextField {
+      Layout.fillWidth: true
+      visible: root.alarmLowVisible
+      text: Cpp_Project_Model.datasetAlarmLow(group, dataset)
+      onTextChanged: Cpp_Project_Model.setDatasetAlarmLow(group, dataset, text)
+      validator: DoubleValidator {}
+    }
+
+    //
+    // Alarm hysteresis
+    //
+    Label {
+      text: qsTr("Hysteresis:")
+      visible: root.alarmOptionsVisible
+    } TextField {
+      Layout.fillWidth: true
+      visible: root.alarmOptionsVisible
+      text: Cpp_Project_Model.datasetAlarmHysteresis(group, dataset)
+      onTextChanged: Cpp_Project_Model.setDatasetAlarmHysteresis(group, dataset, text)
+      validator: DoubleValidator {
+        bottom: 0
+      }
+    }
+
+    //
+    // Alarm debounce (consecutive frames)
+    //
+    Label {
+      text: qsTr("Debounce (frames):")
+      visible: root.alarmOptionsVisible
+    } TextField {
+      Layout.fillWidth: true
+      visible: root.alarmOptionsVisible
+      text: Cpp_Project_Model.datasetAlarmDebounce(group, dataset)
+      onTextChanged: Cpp_Project_Model.setDatasetAlarmDebounce(group, dataset, text)
+      validator: IntValidator {
+        bottom: 1
+        top: 1000
       }
     }
 
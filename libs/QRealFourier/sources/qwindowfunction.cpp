@@ -142,7 +142,7 @@ QHammingFunction
 template<typename T>
 T QHammingFunction<T>::calculate(int currentSample, int totalSamples)
 {
-  return 0.54 + (0.46 * qCos((2 * M_PI * currentSample) / (totalSamples - 1)));
+  return 0.54 - (0.46 * qCos((2 * M_PI * currentSample) / (totalSamples - 1)));
 }
 
 template class QHammingFunction<short>;
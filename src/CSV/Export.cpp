@@ -22,6 +22,8 @@
 
 #include "Export.h"
 
+#include <limits>
+
 #include <QDir>
 #include <QUrl>
 #include <QFileInfo>
@@ -30,7 +32,8 @@
 
 #include <AppInfo.h>
 #include <IO/Manager.h>
-#include <UI/Dashboard.h>
+#include <Misc/Alarms.h>
+#include <JSON/Generator.h>
 #include <Project/Model.h>
 #include <Misc/Utilities.h>
 #include <Misc/TimerEvents.h>
@@ -41,13 +44,19 @@
  */
 CSV::Export::Export()
   : m_fieldCount(0)
+  , m_expressionFields(0)
   , m_exportEnabled(true)
+  , m_frameValid(false)
 {
+  auto gn = &JSON::Generator::instance();
   auto io = &IO::Manager::instance();
   auto te = &Misc::TimerEvents::instance();
+  auto al = &Misc::Alarms::instance();
+  connect(gn, &JSON::Generator::frameChanged, this, &Export::onFrameChanged);
   connect(io, &IO::Manager::connectedChanged, this, &Export::closeFile);
   connect(io, &IO::Manager::frameReceived, this, &Export::registerFrame);
   connect(te, &Misc::TimerEvents::timeout1Hz, this, &Export::writeValues);
+  connect(al, &Misc::Alarms::eventLogged, this, &Export::registerAlarm);
 }
 
 /**
@@ -83,6 +92,14 @@ bool CSV::Export::exportEnabled() const
   return m_exportEnabled;
 }
 
+/**
+ * Returns the number of frames waiting to be written to the CSV file
+ */
+int CSV::Export::backlog() const
+{
+  return m_frames.count();
+}
+
 /**
  * Open the current CSV file in the Explorer/Finder window
  */
@@ -106,6 +123,7 @@ void CSV::Export::setExportEnabled(const bool enabled)
   if (!exportEnabled() && isOpen())
   {
     m_frames.clear();
+    m_alarms.clear();
     closeFile();
   }
 }
@@ -120,7 +138,15 @@ void CSV::Export::closeFile()
     while (!m_frames.isEmpty())
       writeValues();
 
+    writeAlarms();
+    m_alarms.clear();
+    m_alarmFile.close();
+    m_alarmStream.setDevice(Q_NULLPTR);
+
     m_fieldCount = 0;
+    m_expressionFields = 0;
+    m_expressions.clear();
+    m_expressionInputs.clear();
     m_csvFile.close();
     m_textStream.setDevice(Q_NULLPTR);
 
@@ -134,46 +160,62 @@ void CSV::Export::closeFile()
  */
 void CSV::Export::writeValues()
 {
-  // Get separator sequence
+  // No frames to write, write pending alarm events
+  if (m_frames.isEmpty())
+  {
+    writeAlarms();
+    return;
+  }
+
+  // File not open, create it & add cell titles
+  if (!isOpen() && exportEnabled())
+    createCsvFile(m_frames.first());
+
+  // Split frames into fields
   auto sep = IO::Manager::instance().separatorSequence();
+  QVector<QStringList> rows;
+  rows.reserve(m_frames.count());
+  for (auto i = 0; i < m_frames.count(); ++i)
+    rows.append(QString::fromUtf8(m_frames.at(i).data).split(sep));
+
+  // Compute the values of the derived datasets for the whole batch
+  evaluateExpressions(rows);
 
   // Write each frame
-  for (auto i = 0; i < m_frames.count(); ++i)
+  const auto frames = m_frames.count();
+  for (auto i = 0; i < frames; ++i)
   {
-    auto frame = m_frames.at(i);
-    auto fields = QString::fromUtf8(frame.data).split(sep);
-
-    // File not open, create it & add cell titles
-    if (!isOpen() && exportEnabled())
-      createCsvFile(frame);
+    const auto &frame = m_frames.at(i);
+    const auto &fields = rows.at(i);
 
     // Write RX date/time
     m_textStream << frame.rxDateTime.toString("yyyy/MM/dd/ HH:mm:ss::zzz")
                  << ",";
 
-    // Write frame data
+    // Write frame data & pad missing fields
     for (auto j = 0; j < fields.count(); ++j)
     {
       m_textStream << fields.at(j);
       if (j < fields.count() - 1)
         m_textStream << ",";
+    }
 
-      else
-      {
-        auto d = m_fieldCount - fields.count();
-        if (d > 0)
-        {
-          for (auto k = 0; k < d - 1; ++k)
-            m_textStream << ",";
-        }
+    for (auto j = fields.count(); j < m_fieldCount; ++j)
+      m_textStream << ",";
 
-        m_textStream << "\n";
-      }
-    }
+    // Write derived datasets
+    for (auto j = 0; j < m_expressions.count(); ++j)
+      m_textStream << ","
+                   << JSON::Expression::format(m_results.at(j * frames + i));
+
+    m_textStream << "\n";
   }
 
   // Clear frames
   m_frames.clear();
+
+  // Write alarm events
+  writeAlarms();
 }
 
 /**
@@ -182,7 +224,7 @@ void CSV::Export::writeValues()
  */
 void CSV::Export::createCsvFile(const CSV::RawFrame &frame)
 { // Get project title
-  auto projectTitle = UI::Dashboard::instance().title();
+  auto projectTitle = m_projectTitle;
 
   // Get file name
   const QString fileName = frame.rxDateTime.toString("HH-mm-ss") + ".csv";
@@ -217,15 +259,47 @@ void CSV::Export::createCsvFile(const CSV::RawFrame &frame)
   m_textStream.setEncoding(QStringConverter::Utf8);
 #endif
 
-  // Get number of fields by counting datasets with non-duplicated indexes
+  // Get the groups of the project
+  QVector<JSON::Group> groups;
+  const auto &model = Project::Model::instance();
+  for (int i = 0; i < model.groupCount(); ++i)
+    groups.append(model.getGroup(i));
+
+  // Get number of fields by counting datasets with non-duplicated indexes,
+  // compile the expressions of the derived datasets & map the datasets that
+  // they reference to frame fields (missing datasets evaluate to NaN)
   QVector<int> fields;
   QVector<QString> titles;
-  for (int i = 0; i < Project::Model::instance().groupCount(); ++i)
+  QVector<QString> derived;
+  for (int i = 0; i < groups.count(); ++i)
   {
-    for (int j = 0; j < Project::Model::instance().datasetCount(i); ++j)
+    for (int j = 0; j < groups.at(i).datasetCount(); ++j)
     {
-      auto dataset = Project::Model::instance().getDataset(i, j);
-      if (!fields.contains(dataset.index()))
+      const auto &dataset = groups.at(i).getDataset(j);
+      if (!dataset.expression().trimmed().isEmpty())
+      {
+        JSON::Expression expression;
+        if (expression.compile(dataset.expression()))
+        {
+          QVector<int> inputs;
+          const auto references = expression.references();
+          for (const auto &reference : references)
+          {
+            int g, d, field = -1;
+            if (JSON::Expression::findDataset(reference, groups, &g, &d))
+              field = groups.at(g).getDataset(d).index() - 1;
+
+            inputs.append(field);
+            m_expressionFields = qMax(m_expressionFields, field + 1);
+          }
+
+          derived.append(dataset.title());
+          m_expressions.append(expression);
+          m_expressionInputs.append(inputs);
+        }
+      }
+
+      else if (!fields.contains(dataset.index()))
       {
         fields.append(dataset.index());
         titles.append(dataset.title());
@@ -242,14 +316,122 @@ void CSV::Export::createCsvFile(const CSV::RawFrame &frame)
 
     if (i < m_fieldCount - 1)
       m_textStream << ",";
-    else
-      m_textStream << "\n";
   }
 
+  for (auto i = 0; i < derived.count(); ++i)
+    m_textStream << "," << derived.at(i) << "(derived)";
+
+  m_textStream << "\n";
+
   // Update UI
   Q_EMIT openChanged();
 }
 
+/**
+ * Writes the pending alarm events to the alarm log of the current CSV file,
+ * creating the alarm log when the first event is written.
+ */
+void CSV::Export::writeAlarms()
+{
+  // Nothing to write
+  if (m_alarms.isEmpty() || !isOpen())
+    return;
+
+  // Create the alarm log next to the CSV file
+  if (!m_alarmFile.isOpen())
+  {
+    const QFileInfo info(m_csvFile.fileName());
+    const auto name = info.completeBaseName() + "-alarms.csv";
+    m_alarmFile.setFileName(info.dir().filePath(name));
+    if (!m_alarmFile.open(QIODevice::WriteOnly | QIODevice::Text))
+    {
+      m_alarms.clear();
+      return;
+    }
+
+    m_alarmStream.setDevice(&m_alarmFile);
+    m_alarmStream.setGenerateByteOrderMark(true);
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+    m_alarmStream.setCodec("UTF-8");
+#else
+    m_alarmStream.setEncoding(QStringConverter::Utf8);
+#endif
+    m_alarmStream << "RX Date/Time,Group,Dataset,Condition,State,Value,Limit\n";
+  }
+
+  // Write each event
+  for (auto i = 0; i < m_alarms.count(); ++i)
+  {
+    const auto &event = m_alarms.at(i);
+    const auto time = QDateTime::fromString(event.value("time").toString(),
+                                            Qt::ISODateWithMs);
+    const auto active = event.value("active").toBool();
+    const auto value = event.value("value").toDouble();
+    const auto limit = event.value("limit").toDouble();
+    m_alarmStream << time.toString("yyyy/MM/dd/ HH:mm:ss::zzz") << ","
+                  << event.value("group").toString() << ","
+                  << event.value("dataset").toString() << ","
+                  << event.value("condition").toString() << ","
+                  << (active ? "raised" : "cleared") << ","
+                  << JSON::Expression::format(value) << ","
+                  << JSON::Expression::format(limit) << "\n";
+  }
+
+  // Clear events
+  m_alarms.clear();
+  m_alarmStream.flush();
+}
+
+/**
+ * Evaluates the expressions of the derived datasets for the given frame
+ * @a rows. The fields of all frames are converted to numbers first, then the
+ * inputs of each expression are gathered & the expression is evaluated for
+ * the whole batch at once. The results are stored in @c m_results, one block
+ * of values per expression.
+ */
+void CSV::Export::evaluateExpressions(const QVector<QStringList> &rows)
+{
+  // No derived datasets
+  if (m_expressions.isEmpty())
+    return;
+
+  // Convert the fields used by the expressions to numbers
+  const auto frames = rows.count();
+  const auto stride = m_expressionFields;
+  m_fieldValues.resize(frames * stride);
+  for (auto i = 0; i < frames; ++i)
+  {
+    const auto &fields = rows.at(i);
+    const auto values = m_fieldValues.data() + i * stride;
+    for (auto j = 0; j < stride; ++j)
+    {
+      const bool valid = j < fields.count();
+      if (!valid || !JSON::Dataset::parseNumber(fields.at(j), values[j]))
+        values[j] = std::numeric_limits<double>::quiet_NaN();
+    }
+  }
+
+  // Gather the inputs of each expression & evaluate it for all frames
+  constexpr auto kNaN = std::numeric_limits<double>::quiet_NaN();
+  m_results.resize(m_expressions.count() * frames);
+  for (auto i = 0; i < m_expressions.count(); ++i)
+  {
+    const auto &inputs = m_expressionInputs.at(i);
+    const auto count = inputs.count();
+    m_inputValues.resize(frames * count);
+    for (auto j = 0; j < frames; ++j)
+    {
+      const auto src = m_fieldValues.constData() + j * stride;
+      const auto dst = m_inputValues.data() + j * count;
+      for (auto k = 0; k < count; ++k)
+        dst[k] = inputs.at(k) >= 0 ? src[inputs.at(k)] : kNaN;
+    }
+
+    m_expressions.at(i).evaluate(m_inputValues.constData(), count, frames,
+                                 m_results.data() + i * frames);
+  }
+}
+
 /**
  * Appends the latest data from the device to the output buffer
  */
@@ -260,8 +442,8 @@ void CSV::Export::registerFrame(const QByteArray &data)
   if (!IO::Manager::instance().connected())
     return;
 
-  // Ignore if current dashboard frame hasn't been loaded yet
-  if (!UI::Dashboard::instance().currentFrame().isValid())
+  // Ignore if the current frame hasn't been loaded yet
+  if (!m_frameValid)
     return;
 
   // Ignore if CSV export is disabled
@@ -271,6 +453,30 @@ void CSV::Export::registerFrame(const QByteArray &data)
   // Register raw frame to list
   RawFrame frame;
   frame.data = data;
-  frame.rxDateTime = QDateTime::currentDateTime();
+  auto &io = IO::Manager::instance();
+  frame.rxDateTime = io.dateTime(io.frameTimestamp());
   m_frames.append(frame);
 }
+
+/**
+ * Keeps the title & validity of the latest frame built by the JSON generator,
+ * which are used to name the CSV file & to skip data that cannot be parsed.
+ */
+void CSV::Export::onFrameChanged(const JSON::Frame &frame)
+{
+  m_frameValid = frame.isValid();
+  m_projectTitle = frame.title();
+}
+
+/**
+ * Appends the given alarm @a event to the alarm log buffer
+ */
+void CSV::Export::registerAlarm(const QJsonObject &event)
+{
+  // Ignore if device is not connected or if CSV export is disabled
+  if (!IO::Manager::instance().connected() || !exportEnabled())
+    return;
+
+  // Register alarm event
+  m_alarms.append(event);
+}
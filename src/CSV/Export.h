@@ -29,6 +29,8 @@
 #include <QDateTime>
 #include <QTextStream>
 #include <QJsonObject>
+#include <JSON/Frame.h>
+#include <JSON/Expression.h>
 
 namespace CSV
 {
@@ -42,6 +44,14 @@ namespace CSV
  * low-frequency timer expires (e.g. every 1 second). The idea behind this
  * is to allow exporting data, but avoid freezing the application when serial
  * data is received continuously.
+ *
+ * Derived datasets (datasets with a math expression) are written after the
+ * frame fields. The datasets referenced by each expression are mapped to the
+ * fields of the frame when the file is created, and the expressions are
+ * evaluated for all the frames of each batch at once.
+ *
+ * Alarm events reported by the @c Misc::Alarms class are written to a second
+ * file next to the CSV file (with the "-alarms.csv" suffix).
  */
 typedef struct
 {
@@ -78,6 +88,7 @@ private:
 public:
   static Export &instance();
 
+  int backlog() const;
   bool isOpen() const;
   bool exportEnabled() const;
 
@@ -89,13 +100,31 @@ public Q_SLOTS:
 private Q_SLOTS:
   void writeValues();
   void registerFrame(const QByteArray &data);
+  void registerAlarm(const QJsonObject &event);
   void createCsvFile(const CSV::RawFrame &frame);
+  void onFrameChanged(const JSON::Frame &frame);
+
+private:
+  void writeAlarms();
+  void evaluateExpressions(const QVector<QStringList> &rows);
 
 private:
   QFile m_csvFile;
   int m_fieldCount;
+  int m_expressionFields;
+  QVector<double> m_results;
+  QVector<double> m_fieldValues;
+  QVector<double> m_inputValues;
+  QVector<JSON::Expression> m_expressions;
+  QVector<QVector<int>> m_expressionInputs;
   bool m_exportEnabled;
+  bool m_frameValid;
+  QString m_projectTitle;
   QTextStream m_textStream;
   QVector<RawFrame> m_frames;
+
+  QFile m_alarmFile;
+  QTextStream m_alarmStream;
+  QVector<QJsonObject> m_alarms;
 };
 } // namespace CSV
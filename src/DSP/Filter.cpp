@@ -0,0 +1,603 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <cmath>
+#include <algorithm>
+
+#include <QtMath>
+#include <QStringList>
+#include <QRegularExpression>
+
+#include <DSP/Filter.h>
+
+//----------------------------------------------------------------------------------------
+// Filter base class
+//----------------------------------------------------------------------------------------
+
+/**
+ * Constructor function, sets the number of channels processed by the filter
+ */
+DSP::Filter::Filter(const int channels)
+  : m_channels(channels)
+{
+}
+
+/**
+ * Destructor function
+ */
+DSP::Filter::~Filter() {}
+
+/**
+ * Returns the number of channels processed by the filter
+ */
+int DSP::Filter::channels() const
+{
+  return m_channels;
+}
+
+//----------------------------------------------------------------------------------------
+// Biquad filter
+//----------------------------------------------------------------------------------------
+
+/**
+ * Calculates the (normalized) coefficients of the filter.
+ *
+ * @param channels   number of channels
+ * @param type       filter response
+ * @param cutoff     cut-off or center frequency, in Hz
+ * @param sampleRate sampling rate of the channels, in Hz
+ * @param q          quality factor, 1/sqrt(2) gives a Butterworth response
+ */
+DSP::Biquad::Biquad(const int channels, const Type type, const double cutoff,
+                    const double sampleRate, const double q)
+  : Filter(channels)
+  , m_z1(channels, 0)
+  , m_z2(channels, 0)
+{
+  const double w0 = 2 * M_PI * cutoff / sampleRate;
+  const double cosw0 = std::cos(w0);
+  const double alpha = std::sin(w0) / (2 * q);
+  const double a0 = 1 + alpha;
+
+  double b0 = 0, b1 = 0, b2 = 0;
+  switch (type)
+  {
+    case LowPass:
+      b0 = (1 - cosw0) / 2;
+      b1 = 1 - cosw0;
+      b2 = (1 - cosw0) / 2;
+      break;
+    case HighPass:
+      b0 = (1 + cosw0) / 2;
+      b1 = -(1 + cosw0);
+      b2 = (1 + cosw0) / 2;
+      break;
+    case BandPass:
+      b0 = alpha;
+      b1 = 0;
+      b2 = -alpha;
+      break;
+    case Notch:
+      b0 = 1;
+      b1 = -2 * cosw0;
+      b2 = 1;
+      break;
+  }
+
+  m_b0 = b0 / a0;
+  m_b1 = b1 / a0;
+  m_b2 = b2 / a0;
+  m_a1 = -2 * cosw0 / a0;
+  m_a2 = (1 - alpha) / a0;
+}
+
+/**
+ * Sets the state of each channel to the steady state of its given value
+ */
+void DSP::Biquad::prime(const double *values)
+{
+  const double gain = (m_b0 + m_b1 + m_b2) / (1 + m_a1 + m_a2);
+  for (int c = 0; c < m_channels; ++c)
+  {
+    const double x = values[c];
+    const double y = x * gain;
+    m_z1[c] = y - m_b0 * x;
+    m_z2[c] = m_b2 * x - m_a2 * y;
+  }
+}
+
+/**
+ * Filters one sample of each channel
+ */
+bool DSP::Biquad::process(double *values)
+{
+  auto z1 = m_z1.data();
+  auto z2 = m_z2.data();
+  for (int c = 0; c < m_channels; ++c)
+  {
+    const double x = values[c];
+    const double y = m_b0 * x + z1[c];
+    z1[c] = m_b1 * x - m_a1 * y + z2[c];
+    z2[c] = m_b2 * x - m_a2 * y;
+    values[c] = y;
+  }
+
+  return true;
+}
+
+//----------------------------------------------------------------------------------------
+// FIR filter
+//----------------------------------------------------------------------------------------
+
+/**
+ * Constructor function, the history of each channel holds as many samples as
+ * there are @a taps.
+ */
+DSP::FIRFilter::FIRFilter(const int channels, const QVector<double> &taps)
+  : Filter(channels)
+  , m_position(0)
+  , m_taps(taps)
+  , m_history(taps.count() * channels, 0)
+  , m_sum(channels, 0)
+{
+}
+
+/**
+ * Fills the history of each channel with its given value
+ */
+void DSP::FIRFilter::prime(const double *values)
+{
+  for (int i = 0; i < m_taps.count(); ++i)
+    std::copy_n(values, m_channels, m_history.data() + i * m_channels);
+}
+
+/**
+ * Filters one sample of each channel. The newest sample is written over the
+ * oldest one in the history, and the taps are applied one at a time to all
+ * channels.
+ */
+bool DSP::FIRFilter::process(double *values)
+{
+  const int length = m_taps.count();
+  const auto history = m_history.data();
+  std::copy_n(values, m_channels, history + m_position * m_channels);
+
+  auto sum = m_sum.data();
+  std::fill_n(sum, m_channels, 0.0);
+  for (int k = 0; k < length; ++k)
+  {
+    int index = m_position - k;
+    if (index < 0)
+      index += length;
+
+    const double tap = m_taps.at(k);
+    const double *row = history + index * m_channels;
+    for (int c = 0; c < m_channels; ++c)
+      sum[c] += tap * row[c];
+  }
+
+  std::copy_n(sum, m_channels, values);
+  m_position = (m_position + 1) % length;
+  return true;
+}
+
+/**
+ * Returns the taps of a moving average of the given @a length
+ */
+QVector<double> DSP::FIRFilter::average(const int length)
+{
+  return QVector<double>(length, 1.0 / length);
+}
+
+/**
+ * Returns the taps of a windowed-sinc low-pass filter (Hamming window) with
+ * the given @a length & @a cutoff frequency, normalized to unity gain.
+ */
+QVector<double> DSP::FIRFilter::lowPass(const int length, const double cutoff,
+                                        const double sampleRate)
+{
+  QVector<double> taps(length);
+  const double fc = cutoff / sampleRate;
+  const double middle = (length - 1) / 2.0;
+
+  double sum = 0;
+  for (int i = 0; i < length; ++i)
+  {
+    double window = 1;
+    if (length > 1)
+      window = 0.54 - 0.46 * std::cos(2 * M_PI * i / (length - 1));
+
+    const double n = i - middle;
+    if (n == 0)
+      taps[i] = 2 * fc * window;
+    else
+      taps[i] = std::sin(2 * M_PI * fc * n) / (M_PI * n) * window;
+
+    sum += taps[i];
+  }
+
+  for (int i = 0; i < length; ++i)
+    taps[i] /= sum;
+
+  return taps;
+}
+
+//----------------------------------------------------------------------------------------
+// Median filter
+//----------------------------------------------------------------------------------------
+
+/**
+ * Constructor function, keeps the last @a length samples of each channel
+ */
+DSP::MedianFilter::MedianFilter(const int channels, const int length)
+  : Filter(channels)
+  , m_length(length)
+  , m_position(0)
+  , m_window(length, 0)
+  , m_history(length * channels, 0)
+{
+}
+
+/**
+ * Fills the history of each channel with its given value
+ */
+void DSP::MedianFilter::prime(const double *values)
+{
+  for (int i = 0; i < m_length; ++i)
+    std::copy_n(values, m_channels, m_history.data() + i * m_channels);
+}
+
+/**
+ * Replaces the sample of each channel with the median of its last samples
+ */
+bool DSP::MedianFilter::process(double *values)
+{
+  const auto history = m_history.data();
+  std::copy_n(values, m_channels, history + m_position * m_channels);
+  m_position = (m_position + 1) % m_length;
+
+  const auto window = m_window.data();
+  const auto middle = window + m_length / 2;
+  for (int c = 0; c < m_channels; ++c)
+  {
+    for (int i = 0; i < m_length; ++i)
+      window[i] = history[i * m_channels + c];
+
+    std::nth_element(window, middle, window + m_length);
+    values[c] = *middle;
+  }
+
+  return true;
+}
+
+//----------------------------------------------------------------------------------------
+// CIC decimator
+//----------------------------------------------------------------------------------------
+
+/**
+ * Constructor function
+ *
+ * @param channels number of channels
+ * @param ratio    decimation ratio (R)
+ * @param stages   number of integrator-comb stages (N)
+ */
+DSP::CICDecimator::CICDecimator(const int channels, const int ratio,
+                                const int stages)
+  : Filter(channels)
+  , m_ratio(ratio)
+  , m_phase(0)
+  , m_stages(stages)
+  , m_position(0)
+  , m_sums(stages * channels, 0)
+  , m_history(stages * ratio * channels, 0)
+{
+}
+
+/**
+ * Fills the moving sums of each channel with its given value & makes sure
+ * that the next sample is output.
+ */
+void DSP::CICDecimator::prime(const double *values)
+{
+  for (int s = 0; s < m_stages; ++s)
+  {
+    for (int c = 0; c < m_channels; ++c)
+      m_sums[s * m_channels + c] = values[c] * m_ratio;
+
+    for (int i = 0; i < m_ratio; ++i)
+    {
+      const auto row = m_history.data() + (s * m_ratio + i) * m_channels;
+      std::copy_n(values, m_channels, row);
+    }
+  }
+
+  m_phase = m_ratio - 1;
+}
+
+/**
+ * Feeds one sample of each channel through the moving sums, and returns
+ * @c true once every R samples.
+ */
+bool DSP::CICDecimator::process(double *values)
+{
+  const double gain = 1.0 / m_ratio;
+  for (int s = 0; s < m_stages; ++s)
+  {
+    auto sum = m_sums.data() + s * m_channels;
+    auto row = m_history.data() + (s * m_ratio + m_position) * m_channels;
+    for (int c = 0; c < m_channels; ++c)
+    {
+      sum[c] += values[c] - row[c];
+      row[c] = values[c];
+      values[c] = sum[c] * gain;
+    }
+  }
+
+  // Recalculate the moving sums to discard rounding errors
+  m_position = (m_position + 1) % m_ratio;
+  if (m_position == 0)
+  {
+    for (int s = 0; s < m_stages; ++s)
+    {
+      auto sum = m_sums.data() + s * m_channels;
+      std::fill_n(sum, m_channels, 0.0);
+      for (int i = 0; i < m_ratio; ++i)
+      {
+        const auto row = m_history.data() + (s * m_ratio + i) * m_channels;
+        for (int c = 0; c < m_channels; ++c)
+          sum[c] += row[c];
+      }
+    }
+  }
+
+  // Output one out of every R samples
+  m_phase = (m_phase + 1) % m_ratio;
+  return m_phase == 0;
+}
+
+//----------------------------------------------------------------------------------------
+// Filter chain
+//----------------------------------------------------------------------------------------
+
+/**
+ * Constructor function, creates an empty (invalid) chain
+ */
+DSP::FilterChain::FilterChain()
+  : m_primed(false)
+  , m_channels(0)
+{
+}
+
+/**
+ * Returns @c true if the chain was compiled successfully
+ */
+bool DSP::FilterChain::isValid() const
+{
+  return !m_filters.isEmpty();
+}
+
+/**
+ * Returns the number of channels processed by the chain
+ */
+int DSP::FilterChain::channels() const
+{
+  return m_channels;
+}
+
+/**
+ * Returns a description of the last compilation error (if any)
+ */
+QString DSP::FilterChain::error() const
+{
+  return m_error;
+}
+
+/**
+ * Primes the filters again with the next processed sample
+ */
+void DSP::FilterChain::reset()
+{
+  m_primed = false;
+}
+
+/**
+ * Filters one sample of each channel in place. The filters are primed with the
+ * first sample, so that the output does not start from zero.
+ */
+void DSP::FilterChain::process(double *values)
+{
+  // Prime each filter with its input & run it once
+  if (!m_primed)
+  {
+    for (int i = 0; i < m_filters.count(); ++i)
+    {
+      m_filters[i]->prime(values);
+      m_filters[i]->process(values);
+    }
+
+    std::copy_n(values, m_channels, m_output.data());
+    m_primed = true;
+    return;
+  }
+
+  // Run the filters, hold the last output if a decimator skips the sample
+  for (int i = 0; i < m_filters.count(); ++i)
+  {
+    if (!m_filters[i]->process(values))
+    {
+      std::copy_n(m_output.constData(), m_channels, values);
+      return;
+    }
+  }
+
+  std::copy_n(values, m_channels, m_output.data());
+}
+
+/**
+ * Builds the filters described by @a spec for the given number of
+ * @a channels.
+ *
+ * @return @c true on success, @c false if the specification is invalid, in
+ *         which case @c error() describes the problem.
+ */
+bool DSP::FilterChain::compile(const QString &spec, const int channels)
+{
+  // Reset state
+  m_primed = false;
+  m_error.clear();
+  m_filters.clear();
+  m_channels = qMax(1, channels);
+  m_output.fill(0, m_channels);
+
+  // Build each filter
+  static const QRegularExpression regex(
+      QStringLiteral("^([a-z]+)\\s*\\(([^()]*)\\)$"),
+      QRegularExpression::CaseInsensitiveOption);
+  const auto stages = spec.split('|');
+  for (int i = 0; i < stages.count(); ++i)
+  {
+    // Split filter name & arguments
+    const auto stage = stages.at(i).trimmed();
+    const auto match = regex.match(stage);
+    if (!match.hasMatch())
+    {
+      m_error = QStringLiteral("Invalid filter \"%1\"").arg(stage);
+      break;
+    }
+
+    const auto name = match.captured(1).toLower();
+    QVector<double> args;
+    const auto list = match.captured(2).split(',');
+    for (int j = 0; j < list.count() && !list.at(j).trimmed().isEmpty(); ++j)
+    {
+      bool ok;
+      args.append(list.at(j).trimmed().toDouble(&ok));
+      if (!ok)
+      {
+        m_error = QStringLiteral("Invalid argument \"%1\" in \"%2\"")
+                      .arg(list.at(j).trimmed(), stage);
+        break;
+      }
+    }
+
+    if (!m_error.isEmpty())
+      break;
+
+    // Validate arguments & create the filter
+    const auto count = args.count();
+    const auto arg = [&](const int index, const double fallback) {
+      return index < count ? args.at(index) : fallback;
+    };
+
+    QSharedPointer<Filter> filter;
+    if (name == "lowpass" || name == "highpass" || name == "bandpass"
+        || name == "notch")
+    {
+      const auto fc = arg(0, 0);
+      const auto fs = arg(1, 0);
+      const auto q = arg(2, M_SQRT1_2);
+      if (count < 2 || count > 3 || fs <= 0 || fc <= 0 || fc >= fs / 2
+          || q <= 0)
+      {
+        m_error = QStringLiteral("%1 requires 0 < cutoff < sampleRate / 2 "
+                                 "and q > 0")
+                      .arg(name);
+        break;
+      }
+
+      auto type = Biquad::LowPass;
+      if (name == "highpass")
+        type = Biquad::HighPass;
+      else if (name == "bandpass")
+        type = Biquad::BandPass;
+      else if (name == "notch")
+        type = Biquad::Notch;
+
+      filter.reset(new Biquad(m_channels, type, fc, fs, q));
+    }
+
+    else if (name == "average" || name == "median")
+    {
+      const int length = qRound(arg(0, 0));
+      if (count != 1 || length < 1 || length > 255)
+      {
+        m_error = QStringLiteral("%1 requires a length between 1 and 255")
+                      .arg(name);
+        break;
+      }
+
+      if (name == "average")
+        filter.reset(new FIRFilter(m_channels, FIRFilter::average(length)));
+      else
+        filter.reset(new MedianFilter(m_channels, length));
+    }
+
+    else if (name == "fir")
+    {
+      const int length = qRound(arg(0, 0));
+      const auto fc = arg(1, 0);
+      const auto fs = arg(2, 0);
+      if (count != 3 || length < 1 || length > 255 || fs <= 0 || fc <= 0
+          || fc >= fs / 2)
+      {
+        m_error = QStringLiteral("fir requires a length between 1 and 255 "
+                                 "and 0 < cutoff < sampleRate / 2");
+        break;
+      }
+
+      const auto taps = FIRFilter::lowPass(length, fc, fs);
+      filter.reset(new FIRFilter(m_channels, taps));
+    }
+
+    else if (name == "cic")
+    {
+      const int ratio = qRound(arg(0, 0));
+      const int order = qRound(arg(1, 1));
+      if (count < 1 || count > 2 || ratio < 2 || ratio > 1024 || order < 1
+          || order > 5)
+      {
+        m_error = QStringLiteral("cic requires a ratio between 2 and 1024 "
+                                 "and between 1 and 5 stages");
+        break;
+      }
+
+      filter.reset(new CICDecimator(m_channels, ratio, order));
+    }
+
+    else
+    {
+      m_error = QStringLiteral("Unknown filter \"%1\"").arg(name);
+      break;
+    }
+
+    m_filters.append(filter);
+  }
+
+  // Discard partial chains
+  if (!m_error.isEmpty())
+  {
+    m_filters.clear();
+    return false;
+  }
+
+  return true;
+}
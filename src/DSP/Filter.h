@@ -0,0 +1,216 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <QString>
+#include <QVector>
+#include <QSharedPointer>
+
+namespace DSP
+{
+/**
+ * @brief The Filter class
+ *
+ * Base class of the filters that can be applied to datasets. A filter
+ * processes one sample of several channels at a time. The channels share the
+ * filter coefficients but each channel has its own state, which is stored
+ * channel-minor (i.e. the state of every channel for a given tap is
+ * contiguous), so that the kernels are loops over the channels that the
+ * compiler can vectorize.
+ */
+class Filter
+{
+public:
+  Filter(const int channels);
+  virtual ~Filter();
+
+  int channels() const;
+
+  /**
+   * Initializes the state of the filter as if the given @a values had been
+   * received forever, avoiding the start-up transient. The next call to
+   * @c process() must return @c true.
+   */
+  virtual void prime(const double *values) = 0;
+
+  /**
+   * Filters one sample of each channel in place. Returns @c false if the
+   * filter did not produce an output for this sample (e.g. decimators).
+   */
+  virtual bool process(double *values) = 0;
+
+protected:
+  int m_channels;
+};
+
+/**
+ * @brief The Biquad class
+ *
+ * Second order IIR filter (low-pass, high-pass, band-pass or notch) with the
+ * coefficients of the "Audio EQ Cookbook" by R. Bristow-Johnson, implemented
+ * in transposed direct form II.
+ */
+class Biquad : public Filter
+{
+public:
+  enum Type
+  {
+    LowPass,
+    HighPass,
+    BandPass,
+    Notch
+  };
+
+  Biquad(const int channels, const Type type, const double cutoff,
+         const double sampleRate, const double q);
+
+  void prime(const double *values) override;
+  bool process(double *values) override;
+
+private:
+  double m_b0, m_b1, m_b2;
+  double m_a1, m_a2;
+  QVector<double> m_z1;
+  QVector<double> m_z2;
+};
+
+/**
+ * @brief The FIRFilter class
+ *
+ * Finite impulse response filter with arbitrary taps, used for moving averages
+ * and windowed-sinc low-pass filters.
+ */
+class FIRFilter : public Filter
+{
+public:
+  FIRFilter(const int channels, const QVector<double> &taps);
+
+  void prime(const double *values) override;
+  bool process(double *values) override;
+
+  static QVector<double> average(const int length);
+  static QVector<double> lowPass(const int length, const double cutoff,
+                                 const double sampleRate);
+
+private:
+  int m_position;
+  QVector<double> m_taps;
+  QVector<double> m_history;
+  QVector<double> m_sum;
+};
+
+/**
+ * @brief The MedianFilter class
+ *
+ * Replaces each sample with the median of the last N samples of the channel,
+ * which removes spikes without smearing steps like a low-pass filter does.
+ */
+class MedianFilter : public Filter
+{
+public:
+  MedianFilter(const int channels, const int length);
+
+  void prime(const double *values) override;
+  bool process(double *values) override;
+
+private:
+  int m_length;
+  int m_position;
+  QVector<double> m_window;
+  QVector<double> m_history;
+};
+
+/**
+ * @brief The CICDecimator class
+ *
+ * Cascaded integrator-comb decimator. Each stage is implemented as a moving
+ * sum of the last R samples (which has the same response as an integrator &
+ * a comb with a differential delay of one), normalized to unity gain. Only
+ * one out of every R samples is output.
+ *
+ * Floating point moving sums slowly accumulate rounding errors, so they are
+ * recalculated from the stored samples every R samples.
+ */
+class CICDecimator : public Filter
+{
+public:
+  CICDecimator(const int channels, const int ratio, const int stages);
+
+  void prime(const double *values) override;
+  bool process(double *values) override;
+
+private:
+  int m_ratio;
+  int m_phase;
+  int m_stages;
+  int m_position;
+  QVector<double> m_sums;
+  QVector<double> m_history;
+};
+
+/**
+ * @brief The FilterChain class
+ *
+ * Compiles a filter specification into a list of filters that are applied one
+ * after the other to a group of channels. The specification is a list of
+ * filters separated by @c | characters, for example:
+ *
+ * @code
+ * median(5) | lowpass(2, 100) | cic(4, 2)
+ * @endcode
+ *
+ * Available filters (frequencies in Hz):
+ *
+ * - lowpass(cutoff, sampleRate[, q]):  biquad low-pass filter
+ * - highpass(cutoff, sampleRate[, q]): biquad high-pass filter
+ * - bandpass(center, sampleRate[, q]): biquad band-pass filter
+ * - notch(center, sampleRate[, q]):    biquad notch filter
+ * - average(length):                   moving average (FIR)
+ * - fir(length, cutoff, sampleRate):   windowed-sinc low-pass filter (FIR)
+ * - median(length):                    median filter
+ * - cic(ratio[, stages]):              CIC decimator
+ *
+ * When a decimator does not produce an output, the chain holds its previous
+ * output.
+ */
+class FilterChain
+{
+public:
+  FilterChain();
+
+  bool isValid() const;
+  int channels() const;
+  QString error() const;
+
+  void reset();
+  void process(double *values);
+  bool compile(const QString &spec, const int channels);
+
+private:
+  bool m_primed;
+  int m_channels;
+  QString m_error;
+  QVector<double> m_output;
+  QVector<QSharedPointer<Filter>> m_filters;
+};
+} // namespace DSP
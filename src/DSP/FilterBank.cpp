@@ -0,0 +1,175 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <cmath>
+
+#include <DSP/FilterBank.h>
+
+/**
+ * Constructor function, creates an empty filter bank
+ */
+DSP::FilterBank::FilterBank() {}
+
+/**
+ * Returns @c true if no dataset has a (valid) filter
+ */
+bool DSP::FilterBank::isEmpty() const
+{
+  return m_banks.isEmpty();
+}
+
+/**
+ * Returns the errors found while compiling the filter specifications
+ */
+QStringList DSP::FilterBank::errors() const
+{
+  return m_errors;
+}
+
+/**
+ * Clears the state of every filter, which is primed again with the next frame
+ */
+void DSP::FilterBank::reset()
+{
+  for (int i = 0; i < m_banks.count(); ++i)
+    m_banks[i].chain.reset();
+
+  m_last.fill(0);
+}
+
+/**
+ * Filters the values of the datasets of the given @a frame in place. Frames
+ * whose structure does not match the configured specifications are not
+ * modified.
+ */
+void DSP::FilterBank::process(JSON::Frame &frame)
+{
+  // Nothing to do
+  if (m_banks.isEmpty())
+    return;
+
+  // Validate frame structure
+  auto &groups = frame.groups();
+  if (groups.count() != m_specs.count())
+    return;
+
+  for (int i = 0; i < groups.count(); ++i)
+  {
+    if (groups[i].datasets().count() != m_specs.at(i).count())
+      return;
+  }
+
+  // Filter the datasets of each bank at once
+  for (int i = 0; i < m_banks.count(); ++i)
+  {
+    auto &bank = m_banks[i];
+    const auto count = bank.channels.count();
+
+    // Gather values (use the last numeric value for non-numeric datasets)
+    for (int j = 0; j < count; ++j)
+    {
+      const auto &c = bank.channels.at(j);
+      const auto &dataset = groups[c.group].datasets().at(c.dataset);
+      if (dataset.isNumeric() && std::isfinite(dataset.numericValue()))
+        m_last[c.index] = dataset.numericValue();
+
+      m_values[j] = m_last.at(c.index);
+    }
+
+    // Run the filters
+    bank.chain.process(m_values.data());
+
+    // Scatter values
+    for (int j = 0; j < count; ++j)
+    {
+      const auto &c = bank.channels.at(j);
+      auto &dataset = groups[c.group].datasets()[c.dataset];
+      if (dataset.isNumeric())
+        dataset.setNumericValue(m_values.at(j));
+    }
+  }
+}
+
+/**
+ * Builds the filter chains for the given @a specs, which contain the filter
+ * specification of each dataset of each group (empty strings for unfiltered
+ * datasets).
+ *
+ * @return @c true if the specifications changed & the filters were rebuilt
+ */
+bool DSP::FilterBank::configure(const QVector<QStringList> &specs)
+{
+  // Nothing changed, keep the state of the filters
+  if (specs == m_specs)
+    return false;
+
+  // Reset state
+  m_specs = specs;
+  m_banks.clear();
+  m_errors.clear();
+
+  // Group datasets with the same filter specification
+  int index = 0;
+  QStringList sources;
+  QVector<QVector<Channel>> channels;
+  for (int i = 0; i < specs.count(); ++i)
+  {
+    for (int j = 0; j < specs.at(i).count(); ++j, ++index)
+    {
+      const auto spec = specs.at(i).at(j).trimmed();
+      if (spec.isEmpty())
+        continue;
+
+      auto k = sources.indexOf(spec);
+      if (k < 0)
+      {
+        k = sources.count();
+        sources.append(spec);
+        channels.append(QVector<Channel>());
+      }
+
+      channels[k].append({i, j, index});
+    }
+  }
+
+  // Compile a filter chain for each group of datasets
+  int maxChannels = 0;
+  for (int i = 0; i < sources.count(); ++i)
+  {
+    Bank bank;
+    bank.channels = channels.at(i);
+    if (!bank.chain.compile(sources.at(i), bank.channels.count()))
+    {
+      m_errors.append(QStringLiteral("%1: %2").arg(sources.at(i),
+                                                   bank.chain.error()));
+      continue;
+    }
+
+    maxChannels = qMax(maxChannels, bank.channels.count());
+    m_banks.append(bank);
+  }
+
+  // Allocate buffers once
+  m_last.fill(0, index);
+  m_values.fill(0, maxChannels);
+  return true;
+}
@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <QVector>
+#include <QStringList>
+
+#include <DSP/Filter.h>
+#include <JSON/Frame.h>
+
+namespace DSP
+{
+/**
+ * @brief The FilterBank class
+ *
+ * Applies the filter chains of the datasets (given by their "filter" key) to
+ * the frames generated by the JSON generator, before they reach the dashboard
+ * or any other frame listener. Raw frames (e.g. the ones written to CSV files)
+ * are not affected.
+ *
+ * Datasets with the same filter specification share a single
+ * @c FilterChain, which processes all of them at once, so that each filter
+ * kernel is a loop over the channels that the compiler can vectorize.
+ *
+ * Non-numeric values are not modified. Instead, the last numeric value of the
+ * dataset is fed to its filter, so that the filter state remains valid.
+ */
+class FilterBank
+{
+public:
+  FilterBank();
+
+  bool isEmpty() const;
+  QStringList errors() const;
+
+  void reset();
+  void process(JSON::Frame &frame);
+  bool configure(const QVector<QStringList> &specs);
+
+private:
+  struct Channel
+  {
+    int group;
+    int dataset;
+    int index;
+  };
+
+  struct Bank
+  {
+    FilterChain chain;
+    QVector<Channel> channels;
+  };
+
+  QStringList m_errors;
+  QVector<Bank> m_banks;
+  QVector<double> m_last;
+  QVector<double> m_values;
+  QVector<QStringList> m_specs;
+};
+} // namespace DSP
@@ -0,0 +1,614 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <QtMath>
+
+#include <UI/Dashboard.h>
+#include <DSP/SpectrumAnalyzer.h>
+#include <Misc/TimerEvents.h>
+
+//----------------------------------------------------------------------------------------
+// Spectrum worker
+//----------------------------------------------------------------------------------------
+
+/**
+ * Constructor function
+ */
+DSP::SpectrumWorker::SpectrumWorker() {}
+
+/**
+ * Calculates the spectrum of the newest samples of the given buffer & emits
+ * the magnitude (in dB) of each frequency bin through the @c finished()
+ * signal.
+ *
+ * The segment size is the largest power of two that allows @a averages
+ * segments (overlapped by @a overlap percent) to fit in the buffer. If the
+ * buffer is too short, an empty spectrum is reported.
+ */
+void DSP::SpectrumWorker::process(const int index, const PlotData &samples,
+                                  const int window, const int averages,
+                                  const int overlap)
+{
+  // Find the largest segment size that fits in the buffer
+  int hop = 0;
+  int size = kMaxSize;
+  const int count = qMax(1, averages);
+  const int available = samples.count();
+  while (size >= kMinSize)
+  {
+    hop = qMax(1, size * (100 - overlap) / 100);
+    if (size + (count - 1) * hop <= available)
+      break;
+
+    size /= 2;
+  }
+
+  // Buffer too short
+  if (size < kMinSize)
+  {
+    Q_EMIT finished(index, PlotData(), 0);
+    return;
+  }
+
+  // Prepare buffers & FFT plan
+  const int bins = size / 2 + 1;
+  m_input.resize(size);
+  m_output.resize(size);
+  m_power.fill(0, bins);
+  m_transformer.setSize(size);
+
+  // Add the power spectrum of each segment
+  const auto &w = coefficients(window, size);
+  const auto data = samples.constData();
+  for (int s = 0; s < count; ++s)
+    accumulate(data + available - size - (count - 1 - s) * hop, w);
+
+  // Convert the averaged power to a single-sided amplitude in dB
+  PlotData magnitudes(bins);
+  decibels(w, count, magnitudes.data());
+  Q_EMIT finished(index, magnitudes, size);
+}
+
+/**
+ * Calculates @a rows consecutive spectra of the given buffer, each one of
+ * @a size samples & separated by @a hop samples, and emits them through the
+ * @c rowsFinished() signal. The first row ends at the @a end offset of the
+ * buffer, rows that do not fit in the buffer are skipped.
+ */
+void DSP::SpectrumWorker::processRows(const int index, const PlotData &samples,
+                                      const int window, const int size,
+                                      const int hop, const int rows,
+                                      const int end)
+{
+  // Validate arguments
+  if (size < kMinSize || size > kMaxSize || rows <= 0 || hop <= 0)
+  {
+    Q_EMIT rowsFinished(index, PlotData(), 0);
+    return;
+  }
+
+  // Prepare buffers & FFT plan
+  const int bins = size / 2 + 1;
+  m_input.resize(size);
+  m_output.resize(size);
+  m_transformer.setSize(size);
+
+  // Calculate the spectrum of each row
+  int count = 0;
+  PlotData magnitudes(rows * bins);
+  const auto &w = coefficients(window, size);
+  const auto data = samples.constData();
+  for (int r = 0; r < rows; ++r)
+  {
+    const auto last = end + r * hop;
+    if (last < size || last > samples.count())
+      continue;
+
+    m_power.fill(0, bins);
+    accumulate(data + last - size, w);
+    decibels(w, 1, magnitudes.data() + count * bins);
+    ++count;
+  }
+
+  magnitudes.resize(count * bins);
+  Q_EMIT rowsFinished(index, magnitudes, count > 0 ? size : 0);
+}
+
+/**
+ * Multiplies the given @a segment by the @a window coefficients, transforms
+ * it & adds the power of each frequency bin to the power buffer.
+ */
+void DSP::SpectrumWorker::accumulate(const double *segment,
+                                     const QVector<float> &window)
+{
+  const auto size = window.count();
+  for (int i = 0; i < size; ++i)
+    m_input[i] = static_cast<float>(segment[i]) * window.at(i);
+
+  m_transformer.forwardTransform(m_input.data(), m_output.data());
+
+  // Real parts are stored in [0, size/2], imaginary parts in (size/2, size)
+  const auto half = size / 2;
+  m_power[0] += m_output[0] * m_output[0];
+  m_power[half] += m_output[half] * m_output[half];
+  for (int k = 1; k < half; ++k)
+  {
+    const double re = m_output[k];
+    const double im = m_output[half + k];
+    m_power[k] += re * re + im * im;
+  }
+}
+
+/**
+ * Converts the power buffer (accumulated over the given number of
+ * @a segments) to a single-sided amplitude in dB & writes it to @a output.
+ */
+void DSP::SpectrumWorker::decibels(const QVector<float> &window,
+                                   const int segments, double *output)
+{
+  // Get the sum of the window coefficients to scale the amplitudes
+  double gain = 0;
+  for (int i = 0; i < window.count(); ++i)
+    gain += window.at(i);
+
+  // Average the power of each bin
+  const int bins = window.count() / 2 + 1;
+  for (int k = 0; k < bins; ++k)
+  {
+    const double scale = (k == 0 || k == bins - 1) ? 1 / gain : 2 / gain;
+    const double power = m_power[k] / segments * scale * scale;
+    output[k] = 10 * std::log10(qMax(power, 1e-20));
+  }
+}
+
+/**
+ * Returns the coefficients of the given @a window function for segments of
+ * the given @a size, calculating them the first time that they are needed.
+ */
+const QVector<float> &DSP::SpectrumWorker::coefficients(const int window,
+                                                        const int size)
+{
+  auto &coefficients = m_windows[window * (kMaxSize + 1) + size];
+  if (coefficients.count() != size)
+  {
+    coefficients.fill(1, size);
+
+    const auto names = QWindowFunctionManager<float>::functions();
+    if (window > 0 && window < names.count())
+    {
+      auto function = QWindowFunctionManager<float>::createFunction(
+          names.at(window));
+      if (function)
+      {
+        function->create(size);
+        function->apply(coefficients.data(), size);
+        delete function;
+      }
+    }
+  }
+
+  return coefficients;
+}
+
+//----------------------------------------------------------------------------------------
+// Spectrum analyzer
+//----------------------------------------------------------------------------------------
+
+/**
+ * Constructor function, creates the worker. The worker thread is started
+ * when the first spectrum is requested.
+ */
+DSP::SpectrumAnalyzer::SpectrumAnalyzer()
+  : m_overlap(50)
+  , m_averages(1)
+  , m_window(2)
+  , m_sampleRate(0)
+  , m_frames(0)
+  , m_samples(0)
+  , m_measuredRate(0)
+  , m_worker(new SpectrumWorker)
+{
+  // Move the worker to its thread
+  qRegisterMetaType<PlotData>();
+  m_worker->moveToThread(&m_thread);
+  m_thread.setObjectName(QStringLiteral("Spectrum"));
+  m_clock.start();
+
+  // clang-format off
+    connect(&m_thread, &QThread::finished,
+            m_worker, &QObject::deleteLater);
+    connect(m_worker, &DSP::SpectrumWorker::finished,
+            this, &DSP::SpectrumAnalyzer::onFinished);
+    connect(m_worker, &DSP::SpectrumWorker::rowsFinished,
+            this, &DSP::SpectrumAnalyzer::onRowsFinished);
+    connect(&UI::Dashboard::instance(), &UI::Dashboard::updated,
+            this, &DSP::SpectrumAnalyzer::countFrame);
+    connect(&Misc::TimerEvents::instance(), &Misc::TimerEvents::timeout1Hz,
+            this, &DSP::SpectrumAnalyzer::measureSampleRate);
+    connect(&Misc::TimerEvents::instance(), &Misc::TimerEvents::timeout20Hz,
+            this, &DSP::SpectrumAnalyzer::dispatch);
+  // clang-format on
+}
+
+/**
+ * Destructor function, stops the worker thread (if it was started)
+ */
+DSP::SpectrumAnalyzer::~SpectrumAnalyzer()
+{
+  if (m_thread.isRunning())
+  {
+    m_thread.quit();
+    m_thread.wait();
+  }
+
+  else
+    delete m_worker;
+}
+
+/**
+ * Returns the only instance of the class
+ */
+DSP::SpectrumAnalyzer &DSP::SpectrumAnalyzer::instance()
+{
+  static SpectrumAnalyzer singleton;
+  return singleton;
+}
+
+/**
+ * Returns the overlap between consecutive averaged segments (in percent)
+ */
+int DSP::SpectrumAnalyzer::overlap() const
+{
+  return m_overlap;
+}
+
+/**
+ * Returns the number of segments whose spectra are averaged
+ */
+int DSP::SpectrumAnalyzer::averages() const
+{
+  return m_averages;
+}
+
+/**
+ * Returns the index of the selected window function
+ */
+int DSP::SpectrumAnalyzer::windowFunction() const
+{
+  return m_window;
+}
+
+/**
+ * Returns the names of the available window functions
+ */
+StringList DSP::SpectrumAnalyzer::windowFunctions() const
+{
+  StringList list;
+  const auto names = QWindowFunctionManager<float>::functions();
+  for (int i = 0; i < names.count(); ++i)
+    list.append(names.at(i));
+
+  return list;
+}
+
+/**
+ * Returns the sample rate set by the user (in Hz), or 0 if the sample rate is
+ * measured automatically.
+ */
+double DSP::SpectrumAnalyzer::sampleRate() const
+{
+  return m_sampleRate;
+}
+
+/**
+ * Returns the number of frames received per second
+ */
+double DSP::SpectrumAnalyzer::measuredSampleRate() const
+{
+  return m_measuredRate;
+}
+
+/**
+ * Returns the sample rate used to calculate the frequency of each bin
+ */
+double DSP::SpectrumAnalyzer::effectiveSampleRate() const
+{
+  if (m_sampleRate > 0)
+    return m_sampleRate;
+
+  return m_measuredRate;
+}
+
+/**
+ * Returns the latest spectrum rows calculated for the waterfall dataset with
+ * the given @a index
+ */
+const DSP::Spectrum &DSP::SpectrumAnalyzer::rows(const int index) const
+{
+  return m_rows.at(index);
+}
+
+/**
+ * Returns the latest spectrum calculated for the FFT dataset with the given
+ * @a index
+ */
+const DSP::Spectrum &DSP::SpectrumAnalyzer::spectrum(const int index) const
+{
+  return m_spectra.at(index);
+}
+
+/**
+ * Asks the analyzer to calculate the spectrum of the FFT dataset with the
+ * given @a index during the next display refresh.
+ */
+void DSP::SpectrumAnalyzer::request(const int index)
+{
+  if (index < 0)
+    return;
+
+  if (m_requested.count() <= index)
+  {
+    m_pending.resize(index + 1);
+    m_requested.resize(index + 1);
+    m_spectra.resize(index + 1);
+  }
+
+  m_requested[index] = true;
+  startThread();
+}
+
+/**
+ * Asks the analyzer to calculate the new spectrum rows of the waterfall
+ * dataset with the given @a index during the next display refresh.
+ */
+void DSP::SpectrumAnalyzer::requestRows(const int index)
+{
+  if (index < 0)
+    return;
+
+  if (m_rowsRequested.count() <= index)
+  {
+    const auto count = m_nextRow.count();
+    m_nextRow.resize(index + 1);
+    m_rowsPending.resize(index + 1);
+    m_rowsRequested.resize(index + 1);
+    m_rows.resize(index + 1);
+
+    for (auto i = count; i < m_nextRow.count(); ++i)
+      m_nextRow[i] = -1;
+  }
+
+  m_rowsRequested[index] = true;
+  startThread();
+}
+
+/**
+ * Changes the overlap between consecutive averaged segments (in percent)
+ */
+void DSP::SpectrumAnalyzer::setOverlap(const int overlap)
+{
+  const auto value = qBound(0, overlap, 90);
+  if (m_overlap != value)
+  {
+    m_overlap = value;
+    Q_EMIT overlapChanged();
+  }
+}
+
+/**
+ * Changes the number of segments whose spectra are averaged
+ */
+void DSP::SpectrumAnalyzer::setAverages(const int averages)
+{
+  const auto value = qBound(1, averages, 64);
+  if (m_averages != value)
+  {
+    m_averages = value;
+    Q_EMIT averagesChanged();
+  }
+}
+
+/**
+ * Changes the window function applied to each segment
+ */
+void DSP::SpectrumAnalyzer::setWindowFunction(const int window)
+{
+  const auto value = qBound(0, window, windowFunctions().count() - 1);
+  if (m_window != value)
+  {
+    m_window = value;
+    Q_EMIT windowFunctionChanged();
+  }
+}
+
+/**
+ * Changes the sample rate (in Hz) used to calculate the frequency axis, set
+ * it to 0 to use the measured frame rate instead.
+ */
+void DSP::SpectrumAnalyzer::setSampleRate(const double sampleRate)
+{
+  const auto value = qMax(0.0, sampleRate);
+  if (!qFuzzyCompare(m_sampleRate + 1, value + 1))
+  {
+    m_sampleRate = value;
+    Q_EMIT sampleRateChanged();
+  }
+}
+
+/**
+ * Sends the buffers of the requested FFT datasets to the worker thread.
+ * Datasets whose previous spectrum is still being calculated are skipped, so
+ * that jobs never pile up in the worker thread.
+ */
+void DSP::SpectrumAnalyzer::dispatch()
+{
+  const auto &buffers = UI::Dashboard::instance().fftPlotValues();
+  for (int i = 0; i < m_requested.count(); ++i)
+  {
+    if (!m_requested.at(i) || m_pending.at(i) || i >= buffers.count())
+      continue;
+
+    m_pending[i] = true;
+    m_requested[i] = false;
+
+    const auto worker = m_worker;
+    const auto window = m_window;
+    const auto overlap = m_overlap;
+    const auto averages = m_averages;
+    const auto samples = buffers.at(i);
+    QMetaObject::invokeMethod(
+        worker,
+        [=] { worker->process(i, samples, window, averages, overlap); },
+        Qt::QueuedConnection);
+  }
+
+  dispatchRows();
+}
+
+/**
+ * Starts the worker thread the first time that a spectrum is requested, so
+ * that projects without FFT or waterfall widgets never create it.
+ */
+void DSP::SpectrumAnalyzer::startThread()
+{
+  if (!m_thread.isRunning())
+    m_thread.start(QThread::LowPriority);
+}
+
+/**
+ * Counts the frames received by the dashboard to measure the sample rate
+ */
+void DSP::SpectrumAnalyzer::countFrame()
+{
+  ++m_frames;
+  ++m_samples;
+}
+
+/**
+ * Updates the measured sample rate with the number of frames received since
+ * the last measurement.
+ */
+void DSP::SpectrumAnalyzer::measureSampleRate()
+{
+  const auto elapsed = m_clock.restart();
+  const auto rate = elapsed > 0 ? m_frames * 1000.0 / elapsed : 0;
+  m_frames = 0;
+
+  if (!qFuzzyCompare(m_measuredRate + 1, rate + 1))
+  {
+    m_measuredRate = rate;
+    Q_EMIT measuredSampleRateChanged();
+  }
+}
+
+/**
+ * Stores the spectrum calculated by the worker thread & notifies the widgets
+ */
+void DSP::SpectrumAnalyzer::onFinished(const int index,
+                                       const PlotData &magnitudes,
+                                       const int size)
+{
+  if (index < 0 || index >= m_spectra.count())
+    return;
+
+  m_pending[index] = false;
+  m_spectra[index].size = size;
+  m_spectra[index].magnitudes = magnitudes;
+  Q_EMIT spectrumChanged(index);
+}
+
+/**
+ * Stores the spectrum rows calculated by the worker thread & notifies the
+ * waterfall widgets
+ */
+void DSP::SpectrumAnalyzer::onRowsFinished(const int index,
+                                           const PlotData &magnitudes,
+                                           const int size)
+{
+  if (index < 0 || index >= m_rows.count())
+    return;
+
+  m_rowsPending[index] = false;
+  m_rows[index].size = size;
+  m_rows[index].magnitudes = magnitudes;
+  if (size > 0)
+    Q_EMIT rowsChanged(index);
+}
+
+/**
+ * Sends the buffers of the requested waterfall datasets to the worker thread,
+ * together with the position of the rows that were added since the previous
+ * refresh.
+ *
+ * Each dashboard update adds one sample to the buffers, so the frame counter
+ * is used to know which samples of the buffer are new. Rows that are no longer
+ * in the buffer (e.g. while the widget was hidden) are skipped, and at most
+ * @c kMaxRows rows are calculated per refresh.
+ */
+void DSP::SpectrumAnalyzer::dispatchRows()
+{
+  const auto &buffers = UI::Dashboard::instance().waterfallPlotValues();
+  for (int i = 0; i < m_rowsRequested.count(); ++i)
+  {
+    if (!m_rowsRequested.at(i) || m_rowsPending.at(i) || i >= buffers.count())
+      continue;
+
+    // Use the largest segment size that fits in the buffer
+    const auto available = buffers.at(i).count();
+    int size = SpectrumWorker::kMaxSize;
+    while (size > available)
+      size /= 2;
+
+    if (size < SpectrumWorker::kMinSize)
+      continue;
+
+    // Start new waterfalls with the latest samples & skip lost rows
+    const int hop = qMax(1, size * (100 - m_overlap) / 100);
+    auto &next = m_nextRow[i];
+    if (next < 0)
+      next = m_samples;
+
+    next = qMax(next, m_samples - available + size);
+    next = qMax(next, m_samples - (kMaxRows - 1) * hop);
+
+    // Wait until the buffer advances by one hop
+    if (next > m_samples)
+      continue;
+
+    // Get the rows to calculate & the position of the first one
+    const auto lag = static_cast<int>(m_samples - next);
+    const int rows = lag / hop + 1;
+    const int end = available - lag;
+    next += static_cast<qint64>(rows) * hop;
+
+    m_rowsPending[i] = true;
+    m_rowsRequested[i] = false;
+
+    const auto worker = m_worker;
+    const auto window = m_window;
+    const auto samples = buffers.at(i);
+    QMetaObject::invokeMethod(
+        worker,
+        [=] { worker->processRows(i, samples, window, size, hop, rows, end); },
+        Qt::QueuedConnection);
+  }
+}
@@ -0,0 +1,219 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <QObject>
+#include <QThread>
+#include <QElapsedTimer>
+
+#include <DataTypes.h>
+#include <qfouriertransformer.h>
+
+namespace DSP
+{
+/**
+ * @brief The Spectrum struct
+ *
+ * Single-sided magnitude spectrum of a FFT dataset, in decibels relative to
+ * the units of the dataset. The bin @c k corresponds to the frequency
+ * @c k * sampleRate / size.
+ *
+ * Waterfall spectra contain several consecutive rows (oldest first), each one
+ * with @c size / 2 + 1 bins.
+ */
+struct Spectrum
+{
+  int size = 0;
+  PlotData magnitudes;
+};
+
+/**
+ * @brief The SpectrumWorker class
+ *
+ * Lives in the spectrum analyzer thread & calculates the spectrum of the
+ * sample buffers that it receives.
+ *
+ * The buffer is split in overlapping segments (Welch's method), each segment
+ * is multiplied by the selected window function & transformed, and the power
+ * of each frequency bin is averaged over all the segments. A single
+ * @c QFourierTransformer is used for all the datasets, so that the FFT plans
+ * of each size are only created once.
+ */
+class SpectrumWorker : public QObject
+{
+  Q_OBJECT
+
+Q_SIGNALS:
+  void finished(const int index, const PlotData &magnitudes, const int size);
+  void rowsFinished(const int index, const PlotData &magnitudes,
+                    const int size);
+
+public:
+  SpectrumWorker();
+
+  static constexpr int kMinSize = 8;
+  static constexpr int kMaxSize = 16384;
+
+public Q_SLOTS:
+  void process(const int index, const PlotData &samples, const int window,
+               const int averages, const int overlap);
+  void processRows(const int index, const PlotData &samples, const int window,
+                   const int size, const int hop, const int rows,
+                   const int end);
+
+private:
+  void accumulate(const double *segment, const QVector<float> &window);
+  void decibels(const QVector<float> &window, const int segments,
+                double *output);
+  const QVector<float> &coefficients(const int window, const int size);
+
+private:
+  QVector<float> m_input;
+  QVector<float> m_output;
+  QVector<double> m_power;
+  QFourierTransformer m_transformer;
+  QHash<int, QVector<float>> m_windows;
+};
+
+/**
+ * @brief The SpectrumAnalyzer class
+ *
+ * Calculates the spectrum of the FFT datasets in a worker thread, at most once
+ * per display refresh & only for the datasets whose widgets are visible.
+ *
+ * Waterfall datasets are processed in rows: every time that the buffer
+ * advances by one hop (the segment size minus the overlap), a new spectrum
+ * row is calculated. Only the rows added since the last refresh are sent to
+ * the widgets, which keep the previous rows in their own images.
+ *
+ * The frequency axis is calculated from the sample rate set by the user, or
+ * (if the sample rate is set to 0) from the measured frame rate, since the
+ * dashboard adds one sample to each FFT buffer per received frame.
+ */
+class SpectrumAnalyzer : public QObject
+{
+  // clang-format off
+    Q_OBJECT
+    Q_PROPERTY(int windowFunction
+               READ windowFunction
+               WRITE setWindowFunction
+               NOTIFY windowFunctionChanged)
+    Q_PROPERTY(StringList windowFunctions
+               READ windowFunctions
+               CONSTANT)
+    Q_PROPERTY(int averages
+               READ averages
+               WRITE setAverages
+               NOTIFY averagesChanged)
+    Q_PROPERTY(int overlap
+               READ overlap
+               WRITE setOverlap
+               NOTIFY overlapChanged)
+    Q_PROPERTY(double sampleRate
+               READ sampleRate
+               WRITE setSampleRate
+               NOTIFY sampleRateChanged)
+    Q_PROPERTY(double measuredSampleRate
+               READ measuredSampleRate
+               NOTIFY measuredSampleRateChanged)
+  // clang-format on
+
+Q_SIGNALS:
+  void overlapChanged();
+  void averagesChanged();
+  void sampleRateChanged();
+  void windowFunctionChanged();
+  void measuredSampleRateChanged();
+  void rowsChanged(const int index);
+  void spectrumChanged(const int index);
+
+private:
+  explicit SpectrumAnalyzer();
+  SpectrumAnalyzer(SpectrumAnalyzer &&) = delete;
+  SpectrumAnalyzer(const SpectrumAnalyzer &) = delete;
+  SpectrumAnalyzer &operator=(SpectrumAnalyzer &&) = delete;
+  SpectrumAnalyzer &operator=(const SpectrumAnalyzer &) = delete;
+
+  ~SpectrumAnalyzer();
+
+public:
+  static constexpr int kMaxRows = 64;
+
+  static SpectrumAnalyzer &instance();
+
+  int overlap() const;
+  int averages() const;
+  int windowFunction() const;
+  StringList windowFunctions() const;
+
+  double sampleRate() const;
+  double measuredSampleRate() const;
+  double effectiveSampleRate() const;
+
+  const Spectrum &rows(const int index) const;
+  const Spectrum &spectrum(const int index) const;
+
+public Q_SLOTS:
+  void request(const int index);
+  void requestRows(const int index);
+  void setOverlap(const int overlap);
+  void setAverages(const int averages);
+  void setWindowFunction(const int window);
+  void setSampleRate(const double sampleRate);
+
+private Q_SLOTS:
+  void dispatch();
+  void countFrame();
+  void measureSampleRate();
+  void onFinished(const int index, const PlotData &magnitudes, const int size);
+  void onRowsFinished(const int index, const PlotData &magnitudes,
+                      const int size);
+
+private:
+  void startThread();
+  void dispatchRows();
+
+private:
+  int m_overlap;
+  int m_averages;
+  int m_window;
+  double m_sampleRate;
+
+  int m_frames;
+  qint64 m_samples;
+  double m_measuredRate;
+  QElapsedTimer m_clock;
+
+  QThread m_thread;
+  SpectrumWorker *m_worker;
+
+  QVector<bool> m_pending;
+  QVector<bool> m_requested;
+  QVector<Spectrum> m_spectra;
+
+  QVector<qint64> m_nextRow;
+  QVector<bool> m_rowsPending;
+  QVector<bool> m_rowsRequested;
+  QVector<Spectrum> m_rows;
+};
+} // namespace DSP
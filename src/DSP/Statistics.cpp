@@ -0,0 +1,623 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <algorithm>
+
+#include <QtMath>
+#include <QJsonObject>
+
+#include <IO/Manager.h>
+#include <CSV/Player.h>
+#include <DSP/Statistics.h>
+#include <JSON/Generator.h>
+
+//----------------------------------------------------------------------------------------
+// Quantile estimator
+//----------------------------------------------------------------------------------------
+
+/**
+ * Constructor function, @a probability is the quantile to estimate (e.g. 0.5
+ * for the median).
+ */
+DSP::QuantileEstimator::QuantileEstimator(const double probability)
+  : m_count(0)
+  , m_probability(qBound(0.0, probability, 1.0))
+{
+  clear();
+}
+
+/**
+ * Returns the estimated quantile of the appended samples. While less than
+ * five samples have been appended, the quantile is calculated exactly.
+ */
+double DSP::QuantileEstimator::value() const
+{
+  if (m_count <= 0)
+    return 0;
+
+  if (m_count >= 5)
+    return m_heights[2];
+
+  double samples[5];
+  std::copy(m_heights, m_heights + m_count, samples);
+  std::sort(samples, samples + m_count);
+  return samples[qRound(m_probability * (m_count - 1))];
+}
+
+/**
+ * Returns the quantile estimated by this object
+ */
+double DSP::QuantileEstimator::probability() const
+{
+  return m_probability;
+}
+
+/**
+ * Removes all the appended samples
+ */
+void DSP::QuantileEstimator::clear()
+{
+  const auto p = m_probability;
+
+  m_count = 0;
+  for (int i = 0; i < 5; ++i)
+  {
+    m_heights[i] = 0;
+    m_positions[i] = i + 1;
+  }
+
+  m_desired[0] = 1;
+  m_desired[1] = 1 + 2 * p;
+  m_desired[2] = 1 + 4 * p;
+  m_desired[3] = 3 + 2 * p;
+  m_desired[4] = 5;
+
+  m_increments[0] = 0;
+  m_increments[1] = p / 2;
+  m_increments[2] = p;
+  m_increments[3] = (1 + p) / 2;
+  m_increments[4] = 1;
+}
+
+/**
+ * Registers a new sample & adjusts the height of the markers whose position
+ * drifted away from their desired position.
+ */
+void DSP::QuantileEstimator::append(const double value)
+{
+  // Use the first five samples as the initial marker heights
+  if (m_count < 5)
+  {
+    m_heights[m_count++] = value;
+    if (m_count == 5)
+      std::sort(m_heights, m_heights + 5);
+
+    return;
+  }
+
+  // Find the cell of the new sample & extend the extreme markers if needed
+  int k = 0;
+  ++m_count;
+  if (value < m_heights[0])
+    m_heights[0] = value;
+  else if (value >= m_heights[4])
+  {
+    k = 3;
+    m_heights[4] = value;
+  }
+  else
+  {
+    while (value >= m_heights[k + 1])
+      ++k;
+  }
+
+  // Increment the positions of the markers above the new sample
+  for (int i = k + 1; i < 5; ++i)
+    m_positions[i] += 1;
+  for (int i = 0; i < 5; ++i)
+    m_desired[i] += m_increments[i];
+
+  // Adjust the heights of the middle markers
+  for (int i = 1; i <= 3; ++i)
+  {
+    const auto d = m_desired[i] - m_positions[i];
+    if ((d >= 1 && m_positions[i + 1] - m_positions[i] > 1)
+        || (d <= -1 && m_positions[i - 1] - m_positions[i] < -1))
+    {
+      const int s = d >= 0 ? 1 : -1;
+      const auto height = parabolic(i, s);
+      if (m_heights[i - 1] < height && height < m_heights[i + 1])
+        m_heights[i] = height;
+      else
+        m_heights[i] = linear(i, s);
+
+      m_positions[i] += s;
+    }
+  }
+}
+
+/**
+ * Returns the new height of the marker @a i when it is moved by @a d
+ * positions, using a piecewise-parabolic interpolation.
+ */
+double DSP::QuantileEstimator::parabolic(const int i, const double d) const
+{
+  const auto *q = m_heights;
+  const auto *n = m_positions;
+  return q[i]
+         + d / (n[i + 1] - n[i - 1])
+               * ((n[i] - n[i - 1] + d) * (q[i + 1] - q[i]) / (n[i + 1] - n[i])
+                  + (n[i + 1] - n[i] - d) * (q[i] - q[i - 1])
+                        / (n[i] - n[i - 1]));
+}
+
+/**
+ * Returns the new height of the marker @a i when it is moved by @a d
+ * positions, using a linear interpolation with its neighbour.
+ */
+double DSP::QuantileEstimator::linear(const int i, const int d) const
+{
+  const auto *q = m_heights;
+  const auto *n = m_positions;
+  return q[i] + d * (q[i + d] - q[i]) / (n[i + d] - n[i]);
+}
+
+//----------------------------------------------------------------------------------------
+// Running statistics
+//----------------------------------------------------------------------------------------
+
+/**
+ * Constructor function
+ */
+DSP::RunningStatistics::RunningStatistics()
+  : m_count(0)
+  , m_min(0)
+  , m_max(0)
+  , m_mean(0)
+  , m_m2(0)
+  , m_p50(0.50)
+  , m_p95(0.95)
+  , m_p99(0.99)
+  , m_windowHead(0)
+  , m_windowCount(0)
+  , m_windowMean(0)
+  , m_windowM2(0)
+{
+}
+
+/**
+ * Returns the number of samples registered since the statistics were cleared
+ */
+qint64 DSP::RunningStatistics::count() const
+{
+  return m_count;
+}
+
+/**
+ * Returns the smallest registered value
+ */
+double DSP::RunningStatistics::minimum() const
+{
+  return m_min;
+}
+
+/**
+ * Returns the largest registered value
+ */
+double DSP::RunningStatistics::maximum() const
+{
+  return m_max;
+}
+
+/**
+ * Returns the mean of the registered values
+ */
+double DSP::RunningStatistics::mean() const
+{
+  return m_mean;
+}
+
+/**
+ * Returns the standard deviation of the registered values
+ */
+double DSP::RunningStatistics::stdDev() const
+{
+  return qSqrt(variance());
+}
+
+/**
+ * Returns the (sample) variance of the registered values
+ */
+double DSP::RunningStatistics::variance() const
+{
+  if (m_count < 2)
+    return 0;
+
+  return m_m2 / (m_count - 1);
+}
+
+/**
+ * Returns the estimated median of the registered values
+ */
+double DSP::RunningStatistics::median() const
+{
+  return m_p50.value();
+}
+
+/**
+ * Returns the estimated 95th percentile of the registered values
+ */
+double DSP::RunningStatistics::percentile95() const
+{
+  return m_p95.value();
+}
+
+/**
+ * Returns the estimated 99th percentile of the registered values
+ */
+double DSP::RunningStatistics::percentile99() const
+{
+  return m_p99.value();
+}
+
+/**
+ * Returns the number of samples used to calculate the window statistics, or 0
+ * if the window statistics are disabled.
+ */
+int DSP::RunningStatistics::windowSize() const
+{
+  return m_window.count();
+}
+
+/**
+ * Returns the number of samples that are currently inside the window
+ */
+int DSP::RunningStatistics::windowCount() const
+{
+  return m_windowCount;
+}
+
+/**
+ * Returns the mean of the last @c windowSize() samples
+ */
+double DSP::RunningStatistics::windowMean() const
+{
+  return m_windowMean;
+}
+
+/**
+ * Returns the standard deviation of the last @c windowSize() samples
+ */
+double DSP::RunningStatistics::windowStdDev() const
+{
+  if (m_windowCount < 2)
+    return 0;
+
+  return qSqrt(qMax(0.0, m_windowM2 / (m_windowCount - 1)));
+}
+
+/**
+ * Removes all the registered samples, the window size is not changed
+ */
+void DSP::RunningStatistics::clear()
+{
+  m_count = 0;
+  m_min = 0;
+  m_max = 0;
+  m_mean = 0;
+  m_m2 = 0;
+
+  m_p50.clear();
+  m_p95.clear();
+  m_p99.clear();
+
+  m_windowHead = 0;
+  m_windowCount = 0;
+  m_windowMean = 0;
+  m_windowM2 = 0;
+}
+
+/**
+ * Registers a new sample & updates all the statistics in constant time.
+ * Values that are not finite (NaN or infinite) are ignored.
+ */
+void DSP::RunningStatistics::append(const double value)
+{
+  if (!qIsFinite(value))
+    return;
+
+  // Update extremes
+  if (m_count == 0)
+  {
+    m_min = value;
+    m_max = value;
+  }
+  else
+  {
+    m_min = qMin(m_min, value);
+    m_max = qMax(m_max, value);
+  }
+
+  // Update mean & variance (Welford's algorithm)
+  ++m_count;
+  const auto delta = value - m_mean;
+  m_mean += delta / m_count;
+  m_m2 += delta * (value - m_mean);
+
+  // Update quantile estimates
+  m_p50.append(value);
+  m_p95.append(value);
+  m_p99.append(value);
+
+  // Window disabled
+  const auto size = m_window.count();
+  if (size <= 0)
+    return;
+
+  // Add the sample to the window while it is not full
+  if (m_windowCount < size)
+  {
+    ++m_windowCount;
+    const auto d = value - m_windowMean;
+    m_windowMean += d / m_windowCount;
+    m_windowM2 += d * (value - m_windowMean);
+  }
+
+  // Replace the oldest sample of the window with the new one
+  else
+  {
+    const auto oldest = m_window.at(m_windowHead);
+    const auto previousMean = m_windowMean;
+    const auto d = value - oldest;
+    m_windowMean += d / size;
+    m_windowM2 += d * (value - m_windowMean + oldest - previousMean);
+  }
+
+  m_window[m_windowHead] = value;
+  m_windowHead = (m_windowHead + 1) % size;
+}
+
+/**
+ * Changes the number of samples used to calculate the window statistics, set
+ * it to 0 to disable the window statistics. The window is emptied.
+ */
+void DSP::RunningStatistics::setWindowSize(const int size)
+{
+  m_window.clear();
+  m_window.resize(qMax(0, size));
+  m_window.squeeze();
+
+  m_windowHead = 0;
+  m_windowCount = 0;
+  m_windowMean = 0;
+  m_windowM2 = 0;
+}
+
+//----------------------------------------------------------------------------------------
+// Statistics module
+//----------------------------------------------------------------------------------------
+
+/**
+ * Constructor function
+ */
+DSP::Statistics::Statistics()
+  : m_enabled(true)
+  , m_windowSize(0)
+  , m_revision(0)
+{
+  // clang-format off
+    connect(&JSON::Generator::instance(), &JSON::Generator::frameChanged,
+            this, &DSP::Statistics::registerFrame);
+    connect(&JSON::Generator::instance(), &JSON::Generator::jsonFileMapChanged,
+            this, &DSP::Statistics::reset);
+    connect(&IO::Manager::instance(), &IO::Manager::connectedChanged,
+            this, &DSP::Statistics::reset);
+    connect(&CSV::Player::instance(), &CSV::Player::openChanged,
+            this, &DSP::Statistics::reset);
+  // clang-format on
+}
+
+/**
+ * Returns the only instance of the class
+ */
+DSP::Statistics &DSP::Statistics::instance()
+{
+  static Statistics singleton;
+  return singleton;
+}
+
+/**
+ * Returns @c true if the statistics are calculated as frames are received
+ */
+bool DSP::Statistics::enabled() const
+{
+  return m_enabled;
+}
+
+/**
+ * Returns the number of samples used to calculate the window statistics, or 0
+ * if the window statistics are disabled.
+ */
+int DSP::Statistics::windowSize() const
+{
+  return m_windowSize;
+}
+
+/**
+ * Returns the number of datasets whose statistics are calculated
+ */
+int DSP::Statistics::datasetCount() const
+{
+  return m_statistics.count();
+}
+
+/**
+ * Returns the statistics of the datasets that have received numeric values,
+ * in a format that can be sent to the plugins.
+ */
+QJsonArray DSP::Statistics::toJson() const
+{
+  QJsonArray array;
+  for (int i = 0; i < m_statistics.count(); ++i)
+  {
+    const auto &stats = m_statistics.at(i);
+    if (stats.count() <= 0)
+      continue;
+
+    QJsonObject object;
+    object.insert("title", m_titles.at(i));
+    object.insert("count", stats.count());
+    object.insert("min", stats.minimum());
+    object.insert("max", stats.maximum());
+    object.insert("mean", stats.mean());
+    object.insert("stdDev", stats.stdDev());
+    object.insert("median", stats.median());
+    object.insert("p95", stats.percentile95());
+    object.insert("p99", stats.percentile99());
+    if (stats.windowSize() > 0)
+    {
+      object.insert("windowCount", stats.windowCount());
+      object.insert("windowMean", stats.windowMean());
+      object.insert("windowStdDev", stats.windowStdDev());
+    }
+
+    array.append(object);
+  }
+
+  return array;
+}
+
+/**
+ * Returns @c true if statistics are available for the given @a dataset of the
+ * given @a group (positions in the frame).
+ */
+bool DSP::Statistics::contains(const int group, const int dataset) const
+{
+  if (group < 0 || group + 1 >= m_offsets.count() || dataset < 0)
+    return false;
+
+  return dataset < m_offsets.at(group + 1) - m_offsets.at(group);
+}
+
+/**
+ * Returns the statistics of the given @a dataset of the given @a group
+ * (positions in the frame), check @c contains() before calling this function.
+ */
+const DSP::RunningStatistics &DSP::Statistics::get(const int group,
+                                                   const int dataset) const
+{
+  return m_statistics.at(m_offsets.at(group) + dataset);
+}
+
+/**
+ * Removes the statistics of all datasets
+ */
+void DSP::Statistics::reset()
+{
+  m_revision = 0;
+  m_titles.clear();
+  m_offsets.clear();
+  m_statistics.clear();
+  Q_EMIT statisticsReset();
+}
+
+/**
+ * Enables or disables the calculation of statistics, disabling them also
+ * removes the statistics calculated so far.
+ */
+void DSP::Statistics::setEnabled(const bool enabled)
+{
+  if (m_enabled != enabled)
+  {
+    m_enabled = enabled;
+    if (!enabled)
+      reset();
+
+    Q_EMIT enabledChanged();
+  }
+}
+
+/**
+ * Changes the number of samples used to calculate the window statistics of
+ * each dataset, set it to 0 to disable the window statistics.
+ */
+void DSP::Statistics::setWindowSize(const int size)
+{
+  const auto value = qMax(0, size);
+  if (m_windowSize != value)
+  {
+    m_windowSize = value;
+    for (int i = 0; i < m_statistics.count(); ++i)
+      m_statistics[i].setWindowSize(value);
+
+    Q_EMIT windowSizeChanged();
+  }
+}
+
+/**
+ * Registers the numeric values of the given @a frame.
+ */
+void DSP::Statistics::registerFrame(const JSON::Frame &frame)
+{
+  // Statistics disabled
+  if (!m_enabled)
+    return;
+
+  // Check if the structure of the frame changed
+  const bool changed = frame.revision() != m_revision;
+
+  // Register the datasets of the new frame structure
+  if (changed)
+  {
+    reset();
+    m_revision = frame.revision();
+    m_offsets.append(0);
+    for (int i = 0; i < frame.groupCount(); ++i)
+    {
+      const auto &group = frame.getGroup(i);
+      for (int j = 0; j < group.datasetCount(); ++j)
+      {
+        const auto &dataset = group.getDataset(j);
+        m_titles.append(dataset.title() + " (" + group.title() + ")");
+      }
+
+      m_offsets.append(m_titles.count());
+    }
+
+    m_statistics.resize(m_titles.count());
+    for (int i = 0; i < m_statistics.count(); ++i)
+      m_statistics[i].setWindowSize(m_windowSize);
+  }
+
+  // Append numeric values to the statistics
+  auto stats = m_statistics.data();
+  for (int i = 0; i < frame.groupCount(); ++i)
+  {
+    const auto &group = frame.getGroup(i);
+    for (int j = 0; j < group.datasetCount(); ++j, ++stats)
+    {
+      const auto &dataset = group.getDataset(j);
+      if (dataset.isNumeric())
+        stats->append(dataset.numericValue());
+    }
+  }
+}
@@ -0,0 +1,190 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <QObject>
+#include <QVector>
+#include <QJsonArray>
+
+#include <DataTypes.h>
+#include <JSON/Frame.h>
+
+namespace DSP
+{
+/**
+ * @brief The QuantileEstimator class
+ *
+ * Estimates a quantile of a series without storing its samples, using the P²
+ * algorithm (Jain & Chlamtac, 1985). Five markers are kept & adjusted with a
+ * piecewise-parabolic interpolation as samples are appended, so appending a
+ * sample takes constant time & memory.
+ */
+class QuantileEstimator
+{
+public:
+  QuantileEstimator(const double probability = 0.5);
+
+  double value() const;
+  double probability() const;
+
+  void clear();
+  void append(const double value);
+
+private:
+  double parabolic(const int i, const double d) const;
+  double linear(const int i, const int d) const;
+
+private:
+  int m_count;
+  double m_probability;
+  double m_heights[5];
+  double m_positions[5];
+  double m_desired[5];
+  double m_increments[5];
+};
+
+/**
+ * @brief The RunningStatistics class
+ *
+ * Keeps the statistics of a dataset since it was first received:
+ *
+ * - Minimum & maximum values
+ * - Mean & standard deviation, updated with Welford's algorithm
+ * - Median, 95th & 99th percentiles, estimated with the P² algorithm
+ *
+ * If a window size is set, the mean & standard deviation of the last N
+ * samples are also calculated. The window uses a ring buffer & adds the new
+ * sample while removing the oldest one, so every statistic is updated in
+ * constant time.
+ */
+class RunningStatistics
+{
+public:
+  RunningStatistics();
+
+  qint64 count() const;
+  double minimum() const;
+  double maximum() const;
+  double mean() const;
+  double stdDev() const;
+  double variance() const;
+
+  double median() const;
+  double percentile95() const;
+  double percentile99() const;
+
+  int windowSize() const;
+  int windowCount() const;
+  double windowMean() const;
+  double windowStdDev() const;
+
+  void clear();
+  void append(const double value);
+  void setWindowSize(const int size);
+
+private:
+  qint64 m_count;
+  double m_min;
+  double m_max;
+  double m_mean;
+  double m_m2;
+
+  QuantileEstimator m_p50;
+  QuantileEstimator m_p95;
+  QuantileEstimator m_p99;
+
+  int m_windowHead;
+  int m_windowCount;
+  double m_windowMean;
+  double m_windowM2;
+  PlotData m_window;
+};
+
+/**
+ * @brief The Statistics class
+ *
+ * Calculates the running statistics of every numeric dataset as frames are
+ * received from the JSON generator, before the dashboard throttles them for
+ * display. The statistics are shown by the data group widgets & sent to the
+ * plugins together with the processed frames.
+ *
+ * The statistics of all datasets are stored in a single vector, in the same
+ * order as the datasets of the frame, so registering a frame only walks
+ * through contiguous memory. The statistics are cleared when the structure of
+ * the frames changes, when a new project is loaded or when the dashboard is
+ * reset (e.g. the device is disconnected).
+ */
+class Statistics : public QObject
+{
+  // clang-format off
+    Q_OBJECT
+    Q_PROPERTY(bool enabled
+               READ enabled
+               WRITE setEnabled
+               NOTIFY enabledChanged)
+    Q_PROPERTY(int windowSize
+               READ windowSize
+               WRITE setWindowSize
+               NOTIFY windowSizeChanged)
+  // clang-format on
+
+Q_SIGNALS:
+  void enabledChanged();
+  void windowSizeChanged();
+  void statisticsReset();
+
+private:
+  explicit Statistics();
+  Statistics(Statistics &&) = delete;
+  Statistics(const Statistics &) = delete;
+  Statistics &operator=(Statistics &&) = delete;
+  Statistics &operator=(const Statistics &) = delete;
+
+public:
+  static Statistics &instance();
+
+  bool enabled() const;
+  int windowSize() const;
+  int datasetCount() const;
+  QJsonArray toJson() const;
+
+  bool contains(const int group, const int dataset) const;
+  const RunningStatistics &get(const int group, const int dataset) const;
+
+public Q_SLOTS:
+  void reset();
+  void setEnabled(const bool enabled);
+  void setWindowSize(const int size);
+
+private Q_SLOTS:
+  void registerFrame(const JSON::Frame &frame);
+
+private:
+  bool m_enabled;
+  int m_windowSize;
+  quint64 m_revision;
+  StringList m_titles;
+  QVector<int> m_offsets;
+  QVector<RunningStatistics> m_statistics;
+};
+} // namespace DSP
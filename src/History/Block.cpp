@@ -0,0 +1,380 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <cstring>
+#include <History/Block.h>
+
+//----------------------------------------------------------------------------------------
+// Bit-level helpers
+//----------------------------------------------------------------------------------------
+
+namespace
+{
+/**
+ * Reads the bits written by @c History::Block::write(), starting from the
+ * most significant bit of the first word.
+ */
+class BitReader
+{
+public:
+  BitReader(const quint64 *words)
+    : m_words(words)
+    , m_position(0)
+  {
+  }
+
+  bool bit() { return read(1) != 0; }
+
+  quint64 read(const int bits)
+  {
+    const auto word = m_position / 64;
+    const auto offset = static_cast<int>(m_position % 64);
+    const auto available = 64 - offset;
+    m_position += bits;
+
+    const auto current = m_words[word] << offset;
+    if (bits <= available)
+      return current >> (64 - bits);
+
+    const auto remaining = bits - available;
+    return ((current >> offset) << remaining)
+           | (m_words[word + 1] >> (64 - remaining));
+  }
+
+private:
+  const quint64 *m_words;
+  qint64 m_position;
+};
+
+/**
+ * Converts the two's complement number stored in the lowest @a bits bits of
+ * @a value (with a range of [-2^(bits-1) + 1, 2^(bits-1)]) to a signed number.
+ */
+inline qint64 signExtend(const quint64 value, const int bits)
+{
+  const auto limit = quint64(1) << (bits - 1);
+  if (value > limit)
+    return static_cast<qint64>(value) - (qint64(1) << bits);
+
+  return static_cast<qint64>(value);
+}
+
+/**
+ * Returns the bit representation of the given @a value
+ */
+inline quint64 toBits(const double value)
+{
+  quint64 bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+
+/**
+ * Returns the floating point number represented by the given @a bits
+ */
+inline double fromBits(const quint64 bits)
+{
+  double value;
+  std::memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+} // namespace
+
+//----------------------------------------------------------------------------------------
+// Block implementation
+//----------------------------------------------------------------------------------------
+
+/**
+ * Constructor function, creates an empty block. The @a level indicates how
+ * many times the samples of the block were downsampled (0 for blocks that
+ * contain the samples at the rate at which they were received).
+ */
+History::Block::Block(const int level)
+  : m_level(level)
+  , m_count(0)
+  , m_sealed(false)
+  , m_bits(0)
+  , m_min{0, 0}
+  , m_max{0, 0}
+  , m_firstTime(0)
+  , m_lastTime(0)
+  , m_lastDelta(0)
+  , m_lastValue(0)
+  , m_leading(64)
+  , m_trailing(0)
+{
+}
+
+/**
+ * Returns the number of times that the samples of the block were downsampled
+ */
+int History::Block::level() const
+{
+  return m_level;
+}
+
+/**
+ * Returns the number of samples stored in the block
+ */
+int History::Block::count() const
+{
+  return m_count;
+}
+
+/**
+ * Returns @c true if no more samples can be added to the block
+ */
+bool History::Block::sealed() const
+{
+  return m_sealed;
+}
+
+/**
+ * Returns the approximate amount of memory used by the block (in bytes)
+ */
+qint64 History::Block::bytes() const
+{
+  return sizeof(Block) + m_words.capacity() * sizeof(quint64);
+}
+
+/**
+ * Returns the time of the oldest sample of the block
+ */
+qint64 History::Block::firstTime() const
+{
+  return m_firstTime;
+}
+
+/**
+ * Returns the time of the newest sample of the block
+ */
+qint64 History::Block::lastTime() const
+{
+  return m_lastTime;
+}
+
+/**
+ * Returns the sample with the smallest value of the block
+ */
+const History::Sample &History::Block::minimum() const
+{
+  return m_min;
+}
+
+/**
+ * Returns the sample with the largest value of the block
+ */
+const History::Sample &History::Block::maximum() const
+{
+  return m_max;
+}
+
+/**
+ * Prevents new samples from being added to the block & releases the memory
+ * that was reserved for them.
+ */
+void History::Block::seal()
+{
+  m_sealed = true;
+  m_words.squeeze();
+}
+
+/**
+ * Compresses & appends the given sample to the block. Samples must be added
+ * in chronological order.
+ */
+void History::Block::append(const qint64 time, const double value)
+{
+  Q_ASSERT(!m_sealed);
+  Q_ASSERT(m_count == 0 || time >= m_lastTime);
+
+  const auto bits = toBits(value);
+
+  // First sample, store timestamp & value without compression
+  if (m_count == 0)
+  {
+    write(static_cast<quint64>(time), 64);
+    write(bits, 64);
+    m_firstTime = time;
+    m_min = {time, value};
+    m_max = {time, value};
+  }
+
+  else
+  {
+    // Store the delta-of-delta of the timestamp with a variable length code
+    const auto delta = time - m_lastTime;
+    const auto deltaOfDelta = delta - m_lastDelta;
+    const auto code = static_cast<quint64>(deltaOfDelta);
+    if (deltaOfDelta == 0)
+      write(0b0, 1);
+    else if (deltaOfDelta >= -63 && deltaOfDelta <= 64)
+    {
+      write(0b10, 2);
+      write(code, 7);
+    }
+    else if (deltaOfDelta >= -255 && deltaOfDelta <= 256)
+    {
+      write(0b110, 3);
+      write(code, 9);
+    }
+    else if (deltaOfDelta >= -2047 && deltaOfDelta <= 2048)
+    {
+      write(0b1110, 4);
+      write(code, 12);
+    }
+    else
+    {
+      write(0b1111, 4);
+      write(code, 64);
+    }
+
+    // Store the bits that changed since the previous value
+    const auto xorValue = bits ^ m_lastValue;
+    if (xorValue == 0)
+      write(0b0, 1);
+
+    else
+    {
+      const auto trailing = static_cast<int>(qCountTrailingZeroBits(xorValue));
+      const auto leading
+          = qMin(31, static_cast<int>(qCountLeadingZeroBits(xorValue)));
+
+      // Changed bits fit in the window of the previous value
+      if (leading >= m_leading && trailing >= m_trailing)
+      {
+        write(0b10, 2);
+        write(xorValue >> m_trailing, 64 - m_leading - m_trailing);
+      }
+
+      // Store a new window
+      else
+      {
+        const auto significant = 64 - leading - trailing;
+        write(0b11, 2);
+        write(leading, 5);
+        write(significant == 64 ? 0 : significant, 6);
+        write(xorValue >> trailing, significant);
+        m_leading = leading;
+        m_trailing = trailing;
+      }
+    }
+
+    // Update extremes
+    if (value < m_min.value)
+      m_min = {time, value};
+    if (value > m_max.value)
+      m_max = {time, value};
+
+    m_lastDelta = delta;
+  }
+
+  // Update encoder state
+  ++m_count;
+  m_lastTime = time;
+  m_lastValue = bits;
+}
+
+/**
+ * Decompresses the samples of the block & appends them to @a samples.
+ */
+void History::Block::decode(QVector<Sample> &samples) const
+{
+  if (m_count == 0)
+    return;
+
+  // Read first sample
+  BitReader reader(m_words.constData());
+  auto time = static_cast<qint64>(reader.read(64));
+  auto bits = reader.read(64);
+  samples.reserve(samples.count() + m_count);
+  samples.append({time, fromBits(bits)});
+
+  // Read remaining samples
+  qint64 delta = 0;
+  int leading = 0;
+  int trailing = 0;
+  for (int i = 1; i < m_count; ++i)
+  {
+    // Read delta-of-delta of the timestamp
+    qint64 deltaOfDelta = 0;
+    if (reader.bit())
+    {
+      if (!reader.bit())
+        deltaOfDelta = signExtend(reader.read(7), 7);
+      else if (!reader.bit())
+        deltaOfDelta = signExtend(reader.read(9), 9);
+      else if (!reader.bit())
+        deltaOfDelta = signExtend(reader.read(12), 12);
+      else
+        deltaOfDelta = static_cast<qint64>(reader.read(64));
+    }
+
+    delta += deltaOfDelta;
+    time += delta;
+
+    // Read the bits that changed since the previous value
+    if (reader.bit())
+    {
+      if (reader.bit())
+      {
+        leading = static_cast<int>(reader.read(5));
+        auto significant = static_cast<int>(reader.read(6));
+        if (significant == 0)
+          significant = 64;
+
+        trailing = 64 - leading - significant;
+      }
+
+      bits ^= reader.read(64 - leading - trailing) << trailing;
+    }
+
+    samples.append({time, fromBits(bits)});
+  }
+}
+
+/**
+ * Appends the lowest @a bits bits of @a value to the bit stream, starting
+ * with the most significant bit.
+ */
+void History::Block::write(quint64 value, const int bits)
+{
+  if (bits < 64)
+    value &= (quint64(1) << bits) - 1;
+
+  const auto offset = static_cast<int>(m_bits % 64);
+  if (offset == 0)
+    m_words.append(0);
+
+  const auto available = 64 - offset;
+  if (bits <= available)
+    m_words.last() |= value << (available - bits);
+
+  else
+  {
+    const auto remaining = bits - available;
+    m_words.last() |= value >> remaining;
+    m_words.append(value << (64 - remaining));
+  }
+
+  m_bits += bits;
+}
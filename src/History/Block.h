@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <QVector>
+#include <QtGlobal>
+
+namespace History
+{
+/**
+ * @brief A single sample of a dataset history
+ *
+ * The time of the sample is stored in microseconds, using the same monotonic
+ * clock as the dashboard (see @c UI::Dashboard::frameTimestamp()).
+ */
+struct Sample
+{
+  qint64 time;
+  double value;
+};
+
+/**
+ * @brief The Block class
+ *
+ * Stores up to @c kSamples samples of a dataset using the compression scheme
+ * of the Gorilla time series database: timestamps are stored as the
+ * difference between consecutive deltas (delta-of-delta), and each value is
+ * XOR-ed with the previous one, so that only the bits that changed are
+ * stored. Telemetry that is received at a steady rate & changes slowly
+ * usually takes a couple of bytes per sample, instead of sixteen.
+ *
+ * Blocks also keep their time range & the extremes of their samples, so that
+ * queries can skip or summarize blocks without decompressing them. Once a
+ * block is sealed, no more samples can be added to it.
+ */
+class Block
+{
+public:
+  static constexpr int kSamples = 1024;
+
+  Block(const int level = 0);
+
+  int level() const;
+  int count() const;
+  bool sealed() const;
+  qint64 bytes() const;
+  qint64 firstTime() const;
+  qint64 lastTime() const;
+  const Sample &minimum() const;
+  const Sample &maximum() const;
+
+  void seal();
+  void append(const qint64 time, const double value);
+  void decode(QVector<Sample> &samples) const;
+
+private:
+  void write(quint64 value, const int bits);
+
+private:
+  int m_level;
+  int m_count;
+  bool m_sealed;
+  qint64 m_bits;
+  QVector<quint64> m_words;
+
+  Sample m_min;
+  Sample m_max;
+  qint64 m_firstTime;
+  qint64 m_lastTime;
+  qint64 m_lastDelta;
+  quint64 m_lastValue;
+  int m_leading;
+  int m_trailing;
+};
+} // namespace History
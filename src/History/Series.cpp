@@ -0,0 +1,349 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <algorithm>
+#include <History/Series.h>
+
+/**
+ * Constructor function
+ */
+History::Series::Series()
+  : m_count(0)
+  , m_sealedBytes(0)
+{
+}
+
+/**
+ * Returns the approximate amount of memory used by the series (in bytes)
+ */
+qint64 History::Series::bytes() const
+{
+  if (!m_blocks.isEmpty() && !m_blocks.last().sealed())
+    return m_sealedBytes + m_blocks.last().bytes();
+
+  return m_sealedBytes;
+}
+
+/**
+ * Returns the number of samples stored in the series (downsampled data
+ * counts the samples that were kept, not the original samples)
+ */
+qint64 History::Series::count() const
+{
+  return m_count;
+}
+
+/**
+ * Returns @c true if the series does not have any samples
+ */
+bool History::Series::isEmpty() const
+{
+  return m_count == 0;
+}
+
+/**
+ * Returns the time of the oldest sample of the series
+ */
+qint64 History::Series::firstTime() const
+{
+  if (m_blocks.isEmpty())
+    return 0;
+
+  return m_blocks.first().firstTime();
+}
+
+/**
+ * Returns the time of the newest sample of the series
+ */
+qint64 History::Series::lastTime() const
+{
+  if (m_blocks.isEmpty())
+    return 0;
+
+  return m_blocks.last().lastTime();
+}
+
+/**
+ * Removes all the samples of the series
+ */
+void History::Series::clear()
+{
+  m_count = 0;
+  m_sealedBytes = 0;
+  m_blocks.clear();
+}
+
+/**
+ * Releases memory by downsampling the oldest run of @c kMergeBlocks sealed
+ * blocks of the lowest possible level. If there is nothing to downsample, the
+ * oldest block is removed.
+ *
+ * @return @c false if the series has no sealed blocks
+ */
+bool History::Series::compact()
+{
+  // Get number of sealed blocks
+  auto sealed = m_blocks.count();
+  if (sealed > 0 && !m_blocks.last().sealed())
+    --sealed;
+
+  // Downsample the oldest run of blocks, starting from the finest level
+  for (int level = 0; level < kMaxLevel; ++level)
+  {
+    int run = 0;
+    for (int i = 0; i < sealed; ++i)
+    {
+      run = m_blocks.at(i).level() == level ? run + 1 : 0;
+      if (run == kMergeBlocks)
+      {
+        merge(i - kMergeBlocks + 1, kMergeBlocks);
+        return true;
+      }
+    }
+  }
+
+  // Nothing to downsample, remove the oldest block
+  if (sealed > 0)
+  {
+    m_count -= m_blocks.first().count();
+    m_sealedBytes -= m_blocks.first().bytes();
+    m_blocks.removeFirst();
+    return true;
+  }
+
+  return false;
+}
+
+/**
+ * Appends a new sample to the series, samples must be added in chronological
+ * order.
+ */
+void History::Series::append(const qint64 time, const double value)
+{
+  // Create a new block if needed
+  if (m_blocks.isEmpty() || m_blocks.last().sealed())
+    m_blocks.append(Block());
+
+  // Add sample to the newest block
+  auto &block = m_blocks.last();
+  block.append(time, value);
+  ++m_count;
+
+  // Seal the block once it is full
+  if (block.count() >= Block::kSamples)
+  {
+    block.seal();
+    m_sealedBytes += block.bytes();
+  }
+}
+
+/**
+ * Appends the samples received between @a from and @a to (inclusive) to
+ * @a samples.
+ */
+void History::Series::query(const qint64 from, const qint64 to,
+                            QVector<Sample> &samples) const
+{
+  QVector<Sample> decoded;
+  for (int i = findBlock(from); i < m_blocks.count(); ++i)
+  {
+    const auto &block = m_blocks.at(i);
+    if (block.firstTime() > to)
+      break;
+
+    decoded.clear();
+    block.decode(decoded);
+    for (const auto &sample : decoded)
+    {
+      if (sample.time >= from && sample.time <= to)
+        samples.append(sample);
+    }
+  }
+}
+
+/**
+ * Fills @a samples with the minimum & maximum samples received during each
+ * of the @a columns intervals in which the time range that goes from @a from
+ * to @a to is divided (e.g. one interval for each pixel column of a plot).
+ *
+ * Blocks that lie inside a single interval are summarized with their
+ * extremes, so they are not decompressed. This way, querying a long period of
+ * time only decompresses a few blocks.
+ */
+void History::Series::query(const qint64 from, const qint64 to,
+                            const int columns, QVector<Sample> &samples) const
+{
+  samples.clear();
+  if (columns <= 0 || to <= from)
+  {
+    query(from, to, samples);
+    return;
+  }
+
+  // Extremes of the current interval
+  int column = -1;
+  Sample min{0, 0};
+  Sample max{0, 0};
+  const double step = static_cast<double>(to - from) / columns;
+
+  // Writes the extremes of the current interval in chronological order
+  auto flush = [&]() {
+    if (column < 0)
+      return;
+
+    if (min.time < max.time)
+    {
+      samples.append(min);
+      samples.append(max);
+    }
+
+    else if (max.time < min.time)
+    {
+      samples.append(max);
+      samples.append(min);
+    }
+
+    else
+      samples.append(min);
+  };
+
+  // Registers a sample in its interval
+  auto columnOf = [&](const qint64 time) {
+    return qMin(columns - 1, static_cast<int>((time - from) / step));
+  };
+  auto add = [&](const Sample &sample) {
+    const auto c = columnOf(sample.time);
+    if (c != column)
+    {
+      flush();
+      column = c;
+      min = sample;
+      max = sample;
+    }
+
+    else if (sample.value < min.value)
+      min = sample;
+    else if (sample.value > max.value)
+      max = sample;
+  };
+
+  // Process each block that overlaps with the time range
+  QVector<Sample> decoded;
+  for (int i = findBlock(from); i < m_blocks.count(); ++i)
+  {
+    const auto &block = m_blocks.at(i);
+    if (block.firstTime() > to)
+      break;
+
+    // Summarize blocks that lie inside a single interval
+    if (block.firstTime() >= from && block.lastTime() <= to
+        && columnOf(block.firstTime()) == columnOf(block.lastTime()))
+    {
+      if (block.minimum().time <= block.maximum().time)
+      {
+        add(block.minimum());
+        add(block.maximum());
+      }
+
+      else
+      {
+        add(block.maximum());
+        add(block.minimum());
+      }
+
+      continue;
+    }
+
+    // Decompress the block
+    decoded.clear();
+    block.decode(decoded);
+    for (const auto &sample : decoded)
+    {
+      if (sample.time >= from && sample.time <= to)
+        add(sample);
+    }
+  }
+
+  flush();
+}
+
+/**
+ * Returns the index of the first block that has samples received at or after
+ * the given @a time.
+ */
+int History::Series::findBlock(const qint64 time) const
+{
+  const auto block = std::lower_bound(
+      m_blocks.constBegin(), m_blocks.constEnd(), time,
+      [](const Block &b, const qint64 t) { return b.lastTime() < t; });
+
+  return static_cast<int>(block - m_blocks.constBegin());
+}
+
+/**
+ * Replaces the @a count blocks that start at the index @a first with a single
+ * block that keeps the minimum & maximum sample of each group of
+ * 2 * @a count samples, which reduces the number of samples by a factor of
+ * @a count, while preserving the peaks of the original data.
+ */
+void History::Series::merge(const int first, const int count)
+{
+  // Decompress the samples of the blocks
+  QVector<Sample> samples;
+  const auto level = m_blocks.at(first).level();
+  for (int i = first; i < first + count; ++i)
+  {
+    m_count -= m_blocks.at(i).count();
+    m_sealedBytes -= m_blocks.at(i).bytes();
+    m_blocks.at(i).decode(samples);
+  }
+
+  // Keep the extremes of each group of samples (in chronological order)
+  Block block(level + 1);
+  const int group = count * 2;
+  for (int begin = 0; begin < samples.count(); begin += group)
+  {
+    int min = begin;
+    int max = begin;
+    const auto end = qMin(samples.count(), begin + group);
+    for (int i = begin + 1; i < end; ++i)
+    {
+      if (samples.at(i).value < samples.at(min).value)
+        min = i;
+      else if (samples.at(i).value > samples.at(max).value)
+        max = i;
+    }
+
+    const auto a = qMin(min, max);
+    const auto b = qMax(min, max);
+    block.append(samples.at(a).time, samples.at(a).value);
+    if (b != a)
+      block.append(samples.at(b).time, samples.at(b).value);
+  }
+
+  // Replace the original blocks with the downsampled block
+  block.seal();
+  m_count += block.count();
+  m_sealedBytes += block.bytes();
+  m_blocks.remove(first + 1, count - 1);
+  m_blocks[first] = block;
+}
@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <History/Block.h>
+
+namespace History
+{
+/**
+ * @brief The Series class
+ *
+ * Compressed history of a single dataset, stored as a list of chronologically
+ * sorted blocks. The newest block receives the new samples, and it is sealed
+ * once it is full.
+ *
+ * When the history needs to release memory, old blocks are downsampled into
+ * coarser tiers: every @c kMergeBlocks consecutive blocks of the same level
+ * are replaced by a single block that only keeps the minimum & maximum of
+ * each group of samples. Once the oldest data cannot be downsampled any
+ * further, its blocks are removed.
+ */
+class Series
+{
+public:
+  static constexpr int kMaxLevel = 3;
+  static constexpr int kMergeBlocks = 8;
+
+  Series();
+
+  qint64 bytes() const;
+  qint64 count() const;
+  bool isEmpty() const;
+  qint64 firstTime() const;
+  qint64 lastTime() const;
+
+  void clear();
+  bool compact();
+  void append(const qint64 time, const double value);
+
+  void query(const qint64 from, const qint64 to,
+             QVector<Sample> &samples) const;
+  void query(const qint64 from, const qint64 to, const int columns,
+             QVector<Sample> &samples) const;
+
+private:
+  int findBlock(const qint64 time) const;
+  void merge(const int first, const int count);
+
+private:
+  qint64 m_count;
+  qint64 m_sealedBytes;
+  QVector<Block> m_blocks;
+};
+} // namespace History
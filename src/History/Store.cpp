@@ -0,0 +1,242 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <UI/Dashboard.h>
+#include <History/Store.h>
+#include <JSON/Generator.h>
+#include <Misc/TimerEvents.h>
+
+/**
+ * Constructor function
+ */
+History::Store::Store()
+  : m_budget(256)
+  , m_frames(0)
+  , m_revision(0)
+{
+  // clang-format off
+    connect(&UI::Dashboard::instance(), &UI::Dashboard::updated,
+            this, &History::Store::registerFrame);
+    connect(&JSON::Generator::instance(), &JSON::Generator::jsonFileMapChanged,
+            this, &History::Store::clear);
+    connect(&Misc::TimerEvents::instance(), &Misc::TimerEvents::timeout1Hz,
+            this, &History::Store::memoryUsageChanged);
+  // clang-format on
+}
+
+/**
+ * Returns a pointer to the only instance of the class
+ */
+History::Store &History::Store::instance()
+{
+  static Store singleton;
+  return singleton;
+}
+
+/**
+ * Returns the approximate amount of memory used by the history (in bytes)
+ */
+qint64 History::Store::bytes() const
+{
+  qint64 bytes = 0;
+  for (int i = 0; i < m_series.count(); ++i)
+    bytes += m_series.at(i).bytes();
+
+  return bytes;
+}
+
+/**
+ * Returns the maximum amount of memory that the history may use (in MiB).
+ * A value of 0 disables the history.
+ */
+int History::Store::memoryBudget() const
+{
+  return m_budget;
+}
+
+/**
+ * Returns the approximate amount of memory used by the history (in MiB)
+ */
+double History::Store::memoryUsage() const
+{
+  return bytes() / (1024.0 * 1024.0);
+}
+
+/**
+ * Returns the number of datasets registered by the history
+ */
+int History::Store::seriesCount() const
+{
+  return m_series.count();
+}
+
+/**
+ * Returns the index of the series of the dataset displayed by the plot widget
+ * with the given @a plot index, or -1 if the history has no such dataset.
+ */
+int History::Store::plotSeries(const int plot) const
+{
+  int count = 0;
+  for (int i = 0; i < m_graph.count(); ++i)
+  {
+    if (m_graph.at(i) && count++ == plot)
+      return i;
+  }
+
+  return -1;
+}
+
+/**
+ * Returns the title of the dataset registered with the given series @a index
+ */
+QString History::Store::title(const int index) const
+{
+  return m_titles.at(index);
+}
+
+/**
+ * Returns the history of the dataset registered with the given series
+ * @a index, which can be queried for any time range.
+ */
+const History::Series &History::Store::series(const int index) const
+{
+  return m_series.at(index);
+}
+
+/**
+ * Removes all the registered samples & datasets
+ */
+void History::Store::clear()
+{
+  m_frames = 0;
+  m_graph.clear();
+  m_revision = 0;
+  m_titles.clear();
+  m_series.clear();
+
+  Q_EMIT seriesChanged();
+  Q_EMIT memoryUsageChanged();
+}
+
+/**
+ * Changes the maximum amount of memory that the history may use (in MiB),
+ * check the @c memoryBudget() function for more information.
+ */
+void History::Store::setMemoryBudget(const int megabytes)
+{
+  const auto budget = qMax(0, megabytes);
+  if (m_budget != budget)
+  {
+    m_budget = budget;
+    if (m_budget == 0)
+      clear();
+    else
+      enforceBudget();
+
+    Q_EMIT memoryBudgetChanged();
+  }
+}
+
+/**
+ * Registers the numeric values of the frame that is currently displayed by
+ * the dashboard, using the time at which the frame was received.
+ *
+ * The dataset titles are only rebuilt when the structure of the frame changes.
+ */
+void History::Store::registerFrame()
+{
+  // History disabled
+  if (m_budget <= 0)
+    return;
+
+  // Get current frame
+  auto dash = &UI::Dashboard::instance();
+  const auto &frame = dash->currentFrame();
+  if (!frame.isValid())
+    return;
+
+  // Check if the structure of the frame changed
+  const bool changed = frame.revision() != m_revision;
+
+  // Register the datasets of the new frame structure
+  if (changed)
+  {
+    clear();
+    m_revision = frame.revision();
+    for (int i = 0; i < frame.groupCount(); ++i)
+    {
+      const auto &group = frame.getGroup(i);
+      for (int j = 0; j < group.datasetCount(); ++j)
+      {
+        const auto &dataset = group.getDataset(j);
+        m_graph.append(dataset.graph());
+        m_titles.append(dataset.title() + " (" + group.title() + ")");
+      }
+    }
+
+    m_series.resize(m_titles.count());
+    Q_EMIT seriesChanged();
+  }
+
+  // Append numeric values to the history
+  int index = 0;
+  const auto time = dash->frameTimestamp();
+  for (int i = 0; i < frame.groupCount(); ++i)
+  {
+    const auto &group = frame.getGroup(i);
+    for (int j = 0; j < group.datasetCount(); ++j, ++index)
+    {
+      const auto &dataset = group.getDataset(j);
+      if (dataset.isNumeric())
+        m_series[index].append(time, dataset.numericValue());
+    }
+  }
+
+  // Check memory usage periodically
+  if (++m_frames % kBudgetInterval == 0)
+    enforceBudget();
+}
+
+/**
+ * Downsamples (or removes) the oldest data of the largest series until the
+ * history fits in the memory budget.
+ */
+void History::Store::enforceBudget()
+{
+  const auto budget = qint64(m_budget) * 1024 * 1024;
+  while (bytes() > budget)
+  {
+    int largest = -1;
+    qint64 size = 0;
+    for (int i = 0; i < m_series.count(); ++i)
+    {
+      if (m_series.at(i).bytes() > size)
+      {
+        largest = i;
+        size = m_series.at(i).bytes();
+      }
+    }
+
+    if (largest < 0 || !m_series[largest].compact())
+      break;
+  }
+}
@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <QObject>
+#include <DataTypes.h>
+#include <History/Series.h>
+
+namespace History
+{
+/**
+ * @brief The Store class
+ *
+ * Keeps a compressed, in-memory history of every numeric dataset of the
+ * received frames, so that long periods of full-rate telemetry can be
+ * plotted without writing them to disk.
+ *
+ * Each dataset is stored in its own @c History::Series. When the history
+ * uses more memory than the configured budget, the oldest data of the largest
+ * series is downsampled (or removed once it cannot be downsampled any
+ * further), so recent data is kept at full rate & older data is kept at
+ * progressively lower rates.
+ *
+ * The history is cleared when the structure of the frames changes (e.g. a
+ * different project is loaded), but not when the device is disconnected.
+ */
+class Store : public QObject
+{
+  // clang-format off
+    Q_OBJECT
+    Q_PROPERTY(int memoryBudget
+               READ memoryBudget
+               WRITE setMemoryBudget
+               NOTIFY memoryBudgetChanged)
+    Q_PROPERTY(double memoryUsage
+               READ memoryUsage
+               NOTIFY memoryUsageChanged)
+  // clang-format on
+
+Q_SIGNALS:
+  void seriesChanged();
+  void memoryUsageChanged();
+  void memoryBudgetChanged();
+
+private:
+  explicit Store();
+  Store(Store &&) = delete;
+  Store(const Store &) = delete;
+  Store &operator=(Store &&) = delete;
+  Store &operator=(const Store &) = delete;
+
+public:
+  static Store &instance();
+
+  static constexpr int kBudgetInterval = 64;
+
+  qint64 bytes() const;
+  int memoryBudget() const;
+  double memoryUsage() const;
+
+  int seriesCount() const;
+  int plotSeries(const int plot) const;
+  QString title(const int index) const;
+  const Series &series(const int index) const;
+
+public Q_SLOTS:
+  void clear();
+  void setMemoryBudget(const int megabytes);
+
+private Q_SLOTS:
+  void registerFrame();
+
+private:
+  void enforceBudget();
+
+private:
+  int m_budget;
+  int m_frames;
+  quint64 m_revision;
+  StringList m_titles;
+  QVector<bool> m_graph;
+  QVector<Series> m_series;
+};
+} // namespace History
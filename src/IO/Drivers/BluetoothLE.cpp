@@ -37,6 +37,7 @@ IO::Drivers::BluetoothLE::BluetoothLE()
   , m_deviceConnected(false)
   , m_service(Q_NULLPTR)
   , m_controller(Q_NULLPTR)
+  , m_discoveryAgent(Q_NULLPTR)
 {
   // clang-format off
 
@@ -46,26 +47,6 @@ IO::Drivers::BluetoothLE::BluetoothLE()
     connect(this, &IO::Drivers::BluetoothLE::deviceConnectedChanged,
             &IO::Manager::instance(), &IO::Manager::connectedChanged);
 
-    // Operating system not supported, abort initialization process
-    if (!operatingSystemSupported())
-        return;
-
-    // Register discovered devices
-    connect(&m_discoveryAgent, &QBluetoothDeviceDiscoveryAgent::deviceDiscovered,
-            this, &IO::Drivers::BluetoothLE::onDeviceDiscovered);
-
-    // Report BLE discovery errors
-#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
-    connect(&m_discoveryAgent,
-            static_cast<void (QBluetoothDeviceDiscoveryAgent::*)(
-                QBluetoothDeviceDiscoveryAgent::Error)>(
-                &QBluetoothDeviceDiscoveryAgent::error),
-            this, &IO::Drivers::BluetoothLE::onDiscoveryError);
-#else
-    connect(&m_discoveryAgent, &QBluetoothDeviceDiscoveryAgent::errorOccurred,
-            this, &IO::Drivers::BluetoothLE::onDiscoveryError);
-#endif
-
   // clang-format on
 }
 
@@ -274,8 +255,34 @@ void IO::Drivers::BluetoothLE::startDiscovery()
   Q_EMIT devicesChanged();
   Q_EMIT deviceIndexChanged();
 
+  // Create the discovery agent on first use (it initializes the BT stack)
+  if (!m_discoveryAgent)
+  {
+    m_discoveryAgent = new QBluetoothDeviceDiscoveryAgent(this);
+
+    // clang-format off
+
+    // Register discovered devices
+    connect(m_discoveryAgent, &QBluetoothDeviceDiscoveryAgent::deviceDiscovered,
+            this, &IO::Drivers::BluetoothLE::onDeviceDiscovered);
+
+    // Report BLE discovery errors
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+    connect(m_discoveryAgent,
+            static_cast<void (QBluetoothDeviceDiscoveryAgent::*)(
+                QBluetoothDeviceDiscoveryAgent::Error)>(
+                &QBluetoothDeviceDiscoveryAgent::error),
+            this, &IO::Drivers::BluetoothLE::onDiscoveryError);
+#else
+    connect(m_discoveryAgent, &QBluetoothDeviceDiscoveryAgent::errorOccurred,
+            this, &IO::Drivers::BluetoothLE::onDiscoveryError);
+#endif
+
+    // clang-format on
+  }
+
   // Start device discovery process
-  m_discoveryAgent.start(QBluetoothDeviceDiscoveryAgent::LowEnergyMethod);
+  m_discoveryAgent->start(QBluetoothDeviceDiscoveryAgent::LowEnergyMethod);
 }
 
 /**
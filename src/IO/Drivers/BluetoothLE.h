@@ -122,7 +122,7 @@ private:
   StringList m_deviceNames;
   StringList m_serviceNames;
   QList<QBluetoothDeviceInfo> m_devices;
-  QBluetoothDeviceDiscoveryAgent m_discoveryAgent;
+  QBluetoothDeviceDiscoveryAgent *m_discoveryAgent;
 };
 } // namespace Drivers
 } // namespace IO
@@ -36,6 +36,8 @@ IO::Drivers::Network::Network()
   : m_hostExists(false)
   , m_udpMulticast(false)
   , m_lookupActive(false)
+  , m_tcpServerMode(false)
+  , m_tcpServerTagFrames(true)
   , m_udpIgnoreFrameSequences(false)
 {
   // Set initial configuration
@@ -50,11 +52,19 @@ IO::Drivers::Network::Network()
     // Update connect button status when the configuration is changed
     connect(this, &IO::Drivers::Network::addressChanged,
             this, &IO::Drivers::Network::configurationChanged);
+    connect(this, &IO::Drivers::Network::tcpServerAddressChanged,
+            this, &IO::Drivers::Network::configurationChanged);
     connect(this, &IO::Drivers::Network::socketTypeChanged,
             this, &IO::Drivers::Network::configurationChanged);
     connect(this, &IO::Drivers::Network::portChanged,
             this, &IO::Drivers::Network::configurationChanged);
 
+    // Process frames extracted by the TCP server I/O threads
+    connect(&m_tcpServer, &IO::Drivers::TcpServer::framesReceived,
+            this, &IO::Drivers::Network::onServerFramesReceived);
+    connect(&m_tcpServer, &IO::Drivers::TcpServer::connectionCountChanged,
+            this, &IO::Drivers::Network::tcpServerConnectionsChanged);
+
     // Report socket errors
 #if QT_VERSION < QT_VERSION_CHECK(5, 12, 0)
     connect(&m_tcpSocket, SIGNAL(error(QAbstractSocket::SocketError)),
@@ -91,6 +101,7 @@ IO::Drivers::Network &IO::Drivers::Network::instance()
 void IO::Drivers::Network::close()
 {
   // Abort network connections
+  m_tcpServer.stop();
   m_tcpSocket.abort();
   m_udpSocket.abort();
   m_tcpSocket.disconnectFromHost();
@@ -110,7 +121,9 @@ void IO::Drivers::Network::close()
  */
 bool IO::Drivers::Network::isOpen() const
 {
-  if (socketType() == QAbstractSocket::UdpSocket)
+  if (tcpServerMode())
+    return m_tcpServer.isListening();
+  else if (socketType() == QAbstractSocket::UdpSocket)
     return m_udpSocket.isOpen();
   else if (socketType() == QAbstractSocket::TcpSocket)
     return m_tcpSocket.isOpen();
@@ -123,7 +136,9 @@ bool IO::Drivers::Network::isOpen() const
  */
 bool IO::Drivers::Network::isReadable() const
 {
-  if (socketType() == QAbstractSocket::UdpSocket)
+  if (tcpServerMode())
+    return m_tcpServer.isListening();
+  else if (socketType() == QAbstractSocket::UdpSocket)
     return m_udpSocket.isReadable();
   else if (socketType() == QAbstractSocket::TcpSocket)
     return m_tcpSocket.isReadable();
@@ -136,7 +151,9 @@ bool IO::Drivers::Network::isReadable() const
  */
 bool IO::Drivers::Network::isWritable() const
 {
-  if (socketType() == QAbstractSocket::UdpSocket)
+  if (tcpServerMode())
+    return m_tcpServer.isListening();
+  else if (socketType() == QAbstractSocket::UdpSocket)
     return m_udpSocket.isWritable();
   else if (socketType() == QAbstractSocket::TcpSocket)
     return m_tcpSocket.isWritable();
@@ -146,21 +163,34 @@ bool IO::Drivers::Network::isWritable() const
 
 /**
  * Returns @c true if the port is greater than 0 and the host address is valid.
+ * In TCP server mode, we need a valid port to listen on and, if set, a valid
+ * local address to bind to.
  */
 bool IO::Drivers::Network::configurationOk() const
 {
+  if (tcpServerMode())
+    return tcpPort() > 0
+           && (tcpServerAddress().isEmpty()
+               || !QHostAddress(tcpServerAddress()).isNull());
+
   return tcpPort() > 0 && m_hostExists;
 }
 
 /**
  * Writes the given @a data to the network device and returns the number of
- * bytes written
+ * bytes written. In TCP server mode, the data is sent to all connected devices.
  */
 quint64 IO::Drivers::Network::write(const QByteArray &data)
 {
   if (isWritable())
   {
-    if (socketType() == QAbstractSocket::UdpSocket)
+    if (tcpServerMode())
+    {
+      m_tcpServer.write(data);
+      return data.length();
+    }
+
+    else if (socketType() == QAbstractSocket::UdpSocket)
       return m_udpSocket.write(data);
     else if (socketType() == QAbstractSocket::TcpSocket)
       return m_tcpSocket.write(data);
@@ -186,6 +216,26 @@ bool IO::Drivers::Network::open(const QIODevice::OpenMode mode)
   // Init socket pointer
   QIODevice *socket = Q_NULLPTR;
 
+  // TCP server, listen for inbound connections
+  if (tcpServerMode())
+  {
+    auto address = QHostAddress(QHostAddress::Any);
+    if (!tcpServerAddress().isEmpty())
+      address = QHostAddress(tcpServerAddress());
+
+    auto manager = &IO::Manager::instance();
+    auto start = manager->startSequence().toUtf8();
+    auto finish = manager->finishSequence().toUtf8();
+    auto bufferSize = manager->maxBufferSize();
+    if (m_tcpServer.start(address, tcpPort(), start, finish, bufferSize))
+      return true;
+
+    Misc::Utilities::showMessageBox(tr("Unable to start TCP server"),
+                                    m_tcpServer.errorString());
+    close();
+    return false;
+  }
+
   // TCP connection, assign socket pointer & connect to host
   if (socketType() == QAbstractSocket::TcpSocket)
   {
@@ -239,6 +289,15 @@ QString IO::Drivers::Network::remoteAddress() const
   return m_address;
 }
 
+/**
+ * Returns the local address on which the TCP server listens, an empty string
+ * means that the server listens on all network interfaces.
+ */
+QString IO::Drivers::Network::tcpServerAddress() const
+{
+  return m_tcpServerAddress;
+}
+
 /**
  * Returns the TCP port number
  */
@@ -280,6 +339,15 @@ bool IO::Drivers::Network::lookupActive() const
   return m_lookupActive;
 }
 
+/**
+ * Returns @c true if the driver listens for inbound TCP connections instead of
+ * connecting to a remote host.
+ */
+bool IO::Drivers::Network::tcpServerMode() const
+{
+  return m_tcpServerMode;
+}
+
 /**
  * Returns the current socket type as an index of the list returned by the @c
  * socketType function.
@@ -289,7 +357,7 @@ int IO::Drivers::Network::socketTypeIndex() const
   switch (socketType())
   {
     case QAbstractSocket::TcpSocket:
-      return 0;
+      return tcpServerMode() ? 2 : 0;
       break;
     case QAbstractSocket::UdpSocket:
       return 1;
@@ -305,7 +373,25 @@ int IO::Drivers::Network::socketTypeIndex() const
  */
 StringList IO::Drivers::Network::socketTypes() const
 {
-  return StringList{"TCP", "UDP"};
+  return StringList{"TCP", "UDP", tr("TCP Server")};
+}
+
+/**
+ * Returns @c true if the frames received through the TCP server are tagged
+ * with the name of the device that sent them, in which case the groups of
+ * each device are shown separately (with the device name as a prefix).
+ */
+bool IO::Drivers::Network::tcpServerTagFrames() const
+{
+  return m_tcpServerTagFrames;
+}
+
+/**
+ * Returns the number of devices connected to the TCP server
+ */
+int IO::Drivers::Network::tcpServerConnections() const
+{
+  return m_tcpServer.connectionCount();
 }
 
 /**
@@ -335,6 +421,7 @@ QAbstractSocket::SocketType IO::Drivers::Network::socketType() const
  */
 void IO::Drivers::Network::setTcpSocket()
 {
+  m_tcpServerMode = false;
   setSocketType(QAbstractSocket::TcpSocket);
 }
 
@@ -343,9 +430,19 @@ void IO::Drivers::Network::setTcpSocket()
  */
 void IO::Drivers::Network::setUdpSocket()
 {
+  m_tcpServerMode = false;
   setSocketType(QAbstractSocket::UdpSocket);
 }
 
+/**
+ * Instructs the module to listen for inbound TCP connections.
+ */
+void IO::Drivers::Network::setTcpServer()
+{
+  m_tcpServerMode = true;
+  setSocketType(QAbstractSocket::TcpSocket);
+}
+
 /**
  * Changes the TCP socket's @c port number
  */
@@ -394,6 +491,16 @@ void IO::Drivers::Network::setRemoteAddress(const QString &address)
   Q_EMIT addressChanged();
 }
 
+/**
+ * Changes the local IPv4 or IPv6 address on which the TCP server listens for
+ * inbound connections. An empty string listens on all network interfaces.
+ */
+void IO::Drivers::Network::setTcpServerAddress(const QString &address)
+{
+  m_tcpServerAddress = address.simplified();
+  Q_EMIT tcpServerAddressChanged();
+}
+
 /**
  * If @a ignore is set to @c true, then the @c IO::Manager should not check
  * for start/end frame sequences when an UDP datagram is received.
@@ -407,6 +514,16 @@ void IO::Drivers::Network::setUdpIgnoreFrameSequences(const bool ignore)
   Q_EMIT udpIgnoreFrameSequencesChanged();
 }
 
+/**
+ * Enables/disables tagging the frames received through the TCP server with
+ * the name of the device that sent them.
+ */
+void IO::Drivers::Network::setTcpServerTagFrames(const bool tagFrames)
+{
+  m_tcpServerTagFrames = tagFrames;
+  Q_EMIT tcpServerTagFramesChanged();
+}
+
 /**
  * Performs a DNS lookup for the given @a host name
  */
@@ -441,6 +558,9 @@ void IO::Drivers::Network::setSocketTypeIndex(const int index)
     case 1:
       setUdpSocket();
       break;
+    case 2:
+      setTcpServer();
+      break;
     default:
       break;
   }
@@ -498,6 +618,20 @@ void IO::Drivers::Network::onReadyRead()
   }
 }
 
+/**
+ * Registers the @a frames extracted by the TCP server I/O threads for the
+ * given @a device.
+ *
+ * The frames have already been separated by the I/O threads, so they are
+ * processed directly by the I/O manager.
+ */
+void IO::Drivers::Network::onServerFramesReceived(const QString &device,
+                                                  const QByteArrayList &frames)
+{
+  const auto name = tcpServerTagFrames() ? device : QString();
+  IO::Manager::instance().processServerFrames(frames, name);
+}
+
 /**
  * Sets the host IP address when the lookup finishes.
  * If the lookup fails, the error code/string shall be shown to the user in a
@@ -24,6 +24,7 @@
 
 #include <DataTypes.h>
 #include <IO/HAL_Driver.h>
+#include <IO/Drivers/TcpServer.h>
 
 #include <QHostInfo>
 #include <QTcpSocket>
@@ -40,6 +41,11 @@ namespace Drivers
  * @brief The Network class
  *
  * Serial Studio "driver" class to interact with UDP/TCP network ports.
+ *
+ * In TCP server mode, the driver listens for inbound connections instead of
+ * connecting to a remote host. Each connection gets its own frame buffer and
+ * the frames of every device are optionally tagged with the name of the
+ * device, so that each device gets its own set of datasets.
  */
 class Network : public HAL_Driver
 {
@@ -95,6 +101,20 @@ class Network : public HAL_Driver
                READ udpIgnoreFrameSequences
                WRITE setUdpIgnoreFrameSequences
                NOTIFY udpIgnoreFrameSequencesChanged)
+    Q_PROPERTY(bool tcpServerMode
+               READ tcpServerMode
+               NOTIFY socketTypeChanged)
+    Q_PROPERTY(QString tcpServerAddress
+               READ tcpServerAddress
+               WRITE setTcpServerAddress
+               NOTIFY tcpServerAddressChanged)
+    Q_PROPERTY(bool tcpServerTagFrames
+               READ tcpServerTagFrames
+               WRITE setTcpServerTagFrames
+               NOTIFY tcpServerTagFramesChanged)
+    Q_PROPERTY(int tcpServerConnections
+               READ tcpServerConnections
+               NOTIFY tcpServerConnectionsChanged)
   // clang-format on
 
 Q_SIGNALS:
@@ -103,6 +123,9 @@ Q_SIGNALS:
   void socketTypeChanged();
   void udpMulticastChanged();
   void lookupActiveChanged();
+  void tcpServerAddressChanged();
+  void tcpServerTagFramesChanged();
+  void tcpServerConnectionsChanged();
   void udpIgnoreFrameSequencesChanged();
 
 private:
@@ -127,6 +150,7 @@ public:
   bool open(const QIODevice::OpenMode mode) override;
 
   QString remoteAddress() const;
+  QString tcpServerAddress() const;
 
   quint16 tcpPort() const;
   quint16 udpLocalPort() const;
@@ -134,7 +158,10 @@ public:
 
   bool udpMulticast() const;
   bool lookupActive() const;
+  bool tcpServerMode() const;
   int socketTypeIndex() const;
+  bool tcpServerTagFrames() const;
+  int tcpServerConnections() const;
   StringList socketTypes() const;
   bool udpIgnoreFrameSequences() const;
   QAbstractSocket::SocketType socketType() const;
@@ -150,6 +177,7 @@ public:
 public Q_SLOTS:
   void setTcpSocket();
   void setUdpSocket();
+  void setTcpServer();
   void lookup(const QString &host);
   void setTcpPort(const quint16 port);
   void setUdpLocalPort(const quint16 port);
@@ -157,11 +185,15 @@ public Q_SLOTS:
   void setSocketTypeIndex(const int index);
   void setUdpRemotePort(const quint16 port);
   void setRemoteAddress(const QString &address);
+  void setTcpServerAddress(const QString &address);
+  void setTcpServerTagFrames(const bool tagFrames);
   void setUdpIgnoreFrameSequences(const bool ignore);
   void setSocketType(const QAbstractSocket::SocketType type);
 
 private Q_SLOTS:
   void onReadyRead();
+  void onServerFramesReceived(const QString &device,
+                              const QByteArrayList &frames);
   void lookupFinished(const QHostInfo &info);
   void onErrorOccurred(const QAbstractSocket::SocketError socketError);
 
@@ -171,13 +203,17 @@ private:
   bool m_hostExists;
   bool m_udpMulticast;
   bool m_lookupActive;
+  bool m_tcpServerMode;
+  bool m_tcpServerTagFrames;
   quint16 m_udpLocalPort;
   quint16 m_udpRemotePort;
+  QString m_tcpServerAddress;
   bool m_udpIgnoreFrameSequences;
   QAbstractSocket::SocketType m_socketType;
 
   QTcpSocket m_tcpSocket;
   QUdpSocket m_udpSocket;
+  TcpServer m_tcpServer;
 };
 } // namespace Drivers
 } // namespace IO
@@ -0,0 +1,480 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <IO/Drivers/Pipe.h>
+#include <Misc/Utilities.h>
+
+#include <QFile>
+#include <QFileInfo>
+
+#include <cerrno>
+#include <cstring>
+
+#ifdef Q_OS_WIN
+#  include <io.h>
+#  include <windows.h>
+#else
+#  include <poll.h>
+#  include <fcntl.h>
+#  include <unistd.h>
+#  include <sys/stat.h>
+#endif
+
+/**
+ * Time (in milliseconds) that the reader waits for data before checking if
+ * it has been stopped.
+ */
+static constexpr int kPollTimeout = 50;
+
+/**
+ * Value used for handles that are not open
+ */
+static constexpr qintptr kInvalidHandle = -1;
+
+//----------------------------------------------------------------------------------------
+// Reader implementation
+//----------------------------------------------------------------------------------------
+
+/**
+ * Constructor function, the reader does not take ownership of @a handle
+ */
+IO::Drivers::PipeReader::PipeReader(const qintptr handle)
+  : m_handle(handle)
+  , m_stop(false)
+  , m_pending(0)
+{
+}
+
+/**
+ * Asks the reader loop to return, can be called from any thread
+ */
+void IO::Drivers::PipeReader::stop()
+{
+  m_stop.store(true);
+}
+
+/**
+ * Registers that the given number of @a bytes have been processed by the
+ * GUI thread, can be called from any thread.
+ */
+void IO::Drivers::PipeReader::acknowledge(const qint64 bytes)
+{
+  m_pending.fetch_sub(bytes);
+}
+
+/**
+ * Reads the pipe until the reader is stopped or until the end of the data
+ * is reached, in which case the @c finished() signal is emitted.
+ */
+void IO::Drivers::PipeReader::run()
+{
+  QByteArray buffer(kReadSize, Qt::Uninitialized);
+
+#ifdef Q_OS_WIN
+  const auto handle = reinterpret_cast<HANDLE>(m_handle);
+  const bool pipe = GetFileType(handle) == FILE_TYPE_PIPE;
+#else
+  const auto fd = static_cast<int>(m_handle);
+#endif
+
+  while (!m_stop.load())
+  {
+    // Let the GUI thread catch up, the producer blocks when the pipe is full
+    if (m_pending.load() > kMaxPending)
+    {
+      QThread::msleep(1);
+      continue;
+    }
+
+#ifdef Q_OS_WIN
+    // Wait for data (anonymous & named pipes cannot be waited on)
+    DWORD available = kReadSize;
+    if (pipe)
+    {
+      if (!PeekNamedPipe(handle, NULL, 0, NULL, &available, NULL))
+        break;
+
+      if (available == 0)
+      {
+        QThread::msleep(1);
+        continue;
+      }
+    }
+
+    // Read available data
+    DWORD bytes = 0;
+    const auto size = qMin<DWORD>(available, kReadSize);
+    if (!ReadFile(handle, buffer.data(), size, &bytes, NULL) || bytes == 0)
+      break;
+#else
+    // Wait for data
+    pollfd request;
+    request.fd = fd;
+    request.events = POLLIN;
+    request.revents = 0;
+    const int ready = ::poll(&request, 1, kPollTimeout);
+    if (ready < 0 && errno != EINTR)
+      break;
+    if (ready <= 0)
+      continue;
+
+    // Read available data, a value of 0 means that the writer closed the pipe
+    const auto bytes = ::read(fd, buffer.data(), kReadSize);
+    if (bytes < 0 && (errno == EAGAIN || errno == EINTR))
+      continue;
+    if (bytes <= 0)
+      break;
+#endif
+
+    // Send data to the GUI thread
+    m_pending.fetch_add(bytes);
+    Q_EMIT dataRead(QByteArray(buffer.constData(), bytes));
+  }
+
+  if (!m_stop.load())
+    Q_EMIT finished();
+}
+
+//----------------------------------------------------------------------------------------
+// Constructor/destructor & singleton access functions
+//----------------------------------------------------------------------------------------
+
+/**
+ * Constructor function
+ */
+IO::Drivers::Pipe::Pipe()
+  : m_isOpen(false)
+  , m_ownsHandle(false)
+  , m_flags(0)
+  , m_handle(kInvalidHandle)
+  , m_writeHandle(kInvalidHandle)
+  , m_reader(Q_NULLPTR)
+{
+  m_thread.setObjectName(QStringLiteral("Pipe Reader"));
+}
+
+/**
+ * Destructor function, stops the reader thread
+ */
+IO::Drivers::Pipe::~Pipe()
+{
+  close();
+}
+
+/**
+ * Returns the only instance of the class
+ */
+IO::Drivers::Pipe &IO::Drivers::Pipe::instance()
+{
+  static Pipe singleton;
+  return singleton;
+}
+
+//----------------------------------------------------------------------------------------
+// HAL-driver implementation
+//----------------------------------------------------------------------------------------
+
+/**
+ * Stops the reader thread & closes the pipe
+ */
+void IO::Drivers::Pipe::close()
+{
+  // Stop the reader thread
+  if (m_reader)
+  {
+    m_reader->stop();
+    m_thread.quit();
+    m_thread.wait();
+    m_reader = Q_NULLPTR;
+  }
+
+  // Close the pipe, or restore the flags of inherited descriptors
+  if (m_handle != kInvalidHandle)
+  {
+#ifdef Q_OS_WIN
+    if (m_ownsHandle)
+      CloseHandle(reinterpret_cast<HANDLE>(m_handle));
+#else
+    if (m_ownsHandle)
+      ::close(static_cast<int>(m_handle));
+    else
+      ::fcntl(static_cast<int>(m_handle), F_SETFL, m_flags);
+#endif
+  }
+
+  m_isOpen = false;
+  m_ownsHandle = false;
+  m_handle = kInvalidHandle;
+  m_writeHandle = kInvalidHandle;
+}
+
+/**
+ * Returns @c true if the pipe is open
+ */
+bool IO::Drivers::Pipe::isOpen() const
+{
+  return m_isOpen;
+}
+
+/**
+ * Returns @c true if the pipe is open
+ */
+bool IO::Drivers::Pipe::isReadable() const
+{
+  return isOpen();
+}
+
+/**
+ * Returns @c true if data can be sent to the source (character devices, such
+ * as PTYs).
+ */
+bool IO::Drivers::Pipe::isWritable() const
+{
+  return isOpen() && m_writeHandle != kInvalidHandle;
+}
+
+/**
+ * Returns @c true if the standard input or an inherited file descriptor is
+ * used, or if the given path exists.
+ */
+bool IO::Drivers::Pipe::configurationOk() const
+{
+  return usesStdin() || descriptor() >= 0 || QFileInfo::exists(m_path);
+}
+
+/**
+ * Writes the given @a data to the source
+ *
+ * @returns the number of bytes written
+ */
+quint64 IO::Drivers::Pipe::write(const QByteArray &data)
+{
+  if (!isWritable())
+    return 0;
+
+#ifdef Q_OS_WIN
+  DWORD bytes = 0;
+  const auto handle = reinterpret_cast<HANDLE>(m_writeHandle);
+  if (!WriteFile(handle, data.constData(), data.size(), &bytes, NULL))
+    return 0;
+#else
+  const auto fd = static_cast<int>(m_writeHandle);
+  const auto bytes = ::write(fd, data.constData(), data.size());
+  if (bytes <= 0)
+    return 0;
+#endif
+
+  Q_EMIT dataSent(data.left(bytes));
+  return bytes;
+}
+
+/**
+ * Opens the pipe & starts the reader thread
+ */
+bool IO::Drivers::Pipe::open(const QIODevice::OpenMode mode)
+{
+  Q_UNUSED(mode);
+
+  // Stop previous session
+  close();
+
+  // Validate configuration
+  if (!configurationOk())
+    return false;
+
+  // Open the source
+  const auto fd = descriptor();
+  const auto name = QFile::encodeName(m_path);
+  m_ownsHandle = !usesStdin() && fd < 0;
+#ifdef Q_OS_WIN
+  if (usesStdin())
+    m_handle = reinterpret_cast<qintptr>(GetStdHandle(STD_INPUT_HANDLE));
+
+  else if (fd >= 0)
+    m_handle = _get_osfhandle(fd);
+
+  else
+  {
+    const auto path = reinterpret_cast<LPCWSTR>(m_path.utf16());
+    const auto handle = CreateFileW(path, GENERIC_READ,
+                                    FILE_SHARE_READ | FILE_SHARE_WRITE, NULL,
+                                    OPEN_EXISTING, 0, NULL);
+    if (handle != INVALID_HANDLE_VALUE)
+      m_handle = reinterpret_cast<qintptr>(handle);
+  }
+#else
+  if (usesStdin())
+    m_handle = STDIN_FILENO;
+
+  else if (fd >= 0)
+    m_handle = fd;
+
+  else
+  {
+    // FIFOs are opened in read/write mode, so that they never report the end
+    // of the data when a producer exits, and character devices (PTYs) are
+    // opened in read/write mode to be able to send data to them
+    struct stat info;
+    bool fifo = false;
+    bool device = false;
+    if (::stat(name.constData(), &info) == 0)
+    {
+      fifo = S_ISFIFO(info.st_mode);
+      device = S_ISCHR(info.st_mode);
+    }
+
+    const int flags = (fifo || device) ? O_RDWR : O_RDONLY;
+    const int handle = ::open(name.constData(), flags | O_NOCTTY);
+    if (handle >= 0)
+    {
+      m_handle = handle;
+      if (device)
+        m_writeHandle = handle;
+    }
+  }
+
+  // Enable non-blocking reads (original flags are restored when closed)
+  if (m_handle != kInvalidHandle)
+  {
+    const auto handle = static_cast<int>(m_handle);
+    m_flags = ::fcntl(handle, F_GETFL);
+    ::fcntl(handle, F_SETFL, m_flags | O_NONBLOCK);
+  }
+#endif
+
+  // Report errors
+  if (m_handle == kInvalidHandle)
+  {
+    m_ownsHandle = false;
+    m_writeHandle = kInvalidHandle;
+    Misc::Utilities::showMessageBox(tr("Cannot open \"%1\"").arg(m_path),
+                                    QString::fromLocal8Bit(strerror(errno)));
+    return false;
+  }
+
+  // Start the reader thread
+  m_reader = new PipeReader(m_handle);
+  m_reader->moveToThread(&m_thread);
+
+  // clang-format off
+  connect(&m_thread, &QThread::started,
+          m_reader, &IO::Drivers::PipeReader::run);
+  connect(&m_thread, &QThread::finished,
+          m_reader, &QObject::deleteLater);
+  connect(m_reader, &IO::Drivers::PipeReader::dataRead,
+          this, &IO::Drivers::Pipe::onDataRead);
+  connect(m_reader, &IO::Drivers::PipeReader::finished,
+          this, &IO::Drivers::Pipe::onFinished);
+  // clang-format on
+
+  m_thread.start(QThread::HighestPriority);
+  m_isOpen = true;
+  return true;
+}
+
+//----------------------------------------------------------------------------------------
+// Driver specifics
+//----------------------------------------------------------------------------------------
+
+/**
+ * Returns the path of the pipe, PTY or file to read. An empty path (or "-")
+ * selects the standard input, and "fd:N" selects an inherited file
+ * descriptor.
+ */
+QString IO::Drivers::Pipe::path() const
+{
+  return m_path;
+}
+
+/**
+ * Returns @c true if data is piped into the standard input of the application
+ * or if the standard input is redirected from a file. Other inputs, such as
+ * terminals, @c /dev/null or the closed input of a service, return @c false.
+ */
+bool IO::Drivers::Pipe::stdinRedirected()
+{
+#ifdef Q_OS_WIN
+  const auto type = GetFileType(GetStdHandle(STD_INPUT_HANDLE));
+  return type == FILE_TYPE_PIPE || type == FILE_TYPE_DISK;
+#else
+  struct stat info;
+  if (::fstat(STDIN_FILENO, &info) != 0)
+    return false;
+
+  return S_ISFIFO(info.st_mode) || S_ISREG(info.st_mode);
+#endif
+}
+
+/**
+ * Changes the path of the pipe, PTY or file to read
+ */
+void IO::Drivers::Pipe::setPath(const QString &path)
+{
+  m_path = path.trimmed();
+  Q_EMIT pathChanged();
+  Q_EMIT configurationChanged();
+}
+
+/**
+ * Called when the producer closes the pipe (or when the end of the file is
+ * reached), the reader thread is stopped when the driver is closed.
+ */
+void IO::Drivers::Pipe::onFinished()
+{
+  if (sender() == m_reader)
+    Q_EMIT finished();
+}
+
+/**
+ * Sends the @a data read by the reader thread to the I/O manager
+ */
+void IO::Drivers::Pipe::onDataRead(const QByteArray &data)
+{
+  if (sender() != m_reader)
+    return;
+
+  Q_EMIT dataReceived(data);
+  if (m_reader)
+    m_reader->acknowledge(data.size());
+}
+
+/**
+ * Returns @c true if the standard input shall be read
+ */
+bool IO::Drivers::Pipe::usesStdin() const
+{
+  return m_path.isEmpty() || m_path == QStringLiteral("-");
+}
+
+/**
+ * Returns the file descriptor given with the "fd:N" syntax, or -1 if the
+ * path does not use this syntax.
+ */
+int IO::Drivers::Pipe::descriptor() const
+{
+  if (!m_path.startsWith(QStringLiteral("fd:")))
+    return -1;
+
+  bool ok;
+  const auto fd = m_path.mid(3).toInt(&ok);
+  return ok && fd >= 0 ? fd : -1;
+}
@@ -0,0 +1,154 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <QObject>
+#include <QThread>
+#include <IO/HAL_Driver.h>
+
+#include <atomic>
+
+namespace IO
+{
+namespace Drivers
+{
+/**
+ * @brief The PipeReader class
+ *
+ * Lives in the pipe reader thread & reads the pipe with large non-blocking
+ * reads. Reading pauses while too much data is waiting to be processed by
+ * the GUI thread, which fills the pipe buffer & blocks the producer instead
+ * of growing the memory usage of the application.
+ */
+class PipeReader : public QObject
+{
+  Q_OBJECT
+
+Q_SIGNALS:
+  void finished();
+  void dataRead(const QByteArray &data);
+
+public:
+  PipeReader(const qintptr handle);
+
+  static constexpr int kReadSize = 256 * 1024;
+  static constexpr qint64 kMaxPending = 16 * 1024 * 1024;
+
+  void stop();
+  void acknowledge(const qint64 bytes);
+
+public Q_SLOTS:
+  void run();
+
+private:
+  qintptr m_handle;
+  std::atomic<bool> m_stop;
+  std::atomic<qint64> m_pending;
+};
+
+/**
+ * @brief The Pipe class
+ *
+ * Serial Studio driver that reads data from a local producer process, which
+ * avoids the per-datagram overhead of the network driver. The source can be:
+ *
+ * - The standard input of Serial Studio (empty path or "-"), so that the
+ *   output of a process can be piped directly into the headless mode.
+ * - A named pipe (FIFO), which is kept open when the producer exits, so that
+ *   several producers can write to it one after the other.
+ * - A PTY or any other character device, written data is sent to it.
+ * - An inherited file descriptor ("fd:N").
+ * - A regular file, which is read until its end.
+ *
+ * Data is read by a dedicated thread & sent to the I/O manager in the same
+ * chunks that were read. The standard input is read-only, since the standard
+ * output is used for the log of the application.
+ */
+class Pipe : public HAL_Driver
+{
+  // clang-format off
+    Q_OBJECT
+    Q_PROPERTY(QString path
+               READ path
+               WRITE setPath
+               NOTIFY pathChanged)
+  // clang-format on
+
+Q_SIGNALS:
+  void finished();
+  void pathChanged();
+
+private:
+  explicit Pipe();
+  Pipe(Pipe &&) = delete;
+  Pipe(const Pipe &) = delete;
+  Pipe &operator=(Pipe &&) = delete;
+  Pipe &operator=(const Pipe &) = delete;
+
+  ~Pipe();
+
+public:
+  static Pipe &instance();
+
+  //
+  // HAL functions
+  //
+  void close() override;
+  bool isOpen() const override;
+  bool isReadable() const override;
+  bool isWritable() const override;
+  bool configurationOk() const override;
+  quint64 write(const QByteArray &data) override;
+  bool open(const QIODevice::OpenMode mode) override;
+
+  //
+  // Driver specifics
+  //
+  QString path() const;
+  static bool stdinRedirected();
+
+public Q_SLOTS:
+  void setPath(const QString &path);
+
+private Q_SLOTS:
+  void onFinished();
+  void onDataRead(const QByteArray &data);
+
+private:
+  bool usesStdin() const;
+  int descriptor() const;
+
+private:
+  bool m_isOpen;
+  bool m_ownsHandle;
+  QString m_path;
+
+  int m_flags;
+  qintptr m_handle;
+  qintptr m_writeHandle;
+
+  QThread m_thread;
+  PipeReader *m_reader;
+};
+} // namespace Drivers
+} // namespace IO
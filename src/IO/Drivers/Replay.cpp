@@ -0,0 +1,401 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <IO/Manager.h>
+#include <IO/Recorder.h>
+#include <IO/Drivers/Replay.h>
+
+#include <Misc/Utilities.h>
+#include <Misc/TimerEvents.h>
+
+#include <QDir>
+#include <QFileInfo>
+#include <QJsonObject>
+#include <QFileDialog>
+#include <QCoreApplication>
+
+/**
+ * Maximum number of chunks sent on each event loop iteration, so that the
+ * user interface stays responsive when replaying large captures at high
+ * speeds.
+ */
+static constexpr int kMaxChunksPerTick = 256;
+
+//----------------------------------------------------------------------------------------
+// Constructor/destructor & singleton access functions
+//----------------------------------------------------------------------------------------
+
+/**
+ * Constructor function
+ */
+IO::Drivers::Replay::Replay()
+  : m_loop(false)
+  , m_isOpen(false)
+  , m_fullSpeed(false)
+  , m_speed(1)
+  , m_pending(false)
+  , m_dataOffset(0)
+  , m_position(0)
+  , m_lastTick(0)
+  , m_nextTime(0)
+  , m_replayedChunks(0)
+{
+  // Configure replay timer
+  m_timer.setTimerType(Qt::PreciseTimer);
+
+  // clang-format off
+  connect(&m_timer, &QTimer::timeout,
+          this, &IO::Drivers::Replay::replayChunks);
+  connect(&Misc::TimerEvents::instance(), &Misc::TimerEvents::timeout10Hz,
+          this, &IO::Drivers::Replay::updateStatistics);
+  // clang-format on
+}
+
+/**
+ * Returns the only instance of the class
+ */
+IO::Drivers::Replay &IO::Drivers::Replay::instance()
+{
+  static Replay singleton;
+  return singleton;
+}
+
+//----------------------------------------------------------------------------------------
+// HAL-driver implementation
+//----------------------------------------------------------------------------------------
+
+/**
+ * Stops the replay & closes the capture file
+ */
+void IO::Drivers::Replay::close()
+{
+  m_timer.stop();
+  m_file.close();
+  m_nextChunk.clear();
+  m_pending = false;
+  m_isOpen = false;
+}
+
+/**
+ * Returns @c true if a capture file is being replayed
+ */
+bool IO::Drivers::Replay::isOpen() const
+{
+  return m_isOpen;
+}
+
+/**
+ * Returns @c true if a capture file is being replayed
+ */
+bool IO::Drivers::Replay::isReadable() const
+{
+  return isOpen();
+}
+
+/**
+ * Returns @c true if a capture file is being replayed, written data is
+ * discarded.
+ */
+bool IO::Drivers::Replay::isWritable() const
+{
+  return isOpen();
+}
+
+/**
+ * Returns @c true if the selected capture file exists & the replay speed is
+ * valid.
+ */
+bool IO::Drivers::Replay::configurationOk() const
+{
+  const auto exists = QFileInfo(m_filePath).isFile();
+  return exists && (fullSpeed() || speed() > 0);
+}
+
+/**
+ * Discards the given @a data and returns its length, as if it had been
+ * written to the original device.
+ */
+quint64 IO::Drivers::Replay::write(const QByteArray &data)
+{
+  if (isWritable())
+  {
+    Q_EMIT dataSent(data);
+    return data.length();
+  }
+
+  return 0;
+}
+
+/**
+ * Opens the capture file, validates its header & starts the replay.
+ */
+bool IO::Drivers::Replay::open(const QIODevice::OpenMode mode)
+{
+  Q_UNUSED(mode);
+
+  // Stop previous session
+  close();
+
+  // Validate configuration
+  if (!configurationOk())
+    return false;
+
+  // Open the capture file, validate its header & read the first chunk
+  QJsonObject metadata;
+  m_file.setFileName(m_filePath);
+  bool valid = m_file.open(QFile::ReadOnly);
+  valid = valid && IO::Recorder::readHeader(m_file, metadata);
+  m_dataOffset = m_file.pos();
+  if (!valid || !rewind())
+  {
+    m_file.close();
+    Misc::Utilities::showMessageBox(
+        tr("Invalid capture file"),
+        tr("%1 is not a raw data capture, or it is empty").arg(m_filePath));
+    return false;
+  }
+
+  // Frames are only extracted correctly with the sequences of the recording
+  const auto &manager = IO::Manager::instance();
+  if (metadata.value("start").toString() != manager.startSequence()
+      || metadata.value("finish").toString() != manager.finishSequence()
+      || metadata.value("separator").toString() != manager.separatorSequence())
+    Misc::Utilities::showMessageBox(
+        tr("Frame sequences differ from the recording"),
+        tr("%1 was recorded with start \"%2\", finish \"%3\" and separator "
+           "\"%4\" sequences, frames may not be extracted correctly")
+            .arg(m_filePath, metadata.value("start").toString(),
+                 metadata.value("finish").toString(),
+                 metadata.value("separator").toString()));
+
+  // Reset statistics
+  m_replayedChunks = 0;
+
+  // Start the timer
+  if (fullSpeed())
+    m_timer.start(0);
+  else
+    m_timer.start(1);
+
+  // Update internal state
+  m_isOpen = true;
+  Q_EMIT statisticsChanged();
+  return true;
+}
+
+//----------------------------------------------------------------------------------------
+// Driver specifics
+//----------------------------------------------------------------------------------------
+
+/**
+ * Returns @c true if the capture shall be replayed again when the end of the
+ * file is reached.
+ */
+bool IO::Drivers::Replay::loop() const
+{
+  return m_loop;
+}
+
+/**
+ * Returns the replay speed factor (1 = same speed as the recording)
+ */
+double IO::Drivers::Replay::speed() const
+{
+  return m_speed;
+}
+
+/**
+ * Returns @c true if the capture shall be replayed as fast as possible
+ */
+bool IO::Drivers::Replay::fullSpeed() const
+{
+  return m_fullSpeed;
+}
+
+/**
+ * Returns the fraction of the capture file that has been replayed (0 to 1)
+ */
+double IO::Drivers::Replay::progress() const
+{
+  if (!m_file.isOpen() || m_file.size() <= m_dataOffset)
+    return 0;
+
+  const auto position = m_file.pos() - m_dataOffset;
+  return static_cast<double>(position) / (m_file.size() - m_dataOffset);
+}
+
+/**
+ * Returns the path of the capture file
+ */
+QString IO::Drivers::Replay::filePath() const
+{
+  return m_filePath;
+}
+
+/**
+ * Returns the number of chunks sent since the driver was opened
+ */
+quint64 IO::Drivers::Replay::replayedChunks() const
+{
+  return m_replayedChunks;
+}
+
+/**
+ * Lets the user select a capture file
+ */
+void IO::Drivers::Replay::selectFile()
+{
+  // clang-format off
+  const auto path = QStringLiteral("%1/Documents/%2/Raw")
+                    .arg(QDir::homePath(), qApp->applicationName());
+  const auto file = QFileDialog::getOpenFileName(
+                    Q_NULLPTR,
+                    tr("Select raw data capture"),
+                    path,
+                    tr("Raw data captures") + " (*.ssraw)");
+  // clang-format on
+
+  if (!file.isEmpty())
+    setFilePath(file);
+}
+
+/**
+ * Enables or disables replaying the capture in a loop
+ */
+void IO::Drivers::Replay::setLoop(const bool enabled)
+{
+  m_loop = enabled;
+  Q_EMIT loopChanged();
+}
+
+/**
+ * Changes the replay speed factor, the position within the capture is kept
+ * when the speed is changed during a replay.
+ */
+void IO::Drivers::Replay::setSpeed(const double speed)
+{
+  m_speed = qBound(0.01, speed, 1000.0);
+  Q_EMIT speedChanged();
+  Q_EMIT configurationChanged();
+}
+
+/**
+ * Enables or disables the full-speed mode
+ */
+void IO::Drivers::Replay::setFullSpeed(const bool enabled)
+{
+  m_fullSpeed = enabled;
+
+  if (isOpen())
+  {
+    m_lastTick = m_clock.nsecsElapsed();
+    if (m_timer.isActive())
+      m_timer.setInterval(enabled ? 0 : 1);
+  }
+
+  Q_EMIT fullSpeedChanged();
+  Q_EMIT configurationChanged();
+}
+
+/**
+ * Changes the path of the capture file to replay
+ */
+void IO::Drivers::Replay::setFilePath(const QString &path)
+{
+  m_filePath = path;
+  Q_EMIT filePathChanged();
+  Q_EMIT configurationChanged();
+}
+
+/**
+ * Sends the chunks whose (scaled) reception time has elapsed since the last
+ * call, or a fixed batch of chunks in full-speed mode, to the I/O manager.
+ * Chunks are sent one by one, so that the I/O manager receives the same
+ * reads that the original device produced.
+ */
+void IO::Drivers::Replay::replayChunks()
+{
+  // Driver not open, abort
+  if (!isOpen())
+    return;
+
+  // Advance the replay position by the elapsed (scaled) time
+  if (!fullSpeed())
+  {
+    const auto now = m_clock.nsecsElapsed();
+    m_position += static_cast<qint64>((now - m_lastTick) * m_speed);
+    m_lastTick = now;
+  }
+
+  // Send the chunks that are due
+  int count = 0;
+  while (isOpen() && m_pending && count < kMaxChunksPerTick)
+  {
+    if (fullSpeed())
+      m_position = qMax(m_position, m_nextTime);
+    else if (m_nextTime > m_position)
+      break;
+
+    const auto chunk = m_nextChunk;
+    m_pending = IO::Recorder::readChunk(m_file, m_nextTime, m_nextChunk);
+
+    ++count;
+    ++m_replayedChunks;
+    Q_EMIT dataReceived(chunk);
+  }
+
+  // End of capture reached, start again or stop the timer
+  if (isOpen() && !m_pending)
+  {
+    if (!m_loop || !rewind())
+    {
+      m_timer.stop();
+      Q_EMIT statisticsChanged();
+      Q_EMIT finished();
+    }
+  }
+}
+
+/**
+ * Notifies the user interface about the replay progress
+ */
+void IO::Drivers::Replay::updateStatistics()
+{
+  if (isOpen())
+    Q_EMIT statisticsChanged();
+}
+
+/**
+ * Moves to the first chunk of the capture file & resets the replay clock.
+ *
+ * @returns @c false if the capture file does not contain any chunk
+ */
+bool IO::Drivers::Replay::rewind()
+{
+  m_position = 0;
+  m_lastTick = 0;
+  m_clock.start();
+
+  m_file.seek(m_dataOffset);
+  m_pending = IO::Recorder::readChunk(m_file, m_nextTime, m_nextChunk);
+  return m_pending;
+}
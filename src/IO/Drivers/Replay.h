@@ -0,0 +1,153 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <QFile>
+#include <QTimer>
+#include <QObject>
+#include <QElapsedTimer>
+#include <IO/HAL_Driver.h>
+
+namespace IO
+{
+namespace Drivers
+{
+/**
+ * @brief The Replay class
+ *
+ * Serial Studio driver that replays a raw data capture (recorded by the
+ * @c IO::Recorder class) through the complete data pipeline. Each chunk is
+ * sent to the I/O manager exactly as it was received from the original
+ * device, and at the same relative time, so that timing-dependent issues
+ * (frames split across reads, bursts, gaps...) can be reproduced without
+ * the hardware.
+ *
+ * The replay speed can be scaled (e.g. 10x), or the capture can be replayed
+ * as fast as the event loop allows with the @c fullSpeed() mode, which turns
+ * any recorded session into a repeatable benchmark input.
+ *
+ * The frame sequences & project are not changed when a capture is opened,
+ * they must match the ones used while recording.
+ */
+class Replay : public HAL_Driver
+{
+  // clang-format off
+    Q_OBJECT
+    Q_PROPERTY(QString filePath
+               READ filePath
+               WRITE setFilePath
+               NOTIFY filePathChanged)
+    Q_PROPERTY(double speed
+               READ speed
+               WRITE setSpeed
+               NOTIFY speedChanged)
+    Q_PROPERTY(bool fullSpeed
+               READ fullSpeed
+               WRITE setFullSpeed
+               NOTIFY fullSpeedChanged)
+    Q_PROPERTY(bool loop
+               READ loop
+               WRITE setLoop
+               NOTIFY loopChanged)
+    Q_PROPERTY(double progress
+               READ progress
+               NOTIFY statisticsChanged)
+    Q_PROPERTY(quint64 replayedChunks
+               READ replayedChunks
+               NOTIFY statisticsChanged)
+  // clang-format on
+
+Q_SIGNALS:
+  void finished();
+  void loopChanged();
+  void speedChanged();
+  void filePathChanged();
+  void fullSpeedChanged();
+  void statisticsChanged();
+
+private:
+  explicit Replay();
+  Replay(Replay &&) = delete;
+  Replay(const Replay &) = delete;
+  Replay &operator=(Replay &&) = delete;
+  Replay &operator=(const Replay &) = delete;
+
+public:
+  static Replay &instance();
+
+  //
+  // HAL functions
+  //
+  void close() override;
+  bool isOpen() const override;
+  bool isReadable() const override;
+  bool isWritable() const override;
+  bool configurationOk() const override;
+  quint64 write(const QByteArray &data) override;
+  bool open(const QIODevice::OpenMode mode) override;
+
+  //
+  // Driver specifics
+  //
+  bool loop() const;
+  double speed() const;
+  bool fullSpeed() const;
+  double progress() const;
+  QString filePath() const;
+  quint64 replayedChunks() const;
+
+public Q_SLOTS:
+  void selectFile();
+  void setLoop(const bool enabled);
+  void setSpeed(const double speed);
+  void setFullSpeed(const bool enabled);
+  void setFilePath(const QString &path);
+
+private Q_SLOTS:
+  void replayChunks();
+  void updateStatistics();
+
+private:
+  bool rewind();
+
+private:
+  bool m_loop;
+  bool m_isOpen;
+  bool m_fullSpeed;
+  double m_speed;
+  QString m_filePath;
+
+  QFile m_file;
+  QTimer m_timer;
+  QElapsedTimer m_clock;
+
+  bool m_pending;
+  qint64 m_dataOffset;
+  qint64 m_position;
+  qint64 m_lastTick;
+  qint64 m_nextTime;
+  QByteArray m_nextChunk;
+  quint64 m_replayedChunks;
+};
+} // namespace Drivers
+} // namespace IO
@@ -26,6 +26,11 @@
 #include <Misc/Utilities.h>
 #include <Misc/TimerEvents.h>
 
+#ifdef Q_OS_LINUX
+#  include <sys/ioctl.h>
+#  include <linux/serial.h>
+#endif
+
 //----------------------------------------------------------------------------------------
 // Constructor/destructor & singleton access functions
 //----------------------------------------------------------------------------------------
@@ -35,7 +40,10 @@
  */
 IO::Drivers::Serial::Serial()
   : m_port(Q_NULLPTR)
+  , m_lowLatency(false)
   , m_autoReconnect(false)
+  , m_dedicatedReader(false)
+  , m_readBufferSize(0)
   , m_lastSerialDeviceIndex(0)
   , m_portIndex(0)
 {
@@ -73,6 +81,8 @@ IO::Drivers::Serial::~Serial()
 
   if (port())
     disconnectDevice();
+
+  stopDedicatedReader();
 }
 
 /**
@@ -94,7 +104,7 @@ IO::Drivers::Serial &IO::Drivers::Serial::instance()
 void IO::Drivers::Serial::close()
 {
   if (isOpen())
-    port()->close();
+    runInPortThread([=]() { port()->close(); });
 }
 
 /**
@@ -146,7 +156,11 @@ bool IO::Drivers::Serial::configurationOk() const
 quint64 IO::Drivers::Serial::write(const QByteArray &data)
 {
   if (isWritable())
-    return port()->write(data);
+  {
+    qint64 bytes = -1;
+    runInPortThread([&]() { bytes = port()->write(data); });
+    return bytes;
+  }
 
   return -1;
 }
@@ -185,8 +199,18 @@ bool IO::Drivers::Serial::open(const QIODevice::OpenMode mode)
     // Open device
     if (port()->open(mode))
     {
-      connect(port(), &QIODevice::readyRead, this,
-              &IO::Drivers::Serial::onReadyRead);
+      // Apply buffering & latency tweaks
+      port()->setReadBufferSize(readBufferSize());
+      if (lowLatency())
+        configureLowLatency();
+
+      // Read incoming data from the GUI thread or from a dedicated thread
+      if (dedicatedReader())
+        startDedicatedReader();
+      else
+        connect(port(), &QIODevice::readyRead, this,
+                &IO::Drivers::Serial::onReadyRead);
+
       return true;
     }
   }
@@ -227,6 +251,46 @@ bool IO::Drivers::Serial::autoReconnect() const
   return m_autoReconnect;
 }
 
+/**
+ * Returns @c true if the low-latency mode shall be applied to the serial port
+ * when opening it.
+ */
+bool IO::Drivers::Serial::lowLatency() const
+{
+  return m_lowLatency;
+}
+
+/**
+ * Returns @c true if incoming data shall be read from a dedicated thread
+ * instead of the GUI thread.
+ */
+bool IO::Drivers::Serial::dedicatedReader() const
+{
+  return m_dedicatedReader;
+}
+
+/**
+ * Returns the size of the internal read buffer of the serial port, a value of
+ * 0 means that the buffer is unlimited.
+ */
+qint64 IO::Drivers::Serial::readBufferSize() const
+{
+  return m_readBufferSize;
+}
+
+/**
+ * Returns @c true if the current operating system supports the low-latency
+ * tweaks applied by @c configureLowLatency().
+ */
+bool IO::Drivers::Serial::lowLatencySupported() const
+{
+#ifdef Q_OS_LINUX
+  return true;
+#else
+  return false;
+#endif
+}
+
 /**
  * Returns the index of the current serial device selected by the program.
  */
@@ -397,8 +461,14 @@ void IO::Drivers::Serial::disconnectDevice()
     port()->disconnect(this, SLOT(handleError(QSerialPort::SerialPortError)));
 
     // Close & delete serial port handler
-    port()->close();
-    port()->deleteLater();
+    auto serial = port();
+    runInPortThread([=]() {
+      serial->close();
+      serial->deleteLater();
+    });
+
+    // Stop reader thread (pending deletions are processed before it exits)
+    stopDedicatedReader();
   }
 
   // Reset pointer
@@ -419,8 +489,7 @@ void IO::Drivers::Serial::setBaudRate(const qint32 rate)
   m_baudRate = rate;
 
   // Update serial port config
-  if (port())
-    port()->setBaudRate(baudRate());
+  runInPortThread([=]() { port()->setBaudRate(baudRate()); });
 
   // Update user interface
   Q_EMIT baudRateChanged();
@@ -441,6 +510,31 @@ void IO::Drivers::Serial::setPortIndex(const quint8 portIndex)
   Q_EMIT portIndexChanged();
 }
 
+/**
+ * Selects the serial device with the given @a portName (e.g. "ttyUSB0" or
+ * "/dev/ttyUSB0"), returns @c false if the device is not available.
+ */
+bool IO::Drivers::Serial::setPortName(const QString &portName)
+{
+  // Make sure that the device list is up-to-date
+  refreshSerialDevices();
+
+  // Search for the device by name or by system location
+  auto ports = validPorts();
+  for (int i = 0; i < ports.count(); ++i)
+  {
+    const auto &info = ports.at(i);
+    if (info.portName() == portName || info.systemLocation() == portName)
+    {
+      setPortIndex(i + 1);
+      return true;
+    }
+  }
+
+  // Device not found
+  return false;
+}
+
 /**
  * @brief IO::Drivers::Serial::setParity
  * @param parityIndex
@@ -474,8 +568,7 @@ void IO::Drivers::Serial::setParity(const quint8 parityIndex)
   }
 
   // Update serial port config.
-  if (port())
-    port()->setParity(parity());
+  runInPortThread([=]() { port()->setParity(parity()); });
 
   // Notify user interface
   Q_EMIT parityChanged();
@@ -529,8 +622,7 @@ void IO::Drivers::Serial::setDataBits(const quint8 dataBitsIndex)
   }
 
   // Update serial port configuration
-  if (port())
-    port()->setDataBits(dataBits());
+  runInPortThread([=]() { port()->setDataBits(dataBits()); });
 
   // Update user interface
   Q_EMIT dataBitsChanged();
@@ -565,8 +657,7 @@ void IO::Drivers::Serial::setStopBits(const quint8 stopBitsIndex)
   }
 
   // Update serial port configuration
-  if (port())
-    port()->setStopBits(stopBits());
+  runInPortThread([=]() { port()->setStopBits(stopBits()); });
 
   // Update user interface
   Q_EMIT stopBitsChanged();
@@ -581,6 +672,44 @@ void IO::Drivers::Serial::setAutoReconnect(const bool autoreconnect)
   Q_EMIT autoReconnectChanged();
 }
 
+/**
+ * Enables or disables the low-latency mode, changes are applied when the
+ * serial port is opened.
+ */
+void IO::Drivers::Serial::setLowLatency(const bool enabled)
+{
+  m_lowLatency = enabled;
+  m_settings.setValue("IO_DataSource_Serial__LowLatency", enabled);
+  Q_EMIT lowLatencyChanged();
+}
+
+/**
+ * Changes the size of the internal read buffer of the serial port, use 0 to
+ * let the buffer grow as needed.
+ */
+void IO::Drivers::Serial::setReadBufferSize(const qint64 size)
+{
+  // Update buffer size
+  m_readBufferSize = qMax<qint64>(0, size);
+
+  // Update serial port configuration
+  runInPortThread([=]() { port()->setReadBufferSize(readBufferSize()); });
+
+  // Update user interface
+  Q_EMIT readBufferSizeChanged();
+}
+
+/**
+ * Enables or disables reading the serial port from a dedicated thread, changes
+ * are applied when the serial port is opened.
+ */
+void IO::Drivers::Serial::setDedicatedReader(const bool enabled)
+{
+  m_dedicatedReader = enabled;
+  m_settings.setValue("IO_DataSource_Serial__DedicatedReader", enabled);
+  Q_EMIT dedicatedReaderChanged();
+}
+
 /**
  * Changes the flow control option of the serial port.
  *
@@ -610,8 +739,7 @@ void IO::Drivers::Serial::setFlowControl(const quint8 flowControlIndex)
   }
 
   // Update serial port configuration
-  if (port())
-    port()->setFlowControl(flowControl());
+  runInPortThread([=]() { port()->setFlowControl(flowControl()); });
 
   // Update user interface
   Q_EMIT flowControlChanged();
@@ -730,8 +858,17 @@ void IO::Drivers::Serial::readSettings()
   }
 #endif
 
+  // Read low-latency & dedicated reader options
+  m_lowLatency
+      = m_settings.value("IO_DataSource_Serial__LowLatency", false).toBool();
+  m_dedicatedReader
+      = m_settings.value("IO_DataSource_Serial__DedicatedReader", false)
+            .toBool();
+
   // Notify UI
   Q_EMIT baudRateListChanged();
+  Q_EMIT lowLatencyChanged();
+  Q_EMIT dedicatedReaderChanged();
 }
 
 /**
@@ -765,6 +902,85 @@ void IO::Drivers::Serial::writeSettings()
   m_settings.setValue("IO_DataSource_Serial__BaudRates", list);
 }
 
+/**
+ * Reduces the time that it takes for received bytes to reach the application:
+ *
+ * - Sets the @c ASYNC_LOW_LATENCY flag of the tty driver, so that received
+ *   data is flushed to user space immediately.
+ * - Lowers the latency timer of FTDI-like USB adapters, which batch incoming
+ *   data for 16 ms by default.
+ *
+ * Each step may fail depending on the adapter and on the user permissions,
+ * in that case the serial port keeps on working with the default settings.
+ *
+ * @note The termios read thresholds (@c VMIN/@c VTIME) are left untouched,
+ *       since they have no effect on the non-blocking descriptor used by
+ *       @c QSerialPort.
+ */
+void IO::Drivers::Serial::configureLowLatency()
+{
+#ifdef Q_OS_LINUX
+  // Get file descriptor
+  const auto fd = port()->handle();
+  if (fd < 0)
+    return;
+
+  // Enable low-latency flag
+  struct serial_struct serial;
+  if (ioctl(fd, TIOCGSERIAL, &serial) == 0)
+  {
+    serial.flags |= ASYNC_LOW_LATENCY;
+    if (ioctl(fd, TIOCSSERIAL, &serial) != 0)
+      qWarning() << "Cannot set ASYNC_LOW_LATENCY for" << port()->portName();
+  }
+
+  // Lower USB adapter latency timer
+  QFile timer(QStringLiteral("/sys/bus/usb-serial/devices/%1/latency_timer")
+                  .arg(port()->portName()));
+  if (timer.exists())
+  {
+    if (timer.open(QFile::WriteOnly))
+    {
+      timer.write("1");
+      timer.close();
+    }
+
+    else
+      qWarning() << "Cannot write to" << timer.fileName();
+  }
+#endif
+}
+
+/**
+ * Moves the serial port to a dedicated high-priority thread, incoming data is
+ * read & emitted from that thread so that the GUI event loop does not delay
+ * the arrival of new data.
+ */
+void IO::Drivers::Serial::startDedicatedReader()
+{
+  // clang-format off
+  auto serial = port();
+  connect(serial, &QIODevice::readyRead, serial, [=]() {
+    Q_EMIT dataReceived(serial->readAll());
+  });
+  // clang-format on
+
+  m_readerThread.start(QThread::HighestPriority);
+  serial->moveToThread(&m_readerThread);
+}
+
+/**
+ * Stops the dedicated reader thread (if running)
+ */
+void IO::Drivers::Serial::stopDedicatedReader()
+{
+  if (m_readerThread.isRunning())
+  {
+    m_readerThread.quit();
+    m_readerThread.wait();
+  }
+}
+
 /**
  * Returns a list with all the valid serial port objects
  */
@@ -790,3 +1006,19 @@ QVector<QSerialPortInfo> IO::Drivers::Serial::validPorts() const
   // Return list
   return ports;
 }
+
+/**
+ * Executes the given @a function in the thread that owns the serial port
+ * object and waits for it to finish. Nothing happens if the serial port
+ * does not exist.
+ */
+void IO::Drivers::Serial::runInPortThread(const std::function<void()> &function)
+{
+  if (!port())
+    return;
+
+  if (port()->thread() == QThread::currentThread())
+    function();
+  else
+    QMetaObject::invokeMethod(port(), function, Qt::BlockingQueuedConnection);
+}
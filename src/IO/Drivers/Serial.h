@@ -27,12 +27,15 @@
 
 #include <QObject>
 #include <QString>
+#include <QThread>
 #include <QSettings>
 #include <QByteArray>
 #include <QtSerialPort>
 #include <QTextCursor>
 #include <QQuickTextDocument>
 
+#include <functional>
+
 namespace IO
 {
 namespace Drivers
@@ -52,6 +55,21 @@ class Serial : public HAL_Driver
                READ autoReconnect
                WRITE setAutoReconnect
                NOTIFY autoReconnectChanged)
+    Q_PROPERTY(bool lowLatency
+               READ lowLatency
+               WRITE setLowLatency
+               NOTIFY lowLatencyChanged)
+    Q_PROPERTY(bool dedicatedReader
+               READ dedicatedReader
+               WRITE setDedicatedReader
+               NOTIFY dedicatedReaderChanged)
+    Q_PROPERTY(qint64 readBufferSize
+               READ readBufferSize
+               WRITE setReadBufferSize
+               NOTIFY readBufferSizeChanged)
+    Q_PROPERTY(bool lowLatencySupported
+               READ lowLatencySupported
+               CONSTANT)
     Q_PROPERTY(quint8 portIndex
                READ portIndex
                WRITE setPortIndex
@@ -103,9 +121,12 @@ Q_SIGNALS:
   void dataBitsChanged();
   void stopBitsChanged();
   void portIndexChanged();
+  void lowLatencyChanged();
   void flowControlChanged();
   void baudRateListChanged();
   void autoReconnectChanged();
+  void readBufferSizeChanged();
+  void dedicatedReaderChanged();
   void baudRateIndexChanged();
   void availablePortsChanged();
   void connectionError(const QString &name);
@@ -137,6 +158,11 @@ public:
   QSerialPort *port() const;
   bool autoReconnect() const;
 
+  bool lowLatency() const;
+  bool dedicatedReader() const;
+  qint64 readBufferSize() const;
+  bool lowLatencySupported() const;
+
   quint8 portIndex() const;
   quint8 parityIndex() const;
   quint8 displayMode() const;
@@ -162,9 +188,13 @@ public Q_SLOTS:
   void setBaudRate(const qint32 rate);
   void setParity(const quint8 parityIndex);
   void setPortIndex(const quint8 portIndex);
+  bool setPortName(const QString &portName);
   void appendBaudRate(const QString &baudRate);
   void setDataBits(const quint8 dataBitsIndex);
   void setStopBits(const quint8 stopBitsIndex);
+  void setLowLatency(const bool enabled);
+  void setReadBufferSize(const qint64 size);
+  void setDedicatedReader(const bool enabled);
   void setAutoReconnect(const bool autoreconnect);
   void setFlowControl(const quint8 flowControlIndex);
 
@@ -176,12 +206,20 @@ private Q_SLOTS:
   void handleError(QSerialPort::SerialPortError error);
 
 private:
+  void configureLowLatency();
+  void startDedicatedReader();
+  void stopDedicatedReader();
   QVector<QSerialPortInfo> validPorts() const;
+  void runInPortThread(const std::function<void()> &function);
 
 private:
   QSerialPort *m_port;
+  QThread m_readerThread;
 
+  bool m_lowLatency;
   bool m_autoReconnect;
+  bool m_dedicatedReader;
+  qint64 m_readBufferSize;
   int m_lastSerialDeviceIndex;
 
   qint32 m_baudRate;
@@ -0,0 +1,658 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <IO/Manager.h>
+#include <IO/Checksum.h>
+#include <IO/Drivers/Synthetic.h>
+
+#include <JSON/Generator.h>
+#include <Misc/TimerEvents.h>
+
+#include <QtMath>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QJsonDocument>
+
+/**
+ * Seed used for the random number generator, using a constant value ensures
+ * that every run generates the same sequence of frames.
+ */
+static constexpr unsigned int kRandomSeed = 0x53535344;
+
+/**
+ * Number of frames generated on each event loop iteration in full-speed mode
+ */
+static constexpr int kFullSpeedBatch = 256;
+
+//----------------------------------------------------------------------------------------
+// Constructor/destructor & singleton access functions
+//----------------------------------------------------------------------------------------
+
+/**
+ * Constructor function
+ */
+IO::Drivers::Synthetic::Synthetic()
+  : m_isOpen(false)
+  , m_jsonFrames(false)
+  , m_activeChannels(0)
+  , m_random(kRandomSeed)
+  , m_padding(0)
+  , m_channels(4)
+  , m_frameRate(100)
+  , m_fullSpeed(false)
+  , m_crcEnabled(false)
+  , m_noiseLevel(0.05)
+  , m_crcErrorRate(0)
+  , m_signalFrequency(1)
+  , m_corruptFrameRate(0)
+  , m_waveform(Waveform::Sine)
+  , m_elapsedNs(0)
+  , m_pendingFrames(0)
+  , m_effectiveFrameRate(0)
+  , m_generatedFrames(0)
+  , m_lastGeneratedFrames(0)
+  , m_lastStatisticsUpdate(0)
+{
+  // Configure frame generation timer
+  m_timer.setTimerType(Qt::PreciseTimer);
+
+  // clang-format off
+  connect(&m_timer, &QTimer::timeout,
+          this, &IO::Drivers::Synthetic::generateFrames);
+  connect(&Misc::TimerEvents::instance(), &Misc::TimerEvents::timeout1Hz,
+          this, &IO::Drivers::Synthetic::updateStatistics);
+  connect(&JSON::Generator::instance(), &JSON::Generator::jsonFileMapChanged,
+          this, &IO::Drivers::Synthetic::channelsChanged);
+  connect(&JSON::Generator::instance(), &JSON::Generator::operationModeChanged,
+          this, &IO::Drivers::Synthetic::channelsChanged);
+  // clang-format on
+}
+
+/**
+ * Returns the only instance of the class
+ */
+IO::Drivers::Synthetic &IO::Drivers::Synthetic::instance()
+{
+  static Synthetic singleton;
+  return singleton;
+}
+
+//----------------------------------------------------------------------------------------
+// HAL-driver implementation
+//----------------------------------------------------------------------------------------
+
+/**
+ * Stops generating frames
+ */
+void IO::Drivers::Synthetic::close()
+{
+  m_timer.stop();
+  m_isOpen = false;
+}
+
+/**
+ * Returns @c true if the generator is running
+ */
+bool IO::Drivers::Synthetic::isOpen() const
+{
+  return m_isOpen;
+}
+
+/**
+ * Returns @c true if the generator is running
+ */
+bool IO::Drivers::Synthetic::isReadable() const
+{
+  return isOpen();
+}
+
+/**
+ * Returns @c true if the generator is running, written data is discarded
+ */
+bool IO::Drivers::Synthetic::isWritable() const
+{
+  return isOpen();
+}
+
+/**
+ * Returns @c true if the generator has at least one channel and a valid
+ * frame rate.
+ */
+bool IO::Drivers::Synthetic::configurationOk() const
+{
+  const auto hasChannels = projectChannels() > 0 || channels() > 0;
+  return hasChannels && (fullSpeed() || frameRate() > 0);
+}
+
+/**
+ * Discards the given @a data and returns its length, as if it had been
+ * written to a real device.
+ */
+quint64 IO::Drivers::Synthetic::write(const QByteArray &data)
+{
+  if (isWritable())
+  {
+    Q_EMIT dataSent(data);
+    return data.length();
+  }
+
+  return 0;
+}
+
+/**
+ * Resets the generator state & starts generating frames.
+ */
+bool IO::Drivers::Synthetic::open(const QIODevice::OpenMode mode)
+{
+  Q_UNUSED(mode);
+
+  // Stop previous session
+  close();
+
+  // Validate configuration
+  if (!configurationOk())
+    return false;
+
+  // Cache frame sequences
+  auto &manager = IO::Manager::instance();
+  m_start = manager.startSequence().toUtf8();
+  m_finish = manager.finishSequence().toUtf8();
+  m_separator = manager.separatorSequence().toUtf8();
+
+  // Generate JSON frames in automatic mode, or CSV-like frames in manual mode
+  const auto opMode = JSON::Generator::instance().operationMode();
+  m_jsonFrames = opMode == JSON::Generator::kAutomatic;
+  m_activeChannels = projectChannels();
+  if (m_activeChannels <= 0)
+    m_activeChannels = channels();
+
+  // Reset generator state, so that each run is repeatable
+  m_random.seed(kRandomSeed);
+  m_elapsedNs = 0;
+  m_pendingFrames = 0;
+  m_generatedFrames = 0;
+  m_effectiveFrameRate = 0;
+  m_lastGeneratedFrames = 0;
+  m_lastStatisticsUpdate = 0;
+
+  // Start the timer
+  if (fullSpeed())
+    m_timer.start(0);
+  else
+    m_timer.start(qBound(1, 1000 / frameRate(), 10));
+
+  // Update internal state
+  m_clock.start();
+  m_isOpen = true;
+  Q_EMIT statisticsChanged();
+  return true;
+}
+
+//----------------------------------------------------------------------------------------
+// Driver specifics
+//----------------------------------------------------------------------------------------
+
+/**
+ * Returns the number of padding bytes appended (as an additional field) to
+ * each frame. This can be used to test the pipeline with large frames.
+ */
+int IO::Drivers::Synthetic::padding() const
+{
+  return m_padding;
+}
+
+/**
+ * Returns the index of the waveform generated for each channel, in relation
+ * to the list returned by @c waveformList().
+ */
+int IO::Drivers::Synthetic::waveform() const
+{
+  return static_cast<int>(m_waveform);
+}
+
+/**
+ * Returns the number of channels generated when no project is loaded
+ */
+int IO::Drivers::Synthetic::channels() const
+{
+  return m_channels;
+}
+
+/**
+ * Returns the number of frames generated per second
+ */
+int IO::Drivers::Synthetic::frameRate() const
+{
+  return m_frameRate;
+}
+
+/**
+ * Returns @c true if frames shall be generated as fast as possible
+ */
+bool IO::Drivers::Synthetic::fullSpeed() const
+{
+  return m_fullSpeed;
+}
+
+/**
+ * Returns @c true if a CRC-16 code shall be appended to each frame
+ */
+bool IO::Drivers::Synthetic::crcEnabled() const
+{
+  return m_crcEnabled;
+}
+
+/**
+ * Returns the amplitude of the random noise added to each sample
+ */
+double IO::Drivers::Synthetic::noiseLevel() const
+{
+  return m_noiseLevel;
+}
+
+/**
+ * Returns the percentage of frames that are sent with an invalid CRC code
+ */
+double IO::Drivers::Synthetic::crcErrorRate() const
+{
+  return m_crcErrorRate;
+}
+
+/**
+ * Returns the number of channels required by the current project, which is
+ * equal to the highest dataset index of the JSON map. A value of 0 is
+ * returned when no project is loaded or when the JSON generator is in
+ * automatic mode.
+ */
+int IO::Drivers::Synthetic::projectChannels() const
+{
+  auto &generator = JSON::Generator::instance();
+  if (generator.operationMode() != JSON::Generator::kManual)
+    return 0;
+
+  int count = 0;
+  const auto groups = generator.json().value("groups").toArray();
+  for (const auto &group : groups)
+  {
+    const auto datasets = group.toObject().value("datasets").toArray();
+    for (const auto &dataset : datasets)
+      count = qMax(count, dataset.toObject().value("index").toInt());
+  }
+
+  return count;
+}
+
+/**
+ * Returns the frequency (in Hz) of the generated waveforms
+ */
+double IO::Drivers::Synthetic::signalFrequency() const
+{
+  return m_signalFrequency;
+}
+
+/**
+ * Returns the percentage of frames that are corrupted before being sent
+ */
+double IO::Drivers::Synthetic::corruptFrameRate() const
+{
+  return m_corruptFrameRate;
+}
+
+/**
+ * Returns the number of frames generated since the driver was opened
+ */
+quint64 IO::Drivers::Synthetic::generatedFrames() const
+{
+  return m_generatedFrames;
+}
+
+/**
+ * Returns the number of frames that were actually generated during the last
+ * second, in full-speed mode this is the throughput of the application.
+ */
+double IO::Drivers::Synthetic::effectiveFrameRate() const
+{
+  return m_effectiveFrameRate;
+}
+
+/**
+ * Returns a list with the available waveforms
+ */
+StringList IO::Drivers::Synthetic::waveformList() const
+{
+  StringList list;
+  list.append(tr("Sine"));
+  list.append(tr("Square"));
+  list.append(tr("Triangle"));
+  list.append(tr("Sawtooth"));
+  list.append(tr("Noise"));
+  return list;
+}
+
+/**
+ * Generates a single frame with the current configuration, including the
+ * start/finish sequences and the CRC code (if enabled).
+ */
+QByteArray IO::Drivers::Synthetic::generateFrame()
+{
+  // Obtain sample time, signal is a function of the frame number (not the
+  // wall clock) so that each run produces the same data
+  const auto rate = qMax(1, frameRate());
+  const auto time = static_cast<double>(m_generatedFrames) / rate;
+
+  // Build frame payload
+  QByteArray payload;
+  if (m_jsonFrames)
+  {
+    QJsonArray datasets;
+    for (int i = 0; i < m_activeChannels; ++i)
+    {
+      QJsonObject dataset;
+      dataset.insert("title", tr("Channel %1").arg(i + 1));
+      dataset.insert("value", QString::number(sample(i, time), 'f', 4));
+      dataset.insert("graph", true);
+      datasets.append(dataset);
+    }
+
+    QJsonObject group;
+    group.insert("title", tr("Synthetic Signals"));
+    group.insert("widget", "multiplot");
+    group.insert("datasets", datasets);
+
+    QJsonObject frame;
+    frame.insert("title", tr("Synthetic Device"));
+    frame.insert("groups", QJsonArray{group});
+    if (m_padding > 0)
+      frame.insert("padding", QString(m_padding, 'x'));
+
+    payload = QJsonDocument(frame).toJson(QJsonDocument::Compact);
+  }
+
+  else
+  {
+    payload.reserve(m_activeChannels * 10 + m_padding + 8);
+    for (int i = 0; i < m_activeChannels; ++i)
+    {
+      if (i > 0)
+        payload.append(m_separator);
+
+      payload.append(QByteArray::number(sample(i, time), 'f', 4));
+    }
+
+    if (m_padding > 0)
+    {
+      payload.append(m_separator);
+      payload.append(QByteArray(m_padding, 'x'));
+    }
+  }
+
+  // Decide which errors to inject
+  std::uniform_real_distribution<double> percent(0, 100);
+  const bool corrupt = percent(m_random) < m_corruptFrameRate;
+  const bool crcError = m_crcEnabled && percent(m_random) < m_crcErrorRate;
+
+  // Calculate CRC before corrupting the payload
+  const auto crc = crc16(payload.constData(), payload.length());
+
+  // Corrupt frame by overwriting random bytes and (sometimes) dropping the
+  // finish sequence
+  bool dropFinish = false;
+  if (corrupt && !payload.isEmpty())
+  {
+    std::uniform_int_distribution<int> byte(0, 255);
+    std::uniform_int_distribution<int> index(0, payload.length() - 1);
+    for (int i = 0; i < qMax(1, payload.length() / 8); ++i)
+      payload[index(m_random)] = static_cast<char>(byte(m_random));
+
+    dropFinish = byte(m_random) & 1;
+  }
+
+  // Build the frame
+  QByteArray frame;
+  frame.reserve(m_start.length() + payload.length() + m_finish.length() + 8);
+  frame.append(m_start);
+  frame.append(payload);
+  if (!dropFinish)
+    frame.append(m_finish);
+
+  // Append CRC-16 code
+  if (m_crcEnabled)
+  {
+    const quint16 code = crcError ? crc ^ 0xA5A5 : crc;
+    frame.append("crc16:");
+    frame.append(static_cast<char>((code >> 8) & 0xff));
+    frame.append(static_cast<char>(code & 0xff));
+  }
+
+  // Update frame counter
+  ++m_generatedFrames;
+  return frame;
+}
+
+/**
+ * Changes the number of padding bytes appended to each frame
+ */
+void IO::Drivers::Synthetic::setPadding(const int bytes)
+{
+  m_padding = qMax(0, bytes);
+  Q_EMIT paddingChanged();
+}
+
+/**
+ * Changes the waveform generated for each channel
+ */
+void IO::Drivers::Synthetic::setWaveform(const int index)
+{
+  const auto count = waveformList().count();
+  m_waveform = static_cast<Waveform>(qBound(0, index, count - 1));
+  Q_EMIT waveformChanged();
+}
+
+/**
+ * Changes the number of channels generated when no project is loaded
+ */
+void IO::Drivers::Synthetic::setChannels(const int channels)
+{
+  m_channels = qMax(1, channels);
+  Q_EMIT channelsChanged();
+  Q_EMIT configurationChanged();
+}
+
+/**
+ * Changes the number of frames generated per second
+ */
+void IO::Drivers::Synthetic::setFrameRate(const int frameRate)
+{
+  m_frameRate = qMax(1, frameRate);
+
+  if (isOpen() && !fullSpeed())
+    m_timer.setInterval(qBound(1, 1000 / m_frameRate, 10));
+
+  Q_EMIT frameRateChanged();
+  Q_EMIT configurationChanged();
+}
+
+/**
+ * Enables or disables the full-speed mode
+ */
+void IO::Drivers::Synthetic::setFullSpeed(const bool enabled)
+{
+  m_fullSpeed = enabled;
+
+  if (isOpen())
+  {
+    m_elapsedNs = m_clock.nsecsElapsed();
+    m_pendingFrames = 0;
+    if (enabled)
+      m_timer.setInterval(0);
+    else
+      m_timer.setInterval(qBound(1, 1000 / frameRate(), 10));
+  }
+
+  Q_EMIT fullSpeedChanged();
+  Q_EMIT configurationChanged();
+}
+
+/**
+ * Enables or disables appending a CRC-16 code to each frame
+ */
+void IO::Drivers::Synthetic::setCrcEnabled(const bool enabled)
+{
+  m_crcEnabled = enabled;
+  Q_EMIT crcEnabledChanged();
+}
+
+/**
+ * Changes the amplitude of the random noise added to each sample
+ */
+void IO::Drivers::Synthetic::setNoiseLevel(const double level)
+{
+  m_noiseLevel = qMax(0.0, level);
+  Q_EMIT noiseLevelChanged();
+}
+
+/**
+ * Changes the percentage of frames sent with an invalid CRC code
+ */
+void IO::Drivers::Synthetic::setCrcErrorRate(const double rate)
+{
+  m_crcErrorRate = qBound(0.0, rate, 100.0);
+  Q_EMIT crcErrorRateChanged();
+}
+
+/**
+ * Changes the frequency (in Hz) of the generated waveforms
+ */
+void IO::Drivers::Synthetic::setSignalFrequency(const double frequency)
+{
+  m_signalFrequency = qMax(0.0, frequency);
+  Q_EMIT signalFrequencyChanged();
+}
+
+/**
+ * Changes the percentage of frames that are corrupted before being sent
+ */
+void IO::Drivers::Synthetic::setCorruptFrameRate(const double rate)
+{
+  m_corruptFrameRate = qBound(0.0, rate, 100.0);
+  Q_EMIT corruptFrameRateChanged();
+}
+
+/**
+ * Generates the frames that correspond to the time elapsed since the last
+ * call (or a fixed batch of frames in full-speed mode) and sends them to the
+ * I/O manager as a single data chunk.
+ */
+void IO::Drivers::Synthetic::generateFrames()
+{
+  // Driver not open, abort
+  if (!isOpen())
+    return;
+
+  // Obtain number of frames to generate
+  int count = kFullSpeedBatch;
+  if (!fullSpeed())
+  {
+    const auto now = m_clock.nsecsElapsed();
+    m_pendingFrames += (now - m_elapsedNs) * frameRate() / 1e9;
+    m_pendingFrames = qMin(m_pendingFrames, static_cast<double>(frameRate()));
+    m_elapsedNs = now;
+
+    count = static_cast<int>(m_pendingFrames);
+    m_pendingFrames -= count;
+  }
+
+  // Generate frames
+  if (count > 0)
+  {
+    QByteArray data;
+    for (int i = 0; i < count; ++i)
+      data.append(generateFrame());
+
+    Q_EMIT dataReceived(data);
+  }
+}
+
+/**
+ * Calculates the effective frame rate during the last second
+ */
+void IO::Drivers::Synthetic::updateStatistics()
+{
+  if (!isOpen())
+    return;
+
+  const auto now = m_clock.nsecsElapsed();
+  const auto elapsed = (now - m_lastStatisticsUpdate) / 1e9;
+  if (elapsed > 0)
+  {
+    const auto frames = m_generatedFrames - m_lastGeneratedFrames;
+    m_effectiveFrameRate = frames / elapsed;
+  }
+
+  m_lastStatisticsUpdate = now;
+  m_lastGeneratedFrames = m_generatedFrames;
+  Q_EMIT statisticsChanged();
+}
+
+/**
+ * Returns the value of the given @a channel at the given @a time, each
+ * channel is phase-shifted & scaled so that they can be told apart in plots.
+ */
+double IO::Drivers::Synthetic::sample(const int channel, const double time)
+{
+  // Obtain the phase of the signal (in cycles)
+  const auto shift = static_cast<double>(channel) / qMax(1, m_activeChannels);
+  auto phase = time * m_signalFrequency + shift;
+  phase -= qFloor(phase);
+
+  // Generate the waveform
+  double value = 0;
+  switch (m_waveform)
+  {
+    case Waveform::Sine:
+      value = qSin(2 * M_PI * phase);
+      break;
+    case Waveform::Square:
+      value = phase < 0.5 ? 1 : -1;
+      break;
+    case Waveform::Triangle:
+      value = 4 * qAbs(phase - 0.5) - 1;
+      break;
+    case Waveform::Sawtooth:
+      value = 2 * phase - 1;
+      break;
+    case Waveform::Noise:
+      value = 0;
+      break;
+  }
+
+  // Add noise
+  if (m_noiseLevel > 0 || m_waveform == Waveform::Noise)
+  {
+    const auto level = m_waveform == Waveform::Noise ? 1 : m_noiseLevel;
+    std::uniform_real_distribution<double> noise(-level, level);
+    value += noise(m_random);
+  }
+
+  // Scale signal by channel number
+  return value * (channel + 1);
+}
@@ -0,0 +1,226 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <QTimer>
+#include <QObject>
+#include <QElapsedTimer>
+#include <DataTypes.h>
+#include <IO/HAL_Driver.h>
+
+#include <random>
+
+namespace IO
+{
+namespace Drivers
+{
+/**
+ * @brief The Synthetic class
+ *
+ * Serial Studio driver that generates frames without any hardware. Frames are
+ * built with the start, finish & separator sequences used by the I/O manager,
+ * and contain one value for each dataset of the current project (or a
+ * user-defined number of channels when no project is loaded).
+ *
+ * The generator uses a fixed random seed, so that every run pushes exactly
+ * the same data through the pipeline. This allows using the driver to compare
+ * the performance of the frame parsing, JSON generation & dashboard modules
+ * between builds. The @c fullSpeed() mode generates frames as fast as the
+ * event loop allows, which can be used to find the saturation point of the
+ * application.
+ *
+ * Corrupt frames (missing finish sequence & garbage bytes) and invalid CRC
+ * codes can be injected with a configurable probability.
+ */
+class Synthetic : public HAL_Driver
+{
+  // clang-format off
+    Q_OBJECT
+    Q_PROPERTY(int waveform
+               READ waveform
+               WRITE setWaveform
+               NOTIFY waveformChanged)
+    Q_PROPERTY(int frameRate
+               READ frameRate
+               WRITE setFrameRate
+               NOTIFY frameRateChanged)
+    Q_PROPERTY(int channels
+               READ channels
+               WRITE setChannels
+               NOTIFY channelsChanged)
+    Q_PROPERTY(int padding
+               READ padding
+               WRITE setPadding
+               NOTIFY paddingChanged)
+    Q_PROPERTY(double signalFrequency
+               READ signalFrequency
+               WRITE setSignalFrequency
+               NOTIFY signalFrequencyChanged)
+    Q_PROPERTY(double noiseLevel
+               READ noiseLevel
+               WRITE setNoiseLevel
+               NOTIFY noiseLevelChanged)
+    Q_PROPERTY(bool crcEnabled
+               READ crcEnabled
+               WRITE setCrcEnabled
+               NOTIFY crcEnabledChanged)
+    Q_PROPERTY(double crcErrorRate
+               READ crcErrorRate
+               WRITE setCrcErrorRate
+               NOTIFY crcErrorRateChanged)
+    Q_PROPERTY(double corruptFrameRate
+               READ corruptFrameRate
+               WRITE setCorruptFrameRate
+               NOTIFY corruptFrameRateChanged)
+    Q_PROPERTY(bool fullSpeed
+               READ fullSpeed
+               WRITE setFullSpeed
+               NOTIFY fullSpeedChanged)
+    Q_PROPERTY(int projectChannels
+               READ projectChannels
+               NOTIFY channelsChanged)
+    Q_PROPERTY(quint64 generatedFrames
+               READ generatedFrames
+               NOTIFY statisticsChanged)
+    Q_PROPERTY(double effectiveFrameRate
+               READ effectiveFrameRate
+               NOTIFY statisticsChanged)
+    Q_PROPERTY(StringList waveformList
+               READ waveformList
+               CONSTANT)
+  // clang-format on
+
+Q_SIGNALS:
+  void paddingChanged();
+  void waveformChanged();
+  void channelsChanged();
+  void fullSpeedChanged();
+  void frameRateChanged();
+  void noiseLevelChanged();
+  void statisticsChanged();
+  void crcEnabledChanged();
+  void crcErrorRateChanged();
+  void signalFrequencyChanged();
+  void corruptFrameRateChanged();
+
+private:
+  explicit Synthetic();
+  Synthetic(Synthetic &&) = delete;
+  Synthetic(const Synthetic &) = delete;
+  Synthetic &operator=(Synthetic &&) = delete;
+  Synthetic &operator=(const Synthetic &) = delete;
+
+public:
+  static Synthetic &instance();
+
+  enum class Waveform
+  {
+    Sine,
+    Square,
+    Triangle,
+    Sawtooth,
+    Noise
+  };
+  Q_ENUM(Waveform)
+
+  //
+  // HAL functions
+  //
+  void close() override;
+  bool isOpen() const override;
+  bool isReadable() const override;
+  bool isWritable() const override;
+  bool configurationOk() const override;
+  quint64 write(const QByteArray &data) override;
+  bool open(const QIODevice::OpenMode mode) override;
+
+  //
+  // Driver specifics
+  //
+  int padding() const;
+  int waveform() const;
+  int channels() const;
+  int frameRate() const;
+  bool fullSpeed() const;
+  bool crcEnabled() const;
+  double noiseLevel() const;
+  double crcErrorRate() const;
+  int projectChannels() const;
+  double signalFrequency() const;
+  double corruptFrameRate() const;
+  quint64 generatedFrames() const;
+  double effectiveFrameRate() const;
+  StringList waveformList() const;
+
+  QByteArray generateFrame();
+
+public Q_SLOTS:
+  void setPadding(const int bytes);
+  void setWaveform(const int index);
+  void setChannels(const int channels);
+  void setFrameRate(const int frameRate);
+  void setFullSpeed(const bool enabled);
+  void setCrcEnabled(const bool enabled);
+  void setNoiseLevel(const double level);
+  void setCrcErrorRate(const double rate);
+  void setSignalFrequency(const double frequency);
+  void setCorruptFrameRate(const double rate);
+
+private Q_SLOTS:
+  void generateFrames();
+  void updateStatistics();
+
+private:
+  double sample(const int channel, const double time);
+
+private:
+  bool m_isOpen;
+  bool m_jsonFrames;
+  int m_activeChannels;
+  QByteArray m_start;
+  QByteArray m_finish;
+  QByteArray m_separator;
+  QTimer m_timer;
+  QElapsedTimer m_clock;
+  std::mt19937 m_random;
+
+  int m_padding;
+  int m_channels;
+  int m_frameRate;
+  bool m_fullSpeed;
+  bool m_crcEnabled;
+  double m_noiseLevel;
+  double m_crcErrorRate;
+  double m_signalFrequency;
+  double m_corruptFrameRate;
+  Waveform m_waveform;
+
+  qint64 m_elapsedNs;
+  double m_pendingFrames;
+  double m_effectiveFrameRate;
+  quint64 m_generatedFrames;
+  quint64 m_lastGeneratedFrames;
+  qint64 m_lastStatisticsUpdate;
+};
+} // namespace Drivers
+} // namespace IO
@@ -0,0 +1,417 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <IO/Drivers/TcpServer.h>
+
+#include <cstring>
+
+//----------------------------------------------------------------------------------------
+// Connection worker
+//----------------------------------------------------------------------------------------
+
+/**
+ * Constructor function, stores the frame delimiters used to split the data
+ * stream of each connection handled by this worker.
+ */
+IO::Drivers::TcpServerWorker::TcpServerWorker(const QByteArray &start,
+                                              const QByteArray &finish,
+                                              const int maxBufferSize)
+  : m_maxBufferSize(maxBufferSize)
+  , m_start(start)
+  , m_finish(finish)
+{
+}
+
+/**
+ * Aborts and deletes all the connections handled by this worker.
+ */
+void IO::Drivers::TcpServerWorker::closeAll()
+{
+  auto connections = m_connections;
+  m_connections.clear();
+
+  for (auto it = connections.begin(); it != connections.end(); ++it)
+  {
+    it.key()->disconnect(this);
+    it.key()->abort();
+    it.key()->deleteLater();
+    Q_EMIT connectionClosed(it.value().id);
+  }
+}
+
+/**
+ * Writes the given @a data to every connection handled by this worker.
+ */
+void IO::Drivers::TcpServerWorker::write(const QByteArray &data)
+{
+  for (auto it = m_connections.begin(); it != m_connections.end(); ++it)
+  {
+    if (it.key()->isWritable())
+      it.key()->write(data);
+  }
+}
+
+/**
+ * Creates a socket for the given native socket @a descriptor in the worker
+ * thread and registers it with the given connection @a id.
+ */
+void IO::Drivers::TcpServerWorker::addConnection(const qintptr descriptor,
+                                                 const quint32 id)
+{
+  auto socket = new QTcpSocket(this);
+  if (!socket->setSocketDescriptor(descriptor))
+  {
+    socket->deleteLater();
+    return;
+  }
+
+  socket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+
+  // Use the IPv4 notation for IPv4-mapped addresses
+  bool ipv4 = false;
+  auto address = socket->peerAddress();
+  const auto ipv4Address = address.toIPv4Address(&ipv4);
+  if (ipv4)
+    address = QHostAddress(ipv4Address);
+
+  Connection connection;
+  connection.id = id;
+  connection.crc = false;
+  connection.buffer.reserve(qMin(m_maxBufferSize, 64 * 1024));
+  m_connections.insert(socket, connection);
+
+  connect(socket, &QTcpSocket::readyRead, this,
+          &IO::Drivers::TcpServerWorker::onReadyRead);
+  connect(socket, &QTcpSocket::disconnected, this,
+          &IO::Drivers::TcpServerWorker::onDisconnected);
+
+  Q_EMIT connectionOpened(id, address.toString());
+}
+
+/**
+ * Appends the incoming data of the caller socket to its frame buffer and
+ * extracts every complete frame found in the buffer.
+ */
+void IO::Drivers::TcpServerWorker::onReadyRead()
+{
+  // Get caller socket & its connection data
+  auto socket = static_cast<QTcpSocket *>(QObject::sender());
+  auto it = m_connections.find(socket);
+  if (it == m_connections.end())
+    return;
+
+  // Append incoming data to the connection buffer
+  auto &connection = it.value();
+  auto &buffer = connection.buffer;
+  buffer.append(socket->readAll());
+
+  // Extract frames, only removing data from the buffer once
+  int offset = 0;
+  QByteArrayList frames;
+  while (true)
+  {
+    const int sIndex = buffer.indexOf(m_start, offset);
+    if (sIndex < 0)
+      break;
+
+    const int begin = sIndex + m_start.length();
+    const int fIndex = buffer.indexOf(m_finish, begin);
+    if (fIndex < 0)
+      break;
+
+    // Checksum incomplete, wait for more data...
+    const int crc = checksumLength(buffer, fIndex, &connection.crc);
+    if (crc < 0)
+      break;
+
+    // Send the complete frame, so that the I/O manager can record it & verify
+    // its checksum
+    const int end = fIndex + m_finish.length() + crc;
+    if (fIndex > begin)
+      frames.append(buffer.mid(sIndex, end - sIndex));
+
+    offset = end;
+  }
+
+  // Remove parsed data from the buffer
+  if (offset > 0)
+    buffer.remove(0, offset);
+
+  // Clear buffer if the device sends a lot of invalid data
+  if (buffer.size() > m_maxBufferSize)
+    buffer.clear();
+
+  // Notify the GUI thread
+  if (!frames.isEmpty())
+    Q_EMIT framesReceived(connection.id, frames);
+}
+
+/**
+ * Unregisters & deletes the caller socket when the remote peer disconnects.
+ */
+void IO::Drivers::TcpServerWorker::onDisconnected()
+{
+  auto socket = static_cast<QTcpSocket *>(QObject::sender());
+  auto it = m_connections.find(socket);
+  if (it != m_connections.end())
+  {
+    const auto id = it.value().id;
+    m_connections.erase(it);
+    socket->deleteLater();
+    Q_EMIT connectionClosed(id);
+  }
+}
+
+/**
+ * Returns the number of bytes of the checksum that follows the finish sequence
+ * found at the given @a index of the @a buffer (header included), @c 0 if the
+ * frame has no checksum or @c -1 if the checksum is not complete yet.
+ *
+ * Once a checksum is found, @a crc is set to @c true and the worker waits for
+ * the checksum header after every frame of the connection, like the I/O
+ * manager does with the data of the other drivers.
+ */
+int IO::Drivers::TcpServerWorker::checksumLength(const QByteArray &buffer,
+                                                 const int index,
+                                                 bool *crc) const
+{
+  // clang-format off
+  static const struct { const char *header; int length; int bytes; } types[] = {
+    {"crc8:", 5, 1},
+    {"crc16:", 6, 2},
+    {"crc32:", 6, 4}
+  };
+  // clang-format on
+
+  const int offset = index + m_finish.length();
+  const int available = buffer.length() - offset;
+  for (const auto &type : types)
+  {
+    const int length = qMin(available, type.length);
+    if (std::memcmp(buffer.constData() + offset, type.header, length) != 0)
+      continue;
+
+    // Complete header, check that the checksum was received
+    if (length == type.length)
+    {
+      *crc = true;
+      if (available < type.length + type.bytes)
+        return -1;
+
+      return type.length + type.bytes;
+    }
+
+    // Partial header, wait for more data if the device sends checksums
+    if (*crc)
+      return -1;
+  }
+
+  return 0;
+}
+
+//----------------------------------------------------------------------------------------
+// TCP listener
+//----------------------------------------------------------------------------------------
+
+/**
+ * Constructor function
+ */
+IO::Drivers::TcpServer::TcpServer(QObject *parent)
+  : QTcpServer(parent)
+  , m_nextId(0)
+  , m_nextWorker(0)
+{
+  qRegisterMetaType<qintptr>("qintptr");
+  qRegisterMetaType<QByteArrayList>("QByteArrayList");
+}
+
+/**
+ * Stops the I/O threads before destroying the server
+ */
+IO::Drivers::TcpServer::~TcpServer()
+{
+  stop();
+}
+
+/**
+ * Returns the number of devices currently connected to the server
+ */
+int IO::Drivers::TcpServer::connectionCount() const
+{
+  return m_devices.count();
+}
+
+/**
+ * Returns the number of I/O threads used to serve the inbound connections,
+ * we only need a few of them, since each thread can handle many sockets.
+ */
+int IO::Drivers::TcpServer::defaultThreadCount()
+{
+  return qBound(1, QThread::idealThreadCount() / 2, 4);
+}
+
+/**
+ * Starts the I/O thread pool and begins listening for connections on the
+ * given local @a address & @a port.
+ *
+ * @param start  frame start sequence
+ * @param finish frame end sequence
+ * @param maxBufferSize maximum size of each connection's frame buffer
+ */
+bool IO::Drivers::TcpServer::start(const QHostAddress &address,
+                                   const quint16 port, const QByteArray &start,
+                                   const QByteArray &finish,
+                                   const int maxBufferSize)
+{
+  // Reset previous state
+  stop();
+
+  // Begin listening for connections
+  if (!listen(address, port))
+    return false;
+
+  // Create the I/O thread pool
+  for (int i = 0; i < defaultThreadCount(); ++i)
+  {
+    auto thread = new QThread(this);
+    auto worker = new TcpServerWorker(start, finish, maxBufferSize);
+    worker->moveToThread(thread);
+
+    // clang-format off
+    connect(thread, &QThread::finished,
+            worker, &QObject::deleteLater);
+    connect(worker, &IO::Drivers::TcpServerWorker::framesReceived,
+            this, &IO::Drivers::TcpServer::onFramesReceived);
+    connect(worker, &IO::Drivers::TcpServerWorker::connectionOpened,
+            this, &IO::Drivers::TcpServer::onConnectionOpened);
+    connect(worker, &IO::Drivers::TcpServerWorker::connectionClosed,
+            this, &IO::Drivers::TcpServer::onConnectionClosed);
+    // clang-format on
+
+    thread->setObjectName(QStringLiteral("TCP server I/O %1").arg(i));
+    thread->start();
+
+    m_threads.append(thread);
+    m_workers.append(worker);
+  }
+
+  return true;
+}
+
+/**
+ * Stops listening for new connections, closes the current connections and
+ * stops the I/O threads.
+ */
+void IO::Drivers::TcpServer::stop()
+{
+  // Stop listening
+  close();
+
+  // Close connections in their own threads & stop the thread pool
+  for (int i = 0; i < m_threads.count(); ++i)
+  {
+    m_workers.at(i)->disconnect(this);
+    QMetaObject::invokeMethod(m_workers.at(i), "closeAll",
+                              Qt::BlockingQueuedConnection);
+    m_threads.at(i)->quit();
+    m_threads.at(i)->wait();
+    m_threads.at(i)->deleteLater();
+  }
+
+  // Reset state
+  m_nextId = 0;
+  m_nextWorker = 0;
+  m_threads.clear();
+  m_workers.clear();
+  if (!m_devices.isEmpty())
+  {
+    m_devices.clear();
+    Q_EMIT connectionCountChanged();
+  }
+}
+
+/**
+ * Sends the given @a data to all connected devices
+ */
+void IO::Drivers::TcpServer::write(const QByteArray &data)
+{
+  Q_FOREACH (auto worker, m_workers)
+    QMetaObject::invokeMethod(worker, "write", Qt::QueuedConnection,
+                              Q_ARG(QByteArray, data));
+}
+
+/**
+ * Hands the native socket @a descriptor of a new connection to the next I/O
+ * thread of the pool, the socket object is created in the worker thread.
+ */
+void IO::Drivers::TcpServer::incomingConnection(qintptr descriptor)
+{
+  if (m_workers.isEmpty())
+    return;
+
+  auto worker = m_workers.at(m_nextWorker);
+  m_nextWorker = (m_nextWorker + 1) % m_workers.count();
+
+  ++m_nextId;
+  QMetaObject::invokeMethod(worker, "addConnection", Qt::QueuedConnection,
+                            Q_ARG(qintptr, descriptor),
+                            Q_ARG(quint32, m_nextId));
+}
+
+/**
+ * Forgets the device name of the connection with the given @a id, so that
+ * it can be used again when the device reconnects.
+ */
+void IO::Drivers::TcpServer::onConnectionClosed(const quint32 id)
+{
+  if (m_devices.remove(id) > 0)
+    Q_EMIT connectionCountChanged();
+}
+
+/**
+ * Forwards the @a frames received by the connection with the given @a id,
+ * together with the name of the device that sent them.
+ */
+void IO::Drivers::TcpServer::onFramesReceived(const quint32 id,
+                                              const QByteArrayList &frames)
+{
+  const auto it = m_devices.constFind(id);
+  if (it != m_devices.constEnd())
+    Q_EMIT framesReceived(it.value(), frames);
+}
+
+/**
+ * Names the new connection with the given @a id after the @a address of the
+ * remote device. If another device is connected from the same address, the
+ * lowest free number is appended to the name.
+ */
+void IO::Drivers::TcpServer::onConnectionOpened(const quint32 id,
+                                                const QString &address)
+{
+  auto name = address;
+  const auto names = m_devices.values();
+  for (int i = 2; names.contains(name); ++i)
+    name = QStringLiteral("%1 (%2)").arg(address).arg(i);
+
+  m_devices.insert(id, name);
+  Q_EMIT connectionCountChanged();
+}
@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <QHash>
+#include <QThread>
+#include <QVector>
+#include <QTcpSocket>
+#include <QTcpServer>
+#include <QByteArray>
+#include <QHostAddress>
+#include <QByteArrayList>
+
+namespace IO
+{
+namespace Drivers
+{
+/**
+ * @brief The TcpServerWorker class
+ *
+ * Owns a subset of the inbound connections accepted by the @c TcpServer class.
+ * Each worker lives in its own thread, reads data from its sockets and splits
+ * the incoming stream of every connection into frames using a per-connection
+ * buffer. Extracted frames are sent to the GUI thread in batches, so that a
+ * burst of data only generates a single queued signal per connection.
+ *
+ * Frames are sent with their start & finish sequences and their checksum (if
+ * any), which is verified by the I/O manager.
+ */
+class TcpServerWorker : public QObject
+{
+  Q_OBJECT
+
+Q_SIGNALS:
+  void connectionClosed(const quint32 id);
+  void connectionOpened(const quint32 id, const QString &address);
+  void framesReceived(const quint32 id, const QByteArrayList &frames);
+
+public:
+  TcpServerWorker(const QByteArray &start, const QByteArray &finish,
+                  const int maxBufferSize);
+
+public Q_SLOTS:
+  void closeAll();
+  void write(const QByteArray &data);
+  void addConnection(const qintptr descriptor, const quint32 id);
+
+private Q_SLOTS:
+  void onReadyRead();
+  void onDisconnected();
+
+private:
+  int checksumLength(const QByteArray &buffer, const int index,
+                     bool *crc) const;
+
+private:
+  struct Connection
+  {
+    bool crc;
+    quint32 id;
+    QByteArray buffer;
+  };
+
+  int m_maxBufferSize;
+  QByteArray m_start;
+  QByteArray m_finish;
+  QHash<QTcpSocket *, Connection> m_connections;
+};
+
+/**
+ * @brief The TcpServer class
+ *
+ * TCP listener used by the network driver when Serial Studio waits for the
+ * devices to connect to the host (instead of connecting to a device itself).
+ *
+ * Accepted connections are distributed in a round-robin manner across a small
+ * pool of I/O threads, which keeps the GUI thread free of socket reads and
+ * frame extraction even when dozens of devices are connected at once.
+ *
+ * Each connection is named after the address of the remote device, so that a
+ * device keeps its name (and its datasets) when it reconnects. Devices that
+ * connect from the same address at the same time are numbered, e.g.
+ * "192.168.1.20 (2)".
+ */
+class TcpServer : public QTcpServer
+{
+  Q_OBJECT
+
+Q_SIGNALS:
+  void connectionCountChanged();
+  void framesReceived(const QString &device, const QByteArrayList &frames);
+
+public:
+  TcpServer(QObject *parent = Q_NULLPTR);
+  ~TcpServer();
+
+  int connectionCount() const;
+  static int defaultThreadCount();
+
+  bool start(const QHostAddress &address, const quint16 port,
+             const QByteArray &start, const QByteArray &finish,
+             const int maxBufferSize);
+  void stop();
+  void write(const QByteArray &data);
+
+protected:
+  void incomingConnection(qintptr descriptor) override;
+
+private Q_SLOTS:
+  void onConnectionClosed(const quint32 id);
+  void onFramesReceived(const quint32 id, const QByteArrayList &frames);
+  void onConnectionOpened(const quint32 id, const QString &address);
+
+private:
+  quint32 m_nextId;
+  int m_nextWorker;
+  QHash<quint32, QString> m_devices;
+  QVector<QThread *> m_threads;
+  QVector<TcpServerWorker *> m_workers;
+};
+} // namespace Drivers
+} // namespace IO
@@ -23,11 +23,16 @@
 
 #include <IO/Manager.h>
 #include <IO/Checksum.h>
+#include <IO/Recorder.h>
+#include <IO/Drivers/Pipe.h>
 #include <IO/Drivers/Serial.h>
+#include <IO/Drivers/Replay.h>
 #include <IO/Drivers/Network.h>
+#include <IO/Drivers/Synthetic.h>
 #include <IO/Drivers/BluetoothLE.h>
 
 #include <MQTT/Client.h>
+#include <Misc/Instrumentation.h>
 
 /**
  * Adds support for C escape sequences to the given @a str.
@@ -59,10 +64,18 @@ IO::Manager::Manager()
   , m_maxBufferSize(1024 * 1024)
   , m_driver(Q_NULLPTR)
   , m_receivedBytes(0)
+  , m_totalReceivedBytes(0)
+  , m_validFrames(0)
+  , m_checksumErrors(0)
+  , m_incompleteFrames(0)
+  , m_frameTime(0)
   , m_startSequence("/*")
   , m_finishSequence("*/")
   , m_separatorSequence(",")
 {
+  // Start the clock used to timestamp the received data
+  m_clock.start();
+
   // Set initial settings
   setMaxBufferSize(1024 * 1024);
   setSelectedDriver(SelectedDriver::Serial);
@@ -143,6 +156,89 @@ int IO::Manager::maxBufferSize() const
   return m_maxBufferSize;
 }
 
+/**
+ * Returns the number of bytes received from the current device
+ */
+quint64 IO::Manager::receivedBytes() const
+{
+  return m_receivedBytes;
+}
+
+/**
+ * Returns the number of bytes received since the application started
+ */
+quint64 IO::Manager::totalReceivedBytes() const
+{
+  return m_totalReceivedBytes;
+}
+
+/**
+ * Returns the number of frames that passed the integrity checks since the
+ * application started.
+ */
+quint64 IO::Manager::validFrames() const
+{
+  return m_validFrames;
+}
+
+/**
+ * Returns the number of frames discarded due to a checksum mismatch since the
+ * application started.
+ */
+quint64 IO::Manager::checksumErrors() const
+{
+  return m_checksumErrors;
+}
+
+/**
+ * Returns the number of times that a frame had to wait for the rest of its
+ * checksum to arrive since the application started.
+ */
+quint64 IO::Manager::incompleteFrames() const
+{
+  return m_incompleteFrames;
+}
+
+/**
+ * Returns the current time of the monotonic clock used to timestamp the
+ * received data, in microseconds.
+ */
+qint64 IO::Manager::timestamp() const
+{
+  return m_clock.nsecsElapsed() / 1000;
+}
+
+/**
+ * Returns the time (see @c timestamp()) at which the data that contains the
+ * frame being processed was received, so that frames keep the time at which
+ * they arrived regardless of when the rest of the application handles them.
+ */
+qint64 IO::Manager::frameTimestamp() const
+{
+  return m_frameTime;
+}
+
+/**
+ * Converts the given @a time of the monotonic clock (see @c timestamp()) to
+ * the local date/time at which it happened, so that data received together
+ * gets the same date/time, no matter when it is processed.
+ */
+QDateTime IO::Manager::dateTime(const qint64 time) const
+{
+  const auto elapsed = (timestamp() - time) / 1000;
+  return QDateTime::currentDateTime().addMSecs(-elapsed);
+}
+
+/**
+ * Returns the name of the device that sent the frame being processed, or an
+ * empty string if the frame was not received through a multi-device driver
+ * (e.g. the TCP server).
+ */
+QString IO::Manager::frameDevice() const
+{
+  return m_frameDevice;
+}
+
 /**
  * Returns a pointer to the currently selected driver.
  *
@@ -204,6 +300,9 @@ StringList IO::Manager::availableDrivers() const
   list.append(tr("Serial port"));
   list.append(tr("Network port"));
   list.append(tr("Bluetooth LE device"));
+  list.append(tr("Synthetic data generator"));
+  list.append(tr("Raw data replay"));
+  list.append(tr("Pipe, PTY or standard input"));
   return list;
 }
 
@@ -328,18 +427,84 @@ void IO::Manager::processPayload(const QByteArray &payload)
 {
   if (!payload.isEmpty())
   {
+    // Register the time at which the payload was received
+    m_frameTime = timestamp();
+    m_frameDevice.clear();
+
     // Update received bytes indicator
+    m_totalReceivedBytes += payload.size();
     m_receivedBytes += payload.size();
     if (m_receivedBytes >= UINT64_MAX)
       m_receivedBytes = 0;
 
     // Notify user interface & application modules
+    ++m_validFrames;
     Q_EMIT dataReceived(payload);
     Q_EMIT frameReceived(payload);
     Q_EMIT receivedBytesChanged();
   }
 }
 
+/**
+ * Processes the frames extracted by the TCP server I/O threads for the given
+ * @a device.
+ *
+ * Each element of @a frames contains a complete frame, including its start &
+ * finish sequences and its checksum (if any). The frames are recorded as they
+ * were received, so that replaying the capture extracts the same frames, and
+ * their checksums are verified like the ones of the frames extracted by
+ * @c readFrames().
+ *
+ * @param device name of the device that sent the frames, see
+ *               @c frameDevice()
+ */
+void IO::Manager::processServerFrames(const QByteArrayList &frames,
+                                      const QString &device)
+{
+  if (frames.isEmpty())
+    return;
+
+  // Register the time at which the frames were received, their sender & record
+  // them before processing them
+  const auto data = frames.join();
+  m_frameTime = timestamp();
+  m_frameDevice = device;
+  IO::Recorder::instance().append(data);
+
+  // Update received bytes indicator
+  m_totalReceivedBytes += data.size();
+  m_receivedBytes += data.size();
+  if (m_receivedBytes >= UINT64_MAX)
+    m_receivedBytes = 0;
+
+  // Remove the delimiters of each frame & verify its checksum
+  const auto start = startSequence().toUtf8();
+  const auto finish = finishSequence().toUtf8();
+  for (const auto &record : frames)
+  {
+    int chop = 0;
+    bool enableCrc = false;
+    const auto cursor = record.mid(start.length());
+    const auto frame = cursor.left(cursor.indexOf(finish));
+    if (integrityChecks(frame, cursor, &enableCrc, &chop)
+        == ValidationStatus::FrameOk)
+    {
+      ++m_validFrames;
+      Q_EMIT frameReceived(frame);
+    }
+
+    else
+    {
+      ++m_checksumErrors;
+      Misc::Instrumentation::addDropped(Misc::Instrumentation::ChecksumError);
+    }
+  }
+
+  // Notify user interface
+  Q_EMIT receivedBytesChanged();
+  Q_EMIT dataReceived(data);
+}
+
 /**
  * Changes the maximum permited buffer size. Check the @c maxBufferSize()
  * function for more information.
@@ -418,6 +583,18 @@ void IO::Manager::setSelectedDriver(const IO::Manager::SelectedDriver &driver)
   else if (selectedDriver() == SelectedDriver::BluetoothLE)
     setDriver(&(Drivers::BluetoothLE::instance()));
 
+  // Generate synthetic frames
+  else if (selectedDriver() == SelectedDriver::Synthetic)
+    setDriver(&(Drivers::Synthetic::instance()));
+
+  // Replay a raw data capture
+  else if (selectedDriver() == SelectedDriver::Replay)
+    setDriver(&(Drivers::Replay::instance()));
+
+  // Read from a local pipe
+  else if (selectedDriver() == SelectedDriver::Pipe)
+    setDriver(&(Drivers::Pipe::instance()));
+
   // Invalid driver
   else
     setDriver(Q_NULLPTR);
@@ -441,7 +618,11 @@ void IO::Manager::readFrames()
   if (!connected())
     return;
 
+  // Measure time spent extracting frames (not processing them)
+  Misc::Instrumentation::ScopedTimer timer(Misc::Instrumentation::ReadFrames);
+
   // Read until start/finish combinations are not found
+  QVector<QByteArray> frames;
   auto bytes = 0;
   auto prevBytes = 0;
   auto cursor = m_dataBuffer;
@@ -464,13 +645,24 @@ void IO::Manager::readFrames()
     {
       // Checksum verification & Q_EMIT RX frame
       int chop = 0;
-      auto result = integrityChecks(frame, cursor, &chop);
+      auto result = integrityChecks(frame, cursor, &m_enableCrc, &chop);
       if (result == ValidationStatus::FrameOk)
-        Q_EMIT frameReceived(frame);
+      {
+        ++m_validFrames;
+        frames.append(frame);
+      }
+
+      // Checksum mismatch, frame is discarded
+      else if (result == ValidationStatus::ChecksumError)
+      {
+        ++m_checksumErrors;
+        Misc::Instrumentation::addDropped(Misc::Instrumentation::ChecksumError);
+      }
 
       // Checksum data incomplete, try next time...
       else if (result == ValidationStatus::ChecksumIncomplete)
       {
+        ++m_incompleteFrames;
         bytes = prevBytes;
         break;
       }
@@ -494,7 +686,19 @@ void IO::Manager::readFrames()
 
   // Clear temp. buffer (e.g. device sends a lot of invalid data)
   if (m_dataBuffer.size() > maxBufferSize())
+  {
+    Misc::Instrumentation::addDropped(Misc::Instrumentation::BufferOverflow);
     clearTempBuffer();
+  }
+
+  // Update buffer usage statistics
+  Misc::Instrumentation::setQueueDepth(Misc::Instrumentation::InputBuffer,
+                                       m_dataBuffer.size());
+
+  // Notify the rest of the application
+  timer.stop();
+  for (const auto &frame : frames)
+    Q_EMIT frameReceived(frame);
 }
 
 /**
@@ -535,6 +739,12 @@ void IO::Manager::onDataReceived(const QByteArray &data)
   if (!driver())
     disconnectDriver();
 
+  // Register the time at which the data was received & record it before
+  // processing it
+  m_frameTime = timestamp();
+  m_frameDevice.clear();
+  IO::Recorder::instance().append(data);
+
   // Read data & append it to buffer
   auto bytes = data.length();
 
@@ -543,6 +753,7 @@ void IO::Manager::onDataReceived(const QByteArray &data)
   readFrames();
 
   // Update received bytes indicator
+  m_totalReceivedBytes += bytes;
   m_receivedBytes += bytes;
   if (m_receivedBytes >= UINT64_MAX)
     m_receivedBytes = 0;
@@ -560,12 +771,14 @@ void IO::Manager::onDataReceived(const QByteArray &data)
  *
  * @param frame data in which we shall perform integrity checks
  * @param cursor master buffer, should start with checksum type header
+ * @param enableCrc pointer to the flag that is set once a checksum is found,
+ * after which frames without a checksum are considered incomplete
  * @param bytes pointer to the number of bytes that we need to chop from the
  * master buffer
  */
 IO::Manager::ValidationStatus
 IO::Manager::integrityChecks(const QByteArray &frame, const QByteArray &cursor,
-                             int *bytes)
+                             bool *enableCrc, int *bytes)
 {
   // Get finish sequence as byte array
   auto finish = finishSequence().toUtf8();
@@ -577,7 +790,7 @@ IO::Manager::integrityChecks(const QByteArray &frame, const QByteArray &cursor,
   if (cursor.contains(crc8Header))
   {
     // Enable the CRC flag
-    m_enableCrc = true;
+    *enableCrc = true;
     auto offset = cursor.indexOf(crc8Header) + crc8Header.length() - 1;
 
     // Check if we have enough data in the buffer
@@ -601,7 +814,7 @@ IO::Manager::integrityChecks(const QByteArray &frame, const QByteArray &cursor,
   else if (cursor.contains(crc16Header))
   {
     // Enable the CRC flag
-    m_enableCrc = true;
+    *enableCrc = true;
     auto offset = cursor.indexOf(crc16Header) + crc16Header.length() - 1;
 
     // Check if we have enough data in the buffer
@@ -627,7 +840,7 @@ IO::Manager::integrityChecks(const QByteArray &frame, const QByteArray &cursor,
   else if (cursor.contains(crc32Header))
   {
     // Enable the CRC flag
-    m_enableCrc = true;
+    *enableCrc = true;
     auto offset = cursor.indexOf(crc32Header) + crc32Header.length() - 1;
 
     // Check if we have enough data in the buffer
@@ -652,7 +865,7 @@ IO::Manager::integrityChecks(const QByteArray &frame, const QByteArray &cursor,
   }
 
   // Buffer does not contain CRC code
-  else if (!m_enableCrc)
+  else if (!*enableCrc)
   {
     *bytes += finish.length();
     return ValidationStatus::FrameOk;
@@ -23,7 +23,10 @@
 #pragma once
 
 #include <QObject>
+#include <QDateTime>
+#include <QByteArrayList>
 #include <DataTypes.h>
+#include <QElapsedTimer>
 #include <IO/HAL_Driver.h>
 
 namespace IO
@@ -90,6 +93,9 @@ class Manager : public QObject
     Q_PROPERTY(bool configurationOk
                READ configurationOk
                NOTIFY configurationChanged)
+    Q_PROPERTY(quint64 receivedBytes
+               READ receivedBytes
+               NOTIFY receivedBytesChanged)
   // clang-format on
 
 Q_SIGNALS:
@@ -120,7 +126,10 @@ public:
   {
     Serial,
     Network,
-    BluetoothLE
+    BluetoothLE,
+    Synthetic,
+    Replay,
+    Pipe
   };
   Q_ENUM(SelectedDriver)
 
@@ -142,6 +151,17 @@ public:
 
   int maxBufferSize() const;
 
+  quint64 receivedBytes() const;
+  quint64 totalReceivedBytes() const;
+  quint64 validFrames() const;
+  quint64 checksumErrors() const;
+  quint64 incompleteFrames() const;
+
+  qint64 timestamp() const;
+  qint64 frameTimestamp() const;
+  QDateTime dateTime(const qint64 time) const;
+  QString frameDevice() const;
+
   HAL_Driver *driver();
   SelectedDriver selectedDriver() const;
 
@@ -158,6 +178,8 @@ public Q_SLOTS:
   void disconnectDriver();
   void setWriteEnabled(const bool enabled);
   void processPayload(const QByteArray &payload);
+  void processServerFrames(const QByteArrayList &frames,
+                           const QString &device);
   void setMaxBufferSize(const int maxBufferSize);
   void setStartSequence(const QString &sequence);
   void setFinishSequence(const QString &sequence);
@@ -173,7 +195,7 @@ private Q_SLOTS:
 private:
   ValidationStatus integrityChecks(const QByteArray &frame,
                                    const QByteArray &masterBuffer,
-                                   int *bytesToChop);
+                                   bool *enableCrc, int *bytesToChop);
 
 private:
   bool m_enableCrc;
@@ -182,6 +204,13 @@ private:
   HAL_Driver *m_driver;
   QByteArray m_dataBuffer;
   quint64 m_receivedBytes;
+  quint64 m_totalReceivedBytes;
+  quint64 m_validFrames;
+  quint64 m_checksumErrors;
+  quint64 m_incompleteFrames;
+  QElapsedTimer m_clock;
+  qint64 m_frameTime;
+  QString m_frameDevice;
   QString m_startSequence;
   QString m_finishSequence;
   QString m_separatorSequence;
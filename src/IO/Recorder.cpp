@@ -0,0 +1,432 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <AppInfo.h>
+
+#include <IO/Manager.h>
+#include <IO/Recorder.h>
+#include <JSON/Generator.h>
+#include <Misc/Utilities.h>
+#include <Misc/TimerEvents.h>
+
+#include <QDir>
+#include <QtEndian>
+#include <QDateTime>
+#include <QJsonDocument>
+#include <QCoreApplication>
+
+/**
+ * Magic number written at the beginning of each capture file
+ */
+static constexpr char kMagic[] = "SSRAWCAP";
+static constexpr int kMagicSize = sizeof(kMagic) - 1;
+
+/**
+ * Size of the in-memory buffer that triggers a write before the next 10 Hz
+ * timer event.
+ */
+static constexpr int kFlushSize = 1024 * 1024;
+
+//----------------------------------------------------------------------------------------
+// Worker implementation
+//----------------------------------------------------------------------------------------
+
+/**
+ * Writes pending data to disk & closes the capture file
+ */
+void IO::RecorderWorker::close()
+{
+  if (m_file.isOpen())
+  {
+    m_file.flush();
+    m_file.close();
+  }
+}
+
+/**
+ * Appends the given @a data to the capture file
+ */
+void IO::RecorderWorker::write(const QByteArray &data)
+{
+  if (!m_file.isOpen() || data.isEmpty())
+    return;
+
+  if (m_file.write(data) != data.size())
+  {
+    Q_EMIT failed(m_file.fileName());
+    close();
+  }
+}
+
+/**
+ * Creates the capture file at the given @a path & writes its @a header
+ */
+void IO::RecorderWorker::open(const QString &path, const QByteArray &header)
+{
+  close();
+
+  m_file.setFileName(path);
+  if (!m_file.open(QFile::WriteOnly | QFile::Truncate))
+  {
+    Q_EMIT failed(path);
+    return;
+  }
+
+  write(header);
+}
+
+//----------------------------------------------------------------------------------------
+// Constructor/destructor & singleton access functions
+//----------------------------------------------------------------------------------------
+
+/**
+ * Constructor function, creates the writer. The writer thread is started
+ * when the first recording starts.
+ */
+IO::Recorder::Recorder()
+  : m_isOpen(false)
+  , m_enabled(false)
+  , m_worker(new RecorderWorker)
+{
+  // Move the worker to its thread
+  m_worker->moveToThread(&m_thread);
+  m_thread.setObjectName(QStringLiteral("Recorder"));
+
+  // clang-format off
+    connect(&m_thread, &QThread::finished,
+            m_worker, &QObject::deleteLater);
+    connect(m_worker, &IO::RecorderWorker::failed,
+            this, &IO::Recorder::onWriteFailed);
+    connect(&IO::Manager::instance(), &IO::Manager::connectedChanged,
+            this, &IO::Recorder::onConnectedChanged);
+    connect(&Misc::TimerEvents::instance(), &Misc::TimerEvents::timeout10Hz,
+            this, &IO::Recorder::flush);
+    connect(QCoreApplication::instance(), &QCoreApplication::aboutToQuit,
+            this, &IO::Recorder::onAboutToQuit);
+  // clang-format on
+}
+
+/**
+ * Destructor function, deletes the writer if its thread was never started.
+ * The capture file is closed & the thread is stopped before the application
+ * quits (see @c onAboutToQuit()).
+ */
+IO::Recorder::~Recorder()
+{
+  if (m_thread.isRunning())
+  {
+    m_thread.quit();
+    m_thread.wait();
+  }
+
+  else
+    delete m_worker;
+}
+
+/**
+ * Returns the only instance of the class
+ */
+IO::Recorder &IO::Recorder::instance()
+{
+  static Recorder singleton;
+  return singleton;
+}
+
+//----------------------------------------------------------------------------------------
+// Member access functions
+//----------------------------------------------------------------------------------------
+
+/**
+ * Returns @c true if the received data is currently being recorded
+ */
+bool IO::Recorder::isOpen() const
+{
+  return m_isOpen;
+}
+
+/**
+ * Returns @c true if the received data shall be recorded when a device is
+ * connected.
+ */
+bool IO::Recorder::enabled() const
+{
+  return m_enabled;
+}
+
+/**
+ * Returns the path of the current capture file
+ */
+QString IO::Recorder::fileName() const
+{
+  return m_fileName;
+}
+
+/**
+ * Reads & validates the header of the capture file opened by the given
+ * @a device. The JSON object stored in the header is written to @a metadata.
+ *
+ * @returns @c false if the device does not contain a valid capture file
+ */
+bool IO::Recorder::readHeader(QIODevice &device, QJsonObject &metadata)
+{
+  // Validate magic number
+  const auto magic = device.read(kMagicSize);
+  if (magic != QByteArray(kMagic, kMagicSize))
+    return false;
+
+  // Read version & metadata length
+  uchar fields[8];
+  if (device.read(reinterpret_cast<char *>(fields), 8) != 8)
+    return false;
+
+  const auto version = qFromLittleEndian<quint32>(fields);
+  const auto length = qFromLittleEndian<quint32>(fields + 4);
+  if (version > kVersion || length > kMaxChunkSize)
+    return false;
+
+  // Read metadata
+  const auto json = device.read(length);
+  if (json.size() != static_cast<int>(length))
+    return false;
+
+  metadata = QJsonDocument::fromJson(json).object();
+  return true;
+}
+
+/**
+ * Reads the next chunk of the capture file opened by the given @a device,
+ * the time (in nanoseconds since the recording started) at which the chunk
+ * was received is written to @a time.
+ *
+ * @returns @c false at the end of the file, or if the chunk is truncated
+ */
+bool IO::Recorder::readChunk(QIODevice &device, qint64 &time, QByteArray &data)
+{
+  uchar header[kChunkHeaderSize];
+  auto buffer = reinterpret_cast<char *>(header);
+  if (device.read(buffer, kChunkHeaderSize) != kChunkHeaderSize)
+    return false;
+
+  time = qFromLittleEndian<qint64>(header);
+  const auto length = qFromLittleEndian<quint32>(header + 8);
+  if (length > kMaxChunkSize)
+    return false;
+
+  data = device.read(length);
+  return data.size() == static_cast<int>(length);
+}
+
+/**
+ * Appends the given @a data to the capture file, together with the time
+ * elapsed since the recording started.
+ *
+ * This function is called by the @c IO::Manager class as soon as data is
+ * received, so that the recorded timing is not affected by the time spent
+ * processing the frames.
+ */
+void IO::Recorder::append(const QByteArray &data)
+{
+  if (!m_isOpen)
+    return;
+
+  uchar header[kChunkHeaderSize];
+  qToLittleEndian<qint64>(m_clock.nsecsElapsed(), header);
+  qToLittleEndian<quint32>(static_cast<quint32>(data.size()), header + 8);
+
+  m_buffer.append(reinterpret_cast<const char *>(header), sizeof(header));
+  m_buffer.append(data);
+  if (m_buffer.size() >= kFlushSize)
+    flush();
+}
+
+/**
+ * Reveals the current capture file in the Explorer/Finder window
+ */
+void IO::Recorder::openCurrentFile()
+{
+  if (isOpen())
+    Misc::Utilities::revealFile(m_fileName);
+  else
+    Misc::Utilities::showMessageBox(tr("Raw data recording not active"),
+                                    tr("Cannot find capture file!"));
+}
+
+/**
+ * Enables or disables raw data recording, if a device is already connected
+ * the recording starts (or stops) immediately.
+ */
+void IO::Recorder::setEnabled(const bool enabled)
+{
+  if (m_enabled == enabled)
+    return;
+
+  m_enabled = enabled;
+  Q_EMIT enabledChanged();
+
+  onConnectedChanged();
+}
+
+//----------------------------------------------------------------------------------------
+// Recording control
+//----------------------------------------------------------------------------------------
+
+/**
+ * Hands the buffered records over to the writer thread
+ */
+void IO::Recorder::flush()
+{
+  if (m_buffer.isEmpty())
+    return;
+
+  const auto worker = m_worker;
+  const auto buffer = m_buffer;
+  QMetaObject::invokeMethod(
+      worker, [=] { worker->write(buffer); }, Qt::QueuedConnection);
+
+  m_buffer = QByteArray();
+  m_buffer.reserve(kFlushSize + kChunkHeaderSize);
+}
+
+/**
+ * Starts recording when a device is connected (and recording is enabled),
+ * and closes the capture file when the device is disconnected.
+ */
+void IO::Recorder::onConnectedChanged()
+{
+  const auto &manager = IO::Manager::instance();
+  const auto replay = manager.selectedDriver()
+                      == IO::Manager::SelectedDriver::Replay;
+
+  if (manager.connected() && m_enabled && !replay)
+    startRecording();
+  else
+    stopRecording();
+}
+
+/**
+ * Stops recording & notifies the user when the capture file cannot be
+ * written.
+ */
+void IO::Recorder::onWriteFailed(const QString &path)
+{
+  stopRecording();
+  Misc::Utilities::showMessageBox(tr("Raw data recording error"),
+                                  tr("Cannot write to %1").arg(path));
+}
+
+/**
+ * Closes the capture file & stops the writer thread while the event loop is
+ * still running, so that no blocking call is made during static destruction.
+ */
+void IO::Recorder::onAboutToQuit()
+{
+  stopRecording();
+  if (m_thread.isRunning())
+  {
+    m_thread.quit();
+    m_thread.wait();
+    m_worker = Q_NULLPTR;
+  }
+}
+
+/**
+ * Creates a new capture file & starts recording the received data
+ */
+void IO::Recorder::startRecording()
+{
+  if (m_isOpen || !m_worker)
+    return;
+
+  // Get file name & path
+  const auto now = QDateTime::currentDateTime();
+  const auto path = QStringLiteral("%1/Documents/%2/Raw/%3/")
+                        .arg(QDir::homePath(), qApp->applicationName(),
+                             now.toString(QStringLiteral("yyyy/MMM/dd")));
+
+  // Generate file path if required
+  QDir dir(path);
+  if (!dir.exists())
+    dir.mkpath(".");
+
+  // Store the settings required to replay the session
+  auto &manager = IO::Manager::instance();
+  auto &generator = JSON::Generator::instance();
+  QJsonObject metadata;
+  metadata.insert(QStringLiteral("application"), APP_NAME);
+  metadata.insert(QStringLiteral("version"), APP_VERSION);
+  metadata.insert(QStringLiteral("date"), now.toString(Qt::ISODateWithMs));
+  metadata.insert(QStringLiteral("start"), manager.startSequence());
+  metadata.insert(QStringLiteral("finish"), manager.finishSequence());
+  metadata.insert(QStringLiteral("separator"), manager.separatorSequence());
+  metadata.insert(QStringLiteral("project"), generator.jsonMapFilepath());
+  metadata.insert(QStringLiteral("operationMode"),
+                  static_cast<int>(generator.operationMode()));
+  const auto json = QJsonDocument(metadata).toJson(QJsonDocument::Compact);
+
+  // Build file header
+  uchar fields[8];
+  qToLittleEndian<quint32>(kVersion, fields);
+  qToLittleEndian<quint32>(static_cast<quint32>(json.size()), fields + 4);
+
+  QByteArray header(kMagic, kMagicSize);
+  header.append(reinterpret_cast<const char *>(fields), sizeof(fields));
+  header.append(json);
+
+  // Create the file in the writer thread
+  if (!m_thread.isRunning())
+    m_thread.start(QThread::LowPriority);
+
+  const auto worker = m_worker;
+  const auto name = now.toString(QStringLiteral("HH-mm-ss")) + ".ssraw";
+  m_fileName = dir.filePath(name);
+  const auto fileName = m_fileName;
+  QMetaObject::invokeMethod(
+      worker, [=] { worker->open(fileName, header); }, Qt::QueuedConnection);
+
+  // Start recording
+  m_buffer.clear();
+  m_buffer.reserve(kFlushSize + kChunkHeaderSize);
+  m_clock.start();
+  m_isOpen = true;
+  Q_EMIT openChanged();
+}
+
+/**
+ * Writes the pending records & closes the capture file. The call blocks
+ * until the file is closed, so that the capture is complete when the device
+ * is disconnected (or when the application exits).
+ */
+void IO::Recorder::stopRecording()
+{
+  if (!m_isOpen)
+    return;
+
+  m_isOpen = false;
+  flush();
+
+  const auto worker = m_worker;
+  QMetaObject::invokeMethod(
+      worker, [=] { worker->close(); }, Qt::BlockingQueuedConnection);
+
+  m_buffer = QByteArray();
+  Q_EMIT openChanged();
+}
@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <QFile>
+#include <QObject>
+#include <QThread>
+#include <QByteArray>
+#include <QIODevice>
+#include <QJsonObject>
+#include <QElapsedTimer>
+
+namespace IO
+{
+/**
+ * @brief The RecorderWorker class
+ *
+ * Lives in the recorder thread & writes the buffers that it receives to the
+ * capture file, so that disk I/O never blocks the data pipeline.
+ */
+class RecorderWorker : public QObject
+{
+  Q_OBJECT
+
+Q_SIGNALS:
+  void failed(const QString &path);
+
+public Q_SLOTS:
+  void close();
+  void write(const QByteArray &data);
+  void open(const QString &path, const QByteArray &header);
+
+private:
+  QFile m_file;
+};
+
+/**
+ * @brief The Recorder class
+ *
+ * Records the raw bytes received by the @c IO::Manager class (before any
+ * frame extraction takes place), together with the time at which each chunk
+ * was received, so that a session can be replayed later with the
+ * @c IO::Drivers::Replay driver exactly as the device sent it.
+ *
+ * The capture file starts with a small header (magic number, format version
+ * & a JSON object with the frame sequences and project used during the
+ * session), followed by one record per received chunk:
+ *
+ * - Time since the recording started, in nanoseconds (64-bit).
+ * - Length of the chunk, in bytes (32-bit).
+ * - The bytes of the chunk.
+ *
+ * All integers are little-endian. Records are appended to an in-memory
+ * buffer, which is handed over to a worker thread ten times per second (or
+ * earlier, if it grows too large), so the cost per chunk is a single copy.
+ *
+ * Recording starts when a device is connected & stops when the device is
+ * disconnected. Sessions replayed with the @c IO::Drivers::Replay driver are
+ * not recorded again.
+ */
+class Recorder : public QObject
+{
+  // clang-format off
+    Q_OBJECT
+    Q_PROPERTY(bool enabled
+               READ enabled
+               WRITE setEnabled
+               NOTIFY enabledChanged)
+    Q_PROPERTY(bool isOpen
+               READ isOpen
+               NOTIFY openChanged)
+    Q_PROPERTY(QString fileName
+               READ fileName
+               NOTIFY openChanged)
+  // clang-format on
+
+Q_SIGNALS:
+  void openChanged();
+  void enabledChanged();
+
+private:
+  explicit Recorder();
+  Recorder(Recorder &&) = delete;
+  Recorder(const Recorder &) = delete;
+  Recorder &operator=(Recorder &&) = delete;
+  Recorder &operator=(const Recorder &) = delete;
+
+  ~Recorder();
+
+public:
+  static Recorder &instance();
+
+  static constexpr quint32 kVersion = 1;
+  static constexpr int kChunkHeaderSize = 12;
+  static constexpr int kMaxChunkSize = 64 * 1024 * 1024;
+
+  bool isOpen() const;
+  bool enabled() const;
+  QString fileName() const;
+
+  static bool readHeader(QIODevice &device, QJsonObject &metadata);
+  static bool readChunk(QIODevice &device, qint64 &time, QByteArray &data);
+
+  void append(const QByteArray &data);
+
+public Q_SLOTS:
+  void openCurrentFile();
+  void setEnabled(const bool enabled);
+
+private Q_SLOTS:
+  void flush();
+  void onAboutToQuit();
+  void onConnectedChanged();
+  void onWriteFailed(const QString &path);
+
+private:
+  void startRecording();
+  void stopRecording();
+
+private:
+  bool m_isOpen;
+  bool m_enabled;
+  QString m_fileName;
+  QByteArray m_buffer;
+  QElapsedTimer m_clock;
+
+  QThread m_thread;
+  RecorderWorker *m_worker;
+};
+} // namespace IO
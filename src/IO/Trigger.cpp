@@ -0,0 +1,733 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <algorithm>
+
+#include <QDir>
+#include <QFile>
+#include <QTextStream>
+#include <QCoreApplication>
+
+#include <IO/Manager.h>
+#include <IO/Trigger.h>
+#include <JSON/Generator.h>
+#include <JSON/Expression.h>
+#include <Misc/Utilities.h>
+#include <Misc/TimerEvents.h>
+
+/**
+ * Converts the given trigger @a pattern to bytes, replacing C-style escape
+ * sequences (e.g. "\n", "\r", "\t", "\0", "\\" or "\xFF") with the bytes
+ * that they represent.
+ */
+static QByteArray parsePattern(const QString &pattern)
+{
+  QByteArray bytes;
+  const auto text = pattern.toUtf8();
+  for (int i = 0; i < text.length(); ++i)
+  {
+    // Regular character
+    const auto c = text.at(i);
+    if (c != '\\' || i + 1 >= text.length())
+    {
+      bytes.append(c);
+      continue;
+    }
+
+    // Escape sequence
+    const auto e = text.at(++i);
+    if (e == 'n')
+      bytes.append('\n');
+    else if (e == 'r')
+      bytes.append('\r');
+    else if (e == 't')
+      bytes.append('\t');
+    else if (e == '0')
+      bytes.append('\0');
+    else if (e == 'x' && i + 2 < text.length())
+    {
+      bool ok;
+      const auto value = text.mid(i + 1, 2).toInt(&ok, 16);
+      if (ok)
+      {
+        bytes.append(static_cast<char>(value));
+        i += 2;
+      }
+
+      else
+        bytes.append(e);
+    }
+
+    else
+      bytes.append(e);
+  }
+
+  return bytes;
+}
+
+/**
+ * Constructor function
+ */
+IO::Trigger::Trigger()
+  : m_mode(Single)
+  , m_condition(RisingEdge)
+  , m_source(0)
+  , m_level(0)
+  , m_preTrigger(500)
+  , m_postTrigger(500)
+  , m_state(State::Stopped)
+  , m_captureCount(0)
+  , m_revision(0)
+  , m_armTime(0)
+  , m_triggerTime(0)
+  , m_previous(qQNaN())
+  , m_pendingFrame(-1)
+  , m_head(0)
+  , m_count(0)
+  , m_stride(0)
+{
+  // clang-format off
+    connect(&JSON::Generator::instance(), &JSON::Generator::frameChanged,
+            this, &IO::Trigger::registerFrame);
+    connect(&IO::Manager::instance(), &IO::Manager::frameReceived,
+            this, &IO::Trigger::registerRawFrame);
+    connect(&IO::Manager::instance(), &IO::Manager::dataReceived,
+            this, &IO::Trigger::scanData);
+    connect(&IO::Manager::instance(), &IO::Manager::connectedChanged,
+            this, &IO::Trigger::reset);
+    connect(&JSON::Generator::instance(), &JSON::Generator::jsonFileMapChanged,
+            this, &IO::Trigger::reset);
+    connect(&Misc::TimerEvents::instance(), &Misc::TimerEvents::timeout10Hz,
+            this, &IO::Trigger::checkTimeout);
+  // clang-format on
+
+  m_clock.start();
+}
+
+/**
+ * Returns the only instance of the class
+ */
+IO::Trigger &IO::Trigger::instance()
+{
+  static Trigger singleton;
+  return singleton;
+}
+
+/**
+ * Returns the trigger mode, which corresponds to the list returned by the
+ * @c availableModes() function
+ */
+int IO::Trigger::mode() const
+{
+  return m_mode;
+}
+
+/**
+ * Returns the trigger condition, which corresponds to the list returned by
+ * the @c availableConditions() function
+ */
+int IO::Trigger::condition() const
+{
+  return m_condition;
+}
+
+/**
+ * Returns the index of the dataset that is compared with the trigger level,
+ * which corresponds to the list returned by the @c sources() function
+ */
+int IO::Trigger::source() const
+{
+  return m_source;
+}
+
+/**
+ * Returns the value that the source dataset must cross (or exceed) to fire
+ * the trigger
+ */
+double IO::Trigger::level() const
+{
+  return m_level;
+}
+
+/**
+ * Returns the byte pattern that fires the trigger when it is found in the
+ * received data
+ */
+QString IO::Trigger::pattern() const
+{
+  return m_pattern;
+}
+
+/**
+ * Returns the number of milliseconds captured before the trigger fires
+ */
+int IO::Trigger::preTrigger() const
+{
+  return m_preTrigger;
+}
+
+/**
+ * Returns the number of milliseconds captured after the trigger fires
+ */
+int IO::Trigger::postTrigger() const
+{
+  return m_postTrigger;
+}
+
+/**
+ * Returns the current state of the trigger
+ */
+IO::Trigger::State IO::Trigger::state() const
+{
+  return m_state;
+}
+
+/**
+ * Returns the titles of the datasets of the received frames, which can be
+ * used as the trigger source
+ */
+StringList IO::Trigger::sources() const
+{
+  return m_titles;
+}
+
+/**
+ * Returns the number of captures written since the application started
+ */
+int IO::Trigger::captureCount() const
+{
+  return m_captureCount;
+}
+
+/**
+ * Returns the path of the latest capture file
+ */
+QString IO::Trigger::lastCapture() const
+{
+  return m_lastCapture;
+}
+
+/**
+ * Returns a list with the available trigger modes
+ */
+StringList IO::Trigger::availableModes() const
+{
+  return StringList{tr("Single"), tr("Normal"), tr("Auto")};
+}
+
+/**
+ * Returns a list with the available trigger conditions
+ */
+StringList IO::Trigger::availableConditions() const
+{
+  return StringList{tr("Rising edge"), tr("Falling edge"), tr("Any edge"),
+                    tr("Above level"), tr("Below level"), tr("Byte pattern")};
+}
+
+/**
+ * Arms the trigger & resumes the dashboard (if it was frozen by a previous
+ * capture)
+ */
+void IO::Trigger::arm()
+{
+  m_tail.clear();
+  m_previous = qQNaN();
+  m_armTime = m_clock.elapsed();
+  m_state = State::Armed;
+  Q_EMIT captureHeld(false);
+  Q_EMIT stateChanged();
+}
+
+/**
+ * Stops the trigger, pending captures are discarded
+ */
+void IO::Trigger::stop()
+{
+  if (m_state != State::Stopped)
+  {
+    m_state = State::Stopped;
+    Q_EMIT stateChanged();
+  }
+}
+
+/**
+ * Fires the trigger manually (if it is armed)
+ */
+void IO::Trigger::force()
+{
+  if (m_state == State::Armed)
+    fire();
+}
+
+/**
+ * Changes the trigger @a mode, check the @c availableModes() function
+ */
+void IO::Trigger::setMode(const int mode)
+{
+  const auto value = qBound(0, mode, static_cast<int>(Auto));
+  if (m_mode != value)
+  {
+    m_mode = value;
+    Q_EMIT configurationChanged();
+  }
+}
+
+/**
+ * Changes the trigger @a condition, check the @c availableConditions()
+ * function
+ */
+void IO::Trigger::setCondition(const int condition)
+{
+  const auto value = qBound(0, condition, static_cast<int>(BytePattern));
+  if (m_condition != value)
+  {
+    m_tail.clear();
+    m_condition = value;
+    m_previous = qQNaN();
+    Q_EMIT configurationChanged();
+  }
+}
+
+/**
+ * Changes the index of the dataset that is compared with the trigger level
+ */
+void IO::Trigger::setSource(const int source)
+{
+  const auto value = qMax(0, source);
+  if (m_source != value)
+  {
+    m_source = value;
+    m_previous = qQNaN();
+    Q_EMIT configurationChanged();
+  }
+}
+
+/**
+ * Changes the trigger @a level
+ */
+void IO::Trigger::setLevel(const double level)
+{
+  if (m_level != level)
+  {
+    m_level = level;
+    Q_EMIT configurationChanged();
+  }
+}
+
+/**
+ * Changes the byte pattern that fires the trigger
+ */
+void IO::Trigger::setPattern(const QString &pattern)
+{
+  if (m_pattern != pattern)
+  {
+    m_tail.clear();
+    m_pattern = pattern;
+    m_bytes = parsePattern(pattern);
+    Q_EMIT configurationChanged();
+  }
+}
+
+/**
+ * Changes the number of @a milliseconds captured before the trigger fires
+ */
+void IO::Trigger::setPreTrigger(const int milliseconds)
+{
+  const auto value = qMax(0, milliseconds);
+  if (m_preTrigger != value)
+  {
+    m_preTrigger = value;
+    Q_EMIT configurationChanged();
+  }
+}
+
+/**
+ * Changes the number of @a milliseconds captured after the trigger fires
+ */
+void IO::Trigger::setPostTrigger(const int milliseconds)
+{
+  const auto value = qMax(0, milliseconds);
+  if (m_postTrigger != value)
+  {
+    m_postTrigger = value;
+    Q_EMIT configurationChanged();
+  }
+}
+
+/**
+ * Writes the pending capture (if any) & clears the ring buffer when the
+ * device is connected or disconnected, or when the project file changes. The
+ * dataset titles are read again from the next frame, while the memory of the
+ * ring buffer is kept, so that it can be reused by the next connection.
+ */
+void IO::Trigger::reset()
+{
+  if (m_state == State::Triggered)
+    finishCapture();
+
+  m_revision = 0;
+  m_head = 0;
+  m_count = 0;
+  m_tail.clear();
+  m_pendingFrame = -1;
+  m_previous = qQNaN();
+}
+
+/**
+ * Forces a capture in auto mode if the trigger did not fire within the
+ * capture window & finishes the current capture if no frames are received
+ * after the trigger fired.
+ */
+void IO::Trigger::checkTimeout()
+{
+  const auto now = m_clock.elapsed();
+  if (m_state == State::Armed && m_mode == Auto)
+  {
+    const auto timeout = qMax(100, m_preTrigger + m_postTrigger);
+    if (now - m_armTime >= timeout)
+      fire();
+  }
+
+  if (m_state == State::Triggered && now > m_triggerTime + m_postTrigger)
+    finishCapture();
+}
+
+/**
+ * Associates the raw bytes of the given @a frame with the latest frame that
+ * was copied to the ring buffer.
+ *
+ * @note The JSON generator receives frames from the I/O manager before this
+ *       class, so the parsed values are already in the ring buffer.
+ */
+void IO::Trigger::registerRawFrame(const QByteArray &frame)
+{
+  if (m_pendingFrame >= 0 && m_pendingFrame < m_frames.count())
+    m_frames[m_pendingFrame] = frame;
+
+  m_pendingFrame = -1;
+}
+
+/**
+ * Copies the values of the given @a frame to the ring buffer & evaluates the
+ * trigger condition (if the trigger is armed).
+ */
+void IO::Trigger::registerFrame(const JSON::Frame &frame)
+{
+  // Check if the structure of the frame changed
+  const bool changed = frame.revision() != m_revision;
+
+  // Update dataset titles & clear the ring buffer
+  if (changed)
+    configure(frame);
+
+  // Nothing to do if the trigger is stopped
+  if (m_state == State::Stopped)
+    return;
+
+  // Copy frame values to the ring buffer
+  const auto time = m_clock.elapsed();
+  const auto slot = appendFrame(time);
+  auto values = m_values.data() + slot * m_stride;
+  for (int i = 0, k = 0; i < frame.groupCount(); ++i)
+  {
+    const auto &group = frame.getGroup(i);
+    for (int j = 0; j < group.datasetCount(); ++j, ++k)
+    {
+      const auto &dataset = group.getDataset(j);
+      values[k] = dataset.isNumeric() ? dataset.numericValue() : qQNaN();
+    }
+  }
+
+  // Wait for the raw frame
+  m_pendingFrame = slot;
+
+  // Evaluate trigger condition
+  const bool valueTrigger = m_condition != BytePattern;
+  if (m_state == State::Armed && valueTrigger && m_source < m_stride)
+  {
+    const auto value = values[m_source];
+    const auto previous = m_previous;
+    m_previous = value;
+
+    bool fired = false;
+    switch (m_condition)
+    {
+      case RisingEdge:
+        fired = previous < m_level && value >= m_level;
+        break;
+      case FallingEdge:
+        fired = previous > m_level && value <= m_level;
+        break;
+      case AnyEdge:
+        fired = (previous < m_level && value >= m_level)
+                || (previous > m_level && value <= m_level);
+        break;
+      case AboveLevel:
+        fired = value > m_level;
+        break;
+      case BelowLevel:
+        fired = value < m_level;
+        break;
+      default:
+        break;
+    }
+
+    if (fired)
+      fire();
+  }
+
+  // Write the capture once the post-trigger time elapses
+  if (m_state == State::Triggered && time > m_triggerTime + m_postTrigger)
+    finishCapture();
+}
+
+/**
+ * Searches for the trigger pattern in the given @a data, including patterns
+ * that are split between two consecutive chunks of data.
+ */
+void IO::Trigger::scanData(const QByteArray &data)
+{
+  // Pattern trigger not armed
+  if (m_state != State::Armed || m_condition != BytePattern)
+    return;
+
+  // No pattern specified
+  const auto length = m_bytes.length();
+  if (length == 0)
+    return;
+
+  // Search for the pattern, starting with the end of the previous chunk
+  bool found = false;
+  if (!m_tail.isEmpty())
+    found = (m_tail + data.left(length - 1)).contains(m_bytes);
+  if (!found)
+    found = data.contains(m_bytes);
+
+  // Fire trigger
+  if (found)
+  {
+    m_tail.clear();
+    fire();
+    return;
+  }
+
+  // Keep the end of the chunk
+  if (length > 1)
+    m_tail = (m_tail + data).right(length - 1);
+}
+
+/**
+ * Fires the trigger, the capture is written once the post-trigger time elapses
+ */
+void IO::Trigger::fire()
+{
+  m_triggerTime = m_clock.elapsed();
+  m_triggerDateTime = QDateTime::currentDateTime();
+  m_state = State::Triggered;
+  Q_EMIT stateChanged();
+}
+
+/**
+ * Writes the frames within the capture window to a CSV file, and then stops
+ * the trigger (single mode) or arms it again (normal & auto modes).
+ */
+void IO::Trigger::finishCapture()
+{
+  // Get path
+  const auto format = m_triggerDateTime.toString("yyyy/MMM/dd/");
+  const auto path = QString("%1/Documents/%2/Captures/%3/%4")
+                        .arg(QDir::homePath(), qApp->applicationName(),
+                             m_title, format);
+
+  // Generate file path if required
+  QDir dir(path);
+  if (!dir.exists())
+    dir.mkpath(".");
+
+  // Open file
+  const auto name = m_triggerDateTime.toString("HH-mm-ss-zzz") + ".csv";
+  QFile file(dir.filePath(name));
+  if (file.open(QIODevice::WriteOnly | QIODevice::Text))
+  {
+    // Force UTF-8 codec
+    QTextStream stream(&file);
+    stream.setGenerateByteOrderMark(true);
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+    stream.setCodec("UTF-8");
+#else
+    stream.setEncoding(QStringConverter::Utf8);
+#endif
+
+    // Add cell titles
+    stream << "RX Date/Time,Offset (ms)";
+    for (int i = 0; i < m_titles.count(); ++i)
+      stream << "," << m_titles.at(i);
+
+    stream << ",Raw frame\n";
+
+    // Write the frames within the capture window
+    const auto start = m_triggerTime - m_preTrigger;
+    const auto end = m_triggerTime + m_postTrigger;
+    const auto capacity = m_times.count();
+    for (int i = 0; i < m_count; ++i)
+    {
+      const auto slot = (m_head - m_count + i + capacity) % capacity;
+      const auto time = m_times.at(slot);
+      if (time < start || time > end)
+        continue;
+
+      const auto offset = time - m_triggerTime;
+      const auto rxTime = m_triggerDateTime.addMSecs(offset);
+      stream << rxTime.toString("yyyy/MM/dd/ HH:mm:ss::zzz") << "," << offset;
+
+      const auto values = m_values.constData() + slot * m_stride;
+      for (int j = 0; j < m_stride; ++j)
+        stream << "," << JSON::Expression::format(values[j]);
+
+      auto raw = QString::fromUtf8(m_frames.at(slot));
+      raw.replace("\"", "\"\"");
+      stream << ",\"" << raw << "\"\n";
+    }
+
+    // Close file & notify user interface
+    file.close();
+    ++m_captureCount;
+    m_lastCapture = file.fileName();
+    Q_EMIT captured(m_lastCapture);
+  }
+
+  else
+    Misc::Utilities::showMessageBox(tr("Trigger capture error"),
+                                    tr("Cannot open capture file!"));
+
+  // Stop the trigger & keep the captured event on the dashboard
+  if (m_mode == Single)
+  {
+    m_state = State::Stopped;
+    Q_EMIT captureHeld(true);
+  }
+
+  // Arm the trigger again
+  else
+  {
+    m_state = State::Armed;
+    m_previous = qQNaN();
+    m_armTime = m_clock.elapsed();
+  }
+
+  Q_EMIT stateChanged();
+}
+
+/**
+ * Reserves a slot in the ring buffer for a frame received at the given
+ * @a time & returns its index.
+ *
+ * The ring buffer grows while its oldest frame is still within the capture
+ * window (up to @c kMaxValues values), otherwise the oldest frame is
+ * overwritten.
+ */
+int IO::Trigger::appendFrame(const qint64 time)
+{
+  auto capacity = m_times.count();
+  if (m_count == capacity)
+  {
+    // Get the start of the capture window
+    auto start = time - m_preTrigger;
+    if (m_state == State::Triggered)
+      start = m_triggerTime - m_preTrigger;
+
+    // Grow the ring buffer if its oldest frame is still needed
+    const auto limit = qMax(kMinFrames, kMaxValues / qMax(1, m_stride));
+    const auto needed = capacity == 0 || m_times.at(m_head) >= start;
+    if (needed && capacity < limit)
+    {
+      const auto size = qMax(kMinFrames, qMin(capacity * 2, limit));
+      QVector<qint64> times(size);
+      QVector<QByteArray> frames(size);
+      QVector<double> values(size * m_stride);
+      for (int i = 0; i < m_count; ++i)
+      {
+        const auto slot = (m_head - m_count + i + capacity) % capacity;
+        times[i] = m_times.at(slot);
+        frames[i] = m_frames.at(slot);
+        const auto source = m_values.constData() + slot * m_stride;
+        std::copy(source, source + m_stride, values.data() + i * m_stride);
+      }
+
+      m_times.swap(times);
+      m_frames.swap(frames);
+      m_values.swap(values);
+      m_head = m_count;
+      capacity = size;
+    }
+
+    // Overwrite the oldest frame
+    else
+      --m_count;
+  }
+
+  // Register the frame
+  const auto slot = m_head;
+  m_times[slot] = time;
+  m_frames[slot].clear();
+  m_head = (m_head + 1) % capacity;
+  ++m_count;
+  return slot;
+}
+
+/**
+ * Reads the dataset titles of the given @a frame & clears the ring buffer,
+ * since the number of values per frame may have changed.
+ */
+void IO::Trigger::configure(const JSON::Frame &frame)
+{
+  // Read dataset titles
+  m_titles.clear();
+  m_title = frame.title();
+  m_revision = frame.revision();
+  for (int i = 0; i < frame.groupCount(); ++i)
+  {
+    const auto &group = frame.getGroup(i);
+    for (int j = 0; j < group.datasetCount(); ++j)
+      m_titles.append(group.title() + "/" + group.getDataset(j).title());
+  }
+
+  // Release the ring buffer
+  m_head = 0;
+  m_count = 0;
+  m_times.clear();
+  m_frames.clear();
+  m_values.clear();
+  m_pendingFrame = -1;
+  m_previous = qQNaN();
+  m_stride = m_titles.count();
+
+  // Abort the current capture
+  if (m_state == State::Triggered)
+  {
+    m_state = State::Armed;
+    m_armTime = m_clock.elapsed();
+    Q_EMIT stateChanged();
+  }
+
+  Q_EMIT sourcesChanged();
+}
@@ -0,0 +1,227 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <QObject>
+#include <QVector>
+#include <QDateTime>
+#include <QByteArray>
+#include <QElapsedTimer>
+
+#include <DataTypes.h>
+#include <JSON/Frame.h>
+
+namespace IO
+{
+/**
+ * @brief The Trigger class
+ *
+ * Implements an oscilloscope-like trigger, which captures the frames received
+ * shortly before & after an event to a CSV file, without having to record the
+ * whole session.
+ *
+ * While the trigger is armed, every frame (the raw bytes & the values of its
+ * datasets) is copied to a pre-trigger ring buffer. The trigger fires when:
+ *
+ * - The value of the selected dataset crosses the trigger level (rising,
+ *   falling or any edge), or is above/below the trigger level.
+ * - The given byte pattern is found in the data received by the
+ *   @c IO::Manager class (C-style escapes such as "\n" or "\xFF" can be
+ *   used).
+ *
+ * Once the post-trigger time elapses, the frames within the capture window
+ * are written to a CSV file. Depending on the trigger mode:
+ *
+ * - Single: the trigger stops & @c captureHeld() is emitted, so that the
+ *   dashboard freezes & the plots keep displaying the captured event.
+ * - Normal: the trigger is armed again to capture the next event.
+ * - Auto: same as normal, but a capture is forced if the trigger does not
+ *   fire within the capture window.
+ *
+ * Arming the trigger again does not allocate memory, since the ring buffer is
+ * reused. When the trigger is stopped, frames are not copied at all.
+ */
+class Trigger : public QObject
+{
+  // clang-format off
+    Q_OBJECT
+    Q_PROPERTY(int mode
+               READ mode
+               WRITE setMode
+               NOTIFY configurationChanged)
+    Q_PROPERTY(int condition
+               READ condition
+               WRITE setCondition
+               NOTIFY configurationChanged)
+    Q_PROPERTY(int source
+               READ source
+               WRITE setSource
+               NOTIFY configurationChanged)
+    Q_PROPERTY(double level
+               READ level
+               WRITE setLevel
+               NOTIFY configurationChanged)
+    Q_PROPERTY(QString pattern
+               READ pattern
+               WRITE setPattern
+               NOTIFY configurationChanged)
+    Q_PROPERTY(int preTrigger
+               READ preTrigger
+               WRITE setPreTrigger
+               NOTIFY configurationChanged)
+    Q_PROPERTY(int postTrigger
+               READ postTrigger
+               WRITE setPostTrigger
+               NOTIFY configurationChanged)
+    Q_PROPERTY(IO::Trigger::State state
+               READ state
+               NOTIFY stateChanged)
+    Q_PROPERTY(StringList sources
+               READ sources
+               NOTIFY sourcesChanged)
+    Q_PROPERTY(int captureCount
+               READ captureCount
+               NOTIFY captured)
+    Q_PROPERTY(QString lastCapture
+               READ lastCapture
+               NOTIFY captured)
+  // clang-format on
+
+Q_SIGNALS:
+  void stateChanged();
+  void sourcesChanged();
+  void configurationChanged();
+  void captureHeld(const bool held);
+  void captured(const QString &path);
+
+private:
+  explicit Trigger();
+  Trigger(Trigger &&) = delete;
+  Trigger(const Trigger &) = delete;
+  Trigger &operator=(Trigger &&) = delete;
+  Trigger &operator=(const Trigger &) = delete;
+
+public:
+  enum Mode
+  {
+    Single,
+    Normal,
+    Auto
+  };
+
+  enum Condition
+  {
+    RisingEdge,
+    FallingEdge,
+    AnyEdge,
+    AboveLevel,
+    BelowLevel,
+    BytePattern
+  };
+
+  enum class State
+  {
+    Stopped,
+    Armed,
+    Triggered
+  };
+  Q_ENUM(State)
+
+  static Trigger &instance();
+
+  int mode() const;
+  int condition() const;
+  int source() const;
+  double level() const;
+  QString pattern() const;
+  int preTrigger() const;
+  int postTrigger() const;
+  State state() const;
+  StringList sources() const;
+  int captureCount() const;
+  QString lastCapture() const;
+
+  Q_INVOKABLE StringList availableModes() const;
+  Q_INVOKABLE StringList availableConditions() const;
+
+public Q_SLOTS:
+  void arm();
+  void stop();
+  void force();
+  void setMode(const int mode);
+  void setCondition(const int condition);
+  void setSource(const int source);
+  void setLevel(const double level);
+  void setPattern(const QString &pattern);
+  void setPreTrigger(const int milliseconds);
+  void setPostTrigger(const int milliseconds);
+
+private Q_SLOTS:
+  void reset();
+  void checkTimeout();
+  void registerRawFrame(const QByteArray &frame);
+  void registerFrame(const JSON::Frame &frame);
+  void scanData(const QByteArray &data);
+
+private:
+  static constexpr int kMinFrames = 256;
+  static constexpr int kMaxValues = 1 << 22;
+
+  void fire();
+  void finishCapture();
+  int appendFrame(const qint64 time);
+  void configure(const JSON::Frame &frame);
+
+private:
+  int m_mode;
+  int m_condition;
+  int m_source;
+  double m_level;
+  QString m_pattern;
+  QByteArray m_bytes;
+  QByteArray m_tail;
+  int m_preTrigger;
+  int m_postTrigger;
+  State m_state;
+  int m_captureCount;
+  QString m_lastCapture;
+
+  QString m_title;
+  StringList m_titles;
+  quint64 m_revision;
+
+  QElapsedTimer m_clock;
+  qint64 m_armTime;
+  qint64 m_triggerTime;
+  QDateTime m_triggerDateTime;
+  double m_previous;
+  int m_pendingFrame;
+
+  int m_head;
+  int m_count;
+  int m_stride;
+  QVector<qint64> m_times;
+  QVector<double> m_values;
+  QVector<QByteArray> m_frames;
+};
+} // namespace IO
@@ -20,22 +20,108 @@
  * THE SOFTWARE.
  */
 
+#include <charconv>
+
 #include <JSON/Dataset.h>
 #include <JSON/Generator.h>
 
+/**
+ * Parses the decimal number contained in @a text (e.g. "-12.5", "+3" or
+ * ".5") and writes it to @a value, ignoring the system locale.
+ *
+ * Only plain decimals are accepted, exponents, "nan", "inf" and surrounding
+ * whitespace are not, so that the same values are considered numeric as
+ * with the regular expression that was used before.
+ *
+ * Unlike @c QString::toDouble(), the string is not copied to a temporary
+ * buffer in the heap, which makes a difference when frames with hundreds of
+ * datasets are received thousands of times per second.
+ *
+ * @return @c true if the whole string is a valid number.
+ */
+bool JSON::Dataset::parseNumber(const QString &text, double &value)
+{
+  // Copy the string to an ASCII buffer in the stack
+  char buffer[64];
+  const auto length = text.length();
+  if (length == 0 || length > static_cast<int>(sizeof(buffer)))
+    return false;
+
+  const auto data = text.constData();
+  for (int i = 0; i < length; ++i)
+  {
+    const auto c = data[i].unicode();
+    if (c > 127)
+      return false;
+
+    buffer[i] = static_cast<char>(c);
+  }
+
+  // Validate the format of the number: [+-]digits[.digits] or [+-].digits
+  const char *begin = buffer;
+  const char *end = buffer + length;
+  if (*begin == '+')
+    ++begin;
+
+  const char *p = buffer;
+  if (*p == '+' || *p == '-')
+    ++p;
+
+  int integer = 0;
+  while (p < end && *p >= '0' && *p <= '9')
+  {
+    ++p;
+    ++integer;
+  }
+
+  int fraction = -1;
+  if (p < end && *p == '.')
+  {
+    ++p;
+    fraction = 0;
+    while (p < end && *p >= '0' && *p <= '9')
+    {
+      ++p;
+      ++fraction;
+    }
+  }
+
+  if (p != end || (fraction < 0 ? integer == 0 : fraction == 0))
+    return false;
+
+  // Parse the number
+#if defined(__cpp_lib_to_chars)
+  const auto result = std::from_chars(begin, end, value);
+  return result.ec == std::errc() && result.ptr == end;
+#else
+  bool ok;
+  value = QByteArray::fromRawData(begin, end - begin).toDouble(&ok);
+  return ok;
+#endif
+}
+
 JSON::Dataset::Dataset()
   : m_fft(false)
   , m_led(false)
   , m_log(false)
   , m_graph(false)
+  , m_waterfall(false)
+  , m_numeric(false)
+  , m_numericValue(0)
   , m_title("")
   , m_value("")
   , m_units("")
   , m_widget("")
+  , m_filter("")
+  , m_expression("")
+  , m_alarmMode("")
   , m_index(0)
   , m_max(0)
   , m_min(0)
   , m_alarm(0)
+  , m_alarmLow(0)
+  , m_alarmDebounce(1)
+  , m_alarmHysteresis(0)
   , m_fftSamples(1024)
 {
 }
@@ -80,6 +166,15 @@ bool JSON::Dataset::graph() const
   return m_graph;
 }
 
+/**
+ * @return @c true if the UI should generate a waterfall (spectrogram) plot of
+ *         this dataset
+ */
+bool JSON::Dataset::waterfall() const
+{
+  return m_waterfall;
+}
+
 /**
  * Returns the minimum value of the dataset
  */
@@ -104,6 +199,41 @@ double JSON::Dataset::alarm() const
   return m_alarm;
 }
 
+/**
+ * Returns the low alarm level of the dataset (used by "below" & "band" alarms)
+ */
+double JSON::Dataset::alarmLow() const
+{
+  return m_alarmLow;
+}
+
+/**
+ * Returns the number of consecutive frames that must meet (or stop meeting)
+ * the alarm condition before the alarm is raised (or cleared)
+ */
+int JSON::Dataset::alarmDebounce() const
+{
+  return qMax(1, m_alarmDebounce);
+}
+
+/**
+ * Returns the alarm condition of the dataset ("above", "below", "band",
+ * "rate" or "none"), or an empty string if it was not specified
+ */
+QString JSON::Dataset::alarmMode() const
+{
+  return m_alarmMode;
+}
+
+/**
+ * Returns the margin that the value must go back past the alarm level before
+ * a raised alarm is cleared
+ */
+double JSON::Dataset::alarmHysteresis() const
+{
+  return m_alarmHysteresis;
+}
+
 /**
  * @return The title/description of this dataset
  */
@@ -128,6 +258,24 @@ QString JSON::Dataset::units() const
   return m_units;
 }
 
+/**
+ * @return The specification of the filters applied to the value of this
+ *         dataset, or an empty string if the value is not filtered
+ */
+QString JSON::Dataset::filter() const
+{
+  return m_filter;
+}
+
+/**
+ * @return The math expression used to compute the value of this dataset, or
+ *         an empty string if the value is read directly from the frame
+ */
+QString JSON::Dataset::expression() const
+{
+  return m_expression;
+}
+
 /**
  * @return The widget value of this dataset
  */
@@ -144,6 +292,23 @@ int JSON::Dataset::fftSamples() const
   return qMax(1, m_fftSamples);
 }
 
+/**
+ * @return @c true if the value of this dataset is a number
+ */
+bool JSON::Dataset::isNumeric() const
+{
+  return m_numeric;
+}
+
+/**
+ * @return The value of this dataset as a number, or 0 if the value is not
+ *         numeric
+ */
+double JSON::Dataset::numericValue() const
+{
+  return m_numericValue;
+}
+
 /**
  * Returns the JSON data that represents this widget
  */
@@ -169,18 +334,47 @@ bool JSON::Dataset::read(const QJsonObject &object)
     m_max = object.value("max").toDouble();
     m_index = object.value("index").toInt();
     m_alarm = object.value("alarm").toDouble();
+    m_alarmLow = object.value("alarmLow").toDouble();
+    m_alarmMode = object.value("alarmMode").toString();
+    m_alarmDebounce = object.value("alarmDebounce").toInt(1);
+    m_alarmHysteresis = object.value("alarmHysteresis").toDouble();
     m_graph = object.value("graph").toBool();
+    m_waterfall = object.value("waterfall").toBool();
     m_title = object.value("title").toString();
-    m_value = object.value("value").toString();
     m_units = object.value("units").toString();
     m_widget = object.value("widget").toString();
+    m_filter = object.value("filter").toString();
+    m_expression = object.value("expression").toString();
     m_fftSamples = object.value("fftSamples").toInt();
-
-    if (m_value.isEmpty())
-      m_value = "--.--";
+    setValue(object.value("value").toString());
 
     return true;
   }
 
   return false;
 }
+
+/**
+ * Changes the value/reading of this dataset & parses it as a number
+ */
+void JSON::Dataset::setValue(const QString &value)
+{
+  m_value = value;
+  if (m_value.isEmpty())
+    m_value = "--.--";
+
+  m_numeric = parseNumber(m_value, m_numericValue);
+  if (!m_numeric)
+    m_numericValue = 0;
+}
+
+/**
+ * Changes the value/reading of this dataset to the given number, e.g. after
+ * the value read from the frame was filtered
+ */
+void JSON::Dataset::setNumericValue(const double value)
+{
+  m_numeric = true;
+  m_numericValue = value;
+  m_value = QString::number(value, 'g', 12);
+}
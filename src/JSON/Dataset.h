@@ -52,17 +52,31 @@ namespace JSON
  * - Alarm: 45
  *
  * Description for each field of the dataset class:
- * - Value: represents the current sensor reading/value.
+ * - Value: represents the current sensor reading/value. Numeric values are
+ *          parsed once when the frame is read, and widgets should use
+ *          @c numericValue() instead of converting the string themselves.
  * - Units: represents the measurement units of the reading.
  * - Title: description of the dataset.
  * - Widget: widget that shall be used to represents the value,
  *           for example, a level widget, a gauge, a compass, etc.
  * - Graph: if set to true, Serial Studio shall plot the value in
  *          realtime.
+ * - Waterfall: if set to true, Serial Studio shall display the spectrum
+ *              of the value over time.
+ * - Expression: if set, the value is not read from the frame, but computed
+ *               from other datasets of the frame, referenced by index or
+ *               by title (e.g. "hypot($1, $2, $3)" or "${Voltage} * 2"),
+ *               see the @c Expression class.
+ * - Filter: chain of filters applied to the value before it is displayed
+ *           (e.g. "median(5) | lowpass(2, 100)"), see the
+ *           @c DSP::FilterChain class.
  * - Max: maximum value of the dataset, used for gauges & bars.
  * - Min: minimum value of the dataset, used for gauges & bars.
  * - Alarm: if the value exceeds the alarm level, bar widgets
  *          shall be rendered with a dark-red background.
+ * - Alarm mode: condition evaluated by the @c Misc::Alarms class ("above",
+ *               "below", "band", "rate" or "none"), along with the
+ *               "alarmLow", "alarmHysteresis" & "alarmDebounce" parameters.
  *
  * @note All of the dataset fields are optional, except the "value"
  *       field and the "title" field.
@@ -77,29 +91,48 @@ public:
   bool log() const;
   int index() const;
   bool graph() const;
+  bool waterfall() const;
   double min() const;
   double max() const;
   double alarm() const;
+  double alarmLow() const;
+  int alarmDebounce() const;
+  QString alarmMode() const;
+  double alarmHysteresis() const;
   QString title() const;
   QString value() const;
   QString units() const;
   QString widget() const;
   int fftSamples() const;
+  QString filter() const;
+  QString expression() const;
+  bool isNumeric() const;
+  double numericValue() const;
   QJsonObject jsonData() const;
 
   bool read(const QJsonObject &object);
+  void setValue(const QString &value);
+  void setNumericValue(const double value);
   void setTitle(const QString &title) { m_title = title; }
 
+  static bool parseNumber(const QString &text, double &value);
+
 private:
   bool m_fft;
   bool m_led;
   bool m_log;
   bool m_graph;
+  bool m_waterfall;
+  bool m_numeric;
+  double m_numericValue;
 
   QString m_title;
   QString m_value;
   QString m_units;
   QString m_widget;
+  QString m_filter;
+  QString m_expression;
+  QString m_alarmMode;
   QJsonObject m_jsonData;
 
   // Editor-related variables
@@ -107,6 +140,9 @@ private:
   double m_max;
   double m_min;
   double m_alarm;
+  double m_alarmLow;
+  int m_alarmDebounce;
+  double m_alarmHysteresis;
   int m_fftSamples;
 
   friend class Project::Model;
@@ -0,0 +1,787 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+#include <QtMath>
+#include <QVarLengthArray>
+#include <JSON/Expression.h>
+
+/**
+ * Value of missing & non-numeric fields
+ */
+static constexpr double kNaN = std::numeric_limits<double>::quiet_NaN();
+
+/**
+ * Constructor function, creates an invalid (empty) expression
+ */
+JSON::Expression::Expression()
+  : m_result(-1)
+  , m_registers(0)
+  , m_position(0)
+{
+}
+
+/**
+ * Returns @c true if the expression was compiled successfully
+ */
+bool JSON::Expression::isValid() const
+{
+  return m_result >= 0;
+}
+
+/**
+ * Returns a description of the last compilation error (if any)
+ */
+QString JSON::Expression::error() const
+{
+  return m_error;
+}
+
+/**
+ * Returns the source code of the expression
+ */
+QString JSON::Expression::source() const
+{
+  return m_source;
+}
+
+/**
+ * Returns the datasets referenced by the expression, in the order in which
+ * their values must be given to @c evaluate(). Each reference is either a
+ * dataset index (e.g. "4") or a dataset title (e.g. "Voltage").
+ */
+QStringList JSON::Expression::references() const
+{
+  return m_references;
+}
+
+/**
+ * Compiles the given @a source code into bytecode.
+ *
+ * @return @c true on success, @c false if the expression is empty or has a
+ *         syntax error, in which case @c error() describes the problem.
+ */
+bool JSON::Expression::compile(const QString &source)
+{
+  // Reset state
+  m_result = -1;
+  m_position = 0;
+  m_registers = 0;
+  m_error.clear();
+  m_fields.clear();
+  m_references.clear();
+  m_program.clear();
+  m_constants.clear();
+  m_source = source.trimmed();
+
+  // Validate source
+  if (m_source.isEmpty())
+  {
+    m_error = QStringLiteral("Empty expression");
+    return false;
+  }
+
+  // Compile the expression & make sure that all the text was consumed
+  const auto result = parseExpression();
+  skipWhitespace();
+  if (result >= 0 && m_position < m_source.length())
+    m_error = QStringLiteral("Unexpected '%1' at position %2")
+                  .arg(m_source.at(m_position))
+                  .arg(m_position + 1);
+
+  // Discard partial programs
+  if (!m_error.isEmpty())
+  {
+    m_fields.clear();
+    m_program.clear();
+    m_constants.clear();
+    m_references.clear();
+    return false;
+  }
+
+  m_result = result;
+  return true;
+}
+
+/**
+ * Evaluates the expression for a single frame.
+ *
+ * @param fields values of the referenced datasets, @c fields[0] corresponds
+ *               to the first element of @c references()
+ * @param count  number of elements in @a fields
+ *
+ * @return the result of the expression, or NaN if the expression is invalid
+ */
+double JSON::Expression::evaluate(const double *fields, const int count) const
+{
+  if (!isValid())
+    return kNaN;
+
+  // Load constants & fields
+  QVarLengthArray<double, 32> registers(m_registers);
+  for (int i = 0; i < m_constants.count(); ++i)
+    registers[m_constants.at(i).reg] = m_constants.at(i).value;
+  for (int i = 0; i < m_fields.count(); ++i)
+  {
+    const auto &f = m_fields.at(i);
+    registers[f.reg] = f.index <= count ? fields[f.index - 1] : kNaN;
+  }
+
+  // Run the program
+  execute(registers.data(), 1);
+  return registers[m_result];
+}
+
+/**
+ * Evaluates the expression for a batch of frames.
+ *
+ * The frames are processed in blocks of @c kBlockSize frames. The fields of
+ * each block are transposed so that each register holds the values of every
+ * frame in the block, and each instruction is then executed over the whole
+ * block at once.
+ *
+ * @param fields  values of all frames, the value of reference @c n (starting
+ *                at 1) of frame @c f is at <tt>fields[f * stride + n - 1]</tt>
+ * @param stride  number of values per frame
+ * @param frames  number of frames
+ * @param results output buffer, must hold at least @a frames values
+ */
+void JSON::Expression::evaluate(const double *fields, const int stride,
+                                const int frames, double *results) const
+{
+  // Invalid expression, every result is NaN
+  if (!isValid())
+  {
+    std::fill_n(results, frames, kNaN);
+    return;
+  }
+
+  // Process the frames in blocks
+  QVarLengthArray<double, 16 * kBlockSize> block(m_registers * kBlockSize);
+  for (int first = 0; first < frames; first += kBlockSize)
+  {
+    const int n = qMin(kBlockSize, frames - first);
+    const auto registers = block.data();
+
+    // Load constants
+    for (int i = 0; i < m_constants.count(); ++i)
+    {
+      const auto &c = m_constants.at(i);
+      std::fill_n(registers + c.reg * n, n, c.value);
+    }
+
+    // Load fields (one register per field, one element per frame)
+    for (int i = 0; i < m_fields.count(); ++i)
+    {
+      const auto &f = m_fields.at(i);
+      const auto dst = registers + f.reg * n;
+      if (f.index > stride)
+        std::fill_n(dst, n, kNaN);
+      else
+      {
+        const auto src = fields + first * stride + f.index - 1;
+        for (int k = 0; k < n; ++k)
+          dst[k] = src[k * stride];
+      }
+    }
+
+    // Run the program & copy the results
+    execute(registers, n);
+    std::copy_n(registers + m_result * n, n, results + first);
+  }
+}
+
+/**
+ * Converts the result of an expression to the string used as dataset value.
+ * Non-finite results (e.g. due to a missing field) are converted to an empty
+ * string, which the dashboard displays as an unknown value.
+ */
+QString JSON::Expression::format(const double value)
+{
+  if (!std::isfinite(value))
+    return QString();
+
+  return QString::number(value, 'g', 12);
+}
+
+/**
+ * Finds the dataset referenced by the given @a reference in @a groups. A
+ * number refers to the dataset with that frame index, any other text to the
+ * dataset with that title. Derived datasets cannot be referenced, so that
+ * expressions never depend on the order in which they are evaluated.
+ *
+ * @return @c true if the dataset was found, in which case its location is
+ *         written to @a group & @a dataset
+ */
+bool JSON::Expression::findDataset(const QString &reference,
+                                   const QVector<Group> &groups, int *group,
+                                   int *dataset)
+{
+  bool isIndex = false;
+  const auto index = reference.toInt(&isIndex);
+  for (int i = 0; i < groups.count(); ++i)
+  {
+    const auto &g = groups.at(i);
+    for (int j = 0; j < g.datasetCount(); ++j)
+    {
+      const auto &d = g.getDataset(j);
+      if (!d.expression().trimmed().isEmpty())
+        continue;
+
+      const bool found = isIndex ? d.index() == index : d.title() == reference;
+      if (found)
+      {
+        *group = i;
+        *dataset = j;
+        return true;
+      }
+    }
+  }
+
+  return false;
+}
+
+/**
+ * Consumes the given character (after any whitespace), or registers a syntax
+ * error if the next character is different.
+ */
+bool JSON::Expression::expect(const QChar c)
+{
+  skipWhitespace();
+  if (m_position < m_source.length() && m_source.at(m_position) == c)
+  {
+    ++m_position;
+    return true;
+  }
+
+  if (m_error.isEmpty())
+  {
+    if (m_position < m_source.length())
+      m_error = QStringLiteral("Expected '%1' at position %2")
+                    .arg(c)
+                    .arg(m_position + 1);
+    else
+      m_error = QStringLiteral("Expected '%1' at end of expression").arg(c);
+  }
+
+  return false;
+}
+
+/**
+ * Skips spaces & tabs in the source code
+ */
+void JSON::Expression::skipWhitespace()
+{
+  while (m_position < m_source.length() && m_source.at(m_position).isSpace())
+    ++m_position;
+}
+
+/**
+ * Parses a sum or difference of terms.
+ *
+ * @return the register that holds the result, or -1 on error
+ */
+int JSON::Expression::parseExpression()
+{
+  auto lhs = parseTerm();
+  while (lhs >= 0)
+  {
+    skipWhitespace();
+    if (m_position >= m_source.length())
+      break;
+
+    const auto c = m_source.at(m_position);
+    if (c != '+' && c != '-')
+      break;
+
+    ++m_position;
+    const auto rhs = parseTerm();
+    if (rhs < 0)
+      return -1;
+
+    lhs = emit(c == '+' ? Add : Subtract, lhs, rhs);
+  }
+
+  return lhs;
+}
+
+/**
+ * Parses a product, quotient or remainder of factors.
+ *
+ * @return the register that holds the result, or -1 on error
+ */
+int JSON::Expression::parseTerm()
+{
+  auto lhs = parseUnary();
+  while (lhs >= 0)
+  {
+    skipWhitespace();
+    if (m_position >= m_source.length())
+      break;
+
+    const auto c = m_source.at(m_position);
+    if (c != '*' && c != '/' && c != '%')
+      break;
+
+    ++m_position;
+    const auto rhs = parseUnary();
+    if (rhs < 0)
+      return -1;
+
+    if (c == '*')
+      lhs = emit(Multiply, lhs, rhs);
+    else if (c == '/')
+      lhs = emit(Divide, lhs, rhs);
+    else
+      lhs = emit(Modulo, lhs, rhs);
+  }
+
+  return lhs;
+}
+
+/**
+ * Parses an optional sign followed by a power, so that -2^2 equals -4.
+ *
+ * @return the register that holds the result, or -1 on error
+ */
+int JSON::Expression::parseUnary()
+{
+  skipWhitespace();
+  if (m_position < m_source.length())
+  {
+    const auto c = m_source.at(m_position);
+    if (c == '-' || c == '+')
+    {
+      ++m_position;
+      const auto operand = parseUnary();
+      if (operand < 0 || c == '+')
+        return operand;
+
+      return emit(Negate, operand);
+    }
+  }
+
+  return parsePower();
+}
+
+/**
+ * Parses a (right-associative) power, e.g. 2^3^2 equals 2^9. Squares are
+ * compiled to a multiplication, which is much cheaper than @c std::pow().
+ *
+ * @return the register that holds the result, or -1 on error
+ */
+int JSON::Expression::parsePower()
+{
+  const auto base = parsePrimary();
+  if (base < 0)
+    return -1;
+
+  skipWhitespace();
+  if (m_position < m_source.length() && m_source.at(m_position) == '^')
+  {
+    ++m_position;
+    const auto exponent = parseUnary();
+    if (exponent < 0)
+      return -1;
+
+    double value;
+    if (isConstant(exponent, &value) && value == 2)
+      return emit(Multiply, base, base);
+
+    return emit(Power, base, exponent);
+  }
+
+  return base;
+}
+
+/**
+ * Parses a number, a field reference (e.g. $2), a constant, a function call
+ * or an expression between parentheses.
+ *
+ * @return the register that holds the result, or -1 on error
+ */
+int JSON::Expression::parsePrimary()
+{
+  skipWhitespace();
+  if (m_position >= m_source.length())
+  {
+    m_error = QStringLiteral("Unexpected end of expression");
+    return -1;
+  }
+
+  const auto start = m_position;
+  const auto c = m_source.at(m_position);
+
+  // Expression between parentheses
+  if (c == '(')
+  {
+    ++m_position;
+    const auto result = parseExpression();
+    if (result < 0 || !expect(')'))
+      return -1;
+
+    return result;
+  }
+
+  // Dataset reference by title, e.g. ${Voltage}
+  if (c == '$' && m_position + 1 < m_source.length()
+      && m_source.at(m_position + 1) == '{')
+  {
+    const auto end = m_source.indexOf('}', m_position + 2);
+    const auto title = m_source.mid(m_position + 2, end - m_position - 2);
+    if (end < 0 || title.trimmed().isEmpty())
+    {
+      m_error = QStringLiteral("Invalid dataset reference at position %1")
+                    .arg(start + 1);
+      return -1;
+    }
+
+    m_position = end + 1;
+    return field(title.trimmed());
+  }
+
+  // Dataset reference by index, e.g. $4
+  if (c == '$')
+  {
+    ++m_position;
+    while (m_position < m_source.length() && m_source.at(m_position).isDigit())
+      ++m_position;
+
+    const auto index = m_source.mid(start + 1, m_position - start - 1).toInt();
+    if (index < 1)
+    {
+      m_error = QStringLiteral("Invalid dataset reference at position %1")
+                    .arg(start + 1);
+      return -1;
+    }
+
+    return field(QString::number(index));
+  }
+
+  // Number
+  if (c.isDigit() || c == '.')
+  {
+    while (m_position < m_source.length())
+    {
+      const auto d = m_source.at(m_position);
+      const auto prev = m_source.at(m_position - 1).toLower();
+      const bool sign = (d == '-' || d == '+') && prev == 'e';
+      if (!d.isDigit() && d != '.' && d.toLower() != 'e' && !sign)
+        break;
+
+      ++m_position;
+    }
+
+    bool ok;
+    const auto value = m_source.mid(start, m_position - start).toDouble(&ok);
+    if (!ok)
+    {
+      m_error = QStringLiteral("Invalid number at position %1").arg(start + 1);
+      return -1;
+    }
+
+    return constant(value);
+  }
+
+  // Constant or function call
+  if (c.isLetter() || c == '_')
+  {
+    while (m_position < m_source.length()
+           && (m_source.at(m_position).isLetterOrNumber()
+               || m_source.at(m_position) == '_'))
+      ++m_position;
+
+    const auto name = m_source.mid(start, m_position - start).toLower();
+    if (name == QStringLiteral("pi"))
+      return constant(M_PI);
+    if (name == QStringLiteral("e"))
+      return constant(M_E);
+
+    return parseCall(name);
+  }
+
+  m_error = QStringLiteral("Unexpected '%1' at position %2")
+                .arg(c)
+                .arg(start + 1);
+  return -1;
+}
+
+/**
+ * Parses the arguments of a call to the function with the given @a name.
+ * Calls to functions with more than two arguments (e.g. min, max & hypot) are
+ * compiled to a chain of two-argument instructions.
+ *
+ * @return the register that holds the result, or -1 on error
+ */
+int JSON::Expression::parseCall(const QString &name)
+{
+  // Functions with an arity of -1 accept two or more arguments
+  static const struct
+  {
+    const char *name;
+    int arity;
+    Opcode op;
+  } functions[] = {
+      // clang-format off
+      {"sqrt",  1, Sqrt},  {"abs",   1, Abs},   {"sin",   1, Sin},
+      {"cos",   1, Cos},   {"tan",   1, Tan},   {"asin",  1, Asin},
+      {"acos",  1, Acos},  {"atan",  1, Atan},  {"atan2", 2, Atan2},
+      {"exp",   1, Exp},   {"log",   1, Log},   {"log10", 1, Log10},
+      {"floor", 1, Floor}, {"ceil",  1, Ceil},  {"round", 1, Round},
+      {"pow",   2, Power}, {"min",  -1, Min},   {"max",  -1, Max},
+      {"hypot", -1, Hypot},
+      // clang-format on
+  };
+
+  // Find the function
+  int function = -1;
+  const int count = sizeof(functions) / sizeof(functions[0]);
+  for (int i = 0; i < count; ++i)
+  {
+    if (name == QLatin1String(functions[i].name))
+    {
+      function = i;
+      break;
+    }
+  }
+
+  if (function < 0)
+  {
+    m_error = QStringLiteral("Unknown function or constant \"%1\"").arg(name);
+    return -1;
+  }
+
+  // Parse the arguments
+  if (!expect('('))
+    return -1;
+
+  QVarLengthArray<int, 4> args;
+  while (true)
+  {
+    const auto arg = parseExpression();
+    if (arg < 0)
+      return -1;
+
+    args.append(arg);
+    skipWhitespace();
+    if (m_position >= m_source.length() || m_source.at(m_position) != ',')
+      break;
+
+    ++m_position;
+  }
+
+  if (!expect(')'))
+    return -1;
+
+  // Validate the number of arguments
+  const auto &f = functions[function];
+  const auto arity = args.count();
+  if ((f.arity > 0 && arity != f.arity) || (f.arity < 0 && arity < 2))
+  {
+    m_error = QStringLiteral("Wrong number of arguments for \"%1\"").arg(name);
+    return -1;
+  }
+
+  // Emit the instructions
+  if (arity == 1)
+    return emit(f.op, args.at(0));
+
+  auto result = emit(f.op, args.at(0), args.at(1));
+  for (int i = 2; i < arity; ++i)
+    result = emit(f.op, result, args.at(i));
+
+  return result;
+}
+
+/**
+ * Allocates a register that is loaded with the given @a value
+ */
+int JSON::Expression::constant(const double value)
+{
+  const auto reg = m_registers++;
+  m_constants.append({reg, value});
+  return reg;
+}
+
+/**
+ * Returns the register that is loaded with the value of the given dataset
+ * @a reference, registers are shared by all uses of the same dataset.
+ */
+int JSON::Expression::field(const QString &reference)
+{
+  const auto index = m_references.indexOf(reference);
+  if (index >= 0)
+    return m_fields.at(index).reg;
+
+  const auto reg = m_registers++;
+  m_references.append(reference);
+  m_fields.append({reg, m_references.count()});
+  return reg;
+}
+
+/**
+ * Appends an instruction that writes the result of @a op to a new register.
+ * If all the operands are constants, the operation is evaluated right away and
+ * no instruction is generated.
+ *
+ * @return the register that holds the result
+ */
+int JSON::Expression::emit(const Opcode op, const int a, const int b)
+{
+  double x, y = 0;
+  if (isConstant(a, &x) && (b < 0 || isConstant(b, &y)))
+    return constant(apply(op, x, y));
+
+  const auto reg = m_registers++;
+  m_program.append({op, reg, a, b < 0 ? a : b});
+  return reg;
+}
+
+/**
+ * Returns @c true if the given @a reg is loaded with a constant, whose value
+ * is written to @a value.
+ */
+bool JSON::Expression::isConstant(const int reg, double *value) const
+{
+  for (int i = 0; i < m_constants.count(); ++i)
+  {
+    if (m_constants.at(i).reg == reg)
+    {
+      if (value)
+        *value = m_constants.at(i).value;
+
+      return true;
+    }
+  }
+
+  return false;
+}
+
+/**
+ * Runs the program over the given @a registers, each register holds @a count
+ * consecutive values (one per frame). Arithmetic instructions are simple loops
+ * that the compiler can vectorize, the rest call the math library once per
+ * value.
+ */
+void JSON::Expression::execute(double *registers, const int count) const
+{
+  for (int i = 0; i < m_program.count(); ++i)
+  {
+    const auto &instruction = m_program.at(i);
+    const auto a = registers + instruction.a * count;
+    const auto b = registers + instruction.b * count;
+    const auto dst = registers + instruction.dst * count;
+
+    switch (instruction.op)
+    {
+      case Add:
+        for (int k = 0; k < count; ++k)
+          dst[k] = a[k] + b[k];
+        break;
+      case Subtract:
+        for (int k = 0; k < count; ++k)
+          dst[k] = a[k] - b[k];
+        break;
+      case Multiply:
+        for (int k = 0; k < count; ++k)
+          dst[k] = a[k] * b[k];
+        break;
+      case Divide:
+        for (int k = 0; k < count; ++k)
+          dst[k] = a[k] / b[k];
+        break;
+      case Negate:
+        for (int k = 0; k < count; ++k)
+          dst[k] = -a[k];
+        break;
+      default:
+        for (int k = 0; k < count; ++k)
+          dst[k] = apply(instruction.op, a[k], b[k]);
+        break;
+    }
+  }
+}
+
+/**
+ * Evaluates a single operation, unary operations ignore @a b.
+ */
+double JSON::Expression::apply(const Opcode op, const double a, const double b)
+{
+  switch (op)
+  {
+    case Add:
+      return a + b;
+    case Subtract:
+      return a - b;
+    case Multiply:
+      return a * b;
+    case Divide:
+      return a / b;
+    case Modulo:
+      return std::fmod(a, b);
+    case Power:
+      return std::pow(a, b);
+    case Negate:
+      return -a;
+    case Sqrt:
+      return std::sqrt(a);
+    case Abs:
+      return std::fabs(a);
+    case Sin:
+      return std::sin(a);
+    case Cos:
+      return std::cos(a);
+    case Tan:
+      return std::tan(a);
+    case Asin:
+      return std::asin(a);
+    case Acos:
+      return std::acos(a);
+    case Atan:
+      return std::atan(a);
+    case Atan2:
+      return std::atan2(a, b);
+    case Exp:
+      return std::exp(a);
+    case Log:
+      return std::log(a);
+    case Log10:
+      return std::log10(a);
+    case Floor:
+      return std::floor(a);
+    case Ceil:
+      return std::ceil(a);
+    case Round:
+      return std::round(a);
+    case Min:
+      return a < b || std::isnan(a) ? a : b;
+    case Max:
+      return a > b || std::isnan(a) ? a : b;
+    case Hypot:
+      return std::hypot(a, b);
+  }
+
+  return kNaN;
+}
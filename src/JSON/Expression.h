@@ -0,0 +1,170 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <QString>
+#include <QVector>
+#include <QStringList>
+#include <JSON/Group.h>
+
+namespace JSON
+{
+/**
+ * @brief The Expression class
+ *
+ * Compiles the math expression of a derived dataset (e.g. the magnitude of an
+ * accelerometer or the power drawn by a load) and evaluates it natively.
+ *
+ * Expressions reference other datasets of the frame by their index (e.g.
+ * @c $4 is the dataset with @c "index": 4) or by their title (e.g.
+ * @c ${Voltage}), for example:
+ *
+ * - Magnitude:  sqrt($1^2 + $2^2 + $3^2)  or  hypot($1, $2, $3)
+ * - Power:      ${Voltage} * ${Current}
+ * - Conversion: $6 * 9 / 5 + 32
+ *
+ * The compiled expression only knows the list of @c references(), callers
+ * resolve each reference to a dataset (see @c findDataset()) and provide one
+ * value per reference, in the same order, when evaluating the expression.
+ *
+ * Supported operators are @c + @c - @c * @c / @c % and @c ^ (power), along
+ * with the constants @c pi and @c e and the functions sqrt, abs, sin, cos,
+ * tan, asin, acos, atan, atan2, exp, log, log10, floor, ceil, round, pow, min,
+ * max and hypot (the last three accept two or more arguments).
+ *
+ * The source is compiled once into a register-based bytecode: every
+ * instruction reads one or two registers and writes another one. Fields and
+ * constants are loaded into registers before running the program, and
+ * operations with constant operands are folded while compiling.
+ *
+ * The same program can be run for a single frame or for a batch of frames. In
+ * the latter case, each register holds the values of a block of frames, so
+ * that every instruction is an (auto-vectorizable) loop over the block
+ * instead of a dispatch per frame.
+ *
+ * References that are missing or that are not numbers evaluate to NaN.
+ */
+class Expression
+{
+public:
+  Expression();
+
+  bool isValid() const;
+  QString error() const;
+  QString source() const;
+  QStringList references() const;
+
+  bool compile(const QString &source);
+  double evaluate(const double *fields, const int count) const;
+  void evaluate(const double *fields, const int stride, const int frames,
+                double *results) const;
+
+  static QString format(const double value);
+  static bool findDataset(const QString &reference,
+                          const QVector<Group> &groups, int *group,
+                          int *dataset);
+
+private:
+  static constexpr int kBlockSize = 64;
+
+  enum Opcode
+  {
+    Add,
+    Subtract,
+    Multiply,
+    Divide,
+    Modulo,
+    Power,
+    Negate,
+    Sqrt,
+    Abs,
+    Sin,
+    Cos,
+    Tan,
+    Asin,
+    Acos,
+    Atan,
+    Atan2,
+    Exp,
+    Log,
+    Log10,
+    Floor,
+    Ceil,
+    Round,
+    Min,
+    Max,
+    Hypot
+  };
+
+  struct Instruction
+  {
+    Opcode op;
+    int dst;
+    int a;
+    int b;
+  };
+
+  struct Constant
+  {
+    int reg;
+    double value;
+  };
+
+  struct Field
+  {
+    int reg;
+    int index;
+  };
+
+  bool expect(const QChar c);
+  void skipWhitespace();
+  int parseExpression();
+  int parseTerm();
+  int parseUnary();
+  int parsePower();
+  int parsePrimary();
+  int parseCall(const QString &name);
+
+  int constant(const double value);
+  int field(const QString &reference);
+  int emit(const Opcode op, const int a, const int b = -1);
+  bool isConstant(const int reg, double *value = Q_NULLPTR) const;
+
+  void execute(double *registers, const int count) const;
+  static double apply(const Opcode op, const double a, const double b);
+
+private:
+  int m_result;
+  int m_registers;
+
+  QString m_error;
+  QString m_source;
+  QStringList m_references;
+
+  int m_position;
+
+  QVector<Field> m_fields;
+  QVector<Constant> m_constants;
+  QVector<Instruction> m_program;
+};
+} // namespace JSON
@@ -22,6 +22,17 @@
 
 #include <JSON/Frame.h>
 
+static quint64 LAST_REVISION = 0;
+
+/**
+ * Constructor function
+ */
+JSON::Frame::Frame()
+  : m_timestamp(0)
+  , m_revision(0)
+{
+}
+
 /**
  * Destructor function, free memory used by the @c Group objects before
  * destroying an instance of this class.
@@ -38,6 +49,8 @@ JSON::Frame::~Frame()
 void JSON::Frame::clear()
 {
   m_title = "";
+  m_timestamp = 0;
+  m_revision = 0;
   m_groups.clear();
 }
 
@@ -57,6 +70,28 @@ int JSON::Frame::groupCount() const
   return m_groups.count();
 }
 
+/**
+ * Returns the time at which the frame was received by the @c IO::Manager
+ * class (see @c IO::Manager::frameTimestamp()), in microseconds.
+ */
+qint64 JSON::Frame::timestamp() const
+{
+  return m_timestamp;
+}
+
+/**
+ * Returns the structure revision of the frame.
+ *
+ * Frames with the same revision have the same groups & datasets (only their
+ * values differ), so that modules that process every frame can detect a
+ * change in the structure of the frame by comparing a single integer. Empty
+ * frames have a revision of zero.
+ */
+quint64 JSON::Frame::revision() const
+{
+  return m_revision;
+}
+
 /**
  * Returns a vector of pointers to the @c Group objects associated to this
  * frame.
@@ -95,7 +130,8 @@ bool JSON::Frame::read(const QJsonObject &object)
         m_groups.append(group);
     }
 
-    // Return status
+    // Assign a new structure revision & return status
+    m_revision = nextRevision();
     return groupCount() > 0;
   }
 
@@ -104,6 +140,23 @@ bool JSON::Frame::read(const QJsonObject &object)
   return false;
 }
 
+/**
+ * Changes the time at which the frame was received, in microseconds
+ */
+void JSON::Frame::setTimestamp(const qint64 timestamp)
+{
+  m_timestamp = timestamp;
+}
+
+/**
+ * Changes the structure revision of the frame, used to keep the revision of
+ * the previous frame if the structure of the frame did not change.
+ */
+void JSON::Frame::setRevision(const quint64 revision)
+{
+  m_revision = revision;
+}
+
 /**
  * @return The group at the given @a index
  */
@@ -111,3 +164,12 @@ const JSON::Group &JSON::Frame::getGroup(const int index) const
 {
   return m_groups.at(index);
 }
+
+/**
+ * Returns a new structure revision, which is different from the revision of
+ * any frame that was read before.
+ */
+quint64 JSON::Frame::nextRevision()
+{
+  return ++LAST_REVISION;
+}
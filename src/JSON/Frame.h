@@ -55,19 +55,28 @@ namespace JSON
 class Frame
 {
 public:
+  Frame();
   ~Frame();
 
   void clear();
   QString title() const;
   int groupCount() const;
+  qint64 timestamp() const;
+  quint64 revision() const;
   QVector<Group> &groups();
   bool read(const QJsonObject &object);
+  void setTimestamp(const qint64 timestamp);
+  void setRevision(const quint64 revision);
   Q_INVOKABLE const JSON::Group &getGroup(const int index) const;
 
   inline bool isValid() const { return !title().isEmpty() && groupCount() > 0; }
 
+  static quint64 nextRevision();
+
 private:
   QString m_title;
+  qint64 m_timestamp;
+  quint64 m_revision;
   QVector<Group> m_groups;
 };
 } // namespace JSON
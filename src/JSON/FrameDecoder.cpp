@@ -0,0 +1,308 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <cstring>
+#include <JSON/FrameDecoder.h>
+
+/**
+ * Constructor function
+ */
+JSON::FrameDecoder::FrameDecoder() {}
+
+/**
+ * Removes the current frame & the learned schema
+ */
+void JSON::FrameDecoder::reset()
+{
+  m_frame.clear();
+  m_slots.clear();
+  m_offsets.clear();
+  m_segments.clear();
+  m_structure.clear();
+}
+
+/**
+ * Returns the latest decoded frame, so that its values can be post-processed
+ * (e.g. filtered) before it is published
+ */
+JSON::Frame &JSON::FrameDecoder::frame()
+{
+  return m_frame;
+}
+
+/**
+ * Returns the latest decoded frame
+ */
+const JSON::Frame &JSON::FrameDecoder::frame() const
+{
+  return m_frame;
+}
+
+/**
+ * Decodes the given JSON frame @a data using the learned schema.
+ *
+ * The values of the datasets are only updated if the whole frame matches the
+ * schema, otherwise the function returns @c false and the frame must be read
+ * with the @c read() function.
+ */
+bool JSON::FrameDecoder::decode(const QByteArray &data)
+{
+  // No schema learned yet
+  if (m_segments.isEmpty())
+    return false;
+
+  // Compare the frame with the schema & find the location of each value
+  int pos = 0;
+  const auto size = data.size();
+  const auto bytes = data.constData();
+  m_offsets.resize(m_slots.count() * 2);
+  for (int i = 0; i < m_segments.count(); ++i)
+  {
+    // Compare the text between two values
+    const auto &segment = m_segments.at(i);
+    if (size - pos < segment.size()
+        || std::memcmp(bytes + pos, segment.constData(), segment.size()) != 0)
+      return false;
+
+    pos += segment.size();
+
+    // Find the end of the value string (use the slow path for escaped values)
+    if (i < m_slots.count())
+    {
+      const auto begin = pos;
+      while (pos < size && bytes[pos] != '"')
+      {
+        if (bytes[pos] == '\\')
+          return false;
+
+        ++pos;
+      }
+
+      if (pos >= size)
+        return false;
+
+      m_offsets[i * 2] = begin;
+      m_offsets[i * 2 + 1] = pos - begin;
+    }
+  }
+
+  // Frame has trailing data
+  if (pos != size)
+    return false;
+
+  // Update dataset values
+  auto &groups = m_frame.groups();
+  for (int i = 0; i < m_slots.count(); ++i)
+  {
+    const auto &slot = m_slots.at(i);
+    const auto value = bytes + m_offsets.at(i * 2);
+    groups[slot.group].datasets()[slot.dataset].setValue(
+        QString::fromUtf8(value, m_offsets.at(i * 2 + 1)));
+  }
+
+  return true;
+}
+
+/**
+ * Reads the frame from the given JSON @a object. If the raw text of the frame
+ * is given through @a data, its schema is learned so that the following frames
+ * can be processed with the @c decode() function.
+ *
+ * The structure revision of the previous frame is kept if the new frame has
+ * the same number of datasets in each group, unless a learned schema stopped
+ * matching the received text (e.g. because a title changed).
+ *
+ * @return @c true on success, @c false if the frame is not valid
+ */
+bool JSON::FrameDecoder::read(const QJsonObject &object, const QByteArray &data)
+{
+  // Remove previous schema
+  const bool schemaChanged = !m_segments.isEmpty();
+  const auto revision = m_frame.revision();
+  m_slots.clear();
+  m_segments.clear();
+
+  // Read frame
+  if (!m_frame.read(object))
+  {
+    m_structure.clear();
+    return false;
+  }
+
+  // Compare the structure of the frame with the previous one
+  const auto &groups = m_frame.groups();
+  bool changed = schemaChanged || m_structure.count() != groups.count();
+  m_structure.resize(groups.count());
+  for (int i = 0; i < groups.count(); ++i)
+  {
+    const auto count = groups.at(i).datasetCount();
+    changed |= m_structure.at(i) != count;
+    m_structure[i] = count;
+  }
+
+  // Keep the revision of the previous frame if the structure is the same
+  if (!changed && revision > 0)
+    m_frame.setRevision(revision);
+
+  // Learn schema
+  if (!data.isEmpty())
+    learn(data);
+
+  return true;
+}
+
+/**
+ * Splits the raw JSON text of the current frame around the string values of
+ * its datasets, and registers the group & dataset that each value belongs to.
+ *
+ * The schema is discarded if it cannot be used to decode the following frames
+ * (e.g. if a dataset value is not a string, or if the frame contains empty
+ * groups or datasets, which are ignored by the @c Frame class).
+ */
+void JSON::FrameDecoder::learn(const QByteArray &data)
+{
+  // Containers that enclose the current token
+  struct Level
+  {
+    char type;
+    bool expectKey;
+    QByteArray key;
+    QByteArray name;
+  };
+
+  // Checks if the current token is the value of a dataset
+  QVector<Level> stack;
+  const auto isValue = [&stack]() {
+    return stack.count() == 5 && stack.at(1).name == "groups"
+           && stack.at(3).name == "datasets" && stack.at(4).type == '{'
+           && !stack.at(4).expectKey && stack.at(4).key == "value";
+  };
+
+  // Tokenize the frame
+  int start = 0;
+  bool valid = true;
+  QVector<int> datasets;
+  const auto size = data.size();
+  const auto bytes = data.constData();
+  for (int i = 0; i < size && valid; ++i)
+  {
+    const auto c = bytes[i];
+    switch (c)
+    {
+      // Begin object or array, count groups & datasets
+      case '{':
+      case '[': {
+        Level level;
+        level.type = c;
+        level.expectKey = (c == '{');
+        if (!stack.isEmpty())
+          level.name = stack.last().key;
+
+        const auto depth = stack.count();
+        if (c == '{' && depth == 2 && stack.at(1).name == "groups")
+          datasets.append(0);
+        else if (c == '{' && depth == 4 && stack.at(1).name == "groups"
+                 && stack.at(3).name == "datasets")
+          ++datasets.last();
+
+        stack.append(level);
+        break;
+      }
+
+      // End object or array
+      case '}':
+      case ']':
+        if (stack.isEmpty())
+          valid = false;
+        else
+          stack.removeLast();
+        break;
+
+      // Key-value separator
+      case ':':
+        if (!stack.isEmpty())
+          stack.last().expectKey = false;
+        break;
+
+      // Member separator
+      case ',':
+        if (!stack.isEmpty())
+          stack.last().expectKey = (stack.last().type == '{');
+        break;
+
+      // Whitespace
+      case ' ':
+      case '\t':
+      case '\r':
+      case '\n':
+        break;
+
+      // String, register it as a key or as a dataset value
+      case '"': {
+        int end = i + 1;
+        while (end < size && bytes[end] != '"')
+          end += (bytes[end] == '\\') ? 2 : 1;
+
+        if (end >= size)
+          valid = false;
+
+        else if (!stack.isEmpty() && stack.last().expectKey)
+          stack.last().key = data.mid(i + 1, end - i - 1);
+
+        else if (isValue())
+        {
+          m_segments.append(data.mid(start, i + 1 - start));
+          m_slots.append({datasets.count() - 1, datasets.last() - 1});
+          start = end;
+        }
+
+        i = end;
+        break;
+      }
+
+      // Numbers, booleans & null (not supported as dataset values)
+      default:
+        if (isValue())
+          valid = false;
+
+        while (i + 1 < size && !std::strchr(",]} \t\r\n", bytes[i + 1]))
+          ++i;
+        break;
+    }
+  }
+
+  // Validate that each value slot points to an existing dataset
+  valid &= stack.isEmpty() && datasets.count() == m_frame.groupCount();
+  for (int i = 0; i < datasets.count() && valid; ++i)
+    valid = datasets.at(i) == m_frame.getGroup(i).datasetCount();
+
+  // Register the text after the last value
+  if (valid)
+    m_segments.append(data.mid(start));
+
+  // Discard the schema
+  else
+  {
+    m_slots.clear();
+    m_segments.clear();
+  }
+}
@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <QVector>
+#include <QByteArray>
+#include <QJsonObject>
+#include <JSON/Frame.h>
+
+namespace JSON
+{
+/**
+ * @brief The FrameDecoder class
+ *
+ * Converts the JSON frames received in automatic operation mode to a
+ * @c Frame object.
+ *
+ * Devices usually send frames with the same structure over & over again, and
+ * only the "value" fields of the datasets change between frames. When a frame
+ * is read with @c read(), the decoder learns its schema: the raw text of the
+ * frame split around the values of the datasets. Later frames are decoded by
+ * @c decode(), which compares the received text with the schema & copies the
+ * values directly to the datasets of the frame, without building a
+ * @c QJsonDocument or looking up any keys.
+ *
+ * If a frame does not match the schema (e.g. a group was added or a title
+ * changed), @c decode() fails and the frame must be parsed & read again, which
+ * also updates the schema.
+ */
+class FrameDecoder
+{
+public:
+  FrameDecoder();
+
+  void reset();
+  Frame &frame();
+  const Frame &frame() const;
+
+  bool decode(const QByteArray &data);
+  bool read(const QJsonObject &object, const QByteArray &data = QByteArray());
+
+private:
+  void learn(const QByteArray &data);
+
+private:
+  struct Slot
+  {
+    int group;
+    int dataset;
+  };
+
+  Frame m_frame;
+  QVector<Slot> m_slots;
+  QVector<int> m_offsets;
+  QVector<int> m_structure;
+  QVector<QByteArray> m_segments;
+};
+} // namespace JSON
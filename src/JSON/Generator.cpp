@@ -22,30 +22,42 @@
 
 #include "Generator.h"
 
+#include <cmath>
+#include <limits>
+#include <utility>
+
+#include <QTimer>
 #include <QFileInfo>
+#include <QMetaMethod>
 #include <QFileDialog>
 #include <QRegularExpression>
 
 #include <Project/Model.h>
-#include <Project/CodeEditor.h>
+#include <Project/FrameParser.h>
 
 #include <CSV/Player.h>
 #include <IO/Manager.h>
 #include <MQTT/Client.h>
 #include <Misc/Utilities.h>
+#include <Misc/Instrumentation.h>
 
 /**
  * Initializes the JSON Parser class and connects appropiate SIGNALS/SLOTS
  */
 JSON::Generator::Generator()
   : m_opMode(kAutomatic)
+  , m_filtersChanged(true)
+  , m_revision(0)
 {
   // clang-format off
     connect(&IO::Manager::instance(), &IO::Manager::frameReceived,
             this, &JSON::Generator::readData);
+    connect(&IO::Manager::instance(), &IO::Manager::connectedChanged,
+            this, &JSON::Generator::resetFilters);
   // clang-format on
 
-  readSettings();
+  // Restore the last JSON map after the application finishes loading
+  QTimer::singleShot(0, this, &JSON::Generator::readSettings);
 }
 
 /**
@@ -66,7 +78,8 @@ QJsonObject &JSON::Generator::json()
 }
 
 /**
- * Returns the file name (e.g. "JsonMap.json") of the loaded JSON map file
+ * Returns the file name (e.g. "JsonMap.json") of the loaded JSON map file, or
+ * of the restored JSON map file if it has not been parsed yet
  */
 QString JSON::Generator::jsonMapFilename() const
 {
@@ -76,11 +89,15 @@ QString JSON::Generator::jsonMapFilename() const
     return fileInfo.fileName();
   }
 
+  if (!m_pendingJsonMap.isEmpty())
+    return QFileInfo(m_pendingJsonMap).fileName();
+
   return "";
 }
 
 /**
- * Returns the file path of the loaded JSON map file
+ * Returns the file path of the loaded JSON map file, or of the restored JSON
+ * map file if it has not been parsed yet
  */
 QString JSON::Generator::jsonMapFilepath() const
 {
@@ -90,7 +107,7 @@ QString JSON::Generator::jsonMapFilepath() const
     return fileInfo.filePath();
   }
 
-  return "";
+  return m_pendingJsonMap;
 }
 
 /**
@@ -126,6 +143,9 @@ void JSON::Generator::loadJsonMap(const QString &path)
   if (path.isEmpty())
     return;
 
+  // Restored JSON map (if any) is no longer needed
+  m_pendingJsonMap.clear();
+
   // Close previous file (if open)
   if (m_jsonMap.isOpen())
   {
@@ -175,7 +195,11 @@ void JSON::Generator::loadJsonMap(const QString &path)
     m_jsonMap.close();
   }
 
-  // Update UI
+  // Update the filters & expressions of the next frame, then update UI
+  m_filtersChanged = true;
+  for (auto it = m_devices.begin(); it != m_devices.end(); ++it)
+    it.value().filtersChanged = true;
+
   Q_EMIT jsonFileMapChanged();
 }
 
@@ -196,17 +220,41 @@ void JSON::Generator::setOperationMode(
     const JSON::Generator::OperationMode &mode)
 {
   m_opMode = mode;
+  m_filtersChanged = true;
+  for (auto it = m_devices.begin(); it != m_devices.end(); ++it)
+    it.value().filtersChanged = true;
+
   Q_EMIT operationModeChanged();
+
+  // Load the last JSON map when it is actually needed
+  if (m_opMode == kManual && !m_pendingJsonMap.isEmpty())
+    loadJsonMap(m_pendingJsonMap);
 }
 
 /**
- * Loads the last saved JSON map file (if any)
+ * Restores the last saved JSON map file (if any).
+ *
+ * The file is only parsed if the generator is in manual mode, otherwise the
+ * path is stored and the map is loaded once the user switches to manual mode.
  */
 void JSON::Generator::readSettings()
 {
+  // A JSON map was already loaded (e.g. from the command line)
+  if (m_jsonMap.isOpen())
+    return;
+
+  // Load or defer loading the JSON map
   auto path = m_settings.value("json_map_location", "").toString();
   if (!path.isEmpty())
-    loadJsonMap(path);
+  {
+    if (m_opMode == kManual)
+      loadJsonMap(path);
+    else
+    {
+      m_pendingJsonMap = path;
+      Q_EMIT jsonFileMapChanged();
+    }
+  }
 }
 
 /**
@@ -217,6 +265,262 @@ void JSON::Generator::writeSettings(const QString &path)
   m_settings.setValue("json_map_location", path);
 }
 
+/**
+ * Clears the state of the dataset filters & forgets the devices of the
+ * previous connection, so that data from a new connection is not mixed with
+ * data from the previous one.
+ */
+void JSON::Generator::resetFilters()
+{
+  m_filters.reset();
+  m_device.clear();
+  m_devices.clear();
+  m_revisions.clear();
+}
+
+/**
+ * Builds the dataset filters from the "filter" keys of the datasets of the
+ * current frame. The filters are only rebuilt (and their state cleared) if
+ * any of the specifications changed, invalid specifications are reported to
+ * the user.
+ */
+void JSON::Generator::configureFilters()
+{
+  const auto &frame = m_decoder.frame();
+
+  QVector<QStringList> specs;
+  specs.reserve(frame.groupCount());
+  for (int i = 0; i < frame.groupCount(); ++i)
+  {
+    QStringList list;
+    const auto &group = frame.getGroup(i);
+    for (int j = 0; j < group.datasetCount(); ++j)
+      list.append(group.getDataset(j).filter());
+
+    specs.append(list);
+  }
+
+  if (m_filters.configure(specs) && !m_filters.errors().isEmpty())
+    Misc::Utilities::showMessageBox(tr("Invalid dataset filters"),
+                                    m_filters.errors().join("\n"));
+}
+
+/**
+ * Builds the derived datasets from the "expression" keys of the datasets of
+ * the current frame. Expressions are only compiled again if any of them
+ * changed, in which case invalid expressions & references to datasets that do
+ * not exist are reported to the user.
+ *
+ * References are always resolved again, since the datasets that they point to
+ * may have moved within the frame. Datasets with invalid expressions keep the
+ * value read from the frame (if any).
+ */
+void JSON::Generator::configureExpressions()
+{
+  auto &groups = m_decoder.frame().groups();
+
+  // Obtain the expressions of the current frame
+  QStringList sources;
+  for (int i = 0; i < groups.count(); ++i)
+  {
+    const auto &group = groups.at(i);
+    for (int j = 0; j < group.datasetCount(); ++j)
+      sources.append(group.getDataset(j).expression().trimmed());
+  }
+
+  // Compile the expressions again if they changed
+  QStringList errors;
+  const bool changed = sources != m_expressionSources;
+  if (changed)
+  {
+    m_derived.clear();
+    m_expressionSources = sources;
+
+    int index = 0;
+    for (int i = 0; i < groups.count(); ++i)
+    {
+      const auto &group = groups.at(i);
+      for (int j = 0; j < group.datasetCount(); ++j)
+      {
+        const auto &source = sources.at(index++);
+        if (source.isEmpty())
+          continue;
+
+        DerivedDataset derived;
+        derived.group = i;
+        derived.dataset = j;
+        if (!derived.expression.compile(source))
+        {
+          errors.append(QStringLiteral("%1: %2").arg(
+              group.getDataset(j).title(), derived.expression.error()));
+          continue;
+        }
+
+        m_derived.append(derived);
+      }
+    }
+  }
+
+  // Resolve the datasets referenced by each expression
+  int inputs = 0;
+  for (auto &derived : m_derived)
+  {
+    derived.inputGroups.clear();
+    derived.inputDatasets.clear();
+
+    const auto references = derived.expression.references();
+    for (const auto &reference : references)
+    {
+      int group = -1;
+      int dataset = -1;
+      if (!Expression::findDataset(reference, groups, &group, &dataset)
+          && changed)
+      {
+        const auto &group = groups.at(derived.group);
+        const auto title = group.getDataset(derived.dataset).title();
+        errors.append(tr("%1: unknown dataset \"%2\"").arg(title, reference));
+      }
+
+      derived.inputGroups.append(group);
+      derived.inputDatasets.append(dataset);
+    }
+
+    inputs = qMax(inputs, references.count());
+  }
+
+  // Allocate the input buffer once
+  m_fieldValues.resize(inputs);
+
+  // Report invalid expressions
+  if (!errors.isEmpty())
+    Misc::Utilities::showMessageBox(tr("Invalid dataset expressions"),
+                                    errors.join("\n"));
+}
+
+/**
+ * Evaluates the expressions of the derived datasets with the (filtered)
+ * values of the datasets that they reference, and writes the results to the
+ * current frame. References that could not be resolved or whose value is not
+ * a number evaluate to NaN.
+ */
+void JSON::Generator::evaluateExpressions()
+{
+  if (m_derived.isEmpty())
+    return;
+
+  auto &groups = m_decoder.frame().groups();
+  for (int k = 0; k < m_derived.count(); ++k)
+  {
+    const auto &derived = m_derived.at(k);
+
+    // Gather the values of the referenced datasets
+    const auto count = derived.inputGroups.count();
+    for (int i = 0; i < count; ++i)
+    {
+      const auto g = derived.inputGroups.at(i);
+      const auto d = derived.inputDatasets.at(i);
+
+      double value = std::numeric_limits<double>::quiet_NaN();
+      if (g >= 0 && d >= 0)
+      {
+        const auto &dataset = groups.at(g).getDataset(d);
+        if (dataset.isNumeric())
+          value = dataset.numericValue();
+      }
+
+      m_fieldValues[i] = value;
+    }
+
+    // Evaluate the expression & update the derived dataset (results are set
+    // as numbers, since their text may use an exponent, e.g. "1e-05")
+    const auto value = derived.expression.evaluate(m_fieldValues.constData(),
+                                                   count);
+    auto &dataset = groups[derived.group].datasets()[derived.dataset];
+    if (std::isfinite(value))
+      dataset.setNumericValue(value);
+    else
+      dataset.setValue(QString());
+  }
+}
+
+/**
+ * Returns the frame that is sent to the rest of the application. If frames were
+ * received from several devices, the groups of the latest frame of each device
+ * are merged into a single frame & the device name is added to their titles.
+ *
+ * The merged frame gets a new structure revision whenever the structure of
+ * the frame of any device changes, or when a new device is found.
+ */
+const JSON::Frame &JSON::Generator::outputFrame()
+{
+  // Single device, use the decoded frame directly
+  if (m_devices.isEmpty())
+    return m_decoder.frame();
+
+  // Use the title & timestamp of the current frame
+  m_frame = m_decoder.frame();
+  auto &groups = m_frame.groups();
+  groups.clear();
+
+  // Append the groups of each device
+  int index = 0;
+  bool changed = m_revisions.count() != m_devices.count();
+  m_revisions.resize(m_devices.count());
+  for (auto it = m_devices.constBegin(); it != m_devices.constEnd(); ++it)
+  {
+    const auto &device = it.key();
+    const auto &frame = device == m_device ? m_decoder.frame()
+                                           : it.value().decoder.frame();
+
+    changed |= m_revisions.at(index) != frame.revision();
+    m_revisions[index++] = frame.revision();
+
+    for (int i = 0; i < frame.groupCount(); ++i)
+    {
+      groups.append(frame.getGroup(i));
+      if (!device.isEmpty())
+      {
+        auto &group = groups.last();
+        group.m_title = QStringLiteral("%1: %2").arg(device, group.m_title);
+      }
+    }
+  }
+
+  // Update the structure revision of the merged frame
+  if (changed)
+    m_revision = JSON::Frame::nextRevision();
+
+  m_frame.setRevision(m_revision);
+  return m_frame;
+}
+
+/**
+ * Makes the decoder & filters of the given @a device the active ones, and
+ * stores the ones of the previous device, so that the frames of each device
+ * are decoded & filtered independently.
+ */
+void JSON::Generator::selectDevice(const QString &device)
+{
+  if (device == m_device)
+    return;
+
+  auto &previous = m_devices[m_device];
+  std::swap(previous.decoder, m_decoder);
+  std::swap(previous.filters, m_filters);
+  std::swap(previous.filtersChanged, m_filtersChanged);
+  std::swap(previous.expressionSources, m_expressionSources);
+  std::swap(previous.derived, m_derived);
+
+  auto &next = m_devices[device];
+  std::swap(next.decoder, m_decoder);
+  std::swap(next.filters, m_filters);
+  std::swap(next.filtersChanged, m_filtersChanged);
+  std::swap(next.expressionSources, m_expressionSources);
+  std::swap(next.derived, m_derived);
+
+  m_device = device;
+}
+
 /**
  * Tries to parse the given data as a JSON document according to the selected
  * operation mode.
@@ -236,10 +540,38 @@ void JSON::Generator::readData(const QByteArray &data)
   if (data.isEmpty())
     return;
 
+  // Measure time spent generating the JSON frame (includes the frame parser)
+  Misc::Instrumentation::ScopedTimer timer(Misc::Instrumentation::JsonGenerator);
+
+  // Use the decoder & filters of the device that sent the frame
+  selectDevice(IO::Manager::instance().frameDevice());
+
   // Serial device sends JSON (auto mode)
   QJsonObject jsonData;
-  if (operationMode() == JSON::Generator::kAutomatic)
+  const bool automatic = operationMode() == JSON::Generator::kAutomatic;
+  if (automatic)
+  {
+    // Frame has the same structure as the previous one, only update values
+    if (m_decoder.decode(data))
+    {
+      m_decoder.frame().setTimestamp(IO::Manager::instance().frameTimestamp());
+      m_filters.process(m_decoder.frame());
+      evaluateExpressions();
+      const auto &frame = outputFrame();
+      timer.stop();
+      Q_EMIT frameChanged(frame);
+
+      // Only build the JSON document if someone needs it (e.g. plugins)
+      const auto signal = QMetaMethod::fromSignal(&Generator::jsonChanged);
+      if (isSignalConnected(signal))
+        Q_EMIT jsonChanged(QJsonDocument::fromJson(data).object());
+
+      return;
+    }
+
+    // Parse the complete frame
     jsonData = QJsonDocument::fromJson(data).object();
+  }
 
   // Data is separated and parsed by Serial Studio (manual mode)
   else
@@ -248,7 +580,7 @@ void JSON::Generator::readData(const QByteArray &data)
     jsonData = m_json;
 
     // Get fields from frame parser function
-    auto fields = Project::CodeEditor::instance().parse(
+    auto fields = Project::FrameParser::instance().parse(
         QString::fromUtf8(data), IO::Manager::instance().separatorSequence());
 
     // Replace data in JSON map
@@ -288,7 +620,40 @@ void JSON::Generator::readData(const QByteArray &data)
     }
   }
 
+  // Build frame model (and learn the frame schema in auto mode)
+  bool valid = false;
+  if (!jsonData.isEmpty())
+    valid = m_decoder.read(jsonData, automatic ? data : QByteArray());
+
+  // Update the filters & expressions if the frame structure may have changed,
+  // then filter values & evaluate derived datasets
+  if (valid)
+  {
+    m_decoder.frame().setTimestamp(IO::Manager::instance().frameTimestamp());
+    if (automatic || m_filtersChanged)
+    {
+      configureFilters();
+      configureExpressions();
+      m_filtersChanged = false;
+    }
+
+    m_filters.process(m_decoder.frame());
+    evaluateExpressions();
+  }
+
   // Update UI
+  if (valid)
+  {
+    const auto &frame = outputFrame();
+    timer.stop();
+    Q_EMIT frameChanged(frame);
+  }
+
+  // Invalid JSON data received
+  else
+    Misc::Instrumentation::addDropped(Misc::Instrumentation::InvalidFrame);
+
+  // Notify JSON listeners
   if (!jsonData.isEmpty())
     Q_EMIT jsonChanged(jsonData);
 }
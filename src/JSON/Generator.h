@@ -22,6 +22,7 @@
 
 #pragma once
 
+#include <QMap>
 #include <QFile>
 #include <QObject>
 #include <QSettings>
@@ -31,6 +32,9 @@
 #include <QJsonDocument>
 
 #include <JSON/Frame.h>
+#include <DSP/FilterBank.h>
+#include <JSON/Expression.h>
+#include <JSON/FrameDecoder.h>
 
 namespace JSON
 {
@@ -48,14 +52,33 @@ namespace JSON
  * 2) I/O driver receives data
  * 3) I/O manager processes the data and separates the frames
  * 4) JSON generator creates a JSON file with the data contained in each frame.
- * 5) UI dashboard class receives the JSON file.
- * 6) TimerEvents class notifies the UI dashboard that the user interface should
- *    be re-generated.
- * 7) UI dashboard feeds JSON data to a @c Frame object.
- * 8) The @c Frame object creates a model of the JSON data with the values of
+ * 5) JSON generator feeds JSON data to a @c Frame object (in automatic mode,
+ *    the @c FrameDecoder class skips this step if the structure of the frame
+ *    did not change).
+ * 6) The @c Frame object creates a model of the JSON data with the values of
  *    the latest received frame.
+ * 7) UI dashboard class receives the @c Frame object.
+ * 8) TimerEvents class notifies the UI dashboard that the user interface should
+ *    be re-generated.
  * 9) UI dashboard updates the widgets with the C++ model provided by this
  * class.
+ *
+ * Datasets with a "filter" key are filtered (see @c DSP::FilterBank) after the
+ * frame model is built & before @c frameChanged() is emitted. The raw values
+ * are still available through @c jsonChanged() and the raw frames received by
+ * the I/O manager.
+ *
+ * Datasets with an "expression" key (derived datasets) do not read their value
+ * from the frame. In both operation modes, their expressions are compiled when
+ * the structure of the frame changes & evaluated with the (filtered) values of
+ * the datasets that they reference before @c frameChanged() is emitted, so
+ * derived values reach the dashboard, the CSV file, the plugins and any other
+ * listener of the frame exactly like regular values.
+ *
+ * Frames received from several devices at once (e.g. through the TCP server)
+ * are decoded & filtered separately for each device, and the groups of the
+ * latest frame of every device are merged into the frame sent to the rest of
+ * the application, with the name of the device as a prefix of each group.
  */
 class Generator : public QObject
 {
@@ -76,6 +99,7 @@ class Generator : public QObject
 Q_SIGNALS:
   void jsonFileMapChanged();
   void operationModeChanged();
+  void frameChanged(const JSON::Frame &frame);
   void jsonChanged(const QJsonObject &json);
 
 private:
@@ -110,13 +134,59 @@ public Q_SLOTS:
   void writeSettings(const QString &path);
 
 private Q_SLOTS:
+  void resetFilters();
   void readData(const QByteArray &data);
 
 private:
+  void configureFilters();
+  void evaluateExpressions();
+  void configureExpressions();
+  const Frame &outputFrame();
+  void selectDevice(const QString &device);
+
+private:
+  struct DerivedDataset
+  {
+    int group;
+    int dataset;
+    Expression expression;
+    QVector<int> inputGroups;
+    QVector<int> inputDatasets;
+  };
+
   QFile m_jsonMap;
   QJsonObject m_json;
   QSettings m_settings;
+  QString m_pendingJsonMap;
   OperationMode m_opMode;
   QJsonParseError m_error;
+  FrameDecoder m_decoder;
+
+  bool m_filtersChanged;
+  DSP::FilterBank m_filters;
+
+  QVector<double> m_fieldValues;
+  QStringList m_expressionSources;
+  QVector<DerivedDataset> m_derived;
+
+  struct Device
+  {
+    Device()
+      : filtersChanged(true)
+    {
+    }
+
+    FrameDecoder decoder;
+    bool filtersChanged;
+    DSP::FilterBank filters;
+    QStringList expressionSources;
+    QVector<DerivedDataset> derived;
+  };
+
+  Frame m_frame;
+  QString m_device;
+  quint64 m_revision;
+  QVector<quint64> m_revisions;
+  QMap<QString, Device> m_devices;
 };
 } // namespace JSON
@@ -75,6 +75,7 @@ private:
   QString m_widget;
   QVector<JSON::Dataset> m_datasets;
 
+  friend class Generator;
   friend class UI::Dashboard;
   friend class Project::Model;
 };
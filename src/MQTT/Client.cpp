@@ -22,9 +22,12 @@
 
 #include <QFile>
 #include <QFileDialog>
+#include <QJsonDocument>
 
 #include <IO/Manager.h>
 #include <MQTT/Client.h>
+#include <Misc/Alarms.h>
+#include <JSON/Generator.h>
 #include <Misc/Utilities.h>
 #include <Misc/TimerEvents.h>
 
@@ -36,6 +39,7 @@ MQTT::Client::Client()
   , m_lookupActive(false)
   , m_sentMessages(0)
   , m_clientMode(MQTTClientMode::ClientPublisher)
+  , m_revision(0)
   , m_client(Q_NULLPTR)
 {
   // Configure new client
@@ -45,11 +49,16 @@ MQTT::Client::Client()
   // device
   auto io = &IO::Manager::instance();
   auto te = &Misc::TimerEvents::instance();
+  auto al = &Misc::Alarms::instance();
+  auto ge = &JSON::Generator::instance();
   connect(te, &Misc::TimerEvents::timeout1Hz, this, &MQTT::Client::sendData);
   connect(io, &IO::Manager::frameReceived, this,
           &MQTT::Client::onFrameReceived);
+  connect(ge, &JSON::Generator::frameChanged, this,
+          &MQTT::Client::onFrameChanged);
   connect(io, &IO::Manager::connectedChanged, this,
           &MQTT::Client::resetStatistics);
+  connect(al, &Misc::Alarms::eventLogged, this, &MQTT::Client::onAlarmEvent);
 }
 
 /**
@@ -220,6 +229,14 @@ bool MQTT::Client::isConnectedToHost() const
   return m_client->isConnectedToHost();
 }
 
+/**
+ * Returns the number of frames waiting to be published to the MQTT broker
+ */
+int MQTT::Client::backlog() const
+{
+  return m_frames.count();
+}
+
 /**
  * Returns a list with the available quality-of-service modes.
  */
@@ -574,8 +591,24 @@ void MQTT::Client::sendData()
     ++m_sentMessages;
   }
 
-  // Clear frame list
+  // Create & send the values of the derived datasets
+  QByteArray derived;
+  for (int i = 0; i < m_derivedFrames.count(); ++i)
+  {
+    derived.append(m_derivedFrames.at(i));
+    derived.append("\n");
+  }
+
+  if (!derived.isEmpty())
+  {
+    QMQTT::Message message(m_sentMessages, topic() + "/derived", derived);
+    m_client->publish(message);
+    ++m_sentMessages;
+  }
+
+  // Clear frame lists
   m_frames.clear();
+  m_derivedFrames.clear();
 }
 
 /**
@@ -583,8 +616,10 @@ void MQTT::Client::sendData()
  */
 void MQTT::Client::resetStatistics()
 {
+  m_revision = 0;
   m_sentMessages = 0;
   m_frames.clear();
+  m_derivedFrames.clear();
 }
 
 /**
@@ -752,6 +787,86 @@ void MQTT::Client::onFrameReceived(const QByteArray &frame)
     m_frames.append(frame);
 }
 
+/**
+ * Registers the values of the derived datasets of the given @a frame, so that
+ * they are published to the "<topic>/derived" topic along with the frames. The
+ * location of the derived datasets is only looked up again when the structure
+ * of the frame changes.
+ */
+void MQTT::Client::onFrameChanged(const JSON::Frame &frame)
+{
+  // Ignore if device is not connected
+  if (!IO::Manager::instance().connected())
+    return;
+
+  // Ignore if mode is not set to publisher
+  else if (clientMode() != ClientPublisher)
+    return;
+
+  // Find the derived datasets of the frame
+  if (frame.revision() != m_revision)
+  {
+    m_revision = frame.revision();
+    m_derivedGroups.clear();
+    m_derivedDatasets.clear();
+    for (int i = 0; i < frame.groupCount(); ++i)
+    {
+      const auto &group = frame.getGroup(i);
+      for (int j = 0; j < group.datasetCount(); ++j)
+      {
+        if (!group.getDataset(j).expression().trimmed().isEmpty())
+        {
+          m_derivedGroups.append(i);
+          m_derivedDatasets.append(j);
+        }
+      }
+    }
+  }
+
+  // Nothing to publish
+  if (m_derivedGroups.isEmpty())
+    return;
+
+  // Register the values of the derived datasets (NaN values become null)
+  QJsonObject values;
+  for (int i = 0; i < m_derivedGroups.count(); ++i)
+  {
+    const auto &group = frame.getGroup(m_derivedGroups.at(i));
+    const auto &dataset = group.getDataset(m_derivedDatasets.at(i));
+    if (dataset.isNumeric())
+      values.insert(dataset.title(), dataset.numericValue());
+    else
+      values.insert(dataset.title(), QJsonValue());
+  }
+
+  QJsonDocument document(values);
+  m_derivedFrames.append(document.toJson(QJsonDocument::Compact));
+}
+
+/**
+ * Publishes the given alarm @a event to the "<topic>/alarms" topic as soon as
+ * the alarm is raised or cleared.
+ */
+void MQTT::Client::onAlarmEvent(const QJsonObject &event)
+{
+  Q_ASSERT(m_client);
+
+  // Ignore if mode is not set to publisher
+  if (clientMode() != ClientPublisher)
+    return;
+
+  // Ignore if not connected to the broker
+  else if (!isConnectedToHost() || topic().isEmpty())
+    return;
+
+  // Create & send MQTT message
+  QJsonDocument document(event);
+  const auto data = document.toJson(QJsonDocument::Compact);
+  QMQTT::Message message(m_sentMessages, topic() + "/alarms", data);
+  m_client->publish(message);
+  ++m_sentMessages;
+}
+
 /**
  * Displays the SSL errors that occur and allows the user to decide if he/she
  * wants to ignore those errors.
@@ -25,11 +25,13 @@
 #include <QObject>
 #include <QHostInfo>
 #include <QByteArray>
+#include <QJsonObject>
 #include <QHostAddress>
 #include <QSslConfiguration>
 
 #include <qmqtt.h>
 #include <DataTypes.h>
+#include <JSON/Frame.h>
 
 namespace MQTT
 {
@@ -58,6 +60,12 @@ enum MQTTClientMode
  * almost in real-time in another location, such as the "ground control" centre
  * or by the media team which streams the GCS display on the internet as the
  * mission is developing.
+ *
+ * When acting as a publisher, alarm transitions are published immediately
+ * (as JSON objects) to the "<topic>/alarms" topic. Frames are published as
+ * they are received, the values of the derived datasets of each frame (which
+ * are not part of the received data) are published alongside them to the
+ * "<topic>/derived" topic, as one JSON object per line.
  */
 class Client : public QObject
 {
@@ -184,6 +192,7 @@ public:
   bool lookupActive() const;
   bool isSubscribed() const;
   bool isConnectedToHost() const;
+  int backlog() const;
 
   StringList qosLevels() const;
   StringList clientModes() const;
@@ -221,6 +230,8 @@ private Q_SLOTS:
   void lookupFinished(const QHostInfo &info);
   void onError(const QMQTT::ClientError error);
   void onFrameReceived(const QByteArray &frame);
+  void onAlarmEvent(const QJsonObject &event);
+  void onFrameChanged(const JSON::Frame &frame);
   void onSslErrors(const QList<QSslError> &errors);
   void onMessageReceived(const QMQTT::Message &message);
 
@@ -236,6 +247,10 @@ private:
   quint16 m_sentMessages;
   MQTTClientMode m_clientMode;
   QVector<QByteArray> m_frames;
+  quint64 m_revision;
+  QVector<int> m_derivedGroups;
+  QVector<int> m_derivedDatasets;
+  QVector<QByteArray> m_derivedFrames;
   QPointer<QMQTT::Client> m_client;
   QSslConfiguration m_sslConfiguration;
 };
@@ -0,0 +1,324 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <cmath>
+#include <limits>
+
+#include <QDateTime>
+
+#include <IO/Manager.h>
+#include <CSV/Player.h>
+#include <Misc/Alarms.h>
+#include <JSON/Generator.h>
+
+/**
+ * Constructor function
+ */
+Misc::Alarms::Alarms()
+  : m_activeCount(0)
+  , m_lastTime(0)
+  , m_revision(0)
+{
+  // clang-format off
+    connect(&JSON::Generator::instance(), &JSON::Generator::frameChanged,
+            this, &Misc::Alarms::registerFrame);
+    connect(&JSON::Generator::instance(), &JSON::Generator::jsonFileMapChanged,
+            this, &Misc::Alarms::reset);
+    connect(&IO::Manager::instance(), &IO::Manager::connectedChanged,
+            this, &Misc::Alarms::reset);
+    connect(&CSV::Player::instance(), &CSV::Player::openChanged,
+            this, &Misc::Alarms::reset);
+  // clang-format on
+}
+
+/**
+ * Returns the only instance of the class
+ */
+Misc::Alarms &Misc::Alarms::instance()
+{
+  static Alarms singleton;
+  return singleton;
+}
+
+/**
+ * Returns the number of datasets with an alarm condition
+ */
+int Misc::Alarms::alarmCount() const
+{
+  return m_modes.count();
+}
+
+/**
+ * Returns the number of alarms that are currently raised
+ */
+int Misc::Alarms::activeCount() const
+{
+  return m_activeCount;
+}
+
+/**
+ * Returns the latest alarm events (up to @c kMaxEvents), oldest first
+ */
+QJsonArray Misc::Alarms::eventLog() const
+{
+  QJsonArray array;
+  for (int i = 0; i < m_events.count(); ++i)
+    array.append(m_events.at(i));
+
+  return array;
+}
+
+/**
+ * Removes the alarm configuration & clears the raised alarms. The event log is
+ * kept, since it describes what happened before the reset.
+ */
+void Misc::Alarms::reset()
+{
+  m_revision = 0;
+  m_groups.clear();
+  m_datasets.clear();
+  m_modes.clear();
+  m_titles.clear();
+  m_groupTitles.clear();
+  m_high.clear();
+  m_low.clear();
+  m_hysteresis.clear();
+  m_debounce.clear();
+  m_rate.clear();
+  m_values.clear();
+  m_previous.clear();
+  m_counters.clear();
+  m_active.clear();
+  m_transitions.clear();
+
+  m_lastTime = 0;
+  m_activeCount = 0;
+  Q_EMIT alarmsReset();
+  Q_EMIT activeCountChanged();
+}
+
+/**
+ * Evaluates the alarm condition of every dataset with the values of the given
+ * @a frame.
+ */
+void Misc::Alarms::registerFrame(const JSON::Frame &frame)
+{
+  // Check if the structure of the frame changed
+  const bool changed = frame.revision() != m_revision;
+
+  // Read the alarm conditions of the new frame structure
+  if (changed)
+    configure(frame);
+
+  // No alarms defined
+  const auto count = m_modes.count();
+  if (count == 0)
+    return;
+
+  // Get the time since the previous frame (used by rate of change alarms).
+  // Frames read from the same chunk share their ingest time, so the rate is
+  // measured between the first frames of consecutive chunks & it is unknown
+  // (not evaluated) for the other frames.
+  const auto now = frame.timestamp();
+  const bool advance = now > m_lastTime;
+  const auto elapsed = (now - m_lastTime) / 1e6;
+  const auto scale = advance && m_lastTime > 0 ? 1 / elapsed : qQNaN();
+  if (advance)
+    m_lastTime = now;
+
+  // Gather the values of the datasets with alarms
+  const auto values = m_values.data();
+  for (int i = 0; i < count; ++i)
+  {
+    const auto &group = frame.getGroup(m_groups.at(i));
+    const auto &dataset = group.getDataset(m_datasets.at(i));
+    values[i] = dataset.isNumeric() ? dataset.numericValue() : qQNaN();
+  }
+
+  // Evaluate the alarm conditions
+  m_transitions.clear();
+  const auto low = m_low.constData();
+  const auto high = m_high.constData();
+  const auto rate = m_rate.constData();
+  const auto debounce = m_debounce.constData();
+  const auto hysteresis = m_hysteresis.constData();
+  auto active = m_active.data();
+  auto counters = m_counters.data();
+  auto previous = m_previous.data();
+  for (int i = 0; i < count; ++i)
+  {
+    // Get the value (or its rate of change) to compare
+    auto value = values[i];
+    if (rate[i])
+    {
+      value = std::fabs(values[i] - previous[i]) * scale;
+      if (advance)
+        previous[i] = values[i];
+    }
+
+    // Keep the state of the alarm if there is no valid value
+    if (std::isnan(value))
+      continue;
+
+    // Raised alarms are cleared after going past the hysteresis margin
+    const auto margin = active[i] ? hysteresis[i] : 0;
+    const bool condition = value > high[i] - margin || value < low[i] + margin;
+    if (condition == static_cast<bool>(active[i]))
+    {
+      counters[i] = 0;
+      continue;
+    }
+
+    // Change the state after the debounce count
+    if (++counters[i] >= debounce[i])
+    {
+      active[i] = condition;
+      counters[i] = 0;
+      m_transitions.append(i);
+    }
+  }
+
+  // Log alarm transitions
+  if (!m_transitions.isEmpty())
+  {
+    for (int i = 0; i < m_transitions.count(); ++i)
+    {
+      const auto alarm = m_transitions.at(i);
+      m_activeCount += m_active.at(alarm) ? 1 : -1;
+      logEvent(alarm, now);
+    }
+
+    Q_EMIT activeCountChanged();
+  }
+}
+
+/**
+ * Reads the alarm conditions of the datasets of the given @a frame & stores
+ * the parameters of each alarm in flat arrays.
+ */
+void Misc::Alarms::configure(const JSON::Frame &frame)
+{
+  // Clear previous configuration & raised alarms
+  reset();
+
+  // Register the datasets with an alarm condition
+  const auto infinity = std::numeric_limits<double>::infinity();
+  m_revision = frame.revision();
+  for (int i = 0; i < frame.groupCount(); ++i)
+  {
+    const auto &group = frame.getGroup(i);
+    for (int j = 0; j < group.datasetCount(); ++j)
+    {
+      // Get the alarm condition of the dataset
+      const auto &dataset = group.getDataset(j);
+      const auto name = dataset.alarmMode();
+      auto mode = None;
+      if (name == "above" || (name.isEmpty() && dataset.alarm() > 0))
+        mode = Above;
+      else if (name == "below")
+        mode = Below;
+      else if (name == "band")
+        mode = Band;
+      else if (name == "rate")
+        mode = Rate;
+
+      if (mode == None)
+        continue;
+
+      // Register the alarm parameters
+      const bool useLow = mode == Below || mode == Band;
+      const bool useHigh = mode != Below;
+      m_groups.append(i);
+      m_datasets.append(j);
+      m_modes.append(mode);
+      m_titles.append(dataset.title());
+      m_groupTitles.append(group.title());
+      m_high.append(useHigh ? dataset.alarm() : infinity);
+      m_low.append(useLow ? dataset.alarmLow() : -infinity);
+      m_hysteresis.append(qMax(0.0, dataset.alarmHysteresis()));
+      m_debounce.append(qMax(1, dataset.alarmDebounce()));
+      m_rate.append(mode == Rate);
+    }
+  }
+
+  // Allocate the state of each alarm
+  const auto count = m_modes.count();
+  m_values.fill(0, count);
+  m_previous.fill(qQNaN(), count);
+  m_counters.fill(0, count);
+  m_active.fill(0, count);
+}
+
+/**
+ * Appends an event describing the current state of the given @a alarm to the
+ * event log & notifies the rest of the application.
+ *
+ * The event is stamped with the time at which the data of the frame was
+ * received (@a time, see @c JSON::Frame::timestamp()), so that events of
+ * frames processed in batches or replayed at a higher speed line up with the
+ * rows of the data CSV file.
+ */
+void Misc::Alarms::logEvent(const int alarm, const qint64 time)
+{
+  // Get the name of the condition & the limit that was crossed
+  double limit = m_high.at(alarm);
+  const auto value = m_values.at(alarm);
+  QString condition;
+  switch (m_modes.at(alarm))
+  {
+    case Above:
+      condition = "above";
+      break;
+    case Below:
+      condition = "below";
+      limit = m_low.at(alarm);
+      break;
+    case Band:
+      condition = "band";
+      if (value < (m_low.at(alarm) + m_high.at(alarm)) / 2)
+        limit = m_low.at(alarm);
+      break;
+    case Rate:
+      condition = "rate";
+      break;
+    default:
+      break;
+  }
+
+  // Create the event
+  QJsonObject event;
+  const auto dateTime = IO::Manager::instance().dateTime(time);
+  event.insert("time", dateTime.toString(Qt::ISODateWithMs));
+  event.insert("group", m_groupTitles.at(alarm));
+  event.insert("dataset", m_titles.at(alarm));
+  event.insert("condition", condition);
+  event.insert("active", m_active.at(alarm) != 0);
+  event.insert("value", value);
+  event.insert("limit", limit);
+
+  // Register the event
+  m_events.append(event);
+  if (m_events.count() > kMaxEvents)
+    m_events.removeFirst();
+
+  Q_EMIT eventLogged(event);
+}
@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <QObject>
+#include <QVector>
+#include <QJsonArray>
+#include <QJsonObject>
+
+#include <DataTypes.h>
+#include <JSON/Frame.h>
+
+namespace Misc
+{
+/**
+ * @brief The Alarms class
+ *
+ * Evaluates the alarm condition of every dataset as frames are received from
+ * the JSON generator, regardless of which widgets are visible (or if there is
+ * a user interface at all). Each dataset can define one of these conditions:
+ *
+ * - Above: the value is greater than the "alarm" level.
+ * - Below: the value is lower than the "alarmLow" level.
+ * - Band:  the value is outside of the ["alarmLow", "alarm"] range.
+ * - Rate:  the absolute rate of change of the value (units per second) is
+ *          greater than the "alarm" level. The time between samples is
+ *          taken from the time at which the frames were received.
+ *
+ * Once raised, an alarm is only cleared after the value goes back past the
+ * limit by more than the "alarmHysteresis" margin. Both raising & clearing an
+ * alarm require the condition to hold for "alarmDebounce" consecutive frames.
+ * Datasets without an "alarmMode" (e.g. older projects) use the "above"
+ * condition if their alarm level is greater than zero.
+ *
+ * The parameters of the datasets with alarms are stored in flat arrays, so
+ * evaluating a frame is a single loop over contiguous memory, and events are
+ * only built when an alarm is raised or cleared. Each transition is appended
+ * to a timestamped event log & emitted through @c eventLogged(), which is
+ * used by the CSV export, the plugin server and the MQTT client.
+ */
+class Alarms : public QObject
+{
+  // clang-format off
+    Q_OBJECT
+    Q_PROPERTY(int activeCount
+               READ activeCount
+               NOTIFY activeCountChanged)
+  // clang-format on
+
+Q_SIGNALS:
+  void alarmsReset();
+  void activeCountChanged();
+  void eventLogged(const QJsonObject &event);
+
+private:
+  explicit Alarms();
+  Alarms(Alarms &&) = delete;
+  Alarms(const Alarms &) = delete;
+  Alarms &operator=(Alarms &&) = delete;
+  Alarms &operator=(const Alarms &) = delete;
+
+public:
+  static Alarms &instance();
+
+  int alarmCount() const;
+  int activeCount() const;
+  QJsonArray eventLog() const;
+
+public Q_SLOTS:
+  void reset();
+
+private Q_SLOTS:
+  void registerFrame(const JSON::Frame &frame);
+
+private:
+  static constexpr int kMaxEvents = 1000;
+
+  enum Mode
+  {
+    None,
+    Above,
+    Below,
+    Band,
+    Rate
+  };
+
+  void configure(const JSON::Frame &frame);
+  void logEvent(const int alarm, const qint64 time);
+
+private:
+  int m_activeCount;
+  qint64 m_lastTime;
+
+  quint64 m_revision;
+  QVector<QJsonObject> m_events;
+
+  QVector<int> m_groups;
+  QVector<int> m_datasets;
+  QVector<quint8> m_modes;
+  StringList m_titles;
+  StringList m_groupTitles;
+
+  QVector<double> m_high;
+  QVector<double> m_low;
+  QVector<double> m_hysteresis;
+  QVector<int> m_debounce;
+  QVector<quint8> m_rate;
+
+  QVector<double> m_values;
+  QVector<double> m_previous;
+  QVector<int> m_counters;
+  QVector<quint8> m_active;
+  QVector<int> m_transitions;
+};
+} // namespace Misc
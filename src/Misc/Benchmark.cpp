@@ -0,0 +1,1394 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <numeric>
+#include <algorithm>
+
+#include <QFile>
+#include <QDebug>
+#include <QFileInfo>
+#include <QSysInfo>
+#include <QJsonArray>
+#include <QMetaMethod>
+#include <QDirIterator>
+#include <QJsonDocument>
+#include <QElapsedTimer>
+#include <QCommandLineParser>
+
+#include <AppInfo.h>
+#include <CSV/Export.h>
+#include <CSV/Player.h>
+#include <IO/Manager.h>
+#include <IO/Checksum.h>
+#include <IO/Recorder.h>
+#include <DSP/Filter.h>
+#include <JSON/Frame.h>
+#include <UI/Widgets/Bar.h>
+#include <JSON/Expression.h>
+#include <UI/Widgets/GPS.h>
+#include <UI/Dashboard.h>
+#include <UI/Widgets/Plot.h>
+#include <JSON/Generator.h>
+#include <Misc/Benchmark.h>
+#include <UI/Widgets/Gauge.h>
+#include <UI/Widgets/Compass.h>
+#include <UI/Widgets/FFTPlot.h>
+#include <UI/Widgets/LEDPanel.h>
+#include <UI/Widgets/DataGroup.h>
+#include <UI/Widgets/Gyroscope.h>
+#include <UI/Widgets/MultiPlot.h>
+#include <UI/Widgets/Waterfall.h>
+#include <IO/Drivers/Synthetic.h>
+#include <UI/Widgets/Accelerometer.h>
+
+//------------------------------------------------------------------------------
+// Heap allocation counter
+//------------------------------------------------------------------------------
+
+/**
+ * Number of heap allocations performed by the process. On glibc systems, the
+ * C allocator is interposed, so that allocations made by Qt containers (which
+ * call @c malloc() directly) are also counted. On other systems, only the
+ * global @c operator new is replaced.
+ */
+static std::atomic<quint64> ALLOCATIONS(0);
+
+#if defined(__GLIBC__)
+#  define ALLOCATION_SOURCE "malloc"
+extern "C" {
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t count, size_t size);
+void *__libc_realloc(void *ptr, size_t size);
+void __libc_free(void *ptr);
+
+void *malloc(size_t size) noexcept
+{
+  ALLOCATIONS.fetch_add(1, std::memory_order_relaxed);
+  return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size) noexcept
+{
+  ALLOCATIONS.fetch_add(1, std::memory_order_relaxed);
+  return __libc_calloc(count, size);
+}
+
+void *realloc(void *ptr, size_t size) noexcept
+{
+  ALLOCATIONS.fetch_add(1, std::memory_order_relaxed);
+  return __libc_realloc(ptr, size);
+}
+
+void free(void *ptr) noexcept
+{
+  __libc_free(ptr);
+}
+}
+#else
+#  define ALLOCATION_SOURCE "operator new"
+void *operator new(std::size_t size)
+{
+  ALLOCATIONS.fetch_add(1, std::memory_order_relaxed);
+  if (auto ptr = std::malloc(size ? size : 1))
+    return ptr;
+
+  throw std::bad_alloc();
+}
+
+void *operator new[](std::size_t size)
+{
+  return ::operator new(size);
+}
+
+void operator delete(void *ptr) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete[](void *ptr, std::size_t) noexcept
+{
+  std::free(ptr);
+}
+#endif
+
+//------------------------------------------------------------------------------
+// Utility functions
+//------------------------------------------------------------------------------
+
+/**
+ * Returns the (private) slot with the given @a signature of @a object, this
+ * allows benchmarking each pipeline stage in isolation.
+ */
+static QMetaMethod slot(const QObject *object, const char *signature)
+{
+  const auto meta = object->metaObject();
+  const auto norm = QMetaObject::normalizedSignature(signature);
+  const auto index = meta->indexOfSlot(norm.constData());
+  if (index < 0)
+    qCritical() << "Benchmark: slot not found" << signature;
+
+  return meta->method(index);
+}
+
+/**
+ * Returns the slot used by the given dashboard @a widget to display the latest
+ * frame, this is the slot connected to the @c UI::Dashboard::updated() signal.
+ */
+static QMetaMethod refreshSlot(const QObject *widget)
+{
+  const auto meta = widget->metaObject();
+  auto index = meta->indexOfSlot("updateData()");
+  if (index < 0)
+    index = meta->indexOfSlot("update()");
+
+  return meta->method(index);
+}
+
+/**
+ * Creates a dashboard widget of the given @a type, which displays the first
+ * element of its kind registered by the dashboard.
+ */
+static Widgets::DashboardWidgetBase *createWidget(const QString &type)
+{
+  if (type == "plot")
+    return new Widgets::Plot(0);
+  if (type == "multiplot")
+    return new Widgets::MultiPlot(0);
+  if (type == "fft")
+    return new Widgets::FFTPlot(0);
+  if (type == "waterfall")
+    return new Widgets::Waterfall(0);
+  if (type == "bar")
+    return new Widgets::Bar(0);
+  if (type == "gauge")
+    return new Widgets::Gauge(0);
+  if (type == "compass")
+    return new Widgets::Compass(0);
+  if (type == "gyroscope")
+    return new Widgets::Gyroscope(0);
+  if (type == "accelerometer")
+    return new Widgets::Accelerometer(0);
+  if (type == "led")
+    return new Widgets::LEDPanel(0);
+  if (type == "group")
+    return new Widgets::DataGroup(0);
+  if (type == "gps")
+    return new Widgets::GPS(0);
+
+  return Q_NULLPTR;
+}
+
+/**
+ * Returns the @a quantile of the given (sorted) @a samples.
+ */
+static qint64 percentile(const QVector<qint64> &samples, const double quantile)
+{
+  if (samples.isEmpty())
+    return 0;
+
+  const auto index = qRound(quantile * (samples.count() - 1));
+  return samples.at(qBound(0, index, samples.count() - 1));
+}
+
+//------------------------------------------------------------------------------
+// Benchmark implementation
+//------------------------------------------------------------------------------
+
+/**
+ * Constructor function, points the home & configuration directories to a
+ * temporary location, so that the CSV files and settings written by the
+ * benchmarks do not pollute the user's environment.
+ *
+ * @note Must be called before creating the application object.
+ */
+Misc::Benchmark::Benchmark()
+  : m_frames(10000)
+  , m_failures(0)
+{
+  if (m_home.isValid())
+  {
+    qputenv("HOME", m_home.path().toUtf8());
+    qputenv("XDG_CONFIG_HOME", (m_home.path() + "/.config").toUtf8());
+    qputenv("XDG_DATA_HOME", (m_home.path() + "/.local/share").toUtf8());
+  }
+}
+
+/**
+ * Returns @c true if the "--benchmark" option is present in the given command
+ * line arguments.
+ */
+bool Misc::Benchmark::requested(int argc, char **argv)
+{
+  for (int i = 1; i < argc; ++i)
+  {
+    if (std::strcmp(argv[i], "--benchmark") == 0)
+      return true;
+  }
+
+  return false;
+}
+
+/**
+ * Parses the given command line @a arguments, runs the benchmarks and writes
+ * the results. Returns the process exit code, which is non-zero if any of the
+ * benchmarks did not process the expected number of frames.
+ */
+int Misc::Benchmark::run(const QStringList &arguments)
+{
+  // clang-format off
+  QCommandLineParser parser;
+  parser.setApplicationDescription(QStringLiteral("%1 benchmarks").arg(APP_NAME));
+  parser.addHelpOption();
+  parser.addOptions({
+    {"benchmark", "Run the data pipeline benchmarks."},
+    {"output", "Write the JSON results to the given file (stdout by default).", "file"},
+    {"frames", "Number of frames processed by each benchmark.", "count"},
+    {"filter", "Only run the benchmarks whose name contains the given text.", "text"},
+    {"replay", "Also measure the pipeline with the given raw data capture.", "file"},
+  });
+  // clang-format on
+
+  // Parse command line
+  if (!parser.parse(arguments))
+  {
+    qCritical().noquote() << parser.errorText();
+    return EXIT_FAILURE;
+  }
+
+  // Show help
+  if (parser.isSet("help"))
+  {
+    qInfo().noquote() << parser.helpText();
+    return EXIT_SUCCESS;
+  }
+
+  // Read options
+  m_filter = parser.value("filter");
+  m_output = parser.value("output");
+  m_replay = parser.value("replay");
+  if (parser.isSet("frames"))
+    m_frames = qMax(100, parser.value("frames").toInt());
+
+  // Use the synthetic driver, frames are fed manually (no event loop)
+  auto &synthetic = IO::Drivers::Synthetic::instance();
+  synthetic.setFrameRate(1);
+  synthetic.setFullSpeed(false);
+  IO::Manager::instance().setSeparatorSequence(",");
+  IO::Manager::instance().setSelectedDriver(
+      IO::Manager::SelectedDriver::Synthetic);
+
+  // Do not export CSV files unless explicitly benchmarked
+  CSV::Export::instance().setExportEnabled(false);
+
+  // Run benchmarks
+  benchmarkChecksums();
+  benchmarkFrameReader();
+  benchmarkGenerator();
+  benchmarkExpressions();
+  benchmarkFilters();
+  benchmarkFrameModel();
+  benchmarkDashboard();
+  benchmarkEndToEnd();
+  benchmarkCsv();
+  benchmarkWidgets();
+  benchmarkReplay();
+
+  // Close device & write results
+  IO::Manager::instance().disconnectDriver();
+  if (!writeResults())
+    return EXIT_FAILURE;
+
+  return m_failures > 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+/**
+ * Returns @c true if the benchmark with the given @a name matches the filter
+ * specified by the user.
+ */
+bool Misc::Benchmark::enabled(const QString &name) const
+{
+  return m_filter.isEmpty() || name.contains(m_filter, Qt::CaseInsensitive);
+}
+
+/**
+ * Runs the given @a function @a iterations times (after a short warm-up
+ * phase) and registers the elapsed time & heap allocations.
+ *
+ * @param name benchmark name
+ * @param unit what a single operation represents (e.g. a frame)
+ * @param iterations number of measured calls to @a function
+ * @param opsPerIteration number of operations performed by each call
+ * @param bytes number of bytes processed by each call
+ * @param function code to benchmark, receives the iteration number
+ */
+template<typename Function>
+void Misc::Benchmark::measure(const QString &name, const QString &unit,
+                              const int iterations, const int opsPerIteration,
+                              const qint64 bytes, Function function)
+{
+  measure(name, unit, iterations, opsPerIteration, bytes, function, [](int) {});
+}
+
+/**
+ * Same as above, but calls @a prepare before each call to @a function. The
+ * time & allocations of @a prepare are not registered.
+ */
+template<typename Function, typename Prepare>
+void Misc::Benchmark::measure(const QString &name, const QString &unit,
+                              const int iterations, const int opsPerIteration,
+                              const qint64 bytes, Function function,
+                              Prepare prepare)
+{
+  // Warm-up caches, lazy initializations & internal buffers
+  const auto warmup = qBound(1, iterations / 10, 100);
+  for (int i = 0; i < warmup; ++i)
+  {
+    prepare(i);
+    function(i);
+  }
+
+  // Prepare result (allocate memory before measuring)
+  Result result;
+  result.name = name;
+  result.unit = unit;
+  result.bytes = bytes * iterations;
+  result.operations = qint64(iterations) * opsPerIteration;
+  result.samples.resize(iterations);
+
+  // Run the benchmark
+  QElapsedTimer timer;
+  result.allocations = 0;
+  for (int i = 0; i < iterations; ++i)
+  {
+    prepare(warmup + i);
+
+    const auto allocations = ALLOCATIONS.load();
+    timer.start();
+    function(warmup + i);
+    result.samples[i] = timer.nsecsElapsed();
+    result.allocations += ALLOCATIONS.load() - allocations;
+  }
+
+  // Register results
+  result.elapsedNs = std::accumulate(result.samples.begin(),
+                                     result.samples.end(), qint64(0));
+  m_results.append(result);
+
+  // Log progress
+  const auto ns = double(result.elapsedNs) / result.operations;
+  const auto allocs = double(result.allocations) / result.operations;
+  qInfo().noquote() << QStringLiteral("%1 %2 ns/%3, %4 allocs/%3")
+                           .arg(name, -36)
+                           .arg(ns, 10, 'f', 1)
+                           .arg(unit)
+                           .arg(allocs, 0, 'f', 2);
+}
+
+/**
+ * Measures the CRC-8, CRC-16 & CRC-32 implementations with small, medium and
+ * large buffers.
+ */
+void Misc::Benchmark::benchmarkChecksums()
+{
+  for (const int size : {64, 1024, 65536})
+  {
+    QByteArray data(size, Qt::Uninitialized);
+    for (int i = 0; i < size; ++i)
+      data[i] = static_cast<char>(i * 31 + 7);
+
+    volatile quint32 sink = 0;
+    const auto iterations = qMax(100, int(qint64(m_frames) * 1024 / size));
+
+    auto name = QStringLiteral("checksum/crc8/%1B").arg(size);
+    if (enabled(name))
+      measure(name, "buffer", iterations, 1, size, [&](int) {
+        sink = sink + IO::crc8(data.constData(), data.size());
+      });
+
+    name = QStringLiteral("checksum/crc16/%1B").arg(size);
+    if (enabled(name))
+      measure(name, "buffer", iterations, 1, size, [&](int) {
+        sink = sink + IO::crc16(data.constData(), data.size());
+      });
+
+    name = QStringLiteral("checksum/crc32/%1B").arg(size);
+    if (enabled(name))
+      measure(name, "buffer", iterations, 1, size, [&](int) {
+        sink = sink + IO::crc32(data.constData(), data.size());
+      });
+  }
+}
+
+/**
+ * Measures the frame extraction code of the I/O manager with different frame
+ * delimiters, frame sizes and with/without checksums. Data is fed in chunks of
+ * approximately 4 KB, mimicking a fast serial port or network socket.
+ */
+void Misc::Benchmark::benchmarkFrameReader()
+{
+  struct Delimiters
+  {
+    const char *label;
+    const char *start;
+    const char *finish;
+    bool checksum;
+  };
+
+  // clang-format off
+  static const Delimiters delimiters[] = {
+    {"comment", "/*", "*/", false},
+    {"char", "$", ";", false},
+    {"tag", "<frame>", "</frame>\r\n", false},
+    {"crc16", "/*", "*/", true},
+  };
+  // clang-format on
+
+  auto &manager = IO::Manager::instance();
+  auto &synthetic = IO::Drivers::Synthetic::instance();
+  for (const auto &delimiter : delimiters)
+  {
+    for (const int channels : {4, 32, 256})
+    {
+      // Skip filtered benchmarks
+      const auto name = QStringLiteral("reader/%1/%2ch")
+                            .arg(delimiter.label)
+                            .arg(channels);
+      if (!enabled(name))
+        continue;
+
+      // Configure delimiters & reset the manager state
+      manager.setStartSequence(delimiter.start);
+      manager.setFinishSequence(delimiter.finish);
+      if (!reconnect())
+      {
+        verify(name, 1, 0);
+        continue;
+      }
+
+      // Build a ~4 KB chunk of complete frames
+      int frames = 0;
+      int sequence = 0;
+      QByteArray chunk;
+      const QByteArray start(delimiter.start);
+      const QByteArray finish(delimiter.finish);
+      while (chunk.size() < 4096)
+      {
+        const auto payload = csvFrame(channels, sequence++);
+        QByteArray frame = start + payload + finish;
+        if (delimiter.checksum)
+        {
+          // Avoid checksums that look like frame delimiters
+          const auto crc = IO::crc16(payload.constData(), payload.size());
+          const char a = static_cast<char>((crc >> 8) & 0xff);
+          const char b = static_cast<char>(crc & 0xff);
+          if (start.contains(a) || start.contains(b) || finish.contains(a)
+              || finish.contains(b))
+            continue;
+
+          frame.append("crc16:");
+          frame.append(a);
+          frame.append(b);
+        }
+
+        chunk.append(frame);
+        ++frames;
+      }
+
+      // Measure only the frame extraction
+      int calls = 0;
+      const auto valid = manager.validFrames();
+      const auto iterations = qMax(10, m_frames / frames);
+      manager.blockSignals(true);
+      measure(name, "frame", iterations, frames, chunk.size(), [&](int) {
+        ++calls;
+        Q_EMIT synthetic.dataReceived(chunk);
+      });
+      manager.blockSignals(false);
+
+      // Check that all frames were extracted
+      verify(name, quint64(calls) * frames, manager.validFrames() - valid);
+    }
+  }
+
+  // Restore default delimiters
+  manager.setStartSequence("/*");
+  manager.setFinishSequence("*/");
+}
+
+/**
+ * Measures the JSON generator in manual mode (CSV-like frames parsed by the
+ * project frame parser) and in automatic mode (device sends JSON frames).
+ */
+void Misc::Benchmark::benchmarkGenerator()
+{
+  auto &generator = JSON::Generator::instance();
+  const auto readData = slot(&generator, "readData(QByteArray)");
+
+  for (const int channels : {8, 64})
+  {
+    const auto csvName = QStringLiteral("generator/csv/%1ch").arg(channels);
+    const auto jsonName = QStringLiteral("generator/json/%1ch").arg(channels);
+    if (!enabled(csvName) && !enabled(jsonName))
+      continue;
+
+    // Load project & build frames
+    if (!loadProject(channels))
+    {
+      verify(csvName, 1, 0);
+      continue;
+    }
+
+    QVector<QByteArray> csvFrames;
+    QVector<QByteArray> jsonFrames;
+    for (int i = 0; i < 16; ++i)
+    {
+      csvFrames.append(csvFrame(channels, i));
+      jsonFrames.append(QJsonDocument(jsonFrame(channels, i))
+                            .toJson(QJsonDocument::Compact));
+    }
+
+    // Do not propagate the generated JSON frames to the dashboard
+    generator.blockSignals(true);
+
+    // Manual mode
+    generator.setOperationMode(JSON::Generator::kManual);
+    if (enabled(csvName))
+      measure(csvName, "frame", m_frames, 1, csvFrames.first().size(),
+              [&](int i) {
+                readData.invoke(&generator, Qt::DirectConnection,
+                                Q_ARG(QByteArray, csvFrames.at(i % 16)));
+              });
+
+    // Automatic mode
+    generator.setOperationMode(JSON::Generator::kAutomatic);
+    if (enabled(jsonName))
+      measure(jsonName, "frame", m_frames, 1, jsonFrames.first().size(),
+              [&](int i) {
+                readData.invoke(&generator, Qt::DirectConnection,
+                                Q_ARG(QByteArray, jsonFrames.at(i % 16)));
+              });
+
+    // Restore state
+    generator.setOperationMode(JSON::Generator::kManual);
+    generator.blockSignals(false);
+  }
+}
+
+/**
+ * Measures the evaluation of derived dataset expressions, frame by frame (as
+ * done by the JSON generator) and in batches (as done by the CSV export).
+ */
+void Misc::Benchmark::benchmarkExpressions()
+{
+  const int fields = 8;
+  const int batch = 256;
+  const QStringList sources = {"$4 * $5", "hypot($1, $2, $3)",
+                               "sqrt($1^2 + $2^2 + $3^2) * 9.81 / 1000",
+                               "atan2($2, $1) * 180 / pi + $6 % 360"};
+
+  // Build field values
+  QVector<double> values(batch * fields);
+  for (int i = 0; i < values.count(); ++i)
+    values[i] = std::sin(i * 0.1) * 100;
+
+  for (int i = 0; i < sources.count(); ++i)
+  {
+    const auto frameName = QStringLiteral("expression/frame/%1").arg(i);
+    const auto batchName = QStringLiteral("expression/batch/%1").arg(i);
+    if (!enabled(frameName) && !enabled(batchName))
+      continue;
+
+    JSON::Expression expression;
+    if (!expression.compile(sources.at(i)))
+    {
+      verify(frameName, 1, 0);
+      continue;
+    }
+
+    // One frame per evaluation
+    volatile double sink = 0;
+    if (enabled(frameName))
+      measure(frameName, "frame", m_frames, 1, fields * sizeof(double),
+              [&](int n) {
+                const auto frame = values.constData() + (n % batch) * fields;
+                sink = sink + expression.evaluate(frame, fields);
+              });
+
+    // A batch of frames per evaluation
+    QVector<double> results(batch);
+    if (enabled(batchName))
+      measure(batchName, "frame", qMax(1, m_frames / batch), batch,
+              batch * fields * sizeof(double), [&](int) {
+                expression.evaluate(values.constData(), fields, batch,
+                                    results.data());
+                sink = sink + results.at(batch - 1);
+              });
+  }
+}
+
+/**
+ * Measures the dataset filters, processing one sample of all the channels
+ * that share a filter chain at a time (as done by the JSON generator).
+ */
+void Misc::Benchmark::benchmarkFilters()
+{
+  const QStringList specs = {"lowpass(2, 100)", "fir(31, 5, 100)",
+                             "median(5)", "cic(8, 3)",
+                             "median(3) | lowpass(10, 100) | cic(4)"};
+
+  for (const int channels : {8, 64})
+  {
+    // Build input samples
+    QVector<double> input(16 * channels);
+    for (int i = 0; i < input.count(); ++i)
+      input[i] = std::sin(i * 0.37) * 100;
+
+    for (int i = 0; i < specs.count(); ++i)
+    {
+      const auto name = QStringLiteral("filter/%1/%2ch").arg(i).arg(channels);
+      if (!enabled(name))
+        continue;
+
+      DSP::FilterChain chain;
+      if (!chain.compile(specs.at(i), channels))
+      {
+        verify(name, 1, 0);
+        continue;
+      }
+
+      QVector<double> values(channels);
+      measure(name, "frame", m_frames, 1, channels * sizeof(double),
+              [&](int n) {
+                const auto frame = input.constData() + (n % 16) * channels;
+                std::copy_n(frame, channels, values.data());
+                chain.process(values.data());
+              });
+    }
+  }
+}
+
+/**
+ * Measures the conversion of a JSON frame to the internal frame model used by
+ * the dashboard.
+ */
+void Misc::Benchmark::benchmarkFrameModel()
+{
+  for (const int channels : {8, 64})
+  {
+    const auto name = QStringLiteral("model/frame/%1ch").arg(channels);
+    if (!enabled(name))
+      continue;
+
+    QVector<QJsonObject> objects;
+    for (int i = 0; i < 16; ++i)
+      objects.append(jsonFrame(channels, i));
+
+    int valid = 0;
+    int calls = 0;
+    JSON::Frame frame;
+    measure(name, "frame", m_frames, 1, 0, [&](int i) {
+      ++calls;
+      if (frame.read(objects.at(i % 16)))
+        ++valid;
+    });
+
+    verify(name, calls, valid);
+  }
+}
+
+/**
+ * Measures the dashboard update (widget lists & plot data) with the frames
+ * published by the JSON generator, and the plot data regeneration on its own.
+ */
+void Misc::Benchmark::benchmarkDashboard()
+{
+  auto &dashboard = UI::Dashboard::instance();
+  const auto updatePlots = slot(&dashboard, "updatePlots()");
+  const auto processFrame = slot(&dashboard, "processLatestFrame(JSON::Frame)");
+
+  for (const int channels : {8, 64})
+  {
+    const auto frameName = QStringLiteral("dashboard/frame/%1ch").arg(channels);
+    const auto plotName = QStringLiteral("dashboard/plots/%1ch").arg(channels);
+    if (!enabled(frameName) && !enabled(plotName))
+      continue;
+
+    QVector<JSON::Frame> frames(16);
+    for (int i = 0; i < frames.count(); ++i)
+      frames[i].read(jsonFrame(channels, i));
+
+    // Count dashboard updates
+    int calls = 0;
+    int updates = 0;
+    auto connection = QObject::connect(&dashboard, &UI::Dashboard::updated,
+                                       [&]() { ++updates; });
+
+    // Complete dashboard update
+    if (enabled(frameName))
+    {
+      measure(frameName, "frame", m_frames, 1, 0, [&](int i) {
+        ++calls;
+        processFrame.invoke(&dashboard, Qt::DirectConnection,
+                            Q_ARG(JSON::Frame, frames.at(i % 16)));
+      });
+
+      verify(frameName, calls, updates);
+    }
+
+    // Plot data only
+    if (enabled(plotName))
+    {
+      processFrame.invoke(&dashboard, Qt::DirectConnection,
+                          Q_ARG(JSON::Frame, frames.first()));
+      measure(plotName, "frame", m_frames, 1, 0, [&](int) {
+        updatePlots.invoke(&dashboard, Qt::DirectConnection);
+      });
+    }
+
+    QObject::disconnect(connection);
+  }
+}
+
+/**
+ * Measures the complete pipeline, from the moment that the driver receives a
+ * frame to the moment that the dashboard notifies the user interface. Each
+ * iteration feeds a single frame, so the per-iteration samples represent the
+ * ingest-to-dashboard latency.
+ */
+void Misc::Benchmark::benchmarkEndToEnd()
+{
+  auto &manager = IO::Manager::instance();
+  auto &dashboard = UI::Dashboard::instance();
+  auto &synthetic = IO::Drivers::Synthetic::instance();
+
+  for (const int channels : {8, 64})
+  {
+    const auto name = QStringLiteral("pipeline/%1ch").arg(channels);
+    if (!enabled(name))
+      continue;
+
+    // Load project & connect to the synthetic device
+    if (!loadProject(channels) || !reconnect())
+    {
+      verify(name, 1, 0);
+      continue;
+    }
+
+    // Build frames
+    QVector<QByteArray> chunks;
+    for (int i = 0; i < 16; ++i)
+      chunks.append("/*" + csvFrame(channels, i) + "*/");
+
+    // Count dashboard updates
+    int calls = 0;
+    int updates = 0;
+    auto connection = QObject::connect(&dashboard, &UI::Dashboard::updated,
+                                       [&]() { ++updates; });
+
+    // Run benchmark
+    measure(name, "frame", m_frames, 1, chunks.first().size(), [&](int i) {
+      ++calls;
+      Q_EMIT synthetic.dataReceived(chunks.at(i % 16));
+    });
+
+    QObject::disconnect(connection);
+    verify(name, calls, updates);
+  }
+
+  manager.disconnectDriver();
+}
+
+/**
+ * Measures CSV export (frames are written in batches, like the 1 Hz timer
+ * does in the application) and CSV playback of the exported file.
+ */
+void Misc::Benchmark::benchmarkCsv()
+{
+  const int channels = 16;
+  const auto exportName = QStringLiteral("csv/export/%1ch").arg(channels);
+  const auto openName = QStringLiteral("csv/open/%1ch").arg(channels);
+  const auto replayName = QStringLiteral("csv/replay/%1ch").arg(channels);
+  if (!enabled(exportName) && !enabled(openName) && !enabled(replayName))
+    return;
+
+  // Load project & connect to the synthetic device
+  auto &manager = IO::Manager::instance();
+  auto &synthetic = IO::Drivers::Synthetic::instance();
+  if (!loadProject(channels) || !reconnect())
+  {
+    verify(exportName, 1, 0);
+    return;
+  }
+
+  // Build frames & feed one of them, so that the dashboard has a valid frame
+  QVector<QByteArray> frames;
+  for (int i = 0; i < 16; ++i)
+    frames.append(csvFrame(channels, i));
+  Q_EMIT synthetic.dataReceived("/*" + frames.first() + "*/");
+
+  // Export frames
+  auto &csv = CSV::Export::instance();
+  const int batch = 100;
+  const auto writeValues = slot(&csv, "writeValues()");
+  const auto registerFrame = slot(&csv, "registerFrame(QByteArray)");
+  csv.setExportEnabled(true);
+  measure(exportName, "frame", qMax(1, m_frames / batch), batch,
+          frames.first().size() * batch, [&](int i) {
+            for (int j = 0; j < batch; ++j)
+            {
+              const auto &frame = frames.at((i * batch + j) % 16);
+              registerFrame.invoke(&csv, Qt::DirectConnection,
+                                   Q_ARG(QByteArray, frame));
+            }
+
+            writeValues.invoke(&csv, Qt::DirectConnection);
+          });
+  csv.closeFile();
+  csv.setExportEnabled(false);
+
+  // The player refuses to open files while a device is connected
+  manager.disconnectDriver();
+
+  // Find the exported file
+  QString path;
+  QDirIterator it(m_home.path(), {"*.csv"}, QDir::Files,
+                  QDirIterator::Subdirectories);
+  if (it.hasNext())
+    path = it.next();
+
+  // Open the file
+  auto &player = CSV::Player::instance();
+  if (path.isEmpty())
+  {
+    verify(openName, 1, 0);
+    return;
+  }
+
+  if (enabled(openName))
+    measure(openName, "file", 5, 1, QFileInfo(path).size(), [&](int) {
+      player.closeFile();
+      player.openFile(path);
+    });
+
+  else
+    player.openFile(path);
+
+  // Replay the file, restarting when the last frame is reached
+  if (!player.isOpen())
+  {
+    verify(replayName, 1, 0);
+    return;
+  }
+
+  if (enabled(replayName))
+    measure(replayName, "frame", m_frames, 1, 0, [&](int) {
+      if (player.framePosition() >= player.frameCount() - 1)
+        player.setProgress(0);
+
+      player.nextFrame();
+    });
+
+  player.closeFile();
+}
+
+/**
+ * Measures the time needed by each widget type to display a new frame (data
+ * update + rendering to a pixmap, as done by @c UI::DeclarativeWidget) with
+ * different widget sizes. Plot widgets are also measured with different
+ * numbers of points.
+ */
+void Misc::Benchmark::benchmarkWidgets()
+{
+  // clang-format off
+  static const QStringList types = {
+    "plot", "multiplot", "fft", "waterfall", "bar", "gauge", "compass",
+    "gyroscope", "accelerometer", "led", "group", "gps"
+  };
+  static const QSize sizes[] = {{320, 240}, {640, 480}, {1280, 720}};
+  // clang-format on
+
+  // Load the dashboard with a frame that uses every widget type
+  auto &dashboard = UI::Dashboard::instance();
+  const auto project = widgetProject();
+  const auto processFrame = slot(&dashboard, "processLatestFrame(JSON::Frame)");
+  QVector<JSON::Frame> frames(16);
+  for (int i = 0; i < frames.count(); ++i)
+    frames[i].read(jsonFrame(project, kWidgetChannels, i));
+
+  // Painting is expensive, use fewer frames than in the other benchmarks
+  const auto iterations = qMax(10, m_frames / 100);
+  const auto initialPoints = dashboard.points();
+  for (const auto &type : types)
+  {
+    // Only plots depend on the number of points & support the sweep mode
+    QVector<int> densities = {initialPoints};
+    QVector<bool> sweepModes = {false};
+    if (type == "plot" || type == "multiplot")
+    {
+      densities = {100, 1000, 10000};
+      sweepModes = {false, true};
+    }
+
+    for (const int points : densities)
+    {
+      // Fill the plot buffers
+      dashboard.setPoints(points);
+      for (int i = 0; i < points; ++i)
+        processFrame.invoke(&dashboard, Qt::DirectConnection,
+                            Q_ARG(JSON::Frame, frames.at(i % 16)));
+
+      for (const auto &size : sizes)
+      {
+        for (const bool sweep : sweepModes)
+        {
+          // Skip filtered benchmarks
+          auto name = QStringLiteral("widget/%1/%2x%3")
+                          .arg(type)
+                          .arg(size.width())
+                          .arg(size.height());
+          if (densities.count() > 1)
+            name.append(QStringLiteral("/%1pts").arg(points));
+          if (sweep)
+            name.append(QStringLiteral("/sweep"));
+          if (!enabled(name))
+            continue;
+
+          // Create the widget
+          dashboard.setSweepMode(sweep);
+          auto widget = createWidget(type);
+          if (!widget)
+          {
+            verify(name, 1, 0);
+            continue;
+          }
+
+          widget->setEnabled(true);
+          widget->setFixedSize(size);
+          const auto refresh = refreshSlot(widget);
+
+          // Update the dashboard (not measured), then update & paint it
+          dashboard.blockSignals(true);
+          measure(
+              name, "frame", iterations, 1, 0,
+              [&](int) {
+                refresh.invoke(widget, Qt::DirectConnection);
+                const auto pixmap = widget->grab();
+                Q_UNUSED(pixmap);
+              },
+              [&](int i) {
+                processFrame.invoke(&dashboard, Qt::DirectConnection,
+                                    Q_ARG(JSON::Frame, frames.at(i % 16)));
+              });
+          dashboard.blockSignals(false);
+
+          delete widget;
+        }
+      }
+    }
+  }
+
+  dashboard.setSweepMode(false);
+  dashboard.setPoints(initialPoints);
+}
+
+/**
+ * Measures the complete pipeline with the chunks of the raw data capture
+ * given with the "--replay" option. The frame sequences & project stored in
+ * the capture are used, and the chunks are fed with the same boundaries that
+ * the original device produced, so that real-world sessions can be used as
+ * repeatable benchmark inputs.
+ */
+void Misc::Benchmark::benchmarkReplay()
+{
+  if (m_replay.isEmpty())
+    return;
+
+  const auto base = QFileInfo(m_replay).completeBaseName();
+  const auto name = QStringLiteral("replay/%1").arg(base);
+  if (!enabled(name))
+    return;
+
+  // Read the capture
+  qint64 bytes = 0;
+  QJsonObject metadata;
+  QVector<QByteArray> chunks;
+  QFile file(m_replay);
+  if (file.open(QFile::ReadOnly) && IO::Recorder::readHeader(file, metadata))
+  {
+    qint64 time;
+    QByteArray chunk;
+    while (IO::Recorder::readChunk(file, time, chunk))
+    {
+      bytes += chunk.size();
+      chunks.append(chunk);
+    }
+  }
+
+  if (chunks.isEmpty())
+  {
+    qWarning() << "Cannot read raw data capture" << m_replay;
+    verify(name, 1, 0);
+    return;
+  }
+
+  // Apply the settings used while recording
+  auto &manager = IO::Manager::instance();
+  auto &generator = JSON::Generator::instance();
+  manager.setStartSequence(metadata.value("start").toString());
+  manager.setFinishSequence(metadata.value("finish").toString());
+  manager.setSeparatorSequence(metadata.value("separator").toString());
+
+  const auto project = metadata.value("project").toString();
+  const auto mode = metadata.value("operationMode").toInt();
+  generator.setOperationMode(static_cast<JSON::Generator::OperationMode>(mode));
+  if (mode == JSON::Generator::kManual && QFileInfo::exists(project))
+    generator.loadJsonMap(project);
+
+  // Connect to the synthetic device
+  if (!reconnect())
+  {
+    verify(name, 1, 0);
+    return;
+  }
+
+  // Run benchmark
+  auto &synthetic = IO::Drivers::Synthetic::instance();
+  const auto count = chunks.count();
+  measure(name, "chunk", count, 1, bytes / count, [&](int i) {
+    Q_EMIT synthetic.dataReceived(chunks.at(i % count));
+  });
+
+  manager.disconnectDriver();
+}
+
+/**
+ * Disconnects and re-connects the synthetic device, which resets the frame
+ * buffer & checksum state of the I/O manager.
+ */
+bool Misc::Benchmark::reconnect()
+{
+  auto &manager = IO::Manager::instance();
+  manager.disconnectDriver();
+  manager.connectDevice();
+  return manager.connected();
+}
+
+/**
+ * Writes a project file with the given number of @a channels (one plot per
+ * channel) and loads it in the JSON generator.
+ */
+bool Misc::Benchmark::loadProject(const int channels)
+{
+  const auto path = m_home.filePath(QStringLiteral("%1ch.json").arg(channels));
+
+  QFile file(path);
+  if (!file.open(QFile::WriteOnly | QFile::Truncate))
+    return false;
+
+  file.write(QJsonDocument(projectMap(channels)).toJson());
+  file.close();
+
+  auto &generator = JSON::Generator::instance();
+  generator.setOperationMode(JSON::Generator::kManual);
+  generator.loadJsonMap(path);
+  return generator.jsonMapFilepath() == path;
+}
+
+/**
+ * Registers a failure (and logs a warning) if the number of processed frames
+ * differs from the @a expected value.
+ */
+bool Misc::Benchmark::verify(const QString &name, const quint64 expected,
+                             const quint64 actual)
+{
+  if (expected == actual)
+    return true;
+
+  ++m_failures;
+  qWarning().noquote() << QStringLiteral("%1: expected %2 frames, got %3")
+                              .arg(name)
+                              .arg(expected)
+                              .arg(actual);
+  return false;
+}
+
+/**
+ * Returns a comma-separated frame (without delimiters) with the given number
+ * of @a channels.
+ */
+QByteArray Misc::Benchmark::csvFrame(const int channels,
+                                     const int sequence) const
+{
+  QByteArray frame;
+  frame.reserve(channels * 8);
+  for (int i = 0; i < channels; ++i)
+  {
+    if (i > 0)
+      frame.append(',');
+
+    const auto value = std::sin(0.1 * sequence + i) * (i + 1);
+    frame.append(QByteArray::number(value, 'f', 3));
+  }
+
+  return frame;
+}
+
+/**
+ * Returns a complete JSON frame (as sent by devices in automatic mode) with
+ * the given number of @a channels.
+ */
+QJsonObject Misc::Benchmark::jsonFrame(const int channels,
+                                       const int sequence) const
+{
+  return jsonFrame(projectMap(channels), channels, sequence);
+}
+
+/**
+ * Returns a copy of the given @a project with the values of its datasets
+ * (which must use indexes from 1 to @a channels) set.
+ */
+QJsonObject Misc::Benchmark::jsonFrame(const QJsonObject &project,
+                                       const int channels,
+                                       const int sequence) const
+{
+  auto json = project;
+  auto groups = json.value("groups").toArray();
+  auto values = csvFrame(channels, sequence).split(',');
+
+  for (int i = 0; i < groups.count(); ++i)
+  {
+    auto group = groups.at(i).toObject();
+    auto datasets = group.value("datasets").toArray();
+    for (int j = 0; j < datasets.count(); ++j)
+    {
+      auto dataset = datasets.at(j).toObject();
+      const auto index = dataset.value("index").toInt();
+      dataset.insert("value", QString::fromUtf8(values.at(index - 1)));
+      datasets.replace(j, dataset);
+    }
+
+    group.insert("datasets", datasets);
+    groups.replace(i, group);
+  }
+
+  json.insert("groups", groups);
+  return json;
+}
+
+/**
+ * Returns a project with the given number of @a channels, grouped in sets of
+ * eight datasets. Every dataset is plotted.
+ */
+QJsonObject Misc::Benchmark::projectMap(const int channels) const
+{
+  QJsonArray groups;
+  for (int g = 0; g * 8 < channels; ++g)
+  {
+    QJsonArray datasets;
+    for (int i = g * 8; i < qMin(channels, (g + 1) * 8); ++i)
+    {
+      QJsonObject dataset;
+      dataset.insert("led", false);
+      dataset.insert("fft", false);
+      dataset.insert("log", false);
+      dataset.insert("graph", true);
+      dataset.insert("widget", "");
+      dataset.insert("units", "V");
+      dataset.insert("min", 0);
+      dataset.insert("max", 0);
+      dataset.insert("alarm", 0);
+      dataset.insert("fftSamples", 1024);
+      dataset.insert("index", i + 1);
+      dataset.insert("value", "");
+      dataset.insert("title", QStringLiteral("Channel %1").arg(i + 1));
+      datasets.append(dataset);
+    }
+
+    QJsonObject group;
+    group.insert("widget", "");
+    group.insert("datasets", datasets);
+    group.insert("title", QStringLiteral("Group %1").arg(g + 1));
+    groups.append(group);
+  }
+
+  QJsonObject json;
+  json.insert("title", "Benchmark");
+  json.insert("separator", ",");
+  json.insert("frameStart", "/*");
+  json.insert("frameEnd", "*/");
+  json.insert("frameParser", "");
+  json.insert("groups", groups);
+  return json;
+}
+
+/**
+ * Returns a project that uses every widget type supported by the dashboard,
+ * with @c kWidgetChannels datasets.
+ */
+QJsonObject Misc::Benchmark::widgetProject() const
+{
+  // clang-format off
+  static const struct
+  {
+    const char *group;
+    const char *widget;
+    QStringList datasets;
+  } layout[] = {
+    {"Signals", "multiplot", {"gauge", "bar", "compass", ""}},
+    {"Attitude", "gyro", {"pitch", "roll", "yaw"}},
+    {"Acceleration", "accelerometer", {"x", "y", "z"}},
+    {"Position", "map", {"lat", "lon", "alt"}},
+    {"Status", "", {"", "", "", "", "", "", "", ""}},
+  };
+  // clang-format on
+
+  int index = 0;
+  QJsonArray groups;
+  for (const auto &entry : layout)
+  {
+    QJsonArray datasets;
+    for (const auto &widget : entry.datasets)
+    {
+      ++index;
+      QJsonObject dataset;
+      dataset.insert("led", index == 4 || index > 13);
+      dataset.insert("fft", index == 1);
+      dataset.insert("waterfall", index == 1);
+      dataset.insert("log", false);
+      dataset.insert("graph", index <= 4);
+      dataset.insert("widget", widget);
+      dataset.insert("units", "V");
+      dataset.insert("min", -10);
+      dataset.insert("max", 10);
+      dataset.insert("alarm", 0);
+      dataset.insert("fftSamples", 1024);
+      dataset.insert("index", index);
+      dataset.insert("value", "");
+      dataset.insert("title", QStringLiteral("Channel %1").arg(index));
+      datasets.append(dataset);
+    }
+
+    QJsonObject group;
+    group.insert("title", entry.group);
+    group.insert("widget", entry.widget);
+    group.insert("datasets", datasets);
+    groups.append(group);
+  }
+
+  Q_ASSERT(index == kWidgetChannels);
+
+  QJsonObject json;
+  json.insert("title", "Widget benchmark");
+  json.insert("separator", ",");
+  json.insert("frameStart", "/*");
+  json.insert("frameEnd", "*/");
+  json.insert("frameParser", "");
+  json.insert("groups", groups);
+  return json;
+}
+
+/**
+ * Writes the benchmark results in JSON format to the output file, or to the
+ * standard output if no file was specified.
+ */
+bool Misc::Benchmark::writeResults() const
+{
+  QJsonArray results;
+  for (const auto &result : m_results)
+  {
+    const auto ops = double(result.operations);
+
+    QJsonObject object;
+    object.insert("name", result.name);
+    object.insert("unit", result.unit);
+    object.insert("operations", result.operations);
+    object.insert("ns_per_op", result.elapsedNs / ops);
+    object.insert("allocs_per_op", result.allocations / ops);
+
+    // Percentiles only make sense if each sample is a single operation
+    if (result.operations == result.samples.count())
+    {
+      auto samples = result.samples;
+      std::sort(samples.begin(), samples.end());
+      object.insert("p50_ns", percentile(samples, 0.50));
+      object.insert("p99_ns", percentile(samples, 0.99));
+    }
+
+    else
+    {
+      object.insert("p50_ns", QJsonValue::Null);
+      object.insert("p99_ns", QJsonValue::Null);
+    }
+
+    // Throughput
+    if (result.bytes > 0 && result.elapsedNs > 0)
+      object.insert("mb_per_s", result.bytes * 1e3 / result.elapsedNs);
+
+    results.append(object);
+  }
+
+  QJsonObject json;
+  json.insert("application", APP_NAME);
+  json.insert("version", APP_VERSION);
+  json.insert("qt", qVersion());
+  json.insert("os", QSysInfo::prettyProductName());
+  json.insert("cpu", QSysInfo::currentCpuArchitecture());
+  json.insert("allocations", ALLOCATION_SOURCE);
+  json.insert("frames", m_frames);
+  json.insert("failures", m_failures);
+  json.insert("results", results);
+
+  QFile file;
+  if (m_output.isEmpty())
+  {
+    if (!file.open(stdout, QFile::WriteOnly))
+      return false;
+  }
+
+  else
+  {
+    file.setFileName(m_output);
+    if (!file.open(QFile::WriteOnly | QFile::Truncate))
+    {
+      qCritical() << "Cannot write benchmark results to" << m_output;
+      return false;
+    }
+  }
+
+  file.write(QJsonDocument(json).toJson());
+  file.close();
+  return true;
+}
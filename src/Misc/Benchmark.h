@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <QVector>
+#include <QJsonObject>
+#include <QStringList>
+#include <QTemporaryDir>
+
+namespace Misc
+{
+/**
+ * @brief The Benchmark class
+ *
+ * Measures the throughput and latency of the data pipeline (checksums, frame
+ * extraction, JSON generation, derived dataset expressions, dataset filters,
+ * dashboard model updates and CSV export/replay) with synthetic workloads.
+ * Each benchmark reports the time per operation, heap allocations per
+ * operation and, when every iteration processes a single frame, the p50/p99
+ * ingest-to-dashboard latency.
+ *
+ * Dashboard widgets are also measured: every widget type is rendered
+ * offscreen at several sizes (and plots with several numbers of points), so
+ * that the cost of each widget can be compared with the dashboard paint
+ * budget.
+ *
+ * A raw data capture (recorded with the @c IO::Recorder class) can be given
+ * with the "--replay" option to measure the pipeline with real-world data.
+ *
+ * Results are written in JSON format, so that they can be compared between
+ * builds by CI scripts. This class is only compiled when building with
+ * `CONFIG+=benchmark`, run `make benchmark` to execute it.
+ */
+class Benchmark
+{
+public:
+  Benchmark();
+
+  static bool requested(int argc, char **argv);
+  int run(const QStringList &arguments);
+
+private:
+  static constexpr int kWidgetChannels = 21;
+
+  struct Result
+  {
+    QString name;
+    QString unit;
+    qint64 bytes;
+    qint64 operations;
+    qint64 elapsedNs;
+    qint64 allocations;
+    QVector<qint64> samples;
+  };
+
+  bool enabled(const QString &name) const;
+
+  template<typename Function>
+  void measure(const QString &name, const QString &unit, const int iterations,
+               const int opsPerIteration, const qint64 bytes,
+               Function function);
+  template<typename Function, typename Prepare>
+  void measure(const QString &name, const QString &unit, const int iterations,
+               const int opsPerIteration, const qint64 bytes,
+               Function function, Prepare prepare);
+
+  void benchmarkChecksums();
+  void benchmarkFrameReader();
+  void benchmarkGenerator();
+  void benchmarkExpressions();
+  void benchmarkFilters();
+  void benchmarkFrameModel();
+  void benchmarkDashboard();
+  void benchmarkEndToEnd();
+  void benchmarkCsv();
+  void benchmarkWidgets();
+  void benchmarkReplay();
+
+  bool reconnect();
+  bool loadProject(const int channels);
+  bool verify(const QString &name, const quint64 expected,
+              const quint64 actual);
+
+  QByteArray csvFrame(const int channels, const int sequence) const;
+  QJsonObject jsonFrame(const int channels, const int sequence) const;
+  QJsonObject jsonFrame(const QJsonObject &project, const int channels,
+                        const int sequence) const;
+  QJsonObject projectMap(const int channels) const;
+  QJsonObject widgetProject() const;
+
+  bool writeResults() const;
+
+private:
+  int m_frames;
+  int m_failures;
+  QString m_filter;
+  QString m_output;
+  QString m_replay;
+  QTemporaryDir m_home;
+  QVector<Result> m_results;
+};
+} // namespace Misc
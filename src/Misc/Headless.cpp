@@ -0,0 +1,671 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <AppInfo.h>
+
+#include <CSV/Export.h>
+#include <JSON/Generator.h>
+#include <MQTT/Client.h>
+#include <Plugins/Server.h>
+#include <Plugins/SharedMemory.h>
+#include <Plugins/MetricsServer.h>
+#include <Project/Model.h>
+#include <Project/FrameParser.h>
+
+#include <IO/Manager.h>
+#include <IO/Trigger.h>
+#include <IO/Recorder.h>
+#include <IO/Drivers/Pipe.h>
+#include <IO/Drivers/Serial.h>
+#include <IO/Drivers/Replay.h>
+#include <IO/Drivers/Network.h>
+#include <IO/Drivers/Synthetic.h>
+
+#include <Misc/Alarms.h>
+#include <Misc/Headless.h>
+#include <Misc/TimerEvents.h>
+#include <Misc/Instrumentation.h>
+
+#include <QDebug>
+#include <QFileInfo>
+#include <QCoreApplication>
+
+#include <csignal>
+#include <cstring>
+
+/**
+ * Set when the user presses Ctrl+C or when the process is terminated. Qt
+ * functions cannot be called from a signal handler, so the flag is polled
+ * from the event loop (see @c Misc::Headless::checkSignals()).
+ */
+static volatile std::sig_atomic_t s_quitRequested = 0;
+
+/**
+ * Requests the event loop to stop after a termination signal
+ */
+static void handleSignal(int signal)
+{
+  Q_UNUSED(signal);
+  s_quitRequested = 1;
+}
+
+/**
+ * Constructor function, registers the command line options of the headless
+ * mode.
+ */
+Misc::Headless::Headless()
+  : m_bytes(0)
+  , m_frames(0)
+  , m_lastBytes(0)
+  , m_lastFrames(0)
+  , m_lastStatsTime(0)
+{
+  // clang-format off
+  m_parser.setApplicationDescription(QStringLiteral("%1 headless mode").arg(APP_NAME));
+  m_parser.addHelpOption();
+  m_parser.addOptions({
+    {"headless", "Run without a graphical user interface."},
+    {"config", "Read options from the given INI file.", "file"},
+    {"project", "Project file used to parse incoming frames.", "file"},
+    {"driver", "Data source: serial, tcp, udp, tcp-server, synthetic, replay or pipe.", "name"},
+    {"port", "Serial port name (e.g. ttyUSB0 or COM3).", "name"},
+    {"baud", "Serial port baud rate.", "rate"},
+    {"auto-reconnect", "Reconnect to the serial port when it is plugged back."},
+    {"low-latency", "Enable the low-latency mode of the serial port."},
+    {"host", "Remote address for TCP/UDP sockets.", "address"},
+    {"tcp-port", "Remote TCP port (or listening port in server mode).", "port"},
+    {"bind", "Local address of the TCP server (all interfaces by default).", "address"},
+    {"udp-local-port", "Local UDP port.", "port"},
+    {"udp-remote-port", "Remote UDP port.", "port"},
+    {"synthetic-rate", "Frames per second generated by the synthetic driver.", "hz"},
+    {"synthetic-channels", "Channels generated when no project is loaded.", "count"},
+    {"synthetic-full-speed", "Generate synthetic frames as fast as possible."},
+    {"pipe", "FIFO, PTY, file or fd:N read by the pipe driver (stdin by default).", "path"},
+    {"replay-file", "Raw data capture replayed by the replay driver.", "file"},
+    {"replay-speed", "Replay speed factor, or \"max\" to replay as fast as possible.", "factor"},
+    {"replay-loop", "Replay the capture in a loop instead of exiting at its end."},
+    {"start", "Frame start sequence.", "sequence"},
+    {"finish", "Frame finish sequence.", "sequence"},
+    {"separator", "Data separator sequence.", "sequence"},
+    {"csv", "Export received frames to CSV files."},
+    {"record", "Record the raw received data for later replay."},
+    {"plugins", "Enable the plugin server (TCP port 7777)."},
+    {"metrics-port", "Serve Prometheus metrics on the given localhost port.", "port"},
+    {"shm", "Export frames to the shared-memory ring with the given name.", "name"},
+    {"shm-capacity", "Number of records of the shared-memory ring.", "count"},
+    {"mqtt-host", "Publish (or subscribe) to the given MQTT broker.", "address"},
+    {"mqtt-port", "MQTT broker port.", "port"},
+    {"mqtt-topic", "MQTT topic.", "topic"},
+    {"mqtt-user", "MQTT username.", "name"},
+    {"mqtt-password", "MQTT password.", "password"},
+    {"mqtt-subscribe", "Subscribe to the MQTT topic instead of publishing."},
+    {"stats-interval", "Seconds between statistics log entries (0 disables).", "seconds"},
+    {"profile-startup", "Print the startup timeline and the time to first frame."},
+    {"instrumentation", "Collect pipeline statistics and log them with the stats."},
+    {"trace", "Capture pipeline events and write a Chrome trace file on exit.", "file"},
+    {"trigger", "Capture events: rising, falling, edge, above, below or pattern.", "condition"},
+    {"trigger-mode", "Trigger mode: single, normal (default) or auto.", "mode"},
+    {"trigger-source", "Dataset compared with the trigger level (1 = first).", "number"},
+    {"trigger-level", "Trigger level.", "value"},
+    {"trigger-pattern", "Byte pattern that fires the trigger (e.g. ERROR\\n).", "pattern"},
+    {"trigger-pre", "Milliseconds captured before the trigger fires.", "ms"},
+    {"trigger-post", "Milliseconds captured after the trigger fires.", "ms"},
+  });
+
+  connect(&m_statsTimer, &QTimer::timeout,
+          this, &Misc::Headless::logStatistics);
+  // clang-format on
+}
+
+/**
+ * Returns @c true if the "--headless" option is present in the given command
+ * line arguments. This is checked before creating the application object,
+ * since the headless mode does not need a @c QApplication.
+ */
+bool Misc::Headless::requested(int argc, char **argv)
+{
+  for (int i = 1; i < argc; ++i)
+  {
+    if (std::strcmp(argv[i], "--headless") == 0)
+      return true;
+  }
+
+  return false;
+}
+
+/**
+ * Returns @c true if the "--help" option was given, in which case @c start()
+ * prints the help text & returns @c false without starting.
+ */
+bool Misc::Headless::helpRequested() const
+{
+  return m_parser.isSet("help");
+}
+
+/**
+ * Parses the given command line @a arguments, initializes the required
+ * modules and connects to the data source. Returns @c false if the
+ * configuration is invalid, if the device cannot be opened or if the help
+ * text was requested.
+ */
+bool Misc::Headless::start(const QStringList &arguments)
+{
+  // Parse command line
+  if (!m_parser.parse(arguments))
+  {
+    qCritical().noquote() << m_parser.errorText();
+    return false;
+  }
+
+  // Show help
+  if (m_parser.isSet("help"))
+  {
+    qInfo().noquote() << m_parser.helpText();
+    return false;
+  }
+
+  // Load configuration file
+  if (m_parser.isSet("config"))
+  {
+    const auto path = m_parser.value("config");
+    if (!QFileInfo::exists(path))
+    {
+      qCritical() << "Configuration file" << path << "does not exist";
+      return false;
+    }
+
+    m_config.reset(new QSettings(path, QSettings::IniFormat));
+  }
+
+  // Initialize data processing modules (order matters, the frame parser must
+  // exist before the project is loaded)
+  (void)Project::FrameParser::instance();
+  (void)JSON::Generator::instance();
+  (void)Misc::Alarms::instance();
+  (void)IO::Recorder::instance();
+
+  // Load project, configure modules & data source
+  if (!loadProject() || !configureDriver())
+    return false;
+
+  configureModules();
+
+  // Count received data
+  auto manager = &IO::Manager::instance();
+  connect(manager, &IO::Manager::frameReceived, this,
+          &Misc::Headless::onFrameReceived);
+  connect(manager, &IO::Manager::dataReceived, this,
+          &Misc::Headless::onDataReceived);
+
+  // Log alarm transitions
+  connect(&Misc::Alarms::instance(), &Misc::Alarms::eventLogged, this,
+          &Misc::Headless::onAlarmEvent);
+
+  // Close files & connections before exiting
+  auto app = QCoreApplication::instance();
+  connect(app, &QCoreApplication::aboutToQuit, this, &Misc::Headless::shutdown);
+  connect(&Misc::TimerEvents::instance(), &Misc::TimerEvents::timeout10Hz,
+          this, &Misc::Headless::checkSignals);
+  std::signal(SIGINT, handleSignal);
+  std::signal(SIGTERM, handleSignal);
+
+  // Start common event timers (used by CSV export & MQTT)
+  Misc::TimerEvents::instance().startTimers();
+
+  // Connect to the device
+  manager->connectDevice();
+  if (!manager->connected())
+  {
+    qCritical() << "Cannot connect to" << value("driver") << "device";
+    return false;
+  }
+
+  // Start statistics log
+  bool ok;
+  auto interval = value("stats-interval").toInt(&ok);
+  if (!ok)
+    interval = 10;
+
+  m_clock.start();
+  if (interval > 0)
+    m_statsTimer.start(interval * 1000);
+
+  // Log configuration
+  qInfo() << APP_NAME << APP_VERSION << "running in headless mode";
+  return true;
+}
+
+/**
+ * Stops the event loop if a termination signal was received, so that output
+ * files are flushed & closed properly.
+ */
+void Misc::Headless::checkSignals()
+{
+  if (s_quitRequested)
+    QCoreApplication::quit();
+}
+
+/**
+ * Disconnects from the device, which flushes & closes the CSV file, and
+ * disconnects from the MQTT broker.
+ */
+void Misc::Headless::shutdown()
+{
+  m_statsTimer.stop();
+  logStatistics();
+
+  IO::Manager::instance().disconnectDriver();
+  if (MQTT::Client::instance().isConnectedToHost())
+    MQTT::Client::instance().disconnectFromHost();
+
+  // Write trace file
+  const auto trace = value("trace");
+  if (!trace.isEmpty())
+  {
+    auto instrumentation = &Misc::Instrumentation::instance();
+    instrumentation->stopCapture();
+    if (instrumentation->exportTrace(trace))
+      qInfo() << "Pipeline trace written to" << trace;
+  }
+}
+
+/**
+ * Logs the number of frames & bytes received since the last log entry
+ */
+void Misc::Headless::logStatistics()
+{
+  // Calculate rates
+  const auto now = m_clock.elapsed();
+  const auto elapsed = qMax<qint64>(1, now - m_lastStatsTime) / 1000.0;
+  const auto frameRate = (m_frames - m_lastFrames) / elapsed;
+  const auto byteRate = (m_bytes - m_lastBytes) / elapsed;
+
+  // Log statistics
+  auto csv = CSV::Export::instance().isOpen() ? "open" : "closed";
+  auto mqtt = MQTT::Client::instance().isConnectedToHost() ? "connected"
+                                                             : "disconnected";
+  qInfo().noquote() << QStringLiteral("frames: %1 (%2/s), bytes: %3 (%4 KiB/s)"
+                                      ", csv: %5, mqtt: %6")
+                           .arg(m_frames)
+                           .arg(frameRate, 0, 'f', 1)
+                           .arg(m_bytes)
+                           .arg(byteRate / 1024, 0, 'f', 1)
+                           .arg(csv, mqtt);
+
+  // Log pipeline statistics
+  if (Misc::Instrumentation::enabled())
+  {
+    auto instrumentation = &Misc::Instrumentation::instance();
+    for (int i = 0; i < Misc::Instrumentation::StageCount; ++i)
+    {
+      const auto stage = static_cast<Misc::Instrumentation::Stage>(i);
+      const auto count = instrumentation->count(stage);
+      if (count == 0)
+        continue;
+
+      qInfo().noquote() << QStringLiteral("  %1: %2 calls, mean %3 us, "
+                                          "p99 %4 us, max %5 us")
+                               .arg(Misc::Instrumentation::stageName(stage))
+                               .arg(count)
+                               .arg(instrumentation->totalTime(stage) / 1e3
+                                        / count,
+                                    0, 'f', 1)
+                               .arg(instrumentation->percentile(stage, 0.99)
+                                        / 1e3,
+                                    0, 'f', 1)
+                               .arg(instrumentation->maxTime(stage) / 1e3, 0,
+                                    'f', 1);
+    }
+  }
+
+  // Update last values
+  m_lastStatsTime = now;
+  m_lastBytes = m_bytes;
+  m_lastFrames = m_frames;
+}
+
+/**
+ * Increments the received frame counter
+ */
+void Misc::Headless::onFrameReceived()
+{
+  ++m_frames;
+}
+
+/**
+ * Increments the received bytes counter
+ */
+void Misc::Headless::onDataReceived(const QByteArray &data)
+{
+  m_bytes += data.size();
+}
+
+/**
+ * Logs the given alarm @a event
+ */
+void Misc::Headless::onAlarmEvent(const QJsonObject &event)
+{
+  const auto active = event.value("active").toBool();
+  qInfo().noquote() << QStringLiteral("alarm %1: %2/%3 (%4), value: %5, "
+                                      "limit: %6")
+                           .arg(active ? "raised" : "cleared",
+                                event.value("group").toString(),
+                                event.value("dataset").toString(),
+                                event.value("condition").toString())
+                           .arg(event.value("value").toDouble())
+                           .arg(event.value("limit").toDouble());
+}
+
+/**
+ * Loads the project file (if any) and applies the frame sequence overrides.
+ * Without a project file, the device is expected to send JSON frames.
+ */
+bool Misc::Headless::loadProject()
+{
+  // Load project file
+  const auto project = value("project");
+  if (!project.isEmpty())
+  {
+    if (!QFileInfo::exists(project))
+    {
+      qCritical() << "Project file" << project << "does not exist";
+      return false;
+    }
+
+    Project::Model::instance().openJsonFile(project);
+    if (Project::Model::instance().jsonFilePath() != project)
+    {
+      qCritical() << "Cannot load project file" << project;
+      return false;
+    }
+  }
+
+  // No project, device sends JSON data
+  else
+    JSON::Generator::instance().setOperationMode(JSON::Generator::kAutomatic);
+
+  // Frame sequence overrides
+  auto manager = &IO::Manager::instance();
+  if (!value("start").isEmpty())
+    manager->setStartSequence(value("start"));
+  if (!value("finish").isEmpty())
+    manager->setFinishSequence(value("finish"));
+  if (!value("separator").isEmpty())
+    manager->setSeparatorSequence(value("separator"));
+
+  return true;
+}
+
+/**
+ * Selects & configures the I/O driver given by the "driver" option
+ */
+bool Misc::Headless::configureDriver()
+{
+  auto manager = &IO::Manager::instance();
+  auto driver = value("driver").toLower();
+
+  // Read the standard input when data is piped into the application
+  if (driver.isEmpty() && IO::Drivers::Pipe::stdinRedirected())
+  {
+    driver = "pipe";
+    qInfo() << "No driver selected, reading the standard input";
+  }
+
+  // Serial port
+  if (driver == "serial")
+  {
+    auto serial = &IO::Drivers::Serial::instance();
+    manager->setSelectedDriver(IO::Manager::SelectedDriver::Serial);
+    if (!serial->setPortName(value("port")))
+    {
+      qCritical() << "Serial port" << value("port") << "not found";
+      return false;
+    }
+
+    if (!value("baud").isEmpty())
+      serial->setBaudRate(value("baud").toInt());
+
+    serial->setLowLatency(flag("low-latency"));
+    serial->setAutoReconnect(flag("auto-reconnect"));
+  }
+
+  // Network sockets
+  else if (driver == "tcp" || driver == "udp" || driver == "tcp-server")
+  {
+    auto network = &IO::Drivers::Network::instance();
+    manager->setSelectedDriver(IO::Manager::SelectedDriver::Network);
+
+    if (driver == "tcp")
+      network->setTcpSocket();
+    else if (driver == "udp")
+      network->setUdpSocket();
+    else
+      network->setTcpServer();
+
+    if (!value("host").isEmpty())
+      network->setRemoteAddress(value("host"));
+    if (!value("bind").isEmpty())
+      network->setTcpServerAddress(value("bind"));
+    if (!value("tcp-port").isEmpty())
+      network->setTcpPort(value("tcp-port").toUShort());
+    if (!value("udp-local-port").isEmpty())
+      network->setUdpLocalPort(value("udp-local-port").toUShort());
+    if (!value("udp-remote-port").isEmpty())
+      network->setUdpRemotePort(value("udp-remote-port").toUShort());
+  }
+
+  // Synthetic data generator
+  else if (driver == "synthetic")
+  {
+    auto synthetic = &IO::Drivers::Synthetic::instance();
+    manager->setSelectedDriver(IO::Manager::SelectedDriver::Synthetic);
+
+    if (!value("synthetic-rate").isEmpty())
+      synthetic->setFrameRate(value("synthetic-rate").toInt());
+    if (!value("synthetic-channels").isEmpty())
+      synthetic->setChannels(value("synthetic-channels").toInt());
+
+    synthetic->setFullSpeed(flag("synthetic-full-speed"));
+  }
+
+  // Raw data capture replay, exit when the end of the capture is reached
+  else if (driver == "replay")
+  {
+    auto replay = &IO::Drivers::Replay::instance();
+    manager->setSelectedDriver(IO::Manager::SelectedDriver::Replay);
+
+    const auto speed = value("replay-speed").toLower();
+    replay->setFilePath(value("replay-file"));
+    replay->setLoop(flag("replay-loop"));
+    replay->setFullSpeed(speed == "max");
+    if (!speed.isEmpty() && speed != "max")
+      replay->setSpeed(speed.toDouble());
+
+    connect(replay, &IO::Drivers::Replay::finished, this, [] {
+      qInfo() << "End of raw data capture reached";
+      QCoreApplication::quit();
+    });
+  }
+
+  // Pipe, PTY or standard input, exit when the producer closes the pipe
+  else if (driver == "pipe")
+  {
+    auto pipe = &IO::Drivers::Pipe::instance();
+    manager->setSelectedDriver(IO::Manager::SelectedDriver::Pipe);
+    pipe->setPath(value("pipe"));
+
+    connect(pipe, &IO::Drivers::Pipe::finished, this, [] {
+      qInfo() << "End of input data reached";
+      QCoreApplication::quit();
+    });
+  }
+
+  // Invalid driver
+  else
+  {
+    qCritical() << "Invalid or missing driver, use --driver with one of:"
+                << "serial, tcp, udp, tcp-server, synthetic, replay, pipe";
+    return false;
+  }
+
+  // Validate driver configuration
+  if (!manager->configurationOk())
+  {
+    qCritical() << "Invalid configuration for" << driver << "driver";
+    return false;
+  }
+
+  return true;
+}
+
+/**
+ * Enables CSV export, the plugin server and the MQTT client according to the
+ * given options.
+ */
+void Misc::Headless::configureModules()
+{
+  // CSV export
+  CSV::Export::instance().setExportEnabled(flag("csv"));
+
+  // Raw data recording
+  auto recorder = &IO::Recorder::instance();
+  connect(recorder, &IO::Recorder::openChanged, this, [recorder] {
+    if (recorder->isOpen())
+      qInfo() << "Recording raw data to" << recorder->fileName();
+  });
+  recorder->setEnabled(flag("record"));
+
+  // Plugin server
+  Plugins::Server::instance().setEnabled(flag("plugins"));
+
+  // Prometheus metrics endpoint
+  const auto metricsPort = value("metrics-port").toUShort();
+  if (metricsPort > 0)
+  {
+    Plugins::MetricsServer::instance().setPort(metricsPort);
+    Plugins::MetricsServer::instance().setEnabled(true);
+  }
+
+  // Shared-memory output
+  const auto shmName = value("shm");
+  if (!shmName.isEmpty())
+  {
+    auto shm = &Plugins::SharedMemory::instance();
+    shm->setName(shmName);
+    if (!value("shm-capacity").isEmpty())
+      shm->setCapacity(value("shm-capacity").toInt());
+
+    shm->setEnabled(true);
+  }
+
+  // Pipeline instrumentation & trace capture
+  Misc::Instrumentation::instance().setEnabled(flag("instrumentation"));
+  if (!value("trace").isEmpty())
+    Misc::Instrumentation::instance().startCapture();
+
+  // MQTT client
+  const auto mqttHost = value("mqtt-host");
+  if (!mqttHost.isEmpty())
+  {
+    auto mqtt = &MQTT::Client::instance();
+    mqtt->setHost(mqttHost);
+    mqtt->setClientMode(flag("mqtt-subscribe") ? MQTT::ClientSubscriber
+                                               : MQTT::ClientPublisher);
+
+    if (!value("mqtt-port").isEmpty())
+      mqtt->setPort(value("mqtt-port").toUShort());
+    if (!value("mqtt-topic").isEmpty())
+      mqtt->setTopic(value("mqtt-topic"));
+    if (!value("mqtt-user").isEmpty())
+      mqtt->setUsername(value("mqtt-user"));
+    if (!value("mqtt-password").isEmpty())
+      mqtt->setPassword(value("mqtt-password"));
+
+    mqtt->connectToHost();
+  }
+
+  // Trigger capture
+  const auto condition = value("trigger");
+  if (!condition.isEmpty())
+  {
+    const StringList modes{"single", "normal", "auto"};
+    const StringList conditions{"rising", "falling", "edge",
+                                "above", "below", "pattern"};
+
+    auto trigger = &IO::Trigger::instance();
+    const auto mode = value("trigger-mode");
+    const auto conditionId = conditions.indexOf(condition);
+    const auto modeId = mode.isEmpty() ? IO::Trigger::Normal
+                                       : modes.indexOf(mode);
+    if (conditionId < 0 || modeId < 0)
+    {
+      qWarning() << "Invalid trigger configuration, trigger disabled";
+      return;
+    }
+
+    trigger->setMode(modeId);
+    trigger->setCondition(conditionId);
+    trigger->setPattern(value("trigger-pattern"));
+    trigger->setLevel(value("trigger-level").toDouble());
+    trigger->setSource(value("trigger-source").toInt() - 1);
+    if (!value("trigger-pre").isEmpty())
+      trigger->setPreTrigger(value("trigger-pre").toInt());
+    if (!value("trigger-post").isEmpty())
+      trigger->setPostTrigger(value("trigger-post").toInt());
+
+    connect(trigger, &IO::Trigger::captured, this, [](const QString &path) {
+      qInfo() << "Trigger capture written to" << path;
+    });
+
+    trigger->arm();
+  }
+}
+
+/**
+ * Returns @c true if the given boolean option is set in the command line or
+ * in the configuration file.
+ */
+bool Misc::Headless::flag(const QString &name) const
+{
+  if (m_parser.isSet(name))
+    return true;
+
+  if (m_config)
+    return m_config->value(name, false).toBool();
+
+  return false;
+}
+
+/**
+ * Returns the value of the given option, the command line takes precedence
+ * over the configuration file.
+ */
+QString Misc::Headless::value(const QString &name) const
+{
+  if (m_parser.isSet(name))
+    return m_parser.value(name);
+
+  if (m_config)
+    return m_config->value(name).toString();
+
+  return QString();
+}
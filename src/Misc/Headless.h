@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <QTimer>
+#include <QObject>
+#include <QSettings>
+#include <QJsonObject>
+#include <QElapsedTimer>
+#include <QCommandLineParser>
+
+namespace Misc
+{
+/**
+ * @brief The Headless class
+ *
+ * Runs Serial Studio without a graphical user interface. In this mode, only
+ * the modules required to receive, parse, export and forward data are
+ * initialized: the I/O manager & drivers, the JSON generator, CSV export,
+ * the MQTT client and the plugin server. No QML, Qwt or widget code is
+ * loaded.
+ *
+ * The data source and the modules are configured from the command line or
+ * from an INI file (using the same option names as keys), the command line
+ * takes precedence over the INI file. A summary of the received data is
+ * logged periodically, and alarm transitions are logged as they happen.
+ */
+class Headless : public QObject
+{
+  Q_OBJECT
+
+public:
+  Headless();
+
+  static bool requested(int argc, char **argv);
+
+  bool helpRequested() const;
+  bool start(const QStringList &arguments);
+
+private Q_SLOTS:
+  void shutdown();
+  void checkSignals();
+  void logStatistics();
+  void onFrameReceived();
+  void onDataReceived(const QByteArray &data);
+  void onAlarmEvent(const QJsonObject &event);
+
+private:
+  bool loadProject();
+  bool configureDriver();
+  void configureModules();
+
+  bool flag(const QString &name) const;
+  QString value(const QString &name) const;
+
+private:
+  QTimer m_statsTimer;
+  QElapsedTimer m_clock;
+  QCommandLineParser m_parser;
+  QScopedPointer<QSettings> m_config;
+
+  quint64 m_bytes;
+  quint64 m_frames;
+  quint64 m_lastBytes;
+  quint64 m_lastFrames;
+  qint64 m_lastStatsTime;
+};
+} // namespace Misc
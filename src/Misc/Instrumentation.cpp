@@ -0,0 +1,568 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <QDir>
+#include <QFile>
+#include <QThread>
+#include <QFileDialog>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QJsonDocument>
+
+#include <chrono>
+#include <algorithm>
+
+#include <Misc/Utilities.h>
+#include <Misc/TimerEvents.h>
+#include <Misc/Instrumentation.h>
+
+/**
+ * Global enabled flag, read by the hot paths of the application
+ */
+std::atomic<bool> Misc::Instrumentation::s_enabled(false);
+
+/**
+ * Returns the histogram bucket that corresponds to the given @a duration
+ * (in nanoseconds).
+ */
+static int bucketFor(quint64 duration)
+{
+  int bucket = 0;
+  while (duration > 0 && bucket < Misc::Instrumentation::kHistogramBuckets - 1)
+  {
+    duration >>= 1;
+    ++bucket;
+  }
+
+  return bucket;
+}
+
+/**
+ * Constructor function, resets all counters & connects the 1 Hz timer used to
+ * refresh the statistics displayed in the user interface.
+ */
+Misc::Instrumentation::Instrumentation()
+  : m_capturing(false)
+{
+  reset();
+
+  // clang-format off
+  connect(&Misc::TimerEvents::instance(), &Misc::TimerEvents::timeout1Hz,
+          this, &Misc::Instrumentation::updateStatistics);
+  // clang-format on
+}
+
+/**
+ * Returns the only instance of the class
+ */
+Misc::Instrumentation &Misc::Instrumentation::instance()
+{
+  static Instrumentation singleton;
+  return singleton;
+}
+
+/**
+ * Returns @c true if pipeline events are being captured for trace export
+ */
+bool Misc::Instrumentation::capturing() const
+{
+  return m_capturing.load(std::memory_order_relaxed);
+}
+
+/**
+ * Returns the number of events captured for trace export
+ */
+int Misc::Instrumentation::capturedEvents() const
+{
+  QMutexLocker locker(&m_traceMutex);
+  return m_trace.count();
+}
+
+/**
+ * Returns a list with the statistics of each pipeline stage, used by the QML
+ * diagnostics pane.
+ */
+QVariantList Misc::Instrumentation::stages() const
+{
+  QVariantList list;
+  for (int i = 0; i < StageCount; ++i)
+  {
+    const auto stage = static_cast<Stage>(i);
+    const auto events = count(stage);
+
+    QVariantMap map;
+    map.insert("name", stageName(stage));
+    map.insert("count", events);
+    map.insert("rate", m_rates[i]);
+    map.insert("mean", events > 0 ? totalTime(stage) / 1e3 / events : 0);
+    map.insert("p50", percentile(stage, 0.50) / 1e3);
+    map.insert("p99", percentile(stage, 0.99) / 1e3);
+    map.insert("max", maxTime(stage) / 1e3);
+    list.append(map);
+  }
+
+  return list;
+}
+
+/**
+ * Returns a list with the current & maximum depth of each monitored queue
+ */
+QVariantList Misc::Instrumentation::queues() const
+{
+  QVariantList list;
+  for (int i = 0; i < QueueCount; ++i)
+  {
+    const auto queue = static_cast<Queue>(i);
+
+    QVariantMap map;
+    map.insert("name", queueName(queue));
+    map.insert("depth", queueDepth(queue));
+    map.insert("max", maxQueueDepth(queue));
+    list.append(map);
+  }
+
+  return list;
+}
+
+/**
+ * Returns a list with the number of discarded elements for each reason
+ */
+QVariantList Misc::Instrumentation::drops() const
+{
+  QVariantList list;
+  for (int i = 0; i < DropCount; ++i)
+  {
+    const auto drop = static_cast<Drop>(i);
+
+    QVariantMap map;
+    map.insert("name", dropName(drop));
+    map.insert("count", dropped(drop));
+    list.append(map);
+  }
+
+  return list;
+}
+
+/**
+ * Returns a monotonic timestamp in nanoseconds
+ */
+qint64 Misc::Instrumentation::now()
+{
+  using namespace std::chrono;
+  const auto time = steady_clock::now().time_since_epoch();
+  return duration_cast<nanoseconds>(time).count();
+}
+
+/**
+ * Returns the human-readable name of the given pipeline @a stage
+ */
+QString Misc::Instrumentation::stageName(const Stage stage)
+{
+  switch (stage)
+  {
+    case ReadFrames:
+      return tr("Frame extraction");
+    case FrameParser:
+      return tr("Frame parser");
+    case JsonGenerator:
+      return tr("JSON generator");
+    case Dashboard:
+      return tr("Dashboard update");
+    case Replot:
+      return tr("Plot redraw");
+    case WidgetGrab:
+      return tr("Widget rendering");
+    default:
+      return QString();
+  }
+}
+
+/**
+ * Returns the human-readable name of the given @a queue
+ */
+QString Misc::Instrumentation::queueName(const Queue queue)
+{
+  switch (queue)
+  {
+    case InputBuffer:
+      return tr("Input buffer (bytes)");
+    case PendingRepaints:
+      return tr("Pending repaints");
+    default:
+      return QString();
+  }
+}
+
+/**
+ * Returns the human-readable name of the given @a drop reason
+ */
+QString Misc::Instrumentation::dropName(const Drop drop)
+{
+  switch (drop)
+  {
+    case BufferOverflow:
+      return tr("Buffer overflows");
+    case ChecksumError:
+      return tr("Checksum errors");
+    case InvalidFrame:
+      return tr("Invalid frames");
+    case SkippedRepaint:
+      return tr("Skipped repaints");
+    case ThrottledRepaint:
+      return tr("Throttled repaints");
+    default:
+      return QString();
+  }
+}
+
+/**
+ * Returns the number of measurements registered for the given @a stage
+ */
+quint64 Misc::Instrumentation::count(const Stage stage) const
+{
+  return m_stages[stage].count.load(std::memory_order_relaxed);
+}
+
+/**
+ * Returns the total time (in nanoseconds) spent in the given @a stage
+ */
+quint64 Misc::Instrumentation::totalTime(const Stage stage) const
+{
+  return m_stages[stage].total.load(std::memory_order_relaxed);
+}
+
+/**
+ * Returns the longest time (in nanoseconds) spent in the given @a stage
+ */
+quint64 Misc::Instrumentation::maxTime(const Stage stage) const
+{
+  return m_stages[stage].max.load(std::memory_order_relaxed);
+}
+
+/**
+ * Returns the number of events of the given @a stage that fall in the given
+ * histogram @a bucket.
+ */
+quint64 Misc::Instrumentation::histogram(const Stage stage,
+                                         const int bucket) const
+{
+  if (bucket < 0 || bucket >= kHistogramBuckets)
+    return 0;
+
+  return m_stages[stage].histogram[bucket].load(std::memory_order_relaxed);
+}
+
+/**
+ * Returns an estimate of the given percentile @a p (0 to 1) of the latency
+ * of the given @a stage, in nanoseconds. The estimate is the upper bound of the
+ * histogram bucket that contains the percentile.
+ */
+double Misc::Instrumentation::percentile(const Stage stage,
+                                         const double p) const
+{
+  // Get total number of events in histogram
+  quint64 total = 0;
+  for (int i = 0; i < kHistogramBuckets; ++i)
+    total += histogram(stage, i);
+
+  // No events, abort
+  if (total == 0)
+    return 0;
+
+  // Find the bucket that contains the percentile
+  const auto target = static_cast<quint64>(p * total);
+  quint64 accumulated = 0;
+  for (int i = 0; i < kHistogramBuckets; ++i)
+  {
+    accumulated += histogram(stage, i);
+    if (accumulated > target)
+      return std::min<double>(quint64(1) << i, maxTime(stage));
+  }
+
+  return maxTime(stage);
+}
+
+/**
+ * Returns the last registered depth of the given @a queue
+ */
+qint64 Misc::Instrumentation::queueDepth(const Queue queue) const
+{
+  return m_queueDepth[queue].load(std::memory_order_relaxed);
+}
+
+/**
+ * Returns the maximum registered depth of the given @a queue
+ */
+qint64 Misc::Instrumentation::maxQueueDepth(const Queue queue) const
+{
+  return m_maxQueueDepth[queue].load(std::memory_order_relaxed);
+}
+
+/**
+ * Returns the number of discarded elements for the given @a drop reason
+ */
+quint64 Misc::Instrumentation::dropped(const Drop drop) const
+{
+  return m_drops[drop].load(std::memory_order_relaxed);
+}
+
+/**
+ * Registers a measurement of the given @a stage, which started at @a start
+ * and finished at @a end (both in nanoseconds, obtained with @c now()).
+ */
+void Misc::Instrumentation::record(const Stage stage, const qint64 start,
+                                   const qint64 end)
+{
+  // Update counters
+  const quint64 duration = std::max<qint64>(0, end - start);
+  auto &data = m_stages[stage];
+  data.count.fetch_add(1, std::memory_order_relaxed);
+  data.total.fetch_add(duration, std::memory_order_relaxed);
+  data.histogram[bucketFor(duration)].fetch_add(1, std::memory_order_relaxed);
+
+  // Update maximum duration
+  auto max = data.max.load(std::memory_order_relaxed);
+  while (duration > max
+         && !data.max.compare_exchange_weak(max, duration,
+                                            std::memory_order_relaxed))
+  {
+  }
+
+  // Register trace event
+  if (m_capturing.load(std::memory_order_relaxed))
+  {
+    const auto thread = reinterpret_cast<quintptr>(QThread::currentThreadId());
+
+    QMutexLocker locker(&m_traceMutex);
+    if (m_trace.count() < kMaxTraceEvents)
+      m_trace.append({stage, thread, start, end - start});
+  }
+}
+
+/**
+ * Clears all counters, histograms & captured events
+ */
+void Misc::Instrumentation::reset()
+{
+  for (int i = 0; i < StageCount; ++i)
+  {
+    m_stages[i].count = 0;
+    m_stages[i].total = 0;
+    m_stages[i].max = 0;
+    for (int j = 0; j < kHistogramBuckets; ++j)
+      m_stages[i].histogram[j] = 0;
+
+    m_rates[i] = 0;
+    m_lastCount[i] = 0;
+  }
+
+  for (int i = 0; i < QueueCount; ++i)
+  {
+    m_queueDepth[i] = 0;
+    m_maxQueueDepth[i] = 0;
+  }
+
+  for (int i = 0; i < DropCount; ++i)
+    m_drops[i] = 0;
+
+  m_traceMutex.lock();
+  m_trace.clear();
+  m_traceMutex.unlock();
+
+  m_rateTimer.start();
+  Q_EMIT statisticsChanged();
+}
+
+/**
+ * Lets the user select where to save the captured events & writes the trace
+ * file.
+ */
+void Misc::Instrumentation::exportTrace()
+{
+  // Stop capturing events
+  stopCapture();
+
+  // Nothing to export
+  if (capturedEvents() <= 0)
+  {
+    Misc::Utilities::showMessageBox(tr("No events captured"),
+                                    tr("Start a capture and receive some data "
+                                       "before exporting a trace file."));
+    return;
+  }
+
+  // Get file name
+  auto path = QFileDialog::getSaveFileName(
+      Q_NULLPTR, tr("Export pipeline trace"), QDir::homePath() + "/trace.json",
+      tr("Trace files") + " (*.json)");
+
+  // Write file & reveal it
+  if (!path.isEmpty() && exportTrace(path))
+    Misc::Utilities::revealFile(path);
+}
+
+/**
+ * Stops capturing pipeline events
+ */
+void Misc::Instrumentation::stopCapture()
+{
+  if (capturing())
+  {
+    m_capturing = false;
+    Q_EMIT capturingChanged();
+  }
+}
+
+/**
+ * Clears previously captured events & starts capturing new events. The
+ * instrumentation is enabled automatically if required.
+ */
+void Misc::Instrumentation::startCapture()
+{
+  m_traceMutex.lock();
+  m_trace.clear();
+  m_trace.reserve(std::min(kMaxTraceEvents, 64 * 1024));
+  m_traceMutex.unlock();
+
+  setEnabled(true);
+  m_capturing = true;
+  Q_EMIT capturingChanged();
+  Q_EMIT statisticsChanged();
+}
+
+/**
+ * Enables or disables the instrumentation of the data pipeline
+ */
+void Misc::Instrumentation::setEnabled(const bool enabled)
+{
+  if (enabled == s_enabled.load())
+    return;
+
+  if (!enabled)
+    stopCapture();
+
+  s_enabled = enabled;
+  m_rateTimer.start();
+  Q_EMIT enabledChanged();
+}
+
+/**
+ * Writes the captured events to the given @a path in the Chrome trace event
+ * format. Returns @c false if the file cannot be written.
+ */
+bool Misc::Instrumentation::exportTrace(const QString &path)
+{
+  // Copy captured events
+  m_traceMutex.lock();
+  const auto events = m_trace;
+  m_traceMutex.unlock();
+
+  // Use the first event as the time origin & assign short thread IDs
+  const auto origin = events.isEmpty() ? 0 : events.first().start;
+  QVector<quintptr> threads;
+
+  // Generate "complete" events (timestamps are given in microseconds)
+  QJsonArray traceEvents;
+  for (const auto &event : events)
+  {
+    auto tid = threads.indexOf(event.thread);
+    if (tid < 0)
+    {
+      tid = threads.count();
+      threads.append(event.thread);
+    }
+
+    QJsonObject object;
+    object.insert("ph", "X");
+    object.insert("pid", 1);
+    object.insert("tid", tid + 1);
+    object.insert("cat", "pipeline");
+    object.insert("name", stageName(event.stage));
+    object.insert("ts", (event.start - origin) / 1e3);
+    object.insert("dur", event.duration / 1e3);
+    traceEvents.append(object);
+  }
+
+  // Create document
+  QJsonObject document;
+  document.insert("traceEvents", traceEvents);
+  document.insert("displayTimeUnit", "ms");
+
+  // Write file
+  QFile file(path);
+  if (!file.open(QFile::WriteOnly))
+  {
+    Misc::Utilities::showMessageBox(tr("File save error"), file.errorString());
+    return false;
+  }
+
+  file.write(QJsonDocument(document).toJson(QJsonDocument::Compact));
+  file.close();
+  return true;
+}
+
+/**
+ * Calculates the event rate of each stage & notifies the user interface
+ */
+void Misc::Instrumentation::updateStatistics()
+{
+  if (!enabled())
+    return;
+
+  const auto elapsed = m_rateTimer.restart() / 1000.0;
+  for (int i = 0; i < StageCount; ++i)
+  {
+    const auto events = count(static_cast<Stage>(i));
+    if (elapsed > 0)
+      m_rates[i] = (events - m_lastCount[i]) / elapsed;
+
+    m_lastCount[i] = events;
+  }
+
+  Q_EMIT statisticsChanged();
+}
+
+/**
+ * Updates the current & maximum depth of the given @a queue. If @a relative
+ * is @c true, @a value is added to the current depth (which is never allowed
+ * to go below zero, since the instrumentation can be enabled at any time).
+ */
+void Misc::Instrumentation::updateQueueDepth(const Queue queue,
+                                             const qint64 value,
+                                             const bool relative)
+{
+  auto depth = value;
+  if (relative)
+  {
+    depth = m_queueDepth[queue].load(std::memory_order_relaxed) + value;
+    depth = std::max<qint64>(0, depth);
+  }
+
+  m_queueDepth[queue].store(depth, std::memory_order_relaxed);
+
+  auto max = m_maxQueueDepth[queue].load(std::memory_order_relaxed);
+  while (depth > max
+         && !m_maxQueueDepth[queue].compare_exchange_weak(
+             max, depth, std::memory_order_relaxed))
+  {
+  }
+}
@@ -0,0 +1,282 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <QMutex>
+#include <QObject>
+#include <QVector>
+#include <QVariant>
+#include <QElapsedTimer>
+
+#include <atomic>
+
+namespace Misc
+{
+/**
+ * @brief The Instrumentation class
+ *
+ * Collects low-overhead statistics about each stage of the data pipeline
+ * (frame extraction, frame parsing, JSON generation, dashboard updates and
+ * widget rendering), along with queue depths and dropped data counters.
+ *
+ * Hot paths measure themselves through the @c ScopedTimer class, which only
+ * reads an atomic flag when the instrumentation is disabled. When enabled,
+ * every measurement updates a few atomic counters and a log2 latency
+ * histogram. Optionally, individual events can be captured and exported in
+ * the Chrome trace format, which can be opened with Perfetto or with the
+ * "chrome://tracing" page.
+ */
+class Instrumentation : public QObject
+{
+  // clang-format off
+    Q_OBJECT
+    Q_PROPERTY(bool enabled
+               READ enabled
+               WRITE setEnabled
+               NOTIFY enabledChanged)
+    Q_PROPERTY(bool capturing
+               READ capturing
+               NOTIFY capturingChanged)
+    Q_PROPERTY(int capturedEvents
+               READ capturedEvents
+               NOTIFY statisticsChanged)
+    Q_PROPERTY(QVariantList stages
+               READ stages
+               NOTIFY statisticsChanged)
+    Q_PROPERTY(QVariantList queues
+               READ queues
+               NOTIFY statisticsChanged)
+    Q_PROPERTY(QVariantList drops
+               READ drops
+               NOTIFY statisticsChanged)
+  // clang-format on
+
+Q_SIGNALS:
+  void enabledChanged();
+  void capturingChanged();
+  void statisticsChanged();
+
+public:
+  /**
+   * Measured stages of the data pipeline
+   */
+  enum Stage
+  {
+    ReadFrames,
+    FrameParser,
+    JsonGenerator,
+    Dashboard,
+    Replot,
+    WidgetGrab,
+    StageCount
+  };
+  Q_ENUM(Stage)
+
+  /**
+   * Buffers/queues whose depth is monitored
+   */
+  enum Queue
+  {
+    InputBuffer,
+    PendingRepaints,
+    QueueCount
+  };
+  Q_ENUM(Queue)
+
+  /**
+   * Reasons for which received data can be discarded
+   */
+  enum Drop
+  {
+    BufferOverflow,
+    ChecksumError,
+    InvalidFrame,
+    SkippedRepaint,
+    ThrottledRepaint,
+    DropCount
+  };
+  Q_ENUM(Drop)
+
+  /**
+   * Number of buckets of the latency histograms, bucket @c n counts the
+   * events that took between 2^(n-1) and 2^n nanoseconds.
+   */
+  static constexpr int kHistogramBuckets = 40;
+
+  /**
+   * Maximum number of events stored during a trace capture
+   */
+  static constexpr int kMaxTraceEvents = 1000000;
+
+  /**
+   * @brief The ScopedTimer class
+   *
+   * Measures the time elapsed between its construction and its destruction
+   * and registers it with the given pipeline stage.
+   */
+  class ScopedTimer
+  {
+  public:
+    explicit ScopedTimer(const Stage stage)
+      : m_stage(stage)
+      , m_start(Instrumentation::enabled() ? Instrumentation::now() : -1)
+    {
+    }
+
+    ~ScopedTimer() { stop(); }
+
+    /**
+     * Registers the measurement before the timer goes out of scope, used to
+     * exclude the time spent by the next stages of the pipeline.
+     */
+    void stop()
+    {
+      if (m_start >= 0)
+      {
+        Instrumentation::instance().record(m_stage, m_start,
+                                           Instrumentation::now());
+        m_start = -1;
+      }
+    }
+
+  private:
+    Stage m_stage;
+    qint64 m_start;
+  };
+
+private:
+  explicit Instrumentation();
+  Instrumentation(Instrumentation &&) = delete;
+  Instrumentation(const Instrumentation &) = delete;
+  Instrumentation &operator=(Instrumentation &&) = delete;
+  Instrumentation &operator=(const Instrumentation &) = delete;
+
+public:
+  static Instrumentation &instance();
+
+  /**
+   * Returns @c true if the instrumentation is enabled. This function is
+   * called from hot paths, so it is kept inline.
+   */
+  static bool enabled() { return s_enabled.load(std::memory_order_relaxed); }
+
+  bool capturing() const;
+  int capturedEvents() const;
+
+  QVariantList stages() const;
+  QVariantList queues() const;
+  QVariantList drops() const;
+
+  static qint64 now();
+  static QString stageName(const Stage stage);
+  static QString queueName(const Queue queue);
+  static QString dropName(const Drop drop);
+
+  quint64 count(const Stage stage) const;
+  quint64 totalTime(const Stage stage) const;
+  quint64 maxTime(const Stage stage) const;
+  quint64 histogram(const Stage stage, const int bucket) const;
+  double percentile(const Stage stage, const double p) const;
+
+  qint64 queueDepth(const Queue queue) const;
+  qint64 maxQueueDepth(const Queue queue) const;
+  quint64 dropped(const Drop drop) const;
+
+  void record(const Stage stage, const qint64 start, const qint64 end);
+
+  /**
+   * Updates the depth of the given @a queue (only if enabled)
+   */
+  static void setQueueDepth(const Queue queue, const qint64 depth)
+  {
+    if (enabled())
+      instance().updateQueueDepth(queue, depth, false);
+  }
+
+  /**
+   * Adds @a delta to the depth of the given @a queue (only if enabled)
+   */
+  static void addQueueDepth(const Queue queue, const qint64 delta)
+  {
+    if (enabled())
+      instance().updateQueueDepth(queue, delta, true);
+  }
+
+  /**
+   * Registers @a count discarded elements for the given @a reason (only if
+   * enabled)
+   */
+  static void addDropped(const Drop reason, const quint64 count = 1)
+  {
+    if (enabled())
+      instance().m_drops[reason].fetch_add(count, std::memory_order_relaxed);
+  }
+
+public Q_SLOTS:
+  void reset();
+  void exportTrace();
+  void stopCapture();
+  void startCapture();
+  void setEnabled(const bool enabled);
+  bool exportTrace(const QString &path);
+
+private Q_SLOTS:
+  void updateStatistics();
+
+private:
+  void updateQueueDepth(const Queue queue, const qint64 value,
+                        const bool relative);
+
+private:
+  struct StageData
+  {
+    std::atomic<quint64> count;
+    std::atomic<quint64> total;
+    std::atomic<quint64> max;
+    std::atomic<quint64> histogram[kHistogramBuckets];
+  };
+
+  struct TraceEvent
+  {
+    Stage stage;
+    quintptr thread;
+    qint64 start;
+    qint64 duration;
+  };
+
+  static std::atomic<bool> s_enabled;
+
+  std::atomic<bool> m_capturing;
+  StageData m_stages[StageCount];
+  std::atomic<qint64> m_queueDepth[QueueCount];
+  std::atomic<qint64> m_maxQueueDepth[QueueCount];
+  std::atomic<quint64> m_drops[DropCount];
+
+  quint64 m_lastCount[StageCount];
+  double m_rates[StageCount];
+  QElapsedTimer m_rateTimer;
+
+  mutable QMutex m_traceMutex;
+  QVector<TraceEvent> m_trace;
+};
+} // namespace Misc
@@ -31,22 +31,36 @@
 #include <JSON/Generator.h>
 
 #include <Project/Model.h>
-#include <Project/CodeEditor.h>
+#include <Project/CodeEditorProxy.h>
+
+#include <DSP/Statistics.h>
+#include <DSP/SpectrumAnalyzer.h>
+#include <History/Store.h>
 
 #include <IO/Manager.h>
 #include <IO/Console.h>
+#include <IO/Trigger.h>
+#include <IO/Recorder.h>
+#include <IO/Drivers/Pipe.h>
 #include <IO/Drivers/Serial.h>
+#include <IO/Drivers/Replay.h>
 #include <IO/Drivers/Network.h>
+#include <IO/Drivers/Synthetic.h>
 #include <IO/Drivers/BluetoothLE.h>
 
+#include <Misc/Alarms.h>
 #include <Misc/Utilities.h>
 #include <Misc/Translator.h>
 #include <Misc/TimerEvents.h>
 #include <Misc/ThemeManager.h>
 #include <Misc/ModuleManager.h>
+#include <Misc/Instrumentation.h>
+#include <Misc/StartupTimeline.h>
 
 #include <MQTT/Client.h>
 #include <Plugins/Server.h>
+#include <Plugins/SharedMemory.h>
+#include <Plugins/MetricsServer.h>
 
 #include <UI/Dashboard.h>
 #include <UI/DashboardWidget.h>
@@ -55,6 +69,24 @@
 #include <QQuickWindow>
 #include <QSimpleUpdater.h>
 
+/**
+ * Registers the singleton of the given @c Module class as a QML singleton type
+ * with the given @a name. The module is only constructed when the QML
+ * interface uses it for the first time, and the time that it takes to
+ * construct it is recorded in the startup timeline with the given @a label.
+ */
+template<typename Module>
+static void registerLazyModule(const char *name, const QString &label)
+{
+  qmlRegisterSingletonType<Module>(
+      "SerialStudio", 1, 0, name, [label](QQmlEngine *, QJSEngine *) {
+        auto t = &Misc::StartupTimeline::instance();
+        auto module = t->measure(label, [] { return &Module::instance(); });
+        QQmlEngine::setObjectOwnership(module, QQmlEngine::CppOwnership);
+        return module;
+      });
+}
+
 /**
  * Configures the application font and configures application signals/slots to
  * destroy singleton classes before the application quits.
@@ -62,13 +94,16 @@
 Misc::ModuleManager::ModuleManager()
 {
   // Init translator
-  (void)Misc::Translator::instance();
+  auto t = &Misc::StartupTimeline::instance();
+  t->measure("Misc::Translator", [] { (void)Misc::Translator::instance(); });
 
   // Load Roboto fonts from resources
-  QFontDatabase::addApplicationFont(":/fonts/Roboto-Bold.ttf");
-  QFontDatabase::addApplicationFont(":/fonts/Roboto-Regular.ttf");
-  QFontDatabase::addApplicationFont(":/fonts/RobotoMono-Bold.ttf");
-  QFontDatabase::addApplicationFont(":/fonts/RobotoMono-Regular.ttf");
+  t->measure("Fonts", [] {
+    QFontDatabase::addApplicationFont(":/fonts/Roboto-Bold.ttf");
+    QFontDatabase::addApplicationFont(":/fonts/Roboto-Regular.ttf");
+    QFontDatabase::addApplicationFont(":/fonts/RobotoMono-Bold.ttf");
+    QFontDatabase::addApplicationFont(":/fonts/RobotoMono-Regular.ttf");
+  });
 
   // Set Roboto as default app font
   QFont font("Roboto");
@@ -111,14 +146,28 @@ void Misc::ModuleManager::configureUpdater()
 
 /**
  * Register custom QML types, for the moment, we have:
- * - JSON Frame object
- * - JSON Group object
- * - JSON Dataset object
+ * - Terminal widget
+ * - Dashboard widget
+ * - Optional modules, which are constructed on first use
  */
 void Misc::ModuleManager::registerQmlTypes()
 {
   qmlRegisterType<Widgets::Terminal>("SerialStudio", 1, 0, "Terminal");
   qmlRegisterType<UI::DashboardWidget>("SerialStudio", 1, 0, "DashboardWidget");
+
+  // clang-format off
+  registerLazyModule<IO::Drivers::Pipe>("Cpp_IO_Pipe", "IO::Drivers::Pipe");
+  registerLazyModule<IO::Drivers::Replay>("Cpp_IO_Replay", "IO::Drivers::Replay");
+  registerLazyModule<IO::Drivers::Synthetic>("Cpp_IO_Synthetic", "IO::Drivers::Synthetic");
+  registerLazyModule<IO::Trigger>("Cpp_IO_Trigger", "IO::Trigger");
+  registerLazyModule<IO::Recorder>("Cpp_IO_Recorder", "IO::Recorder");
+  registerLazyModule<History::Store>("Cpp_History_Store", "History::Store");
+  registerLazyModule<DSP::SpectrumAnalyzer>("Cpp_DSP_SpectrumAnalyzer", "DSP::SpectrumAnalyzer");
+  registerLazyModule<DSP::Statistics>("Cpp_DSP_Statistics", "DSP::Statistics");
+  registerLazyModule<Plugins::MetricsServer>("Cpp_Plugins_Metrics", "Plugins::MetricsServer");
+  registerLazyModule<Plugins::SharedMemory>("Cpp_Plugins_SharedMemory", "Plugins::SharedMemory");
+  registerLazyModule<Misc::Alarms>("Cpp_Misc_Alarms", "Misc::Alarms");
+  // clang-format on
 }
 
 /**
@@ -144,27 +193,32 @@ bool Misc::ModuleManager::autoUpdaterEnabled()
  */
 void Misc::ModuleManager::initializeQmlInterface()
 {
-  // Initialize modules
-  auto csvExport = &CSV::Export::instance();
-  auto csvPlayer = &CSV::Player::instance();
-  auto ioManager = &IO::Manager::instance();
-  auto ioConsole = &IO::Console::instance();
-  auto mqttClient = &MQTT::Client::instance();
-  auto uiDashboard = &UI::Dashboard::instance();
-  auto projectModel = &Project::Model::instance();
-  auto ioSerial = &IO::Drivers::Serial::instance();
-  auto jsonGenerator = &JSON::Generator::instance();
-  auto pluginsBridge = &Plugins::Server::instance();
-  auto miscUtilities = &Misc::Utilities::instance();
-  auto ioNetwork = &IO::Drivers::Network::instance();
+  // Initialize modules & measure the time that each module takes to load
+  auto t = &Misc::StartupTimeline::instance();
+  // clang-format off
+  auto csvExport = t->measure("CSV::Export", [] { return &CSV::Export::instance(); });
+  auto csvPlayer = t->measure("CSV::Player", [] { return &CSV::Player::instance(); });
+  auto ioManager = t->measure("IO::Manager", [] { return &IO::Manager::instance(); });
+  auto ioConsole = t->measure("IO::Console", [] { return &IO::Console::instance(); });
+  auto mqttClient = t->measure("MQTT::Client", [] { return &MQTT::Client::instance(); });
+  auto uiDashboard = t->measure("UI::Dashboard", [] { return &UI::Dashboard::instance(); });
+  auto projectModel = t->measure("Project::Model", [] { return &Project::Model::instance(); });
+  auto ioSerial = t->measure("IO::Drivers::Serial", [] { return &IO::Drivers::Serial::instance(); });
+  auto jsonGenerator = t->measure("JSON::Generator", [] { return &JSON::Generator::instance(); });
+  auto pluginsBridge = t->measure("Plugins::Server", [] { return &Plugins::Server::instance(); });
+  auto miscUtilities = t->measure("Misc::Utilities", [] { return &Misc::Utilities::instance(); });
+  auto ioNetwork = t->measure("IO::Drivers::Network", [] { return &IO::Drivers::Network::instance(); });
   auto miscTranslator = &Misc::Translator::instance();
-  auto miscTimerEvents = &Misc::TimerEvents::instance();
-  auto miscThemeManager = &Misc::ThemeManager::instance();
-  auto projectCodeEditor = &Project::CodeEditor::instance();
-  auto ioBluetoothLE = &IO::Drivers::BluetoothLE::instance();
+  auto miscTimerEvents = t->measure("Misc::TimerEvents", [] { return &Misc::TimerEvents::instance(); });
+  auto miscThemeManager = t->measure("Misc::ThemeManager", [] { return &Misc::ThemeManager::instance(); });
+  auto miscInstrumentation = t->measure("Misc::Instrumentation", [] { return &Misc::Instrumentation::instance(); });
+  auto projectCodeEditor = t->measure("Project::CodeEditorProxy", [] { return &Project::CodeEditorProxy::instance(); });
+  auto ioBluetoothLE = t->measure("IO::Drivers::BluetoothLE", [] { return &IO::Drivers::BluetoothLE::instance(); });
+  // clang-format on
 
   // Initialize third-party modules
-  auto updater = QSimpleUpdater::getInstance();
+  auto updater = t->measure("QSimpleUpdater",
+                            [] { return QSimpleUpdater::getInstance(); });
 
   // Operating system flags
   bool isWin = false;
@@ -195,6 +249,12 @@ void Misc::ModuleManager::initializeQmlInterface()
   // Start common event timers
   miscTimerEvents->startTimers();
 
+  // Construct the modules that process every frame once data is available
+  connect(ioManager, &IO::Manager::connectedChanged, this,
+          &Misc::ModuleManager::initializeFrameObservers);
+  connect(csvPlayer, &CSV::Player::openChanged, this,
+          &Misc::ModuleManager::initializeFrameObservers);
+
   // Retranslate the QML interface automagically
   connect(miscTranslator, SIGNAL(languageChanged()), engine(),
           SLOT(retranslate()));
@@ -223,6 +283,8 @@ void Misc::ModuleManager::initializeQmlInterface()
   c->setContextProperty("Cpp_ThemeManager", miscThemeManager);
   c->setContextProperty("Cpp_Misc_Translator", miscTranslator);
   c->setContextProperty("Cpp_Misc_TimerEvents", miscTimerEvents);
+  c->setContextProperty("Cpp_Misc_StartupTimeline", t);
+  c->setContextProperty("Cpp_Misc_Instrumentation", miscInstrumentation);
   c->setContextProperty("Cpp_Project_CodeEditor", projectCodeEditor);
   c->setContextProperty("Cpp_UpdaterEnabled", autoUpdaterEnabled());
   c->setContextProperty("Cpp_ModuleManager", this);
@@ -236,7 +298,32 @@ void Misc::ModuleManager::initializeQmlInterface()
                         qApp->organizationDomain());
 
   // Load main.qml
-  engine()->load(QUrl(QStringLiteral("qrc:/qml/main.qml")));
+  t->measure("QML user interface", [this] {
+    engine()->load(QUrl(QStringLiteral("qrc:/qml/main.qml")));
+  });
+}
+
+/**
+ * Constructs the modules that must process every received frame, even if the
+ * user interface never uses them, once a device is connected or a CSV file is
+ * opened for the first time.
+ */
+void Misc::ModuleManager::initializeFrameObservers()
+{
+  if (!IO::Manager::instance().connected() && !CSV::Player::instance().isOpen())
+    return;
+
+  // clang-format off
+  disconnect(&IO::Manager::instance(), &IO::Manager::connectedChanged, this,
+             &Misc::ModuleManager::initializeFrameObservers);
+  disconnect(&CSV::Player::instance(), &CSV::Player::openChanged, this,
+             &Misc::ModuleManager::initializeFrameObservers);
+  // clang-format on
+
+  auto t = &Misc::StartupTimeline::instance();
+  t->measure("Misc::Alarms", [] { (void)Misc::Alarms::instance(); });
+  t->measure("History::Store", [] { (void)History::Store::instance(); });
+  t->measure("DSP::Statistics", [] { (void)DSP::Statistics::instance(); });
 }
 
 /**
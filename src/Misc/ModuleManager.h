@@ -51,6 +51,9 @@ public:
 public Q_SLOTS:
   void onQuit();
 
+private Q_SLOTS:
+  void initializeFrameObservers();
+
 private:
   QQmlApplicationEngine m_engine;
 };
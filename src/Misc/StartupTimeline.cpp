@@ -0,0 +1,203 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <QDebug>
+#include <IO/Manager.h>
+#include <Misc/StartupTimeline.h>
+
+/**
+ * Constructor function, starts the startup clock
+ */
+Misc::StartupTimeline::StartupTimeline()
+  : m_finished(false)
+  , m_logEnabled(false)
+  , m_firstFrameReceived(false)
+  , m_startupTime(-1)
+  , m_connectionTime(-1)
+  , m_timeToFirstFrame(-1)
+{
+  m_clock.start();
+}
+
+/**
+ * Returns the only instance of the class
+ */
+Misc::StartupTimeline &Misc::StartupTimeline::instance()
+{
+  static StartupTimeline singleton;
+  return singleton;
+}
+
+/**
+ * Returns a human-readable list with the recorded startup events, each item
+ * contains the time at which the event started & its duration.
+ */
+StringList Misc::StartupTimeline::entries() const
+{
+  StringList list;
+  for (const auto &entry : m_entries)
+  {
+    const auto start = entry.start / 1e6;
+    if (entry.duration > 0)
+    {
+      const auto duration = entry.duration / 1e6;
+      list.append(QStringLiteral("%1 ms: %2 (%3 ms)")
+                      .arg(start, 8, 'f', 1)
+                      .arg(entry.name)
+                      .arg(duration, 0, 'f', 1));
+    }
+
+    else
+      list.append(QStringLiteral("%1 ms: %2").arg(start, 8, 'f', 1).arg(entry.name));
+  }
+
+  return list;
+}
+
+/**
+ * Returns the time (in milliseconds) that it took for the application to
+ * finish its startup sequence, or -1 if it has not finished yet.
+ */
+double Misc::StartupTimeline::startupTime() const
+{
+  if (m_startupTime < 0)
+    return -1;
+
+  return m_startupTime / 1e6;
+}
+
+/**
+ * Returns the time (in milliseconds) between the last connection to a device
+ * and the reception of its first valid frame, or -1 if no frame has been
+ * received yet.
+ */
+double Misc::StartupTimeline::timeToFirstFrame() const
+{
+  if (m_timeToFirstFrame < 0)
+    return -1;
+
+  return m_timeToFirstFrame / 1e6;
+}
+
+/**
+ * Marks the end of the startup sequence & logs the timeline (if enabled)
+ */
+void Misc::StartupTimeline::finish()
+{
+  if (m_finished)
+    return;
+
+  m_finished = true;
+  m_startupTime = m_clock.nsecsElapsed();
+  mark(QStringLiteral("Startup finished"));
+
+  if (m_logEnabled)
+  {
+    qInfo().noquote() << "Startup timeline:";
+    for (const auto &entry : entries())
+      qInfo().noquote() << " " << entry;
+  }
+}
+
+/**
+ * Starts measuring the time between connecting to a device & receiving the
+ * first valid frame.
+ */
+void Misc::StartupTimeline::trackFirstFrame()
+{
+  // clang-format off
+  connect(&IO::Manager::instance(), &IO::Manager::connectedChanged,
+          this, &Misc::StartupTimeline::onConnectedChanged,
+          Qt::UniqueConnection);
+  // clang-format on
+}
+
+/**
+ * Registers an instant event with the given @a name
+ */
+void Misc::StartupTimeline::mark(const QString &name)
+{
+  record(name, m_clock.nsecsElapsed(), 0);
+}
+
+/**
+ * Enables or disables printing the timeline to the console once startup
+ * finishes.
+ */
+void Misc::StartupTimeline::setLogEnabled(const bool enabled)
+{
+  m_logEnabled = enabled;
+}
+
+/**
+ * Calculates the time to first frame & stops listening for frames until the
+ * next connection.
+ */
+void Misc::StartupTimeline::onFrameReceived()
+{
+  // Disconnect from frame signal to avoid overhead
+  disconnect(&IO::Manager::instance(), &IO::Manager::frameReceived, this,
+             &Misc::StartupTimeline::onFrameReceived);
+
+  // Calculate time to first frame
+  m_timeToFirstFrame = m_clock.nsecsElapsed() - m_connectionTime;
+  Q_EMIT timeToFirstFrameChanged();
+
+  // Register first frame of the session in the timeline
+  if (!m_firstFrameReceived)
+  {
+    m_firstFrameReceived = true;
+    mark(QStringLiteral("First frame received"));
+  }
+
+  // Log time to first frame
+  if (m_logEnabled)
+    qInfo() << "Time to first frame:" << timeToFirstFrame() << "ms";
+}
+
+/**
+ * Starts waiting for the first frame when a device is connected
+ */
+void Misc::StartupTimeline::onConnectedChanged()
+{
+  auto manager = &IO::Manager::instance();
+  if (manager->connected())
+  {
+    m_connectionTime = m_clock.nsecsElapsed();
+    connect(manager, &IO::Manager::frameReceived, this,
+            &Misc::StartupTimeline::onFrameReceived, Qt::UniqueConnection);
+  }
+
+  else
+    disconnect(manager, &IO::Manager::frameReceived, this,
+               &Misc::StartupTimeline::onFrameReceived);
+}
+
+/**
+ * Registers a new event in the timeline
+ */
+void Misc::StartupTimeline::record(const QString &name, const qint64 start,
+                                   const qint64 duration)
+{
+  m_entries.append({name, start, duration});
+  Q_EMIT entriesChanged();
+}
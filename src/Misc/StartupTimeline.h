@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <QObject>
+#include <QVector>
+#include <QElapsedTimer>
+#include <DataTypes.h>
+
+namespace Misc
+{
+/**
+ * @brief The StartupTimeline class
+ *
+ * Records the time that it takes to construct each module of the application
+ * during startup, along with the time elapsed between connecting to a device
+ * and receiving the first valid frame.
+ *
+ * The clock starts when the class is first used, which should be as early as
+ * possible in the @c main() function. Nested measurements (e.g. a module that
+ * constructs another module) are recorded with their full duration.
+ */
+class StartupTimeline : public QObject
+{
+  // clang-format off
+    Q_OBJECT
+    Q_PROPERTY(StringList entries
+               READ entries
+               NOTIFY entriesChanged)
+    Q_PROPERTY(double startupTime
+               READ startupTime
+               NOTIFY entriesChanged)
+    Q_PROPERTY(double timeToFirstFrame
+               READ timeToFirstFrame
+               NOTIFY timeToFirstFrameChanged)
+  // clang-format on
+
+Q_SIGNALS:
+  void entriesChanged();
+  void timeToFirstFrameChanged();
+
+private:
+  explicit StartupTimeline();
+  StartupTimeline(StartupTimeline &&) = delete;
+  StartupTimeline(const StartupTimeline &) = delete;
+  StartupTimeline &operator=(StartupTimeline &&) = delete;
+  StartupTimeline &operator=(const StartupTimeline &) = delete;
+
+public:
+  static StartupTimeline &instance();
+
+  StringList entries() const;
+  double startupTime() const;
+  double timeToFirstFrame() const;
+
+  /**
+   * Calls the given @a function and records the time that it took to execute
+   * with the given @a name. The return value of @a function is forwarded to
+   * the caller.
+   */
+  template<typename Function>
+  auto measure(const QString &name, Function function) -> decltype(function())
+  {
+    const Scope scope(this, name);
+    return function();
+  }
+
+public Q_SLOTS:
+  void finish();
+  void trackFirstFrame();
+  void mark(const QString &name);
+  void setLogEnabled(const bool enabled);
+
+private Q_SLOTS:
+  void onFrameReceived();
+  void onConnectedChanged();
+
+private:
+  void record(const QString &name, const qint64 start, const qint64 duration);
+
+private:
+  /**
+   * Records the time elapsed between its construction & its destruction, so
+   * that @c measure() can return the result of functions of any type.
+   */
+  struct Scope
+  {
+    Scope(StartupTimeline *timeline, const QString &name)
+      : name(name)
+      , timeline(timeline)
+      , start(timeline->m_clock.nsecsElapsed())
+    {
+    }
+
+    ~Scope()
+    {
+      const auto end = timeline->m_clock.nsecsElapsed();
+      timeline->record(name, start, end - start);
+    }
+
+    const QString &name;
+    StartupTimeline *timeline;
+    const qint64 start;
+  };
+
+  struct Entry
+  {
+    QString name;
+    qint64 start;
+    qint64 duration;
+  };
+
+  bool m_finished;
+  bool m_logEnabled;
+  bool m_firstFrameReceived;
+  qint64 m_startupTime;
+  qint64 m_connectionTime;
+  qint64 m_timeToFirstFrame;
+  QElapsedTimer m_clock;
+  QVector<Entry> m_entries;
+};
+} // namespace Misc
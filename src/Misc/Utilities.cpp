@@ -22,6 +22,7 @@
 
 #include <QDir>
 #include <QUrl>
+#include <QDebug>
 #include <QPalette>
 #include <QProcess>
 #include <QFileInfo>
@@ -85,6 +86,22 @@ int Misc::Utilities::showMessageBox(const QString &text,
                                     const QString &windowTitle,
                                     const QMessageBox::StandardButtons &bt)
 {
+  // Running without a GUI (e.g. headless mode or offscreen benchmarks), log
+  // the message instead
+  auto app = qobject_cast<QApplication *>(QCoreApplication::instance());
+  if (!app || QApplication::platformName() == QStringLiteral("offscreen"))
+  {
+    if (informativeText.isEmpty())
+      qWarning().noquote() << text;
+    else
+      qWarning().noquote() << text << "-" << informativeText;
+
+    if (bt & QMessageBox::Ok)
+      return QMessageBox::Ok;
+
+    return QMessageBox::NoButton;
+  }
+
   // Get app icon
   QPixmap icon;
   if (qApp->devicePixelRatio() >= 2)
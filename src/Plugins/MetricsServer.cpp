@@ -0,0 +1,499 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <cstdio>
+#include <cstdarg>
+#include <cstring>
+
+#include <CSV/Export.h>
+#include <IO/Manager.h>
+#include <MQTT/Client.h>
+#include <Plugins/Server.h>
+#include <Misc/Utilities.h>
+#include <Misc/TimerEvents.h>
+#include <Misc/Instrumentation.h>
+#include <Plugins/MetricsServer.h>
+
+/**
+ * Metric label of each pipeline stage, in the same order as the
+ * @c Misc::Instrumentation::Stage enum.
+ */
+static const char *const STAGE_LABELS[] = {
+    "read_frames", "frame_parser", "json_generator",
+    "dashboard",   "replot",       "widget_grab",
+};
+
+/**
+ * Metric label of each drop reason, in the same order as the
+ * @c Misc::Instrumentation::Drop enum.
+ */
+static const char *const DROP_LABELS[] = {
+    "buffer_overflow",
+    "checksum_error",
+    "invalid_frame",
+    "skipped_repaint",
+    "throttled_repaint",
+};
+
+static_assert(sizeof(STAGE_LABELS) / sizeof(STAGE_LABELS[0])
+                  == Misc::Instrumentation::StageCount,
+              "Missing pipeline stage labels");
+static_assert(sizeof(DROP_LABELS) / sizeof(DROP_LABELS[0])
+                  == Misc::Instrumentation::DropCount,
+              "Missing drop reason labels");
+
+/**
+ * Histogram buckets exported to Prometheus, from ~1 µs (2^10 ns) to ~1 s
+ * (2^30 ns). Faster events are counted in the first bucket.
+ */
+static constexpr int FIRST_BUCKET = 10;
+static constexpr int LAST_BUCKET = 30;
+
+//------------------------------------------------------------------------------
+// Metrics worker
+//------------------------------------------------------------------------------
+
+/**
+ * Constructor function
+ */
+Plugins::MetricsWorker::MetricsWorker(const MetricsSnapshot *snapshot)
+  : m_server(Q_NULLPTR)
+  , m_snapshot(snapshot)
+{
+}
+
+/**
+ * Stops listening for incoming connections
+ */
+void Plugins::MetricsWorker::stop()
+{
+  if (m_server)
+  {
+    m_server->close();
+    m_server->deleteLater();
+    m_server = Q_NULLPTR;
+  }
+}
+
+/**
+ * Starts listening for HTTP connections on the loopback interface at the
+ * given @a port. Returns @c false if the port cannot be opened.
+ */
+bool Plugins::MetricsWorker::start(const quint16 port)
+{
+  stop();
+
+  m_server = new QTcpServer(this);
+  connect(m_server, &QTcpServer::newConnection, this,
+          &Plugins::MetricsWorker::onNewConnection);
+
+  if (!m_server->listen(QHostAddress::LocalHost, port))
+  {
+    stop();
+    return false;
+  }
+
+  return true;
+}
+
+/**
+ * Reads the request line of the HTTP request & sends the metrics (or an error
+ * response) to the client, which is disconnected afterwards.
+ */
+void Plugins::MetricsWorker::onReadyRead()
+{
+  // Get caller socket
+  auto socket = qobject_cast<QTcpSocket *>(sender());
+  if (!socket)
+    return;
+
+  // Wait until the request line is complete
+  if (!socket->canReadLine())
+  {
+    if (socket->bytesAvailable() >= kRequestSize)
+      socket->abort();
+
+    return;
+  }
+
+  // Read request line into pre-allocated buffer
+  const auto size = socket->readLine(m_request, kRequestSize);
+  if (size <= 0)
+  {
+    socket->abort();
+    return;
+  }
+
+  // Only one request per connection is answered
+  disconnect(socket, &QTcpSocket::readyRead, this,
+             &Plugins::MetricsWorker::onReadyRead);
+
+  // Check requested path
+  const bool get = std::strncmp(m_request, "GET ", 4) == 0;
+  const bool metrics = std::strncmp(m_request + 4, "/metrics", 8) == 0
+                       && (m_request[12] == ' ' || m_request[12] == '?');
+
+  // Generate response
+  int bodyLength = 0;
+  const char *status = "200 OK";
+  if (!get)
+    status = "405 Method Not Allowed";
+  else if (!metrics)
+    status = "404 Not Found";
+  else
+    bodyLength = formatMetrics();
+
+  // Generate response header
+  const auto headerLength = std::snprintf(
+      m_header, kHeaderSize,
+      "HTTP/1.1 %s\r\n"
+      "Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n"
+      "Content-Length: %d\r\n"
+      "Connection: close\r\n\r\n",
+      status, bodyLength);
+
+  // Place the header right before the body & send the response at once
+  const auto length = qMin(headerLength, kHeaderSize - 1);
+  const auto response = m_response + kHeaderSize - length;
+  std::memcpy(response, m_header, length);
+  socket->write(response, length + bodyLength);
+  socket->disconnectFromHost();
+}
+
+/**
+ * Configures incoming connections
+ */
+void Plugins::MetricsWorker::onNewConnection()
+{
+  while (m_server && m_server->hasPendingConnections())
+  {
+    auto socket = m_server->nextPendingConnection();
+    socket->setReadBufferSize(kRequestSize);
+    connect(socket, &QTcpSocket::readyRead, this,
+            &Plugins::MetricsWorker::onReadyRead);
+    connect(socket, &QTcpSocket::disconnected, socket,
+            &QTcpSocket::deleteLater);
+  }
+}
+
+/**
+ * Writes the current metrics into the body of the response buffer & returns
+ * its length
+ */
+int Plugins::MetricsWorker::formatMetrics()
+{
+  int length = 0;
+  auto s = m_snapshot;
+  auto instrumentation = &Misc::Instrumentation::instance();
+
+  // I/O metrics
+  append(length,
+         "# HELP serialstudio_device_connected Whether a device is connected.\n"
+         "# TYPE serialstudio_device_connected gauge\n"
+         "serialstudio_device_connected %llu\n",
+         static_cast<unsigned long long>(s->connected.load()));
+  append(length,
+         "# HELP serialstudio_received_bytes_total Bytes received from the "
+         "device.\n"
+         "# TYPE serialstudio_received_bytes_total counter\n"
+         "serialstudio_received_bytes_total %llu\n",
+         static_cast<unsigned long long>(s->receivedBytes.load()));
+  append(length,
+         "# HELP serialstudio_frames_total Frames processed by the integrity "
+         "checks.\n"
+         "# TYPE serialstudio_frames_total counter\n"
+         "serialstudio_frames_total{status=\"ok\"} %llu\n"
+         "serialstudio_frames_total{status=\"checksum_error\"} %llu\n"
+         "serialstudio_frames_total{status=\"incomplete\"} %llu\n",
+         static_cast<unsigned long long>(s->validFrames.load()),
+         static_cast<unsigned long long>(s->checksumErrors.load()),
+         static_cast<unsigned long long>(s->incompleteFrames.load()));
+
+  // Backlogs
+  append(length,
+         "# HELP serialstudio_backlog_frames Frames waiting to be exported.\n"
+         "# TYPE serialstudio_backlog_frames gauge\n"
+         "serialstudio_backlog_frames{sink=\"csv\"} %llu\n"
+         "serialstudio_backlog_frames{sink=\"mqtt\"} %llu\n"
+         "serialstudio_backlog_frames{sink=\"plugins\"} %llu\n",
+         static_cast<unsigned long long>(s->csvBacklog.load()),
+         static_cast<unsigned long long>(s->mqttBacklog.load()),
+         static_cast<unsigned long long>(s->pluginBacklog.load()));
+  append(length,
+         "# HELP serialstudio_plugin_pending_bytes Bytes not yet delivered to "
+         "the slowest plugin client.\n"
+         "# TYPE serialstudio_plugin_pending_bytes gauge\n"
+         "serialstudio_plugin_pending_bytes %llu\n",
+         static_cast<unsigned long long>(s->pluginPendingBytes.load()));
+
+  // Dropped data
+  append(length,
+         "# HELP serialstudio_dropped_total Data discarded by the pipeline.\n"
+         "# TYPE serialstudio_dropped_total counter\n");
+  for (int i = 0; i < Misc::Instrumentation::DropCount; ++i)
+  {
+    const auto drop = static_cast<Misc::Instrumentation::Drop>(i);
+    append(length, "serialstudio_dropped_total{reason=\"%s\"} %llu\n",
+           DROP_LABELS[i],
+           static_cast<unsigned long long>(instrumentation->dropped(drop)));
+  }
+
+  // Stage latency histograms
+  append(length,
+         "# HELP serialstudio_stage_duration_seconds Time spent in each stage "
+         "of the data pipeline.\n"
+         "# TYPE serialstudio_stage_duration_seconds histogram\n");
+  for (int i = 0; i < Misc::Instrumentation::StageCount; ++i)
+  {
+    const auto stage = static_cast<Misc::Instrumentation::Stage>(i);
+
+    quint64 cumulative = 0;
+    for (int b = 0; b < Misc::Instrumentation::kHistogramBuckets; ++b)
+    {
+      cumulative += instrumentation->histogram(stage, b);
+      if (b >= FIRST_BUCKET && b <= LAST_BUCKET)
+        append(length,
+               "serialstudio_stage_duration_seconds_bucket"
+               "{stage=\"%s\",le=\"%g\"} %llu\n",
+               STAGE_LABELS[i], static_cast<double>(quint64(1) << b) / 1e9,
+               static_cast<unsigned long long>(cumulative));
+    }
+
+    append(length,
+           "serialstudio_stage_duration_seconds_bucket"
+           "{stage=\"%s\",le=\"+Inf\"} %llu\n"
+           "serialstudio_stage_duration_seconds_sum{stage=\"%s\"} %g\n"
+           "serialstudio_stage_duration_seconds_count{stage=\"%s\"} %llu\n",
+           STAGE_LABELS[i], static_cast<unsigned long long>(cumulative),
+           STAGE_LABELS[i], instrumentation->totalTime(stage) / 1e9,
+           STAGE_LABELS[i], static_cast<unsigned long long>(cumulative));
+  }
+
+  return length;
+}
+
+/**
+ * Appends formatted text to the body of the response buffer, the text is
+ * truncated if the buffer is full.
+ */
+void Plugins::MetricsWorker::append(int &length, const char *format, ...)
+{
+  if (length >= kBodySize - 1)
+    return;
+
+  va_list args;
+  va_start(args, format);
+  const auto body = m_response + kHeaderSize;
+  const auto written
+      = std::vsnprintf(body + length, kBodySize - length, format, args);
+  va_end(args);
+
+  if (written > 0)
+    length = qMin(length + written, kBodySize - 1);
+}
+
+//------------------------------------------------------------------------------
+// Metrics server
+//------------------------------------------------------------------------------
+
+/**
+ * Constructor function
+ */
+Plugins::MetricsServer::MetricsServer()
+  : m_port(METRICS_TCP_PORT)
+  , m_enabled(false)
+  , m_instrumented(false)
+  , m_worker(Q_NULLPTR)
+{
+  // Initialize snapshot
+  m_snapshot.connected = 0;
+  m_snapshot.receivedBytes = 0;
+  m_snapshot.validFrames = 0;
+  m_snapshot.checksumErrors = 0;
+  m_snapshot.incompleteFrames = 0;
+  m_snapshot.csvBacklog = 0;
+  m_snapshot.mqttBacklog = 0;
+  m_snapshot.pluginBacklog = 0;
+  m_snapshot.pluginPendingBytes = 0;
+
+  // Refresh the snapshot periodically
+  connect(&Misc::TimerEvents::instance(), &Misc::TimerEvents::timeout10Hz,
+          this, &Plugins::MetricsServer::updateSnapshot);
+}
+
+/**
+ * Destructor function, stops the metrics thread
+ */
+Plugins::MetricsServer::~MetricsServer()
+{
+  stopWorker();
+  m_thread.quit();
+  m_thread.wait();
+}
+
+/**
+ * Returns the only instance of the class
+ */
+Plugins::MetricsServer &Plugins::MetricsServer::instance()
+{
+  static MetricsServer singleton;
+  return singleton;
+}
+
+/**
+ * Returns @c true if the metrics endpoint is enabled
+ */
+bool Plugins::MetricsServer::enabled() const
+{
+  return m_enabled;
+}
+
+/**
+ * Returns the TCP port used by the metrics endpoint
+ */
+quint16 Plugins::MetricsServer::port() const
+{
+  return m_port;
+}
+
+/**
+ * Returns the URL that should be scraped by Prometheus
+ */
+QString Plugins::MetricsServer::url() const
+{
+  return QStringLiteral("http://127.0.0.1:%1/metrics").arg(m_port);
+}
+
+/**
+ * Changes the TCP @a port used by the metrics endpoint. If the endpoint is
+ * running, it is restarted on the new port.
+ */
+void Plugins::MetricsServer::setPort(const quint16 port)
+{
+  if (port == m_port)
+    return;
+
+  m_port = port;
+  Q_EMIT portChanged();
+
+  if (enabled() && !startWorker())
+    setEnabled(false);
+}
+
+/**
+ * Enables or disables the metrics endpoint. The pipeline instrumentation is
+ * enabled while the endpoint runs, and restored to its previous state once
+ * the endpoint is disabled.
+ */
+void Plugins::MetricsServer::setEnabled(const bool enabled)
+{
+  if (enabled == m_enabled)
+    return;
+
+  // Start listening for requests & collecting latency statistics
+  if (enabled)
+  {
+    if (!startWorker())
+    {
+      Misc::Utilities::showMessageBox(
+          tr("Unable to start metrics endpoint"),
+          tr("Check that TCP port %1 is not used by another application")
+              .arg(m_port));
+      Q_EMIT enabledChanged();
+      return;
+    }
+
+    m_instrumented = Misc::Instrumentation::enabled();
+    Misc::Instrumentation::instance().setEnabled(true);
+    updateSnapshot();
+  }
+
+  // Stop listening for requests & restore the instrumentation state
+  else
+  {
+    stopWorker();
+    if (!m_instrumented)
+      Misc::Instrumentation::instance().setEnabled(false);
+  }
+
+  m_enabled = enabled;
+  Q_EMIT enabledChanged();
+}
+
+/**
+ * Copies the counters & gauges of the application modules into the snapshot
+ * read by the metrics thread.
+ */
+void Plugins::MetricsServer::updateSnapshot()
+{
+  if (!enabled())
+    return;
+
+  auto io = &IO::Manager::instance();
+  auto plugins = &Plugins::Server::instance();
+
+  m_snapshot.connected.store(io->connected() ? 1 : 0);
+  m_snapshot.receivedBytes.store(io->totalReceivedBytes());
+  m_snapshot.validFrames.store(io->validFrames());
+  m_snapshot.checksumErrors.store(io->checksumErrors());
+  m_snapshot.incompleteFrames.store(io->incompleteFrames());
+  m_snapshot.csvBacklog.store(CSV::Export::instance().backlog());
+  m_snapshot.mqttBacklog.store(MQTT::Client::instance().backlog());
+  m_snapshot.pluginBacklog.store(plugins->pendingFrames());
+  m_snapshot.pluginPendingBytes.store(plugins->pendingBytes());
+}
+
+/**
+ * Stops listening for incoming requests
+ */
+void Plugins::MetricsServer::stopWorker()
+{
+  if (m_worker)
+    QMetaObject::invokeMethod(m_worker, &MetricsWorker::stop,
+                              Qt::BlockingQueuedConnection);
+}
+
+/**
+ * Creates the metrics thread (if needed) & starts listening for requests.
+ * Returns @c false if the TCP port cannot be opened.
+ */
+bool Plugins::MetricsServer::startWorker()
+{
+  // Create worker & thread on first use
+  if (!m_worker)
+  {
+    m_worker = new MetricsWorker(&m_snapshot);
+    m_worker->moveToThread(&m_thread);
+    connect(&m_thread, &QThread::finished, m_worker, &QObject::deleteLater);
+    m_thread.setObjectName(QStringLiteral("Metrics"));
+    m_thread.start(QThread::LowPriority);
+  }
+
+  // Start listening in the worker thread
+  bool ok = false;
+  const auto port = m_port;
+  QMetaObject::invokeMethod(
+      m_worker, [this, port, &ok] { ok = m_worker->start(port); },
+      Qt::BlockingQueuedConnection);
+
+  return ok;
+}
@@ -0,0 +1,170 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <QObject>
+#include <QThread>
+#include <QTcpServer>
+#include <QTcpSocket>
+
+#include <atomic>
+
+/**
+ * Default TCP port of the metrics endpoint
+ */
+#define METRICS_TCP_PORT 9777
+
+namespace Plugins
+{
+/**
+ * @brief The MetricsSnapshot struct
+ *
+ * Copy of the application counters & gauges that are owned by the GUI thread.
+ * The snapshot is refreshed by the GUI thread and read by the metrics thread,
+ * so that serving a request never touches the objects of the data pipeline.
+ */
+struct MetricsSnapshot
+{
+  std::atomic<quint64> connected;
+  std::atomic<quint64> receivedBytes;
+  std::atomic<quint64> validFrames;
+  std::atomic<quint64> checksumErrors;
+  std::atomic<quint64> incompleteFrames;
+  std::atomic<quint64> csvBacklog;
+  std::atomic<quint64> mqttBacklog;
+  std::atomic<quint64> pluginBacklog;
+  std::atomic<quint64> pluginPendingBytes;
+};
+
+/**
+ * @brief The MetricsWorker class
+ *
+ * Lives in the metrics thread, accepts HTTP connections & answers each
+ * request with the current metrics in the Prometheus text format.
+ *
+ * Responses are formatted into a fixed-size buffer owned by the worker & sent
+ * with a single write, so formatting a scrape does not allocate memory. Qt
+ * still allocates a socket (and its write buffer) for each connection, but
+ * only in the metrics thread, away from the data pipeline.
+ */
+class MetricsWorker : public QObject
+{
+  Q_OBJECT
+
+public:
+  MetricsWorker(const MetricsSnapshot *snapshot);
+
+  static constexpr int kBodySize = 64 * 1024;
+  static constexpr int kHeaderSize = 256;
+  static constexpr int kRequestSize = 1024;
+
+public Q_SLOTS:
+  void stop();
+  bool start(const quint16 port);
+
+private Q_SLOTS:
+  void onReadyRead();
+  void onNewConnection();
+
+private:
+  int formatMetrics();
+  void append(int &length, const char *format, ...);
+
+private:
+  QTcpServer *m_server;
+  const MetricsSnapshot *m_snapshot;
+
+  char m_header[kHeaderSize];
+  char m_request[kRequestSize];
+  char m_response[kHeaderSize + kBodySize];
+};
+
+/**
+ * @brief The MetricsServer class
+ *
+ * Optional HTTP endpoint that exposes the throughput, integrity & latency
+ * counters of Serial Studio in the Prometheus text format, which allows
+ * unattended setups to be monitored & to raise alerts.
+ *
+ * The endpoint only listens on the loopback interface, and it runs in its own
+ * thread so that scrapes never disturb data ingestion. Enabling the endpoint
+ * also enables the pipeline instrumentation, which provides the latency
+ * histograms, its previous state is restored when the endpoint is disabled.
+ */
+class MetricsServer : public QObject
+{
+  // clang-format off
+    Q_OBJECT
+    Q_PROPERTY(bool enabled
+               READ enabled
+               WRITE setEnabled
+               NOTIFY enabledChanged)
+    Q_PROPERTY(quint16 port
+               READ port
+               WRITE setPort
+               NOTIFY portChanged)
+    Q_PROPERTY(QString url
+               READ url
+               NOTIFY portChanged)
+  // clang-format on
+
+Q_SIGNALS:
+  void portChanged();
+  void enabledChanged();
+
+private:
+  explicit MetricsServer();
+  MetricsServer(MetricsServer &&) = delete;
+  MetricsServer(const MetricsServer &) = delete;
+  MetricsServer &operator=(MetricsServer &&) = delete;
+  MetricsServer &operator=(const MetricsServer &) = delete;
+
+  ~MetricsServer();
+
+public:
+  static MetricsServer &instance();
+
+  bool enabled() const;
+  quint16 port() const;
+  QString url() const;
+
+public Q_SLOTS:
+  void setPort(const quint16 port);
+  void setEnabled(const bool enabled);
+
+private Q_SLOTS:
+  void updateSnapshot();
+
+private:
+  void stopWorker();
+  bool startWorker();
+
+private:
+  quint16 m_port;
+  bool m_enabled;
+  bool m_instrumented;
+  QThread m_thread;
+  MetricsWorker *m_worker;
+  MetricsSnapshot m_snapshot;
+};
+} // namespace Plugins
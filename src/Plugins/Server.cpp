@@ -25,6 +25,8 @@
 #include <QJsonDocument>
 
 #include <IO/Manager.h>
+#include <Misc/Alarms.h>
+#include <DSP/Statistics.h>
 #include <JSON/Generator.h>
 #include <Misc/Utilities.h>
 #include <Plugins/Server.h>
@@ -39,8 +41,6 @@ Plugins::Server::Server()
   // clang-format off
 
     // Send processed data at 1 Hz
-    connect(&JSON::Generator::instance(), &JSON::Generator::jsonChanged,
-            this, &Plugins::Server::registerFrame);
     connect(&Misc::TimerEvents::instance(), &Misc::TimerEvents::timeout1Hz,
             this, &Plugins::Server::sendProcessedData);
 
@@ -48,19 +48,15 @@ Plugins::Server::Server()
     connect(&IO::Manager::instance(), &IO::Manager::dataReceived,
             this, &Plugins::Server::sendRawData);
 
+    // Send alarm transitions directly
+    connect(&Misc::Alarms::instance(), &Misc::Alarms::eventLogged,
+            this, &Plugins::Server::sendAlarm);
+
     // Configure TCP server
     connect(&m_server, &QTcpServer::newConnection,
             this, &Plugins::Server::acceptConnection);
 
   // clang-format on
-
-  // Begin listening on TCP port
-  if (!m_server.listen(QHostAddress::Any, PLUGINS_TCP_PORT))
-  {
-    Misc::Utilities::showMessageBox(tr("Unable to start plugin TCP server"),
-                                    m_server.errorString());
-    m_server.close();
-  }
 }
 
 /**
@@ -88,6 +84,30 @@ bool Plugins::Server::enabled() const
   return m_enabled;
 }
 
+/**
+ * Returns the number of frames waiting to be sent to the connected plugins
+ */
+int Plugins::Server::pendingFrames() const
+{
+  return m_frames.count();
+}
+
+/**
+ * Returns the number of bytes that have not yet been delivered to the slowest
+ * connected plugin.
+ */
+qint64 Plugins::Server::pendingBytes() const
+{
+  qint64 bytes = 0;
+  for (const auto socket : m_sockets)
+  {
+    if (socket)
+      bytes = qMax(bytes, socket->bytesToWrite());
+  }
+
+  return bytes;
+}
+
 /**
  * Disconnects the socket used for communicating with plugins.
  */
@@ -114,17 +134,35 @@ void Plugins::Server::removeConnection()
 }
 
 /**
- * Enables/disables the plugin subsystem
+ * Enables/disables the plugin subsystem.
+ *
+ * The TCP port is only opened while the plugin subsystem is enabled.
  */
 void Plugins::Server::setEnabled(const bool enabled)
 {
+  // Begin listening on TCP port
+  if (enabled && !m_server.isListening())
+  {
+    if (!m_server.listen(QHostAddress::Any, PLUGINS_TCP_PORT))
+    {
+      Misc::Utilities::showMessageBox(tr("Unable to start plugin TCP server"),
+                                      m_server.errorString());
+      m_server.close();
+      m_enabled = false;
+      Q_EMIT enabledChanged();
+      return;
+    }
+  }
+
   // Change value
   m_enabled = enabled;
   Q_EMIT enabledChanged();
 
-  // If not enabled, remove all connections
+  // If not enabled, stop listening & remove all connections
   if (!enabled)
   {
+    m_server.close();
+
     for (int i = 0; i < m_sockets.count(); ++i)
     {
       auto socket = m_sockets.at(i);
@@ -139,6 +177,16 @@ void Plugins::Server::setEnabled(const bool enabled)
     m_sockets.clear();
   }
 
+  // Only receive JSON frames while enabled, so that the JSON generator does not
+  // need to build JSON documents for frames that nobody is going to read
+  auto generator = &JSON::Generator::instance();
+  if (enabled)
+    connect(generator, &JSON::Generator::jsonChanged, this,
+            &Plugins::Server::registerFrame, Qt::UniqueConnection);
+  else
+    disconnect(generator, &JSON::Generator::jsonChanged, this,
+               &Plugins::Server::registerFrame);
+
   // Clear frames array to avoid memory leaks
   m_frames.clear();
 }
@@ -208,6 +256,9 @@ void Plugins::Server::acceptConnection()
  * - Frame ID number
  * - RX timestamp
  * - Frame JSON data
+ *
+ * The running statistics of each dataset (min, max, mean, standard deviation
+ * & percentiles) are sent together with the frames.
  */
 void Plugins::Server::sendProcessedData()
 {
@@ -239,6 +290,11 @@ void Plugins::Server::sendProcessedData()
     // Construct QByteArray with data
     QJsonObject object;
     object.insert("frames", array);
+
+    // Add the running statistics of each dataset
+    auto statistics = &DSP::Statistics::instance();
+    if (statistics->enabled() && statistics->datasetCount() > 0)
+      object.insert("statistics", statistics->toJson());
     const QJsonDocument document(object);
     auto json = document.toJson(QJsonDocument::Compact) + "\n";
 
@@ -290,6 +346,39 @@ void Plugins::Server::sendRawData(const QByteArray &data)
   }
 }
 
+/**
+ * Sends the given alarm @a event to all connected plugins as soon as the
+ * alarm is raised or cleared.
+ */
+void Plugins::Server::sendAlarm(const QJsonObject &event)
+{
+  // Stop if system is not enabled
+  if (!enabled())
+    return;
+
+  // Stop if no sockets are available
+  if (m_sockets.count() < 1)
+    return;
+
+  // Create JSON structure with the alarm event
+  QJsonObject object;
+  object.insert("alarm", event);
+
+  // Get JSON string in compact format & send it over the TCP socket
+  QJsonDocument document(object);
+  auto json = document.toJson(QJsonDocument::Compact) + "\n";
+
+  // Send data to each plugin
+  Q_FOREACH (auto socket, m_sockets)
+  {
+    if (!socket)
+      continue;
+
+    if (socket->isWritable())
+      socket->write(json);
+  }
+}
+
 /**
  * Obtains the latest JSON dataframe & appends it to the JSON list, which is
  * later read and sent by the @c sendProcessedData() function.
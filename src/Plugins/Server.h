@@ -47,6 +47,9 @@ namespace Plugins
  * receive incoming frames processed by Serial Studio, and can write data to the
  * device by simply writting data on the TCP socket.
  *
+ * Alarm transitions are sent to the plugins as soon as they happen, using
+ * objects with the form @c {"alarm": {...}}.
+ *
  * An example of such application can be found at:
  *  https://github.com/Kaan-Sat/CC2021-Control-Panel
  *
@@ -74,6 +77,8 @@ private:
 public:
   static Server &instance();
   bool enabled() const;
+  int pendingFrames() const;
+  qint64 pendingBytes() const;
 
 public Q_SLOTS:
   void removeConnection();
@@ -84,6 +89,7 @@ private Q_SLOTS:
   void acceptConnection();
   void sendProcessedData();
   void sendRawData(const QByteArray &data);
+  void sendAlarm(const QJsonObject &event);
   void registerFrame(const QJsonObject &json);
   void onErrorOccurred(const QAbstractSocket::SocketError socketError);
 
@@ -0,0 +1,441 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <IO/Manager.h>
+#include <JSON/Generator.h>
+#include <Misc/Utilities.h>
+#include <Plugins/SharedMemory.h>
+
+#include <QDateTime>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QJsonDocument>
+
+#include <cerrno>
+#include <cstring>
+
+#ifdef Q_OS_WIN
+#  include <windows.h>
+#else
+#  include <fcntl.h>
+#  include <signal.h>
+#  include <unistd.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#endif
+
+static_assert(sizeof(Plugins::SharedMemoryHeader) == 64,
+              "Shared-memory header must fit in a single cache line");
+static_assert(std::atomic<quint64>::is_always_lock_free,
+              "Shared-memory counters must be lock-free");
+
+/**
+ * Magic number written at the beginning of the shared-memory segment
+ */
+static constexpr char kMagic[] = "SSSHMRNG";
+
+/**
+ * Record slots are aligned to cache lines, so that the writer & the readers
+ * of different slots do not share cache lines.
+ */
+static constexpr qint64 kAlignment = 64;
+
+/**
+ * Rounds the given @a size up to the next multiple of @c kAlignment
+ */
+static qint64 align(const qint64 size)
+{
+  return (size + kAlignment - 1) / kAlignment * kAlignment;
+}
+
+#ifndef Q_OS_WIN
+/**
+ * Returns @c true if the shared-memory segment with the given @a name was
+ * created by Serial Studio & its writer process no longer exists (e.g. it
+ * crashed or was killed before removing the segment).
+ *
+ * Named file mappings are removed by Windows when the last handle is closed,
+ * so this is only needed on Unix systems.
+ */
+static bool isStaleSegment(const QByteArray &name)
+{
+  const int fd = shm_open(name.constData(), O_RDONLY, 0);
+  if (fd < 0)
+    return false;
+
+  bool stale = false;
+  struct stat info;
+  const auto size = sizeof(Plugins::SharedMemoryHeader);
+  if (fstat(fd, &info) == 0 && info.st_size >= static_cast<off_t>(size))
+  {
+    void *memory = mmap(Q_NULLPTR, size, PROT_READ, MAP_SHARED, fd, 0);
+    if (memory != MAP_FAILED)
+    {
+      auto header = static_cast<const Plugins::SharedMemoryHeader *>(memory);
+      const auto pid = static_cast<pid_t>(header->writerPid);
+      if (std::memcmp(header->magic, kMagic, sizeof(header->magic)) == 0
+          && pid > 0)
+        stale = kill(pid, 0) != 0 && errno == ESRCH;
+
+      munmap(memory, size);
+    }
+  }
+
+  ::close(fd);
+  return stale;
+}
+#endif
+
+//----------------------------------------------------------------------------------------
+// Constructor/destructor & singleton access functions
+//----------------------------------------------------------------------------------------
+
+/**
+ * Constructor function
+ */
+Plugins::SharedMemory::SharedMemory()
+  : m_enabled(false)
+  , m_capacity(4096)
+  , m_name(QStringLiteral("SerialStudio"))
+  , m_handle(Q_NULLPTR)
+  , m_memory(Q_NULLPTR)
+  , m_size(0)
+  , m_records(0)
+  , m_epochUs(0)
+  , m_revision(0)
+{
+  // clang-format off
+    connect(&JSON::Generator::instance(), &JSON::Generator::frameChanged,
+            this, &Plugins::SharedMemory::registerFrame);
+    connect(&JSON::Generator::instance(), &JSON::Generator::jsonFileMapChanged,
+            this, &Plugins::SharedMemory::destroy);
+    connect(&IO::Manager::instance(), &IO::Manager::connectedChanged,
+            this, &Plugins::SharedMemory::destroy);
+  // clang-format on
+}
+
+/**
+ * Destructor function, removes the shared-memory segment
+ */
+Plugins::SharedMemory::~SharedMemory()
+{
+  destroy();
+}
+
+/**
+ * Returns the only instance of the class
+ */
+Plugins::SharedMemory &Plugins::SharedMemory::instance()
+{
+  static SharedMemory singleton;
+  return singleton;
+}
+
+//----------------------------------------------------------------------------------------
+// Member access functions
+//----------------------------------------------------------------------------------------
+
+/**
+ * Returns @c true if received frames are exported to shared memory
+ */
+bool Plugins::SharedMemory::enabled() const
+{
+  return m_enabled;
+}
+
+/**
+ * Returns the name of the shared-memory segment (without the platform
+ * specific prefix).
+ */
+QString Plugins::SharedMemory::name() const
+{
+  return m_name;
+}
+
+/**
+ * Returns the number of record slots of the ring buffer
+ */
+int Plugins::SharedMemory::capacity() const
+{
+  return m_capacity;
+}
+
+/**
+ * Enables or disables the shared-memory output. The segment is created when
+ * the next frame is received, since its schema depends on the frame
+ * structure.
+ */
+void Plugins::SharedMemory::setEnabled(const bool enabled)
+{
+  m_enabled = enabled;
+  if (!enabled)
+    destroy();
+
+  Q_EMIT enabledChanged();
+}
+
+/**
+ * Changes the name of the shared-memory segment, the segment is re-created
+ * with the new name when the next frame is received.
+ */
+void Plugins::SharedMemory::setName(const QString &name)
+{
+  m_name = name.trimmed();
+  if (m_name.isEmpty())
+    m_name = QStringLiteral("SerialStudio");
+
+  destroy();
+  Q_EMIT nameChanged();
+}
+
+/**
+ * Changes the number of record slots, the value is rounded up to the next
+ * power of two so that readers can find the slot of a record with a mask.
+ */
+void Plugins::SharedMemory::setCapacity(const int capacity)
+{
+  int slots = kMinCapacity;
+  while (slots < capacity && slots < kMaxCapacity)
+    slots *= 2;
+
+  m_capacity = slots;
+  destroy();
+  Q_EMIT capacityChanged();
+}
+
+//----------------------------------------------------------------------------------------
+// Ring buffer implementation
+//----------------------------------------------------------------------------------------
+
+/**
+ * Writes the values of the given @a frame to the next record slot. The segment
+ * is re-created when the structure revision of the frame changes.
+ */
+void Plugins::SharedMemory::registerFrame(const JSON::Frame &frame)
+{
+  // Shared memory output disabled
+  if (!m_enabled)
+    return;
+
+  // Check if the structure of the frame changed
+  const bool changed = !m_memory || frame.revision() != m_revision;
+
+  // Re-create the segment with the new schema
+  if (changed && !create(frame))
+    return;
+
+  // Obtain the slot of the record
+  auto header = reinterpret_cast<SharedMemoryHeader *>(m_memory);
+  const auto index = m_records & (header->slotCount - 1);
+  const auto offset = header->headerSize + index * header->slotSize;
+  auto slot = reinterpret_cast<SharedMemorySlot *>(m_memory + offset);
+  auto values = reinterpret_cast<double *>(slot + 1);
+
+  // Mark the slot as being written
+  slot->sequence.store(2 * m_records + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  // Write the record
+  slot->timestamp = m_epochUs + m_clock.nsecsElapsed() / 1000;
+  for (int i = 0; i < frame.groupCount(); ++i)
+  {
+    const auto &group = frame.getGroup(i);
+    for (int j = 0; j < group.datasetCount(); ++j)
+    {
+      const auto &dataset = group.getDataset(j);
+      *values++ = dataset.isNumeric() ? dataset.numericValue() : qQNaN();
+    }
+  }
+
+  // Publish the record
+  ++m_records;
+  slot->sequence.store(2 * m_records, std::memory_order_release);
+  header->writeIndex.store(m_records, std::memory_order_release);
+}
+
+/**
+ * Marks the current segment as closed (so that readers open the new one) &
+ * removes it.
+ */
+void Plugins::SharedMemory::destroy()
+{
+  m_revision = 0;
+  if (!m_memory)
+    return;
+
+  auto header = reinterpret_cast<SharedMemoryHeader *>(m_memory);
+  header->closed.store(1, std::memory_order_release);
+
+#ifdef Q_OS_WIN
+  UnmapViewOfFile(m_memory);
+  CloseHandle(static_cast<HANDLE>(m_handle));
+#else
+  munmap(m_memory, static_cast<size_t>(m_size));
+  shm_unlink(m_segmentName.toUtf8().constData());
+#endif
+
+  m_size = 0;
+  m_records = 0;
+  m_handle = Q_NULLPTR;
+  m_memory = Q_NULLPTR;
+}
+
+/**
+ * Creates the shared-memory segment with the schema of the given @a frame &
+ * writes its header.
+ *
+ * @returns @c false if the segment cannot be created, in which case the
+ *          output is disabled.
+ */
+bool Plugins::SharedMemory::create(const JSON::Frame &frame)
+{
+  // Remove previous segment
+  destroy();
+
+  // Build the schema & register the structure revision of the frame
+  QJsonArray datasets;
+  m_revision = frame.revision();
+  for (int i = 0; i < frame.groupCount(); ++i)
+  {
+    const auto &group = frame.getGroup(i);
+    for (int j = 0; j < group.datasetCount(); ++j)
+    {
+      const auto &dataset = group.getDataset(j);
+      QJsonObject object;
+      object.insert(QStringLiteral("group"), group.title());
+      object.insert(QStringLiteral("title"), dataset.title());
+      object.insert(QStringLiteral("units"), dataset.units());
+      object.insert(QStringLiteral("index"), dataset.index());
+      datasets.append(object);
+    }
+  }
+
+  QJsonObject schema;
+  schema.insert(QStringLiteral("title"), frame.title());
+  schema.insert(QStringLiteral("datasets"), datasets);
+  const auto json = QJsonDocument(schema).toJson(QJsonDocument::Compact);
+
+  // Calculate the size of the segment
+  const qint64 values = datasets.count();
+  const qint64 headerSize = sizeof(SharedMemoryHeader) + json.size();
+  const auto slotSize = align(sizeof(SharedMemorySlot) + values * 8);
+  const auto dataOffset = align(headerSize);
+  m_size = dataOffset + slotSize * m_capacity;
+
+  // Create & map the segment, never take over a segment that already exists
+  // (unless its writer no longer exists)
+  bool exists = false;
+#ifdef Q_OS_WIN
+  m_segmentName = QStringLiteral("Local\\") + m_name;
+  const auto name = reinterpret_cast<LPCWSTR>(m_segmentName.utf16());
+  const auto high = static_cast<DWORD>(static_cast<quint64>(m_size) >> 32);
+  const auto low = static_cast<DWORD>(m_size & 0xffffffff);
+  auto handle = CreateFileMappingW(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE,
+                                   high, low, name);
+  if (handle && GetLastError() == ERROR_ALREADY_EXISTS)
+  {
+    exists = true;
+    CloseHandle(handle);
+  }
+
+  else if (handle)
+  {
+    m_handle = handle;
+    m_memory = static_cast<char *>(
+        MapViewOfFile(handle, FILE_MAP_ALL_ACCESS, 0, 0, SIZE_T(m_size)));
+    if (!m_memory)
+      CloseHandle(handle);
+  }
+#else
+  m_segmentName = QStringLiteral("/") + m_name;
+  const auto name = m_segmentName.toUtf8();
+  int fd = shm_open(name.constData(), O_CREAT | O_EXCL | O_RDWR, 0600);
+  if (fd < 0 && errno == EEXIST && isStaleSegment(name))
+  {
+    shm_unlink(name.constData());
+    fd = shm_open(name.constData(), O_CREAT | O_EXCL | O_RDWR, 0600);
+  }
+
+  if (fd < 0 && errno == EEXIST)
+    exists = true;
+
+  else if (fd >= 0)
+  {
+    if (ftruncate(fd, static_cast<off_t>(m_size)) == 0)
+    {
+      void *memory = mmap(Q_NULLPTR, static_cast<size_t>(m_size),
+                          PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+      if (memory != MAP_FAILED)
+        m_memory = static_cast<char *>(memory);
+    }
+
+    ::close(fd);
+    if (!m_memory)
+      shm_unlink(name.constData());
+  }
+#endif
+
+  // Disable the output if the segment cannot be created
+  if (!m_memory)
+  {
+    m_size = 0;
+    m_revision = 0;
+    m_handle = Q_NULLPTR;
+    setEnabled(false);
+    if (exists)
+      Misc::Utilities::showMessageBox(
+          tr("Shared memory error"),
+          tr("Shared-memory segment \"%1\" is already used by another "
+             "application, choose another name")
+              .arg(m_segmentName));
+    else
+      Misc::Utilities::showMessageBox(
+          tr("Shared memory error"),
+          tr("Cannot create shared-memory segment \"%1\"").arg(m_segmentName));
+
+    return false;
+  }
+
+  // Write the header & schema, the segment is zero-filled by the system
+  auto header = reinterpret_cast<SharedMemoryHeader *>(m_memory);
+  std::memcpy(header->magic, kMagic, sizeof(header->magic));
+  header->version = kVersion;
+  header->headerSize = static_cast<quint32>(dataOffset);
+  header->slotSize = static_cast<quint32>(slotSize);
+  header->slotCount = static_cast<quint32>(m_capacity);
+  header->valueCount = static_cast<quint32>(values);
+  header->schemaSize = static_cast<quint32>(json.size());
+#ifdef Q_OS_WIN
+  header->writerPid = static_cast<quint32>(GetCurrentProcessId());
+#else
+  header->writerPid = static_cast<quint32>(getpid());
+#endif
+  std::memcpy(m_memory + sizeof(SharedMemoryHeader), json.constData(),
+              json.size());
+  header->writeIndex.store(0, std::memory_order_release);
+
+  // Reset the record counter & the timestamp reference
+  m_records = 0;
+  m_clock.start();
+  m_epochUs = QDateTime::currentMSecsSinceEpoch() * 1000;
+  return true;
+}
@@ -0,0 +1,171 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <QObject>
+#include <QVector>
+#include <QElapsedTimer>
+
+#include <atomic>
+
+#include <JSON/Frame.h>
+
+namespace Plugins
+{
+/**
+ * @brief The SharedMemoryHeader struct
+ *
+ * Header at the beginning of the shared-memory segment. A JSON document that
+ * describes the schema of the records (project title, plus the group, title,
+ * units & index of each dataset) follows the header, and the record slots
+ * start at @c headerSize bytes from the beginning of the segment.
+ *
+ * @c writerPid is the process ID of the writer, used to reclaim segments that
+ * were left behind by a writer that crashed or was killed.
+ */
+struct SharedMemoryHeader
+{
+  char magic[8];
+  quint32 version;
+  quint32 headerSize;
+  quint32 slotSize;
+  quint32 slotCount;
+  quint32 valueCount;
+  quint32 schemaSize;
+  std::atomic<quint32> closed;
+  quint32 writerPid;
+  std::atomic<quint64> writeIndex;
+  char padding[16];
+};
+
+/**
+ * @brief The SharedMemorySlot struct
+ *
+ * Header of each record slot, followed by @c valueCount doubles (in the order
+ * of the schema). Non-numeric values are stored as NaN.
+ */
+struct SharedMemorySlot
+{
+  std::atomic<quint64> sequence;
+  qint64 timestamp;
+};
+
+/**
+ * @brief The SharedMemory class
+ *
+ * Optional output that exports every received frame to a shared-memory ring
+ * buffer, so that local processes (Python, MATLAB, C++ controllers...) can
+ * read the parsed dataset values without the JSON encoding & TCP copies of
+ * the plugin server.
+ *
+ * Each frame is written as a fixed-size binary record (timestamp in
+ * microseconds since the epoch & one double per dataset) to slot
+ * @c n % slotCount, where @c n is the record number. Every slot is protected
+ * by a sequence counter (seqlock):
+ *
+ * - The writer sets the sequence to @c 2n+1, writes the record, sets the
+ *   sequence to @c 2n+2 & then sets @c writeIndex to @c n+1.
+ * - Readers poll @c writeIndex, copy the slot of record @c n & accept the
+ *   copy only if the sequence equals @c 2n+2 before and after copying. A
+ *   larger sequence means that the reader was overtaken by the writer, and
+ *   that it should skip to @c writeIndex - slotCount.
+ *
+ * The writer never waits for readers, so slow consumers cannot stall data
+ * ingestion. When the structure of the frames changes, the project changes or
+ * the device is connected/disconnected, the segment is marked as @c closed &
+ * re-created with the new schema; readers must then release their mapping &
+ * open the segment again.
+ *
+ * The segment is created with @c shm_open() (name "/<name>") on Unix systems
+ * and as a named file mapping ("Local\<name>") on Windows.
+ */
+class SharedMemory : public QObject
+{
+  // clang-format off
+    Q_OBJECT
+    Q_PROPERTY(bool enabled
+               READ enabled
+               WRITE setEnabled
+               NOTIFY enabledChanged)
+    Q_PROPERTY(QString name
+               READ name
+               WRITE setName
+               NOTIFY nameChanged)
+    Q_PROPERTY(int capacity
+               READ capacity
+               WRITE setCapacity
+               NOTIFY capacityChanged)
+  // clang-format on
+
+Q_SIGNALS:
+  void nameChanged();
+  void enabledChanged();
+  void capacityChanged();
+
+private:
+  explicit SharedMemory();
+  SharedMemory(SharedMemory &&) = delete;
+  SharedMemory(const SharedMemory &) = delete;
+  SharedMemory &operator=(SharedMemory &&) = delete;
+  SharedMemory &operator=(const SharedMemory &) = delete;
+
+  ~SharedMemory();
+
+public:
+  static SharedMemory &instance();
+
+  static constexpr quint32 kVersion = 1;
+  static constexpr int kMinCapacity = 16;
+  static constexpr int kMaxCapacity = 1 << 20;
+
+  bool enabled() const;
+  QString name() const;
+  int capacity() const;
+
+public Q_SLOTS:
+  void setEnabled(const bool enabled);
+  void setName(const QString &name);
+  void setCapacity(const int capacity);
+
+private Q_SLOTS:
+  void destroy();
+  void registerFrame(const JSON::Frame &frame);
+
+private:
+  bool create(const JSON::Frame &frame);
+
+private:
+  bool m_enabled;
+  int m_capacity;
+  QString m_name;
+  QString m_segmentName;
+
+  void *m_handle;
+  char *m_memory;
+  qint64 m_size;
+  quint64 m_records;
+  qint64 m_epochUs;
+  QElapsedTimer m_clock;
+  quint64 m_revision;
+};
+} // namespace Plugins
@@ -22,6 +22,7 @@
 
 #include "CodeEditor.h"
 #include "Model.h"
+#include "FrameParser.h"
 
 #include <QFile>
 #include <QJSEngine>
@@ -35,8 +36,8 @@ Project::CodeEditor::CodeEditor()
   m_highlighter = new QSourceHighlite::QSourceHighliter(m_textEdit.document());
   m_highlighter->setCurrentLanguage(QSourceHighlite::QSourceHighliter::CodeJs);
 
-  // Setup text editor
-  onNewClicked();
+  // Setup text editor (editor is created on demand, so load the project code)
+  readCode();
   m_textEdit.setFont(QFont("Roboto Mono"));
 
   // Setup toolbar
@@ -111,34 +112,7 @@ Project::CodeEditor &Project::CodeEditor::instance()
 
 QString Project::CodeEditor::defaultCode() const
 {
-  QString code;
-  QFile file(":/scripts/frame-parser.js");
-  if (file.open(QFile::ReadOnly))
-  {
-    code = QString::fromUtf8(file.readAll());
-    file.close();
-  }
-
-  return code;
-}
-
-QStringList Project::CodeEditor::parse(const QString &frame,
-                                       const QString &separator)
-{
-  // Construct function arguments
-  QJSValueList args;
-  args << frame << separator;
-
-  // Evaluate frame parsing function
-  auto out = m_parseFunction.call(args).toVariant().toList();
-
-  // Convert output to QStringList
-  QStringList list;
-  for (auto i = 0; i < out.count(); ++i)
-    list.append(out.at(i).toString());
-
-  // Return fields list
-  return list;
+  return FrameParser::instance().defaultCode();
 }
 
 void Project::CodeEditor::displayWindow()
@@ -229,73 +203,7 @@ bool Project::CodeEditor::save(const bool silent)
 
 bool Project::CodeEditor::loadScript(const QString &script)
 {
-  // Check if there are no general JS errors
-  QStringList errors;
-  m_engine.evaluate(script, "", 1, &errors);
-
-  // Check if parse() function exists
-  auto fun = m_engine.globalObject().property("parse");
-  if (fun.isNull() || !fun.isCallable())
-  {
-    Misc::Utilities::showMessageBox(
-        tr("Frame parser error!"),
-        tr("No parse() function has been declared!"));
-    return false;
-  }
-
-  // Try to run parse() function
-  QJSValueList args = {"", ","};
-  auto ret = fun.call(args);
-
-  // Error on engine evaluation
-  if (!errors.isEmpty())
-  {
-    Misc::Utilities::showMessageBox(
-        tr("Frame parser syntax error!"),
-        tr("Error on line %1.").arg(errors.first()));
-    return false;
-  }
-
-  // Error on function execution
-  else if (ret.isError())
-  {
-    QString errorStr;
-    switch (ret.errorType())
-    {
-      case QJSValue::GenericError:
-        errorStr = tr("Generic error");
-        break;
-      case QJSValue::EvalError:
-        errorStr = tr("Evaluation error");
-        break;
-      case QJSValue::RangeError:
-        errorStr = tr("Range error");
-        break;
-      case QJSValue::ReferenceError:
-        errorStr = tr("Reference error");
-        break;
-      case QJSValue::SyntaxError:
-        errorStr = tr("Syntax error");
-        break;
-      case QJSValue::TypeError:
-        errorStr = tr("Type error");
-        break;
-      case QJSValue::URIError:
-        errorStr = tr("URI error");
-        break;
-      default:
-        errorStr = tr("Unknown error");
-        break;
-    }
-
-    Misc::Utilities::showMessageBox(tr("Frame parser error detected!"),
-                                    errorStr);
-    return false;
-  }
-
-  // We have reached this point without any errors, set function caller
-  m_parseFunction = fun;
-  return true;
+  return FrameParser::instance().loadScript(script);
 }
 
 void Project::CodeEditor::closeEvent(QCloseEvent *event)
@@ -332,9 +240,12 @@ void Project::CodeEditor::closeEvent(QCloseEvent *event)
 
 void Project::CodeEditor::readCode()
 {
-  m_textEdit.setPlainText(Model::instance().frameParserCode());
+  auto code = Model::instance().frameParserCode();
+  if (code.isEmpty())
+    code = defaultCode();
+
+  m_textEdit.setPlainText(code);
   m_textEdit.document()->setModified(false);
-  loadScript(m_textEdit.toPlainText());
 }
 
 void Project::CodeEditor::writeChanges()
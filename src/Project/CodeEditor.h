@@ -30,9 +30,6 @@
 #include <QPushButton>
 #include <QPlainTextEdit>
 
-#include <QJSValue>
-#include <QJSEngine>
-
 #include <QSourceHighlite/qsourcehighliter.h>
 
 namespace Project
@@ -52,7 +49,6 @@ private:
 public:
   static CodeEditor &instance();
   QString defaultCode() const;
-  QStringList parse(const QString &frame, const QString &separator);
 
 public Q_SLOTS:
   void displayWindow();
@@ -74,9 +70,7 @@ private slots:
   void writeChanges();
 
 private:
-  QJSEngine m_engine;
   QToolBar m_toolbar;
-  QJSValue m_parseFunction;
   QPlainTextEdit m_textEdit;
   QSourceHighlite::QSourceHighliter *m_highlighter;
 };
@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <QObject>
+
+namespace Project
+{
+/**
+ * @brief The CodeEditorProxy class
+ *
+ * Lightweight object that is registered with QML in place of the frame parser
+ * code editor. The editor (and its syntax highlighter) is only constructed
+ * when the user opens it for the first time.
+ */
+class CodeEditorProxy : public QObject
+{
+  Q_OBJECT
+
+private:
+  explicit CodeEditorProxy() = default;
+  CodeEditorProxy(CodeEditorProxy &&) = delete;
+  CodeEditorProxy(const CodeEditorProxy &) = delete;
+  CodeEditorProxy &operator=(CodeEditorProxy &&) = delete;
+  CodeEditorProxy &operator=(const CodeEditorProxy &) = delete;
+
+public:
+  static CodeEditorProxy &instance();
+
+public Q_SLOTS:
+  void displayWindow();
+};
+} // namespace Project
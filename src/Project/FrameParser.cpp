@@ -0,0 +1,180 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "Model.h"
+#include "FrameParser.h"
+
+#include <QFile>
+#include <Misc/Utilities.h>
+#include <Misc/Instrumentation.h>
+
+/**
+ * Constructor function, loads the frame parser code of the current project
+ * and reloads it automatically when the project changes.
+ */
+Project::FrameParser::FrameParser()
+{
+  connect(&Model::instance(), &Model::frameParserCodeChanged, this,
+          &Project::FrameParser::readCode);
+
+  readCode();
+}
+
+/**
+ * Returns the only instance of the class
+ */
+Project::FrameParser &Project::FrameParser::instance()
+{
+  static FrameParser singleton;
+  return singleton;
+}
+
+/**
+ * Returns the default frame parser code, which splits the frame using the
+ * separator sequence.
+ */
+QString Project::FrameParser::defaultCode() const
+{
+  QString code;
+  QFile file(":/scripts/frame-parser.js");
+  if (file.open(QFile::ReadOnly))
+  {
+    code = QString::fromUtf8(file.readAll());
+    file.close();
+  }
+
+  return code;
+}
+
+/**
+ * Calls the parse() function of the frame parser code with the given
+ * @a frame & @a separator and returns the list of fields.
+ */
+QStringList Project::FrameParser::parse(const QString &frame,
+                                        const QString &separator)
+{
+  // Measure time spent in the JavaScript code
+  Misc::Instrumentation::ScopedTimer timer(Misc::Instrumentation::FrameParser);
+
+  // Construct function arguments
+  QJSValueList args;
+  args << frame << separator;
+
+  // Evaluate frame parsing function
+  auto out = m_parseFunction.call(args).toVariant().toList();
+
+  // Convert output to QStringList
+  QStringList list;
+  for (auto i = 0; i < out.count(); ++i)
+    list.append(out.at(i).toString());
+
+  // Return fields list
+  return list;
+}
+
+/**
+ * Evaluates the given @a script and, if no errors are found, uses its parse()
+ * function to split incoming frames. Errors are reported to the user and the
+ * previous parse() function is kept.
+ */
+bool Project::FrameParser::loadScript(const QString &script)
+{
+  // Check if there are no general JS errors
+  QStringList errors;
+  m_engine.evaluate(script, "", 1, &errors);
+
+  // Check if parse() function exists
+  auto fun = m_engine.globalObject().property("parse");
+  if (fun.isNull() || !fun.isCallable())
+  {
+    Misc::Utilities::showMessageBox(
+        tr("Frame parser error!"),
+        tr("No parse() function has been declared!"));
+    return false;
+  }
+
+  // Try to run parse() function
+  QJSValueList args = {"", ","};
+  auto ret = fun.call(args);
+
+  // Error on engine evaluation
+  if (!errors.isEmpty())
+  {
+    Misc::Utilities::showMessageBox(
+        tr("Frame parser syntax error!"),
+        tr("Error on line %1.").arg(errors.first()));
+    return false;
+  }
+
+  // Error on function execution
+  else if (ret.isError())
+  {
+    QString errorStr;
+    switch (ret.errorType())
+    {
+      case QJSValue::GenericError:
+        errorStr = tr("Generic error");
+        break;
+      case QJSValue::EvalError:
+        errorStr = tr("Evaluation error");
+        break;
+      case QJSValue::RangeError:
+        errorStr = tr("Range error");
+        break;
+      case QJSValue::ReferenceError:
+        errorStr = tr("Reference error");
+        break;
+      case QJSValue::SyntaxError:
+        errorStr = tr("Syntax error");
+        break;
+      case QJSValue::TypeError:
+        errorStr = tr("Type error");
+        break;
+      case QJSValue::URIError:
+        errorStr = tr("URI error");
+        break;
+      default:
+        errorStr = tr("Unknown error");
+        break;
+    }
+
+    Misc::Utilities::showMessageBox(tr("Frame parser error detected!"),
+                                    errorStr);
+    return false;
+  }
+
+  // We have reached this point without any errors, set function caller
+  m_parseFunction = fun;
+  return true;
+}
+
+/**
+ * Loads the frame parser code of the current project
+ */
+void Project::FrameParser::readCode()
+{
+  auto code = Model::instance().frameParserCode();
+  if (code.isEmpty())
+    code = defaultCode();
+
+  loadScript(code);
+}
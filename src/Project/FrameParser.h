@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <QObject>
+#include <QJSValue>
+#include <QJSEngine>
+#include <QStringList>
+
+namespace Project
+{
+/**
+ * @brief The FrameParser class
+ *
+ * Evaluates the JavaScript frame parser code of the current project and uses
+ * it to split incoming frames into individual fields.
+ *
+ * This class does not depend on any widget code, so that frames can be parsed
+ * when Serial Studio runs without a graphical user interface. The code editor
+ * dialog uses this class to validate & apply user changes.
+ */
+class FrameParser : public QObject
+{
+  Q_OBJECT
+
+private:
+  explicit FrameParser();
+  FrameParser(FrameParser &&) = delete;
+  FrameParser(const FrameParser &) = delete;
+  FrameParser &operator=(FrameParser &&) = delete;
+  FrameParser &operator=(const FrameParser &) = delete;
+
+public:
+  static FrameParser &instance();
+
+  QString defaultCode() const;
+  QStringList parse(const QString &frame, const QString &separator);
+
+public Q_SLOTS:
+  bool loadScript(const QString &script);
+
+private Q_SLOTS:
+  void readCode();
+
+private:
+  QJSEngine m_engine;
+  QJSValue m_parseFunction;
+};
+} // namespace Project
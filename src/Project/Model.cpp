@@ -21,7 +21,7 @@
  */
 
 #include "Model.h"
-#include "CodeEditor.h"
+#include "FrameParser.h"
 
 #include <QFile>
 #include <QFileInfo>
@@ -31,9 +31,11 @@
 #include <QJsonDocument>
 
 #include <AppInfo.h>
+#include <DSP/Filter.h>
 #include <IO/Manager.h>
 #include <JSON/Generator.h>
 #include <Misc/Utilities.h>
+#include <JSON/Expression.h>
 
 //
 // For invalid group returns, avoids crashes while creating a new project & the
@@ -123,6 +125,17 @@ StringList Project::Model::availableDatasetLevelWidgets()
   return StringList{tr("None"), tr("Gauge"), tr("Bar/level"), tr("Compass")};
 }
 
+/**
+ * Returns a list with the available alarm conditions of a dataset. The order
+ * of this list is used by the @c setDatasetAlarmMode() function.
+ */
+StringList Project::Model::availableAlarmModes()
+{
+  return StringList{tr("None"), tr("Above alarm level"),
+                    tr("Below low alarm level"), tr("Outside of band"),
+                    tr("Rate of change")};
+}
+
 /**
  * Returns the default path for saving JSON project files
  */
@@ -347,9 +360,17 @@ bool Project::Model::saveJsonFile()
       dataset.insert("units", datasetUnits(i, j));
       dataset.insert("graph", datasetGraph(i, j));
       dataset.insert("widget", datasetWidget(i, j));
+      dataset.insert("waterfall", datasetWaterfall(i, j));
+      dataset.insert("expression", datasetExpression(i, j));
+      dataset.insert("filter", datasetFilter(i, j));
       dataset.insert("min", datasetWidgetMin(i, j).toDouble());
       dataset.insert("max", datasetWidgetMax(i, j).toDouble());
       dataset.insert("alarm", datasetWidgetAlarm(i, j).toDouble());
+      dataset.insert("alarmMode", datasetAlarmMode(i, j));
+      dataset.insert("alarmLow", datasetAlarmLow(i, j).toDouble());
+      dataset.insert("alarmDebounce", datasetAlarmDebounce(i, j).toInt());
+      dataset.insert("alarmHysteresis",
+                     datasetAlarmHysteresis(i, j).toDouble());
       dataset.insert("fftSamples", datasetFFTSamples(i, j).toInt());
       dataset.insert("index", datasetIndex(i, j));
       dataset.insert("value", "");
@@ -515,6 +536,18 @@ bool Project::Model::datasetLogPlot(const int group, const int dataset) const
   return getDataset(group, dataset).log();
 }
 
+/**
+ * Returns @c true if Serial Studio should display the spectrum of the given
+ * @a dataset (which is contained by the specified @a group) over time.
+ *
+ * @param group   index of the group in which the dataset belongs
+ * @param dataset index of the dataset
+ */
+bool Project::Model::datasetWaterfall(const int group, const int dataset) const
+{
+  return getDataset(group, dataset).waterfall();
+}
+
 /**
  * Returns the title of the specified dataset.
  *
@@ -537,6 +570,84 @@ QString Project::Model::datasetUnits(const int group, const int dataset) const
   return getDataset(group, dataset).units();
 }
 
+/**
+ * Returns the math expression used to compute the value of the specified
+ * dataset, or an empty string if the value is read from the frame.
+ *
+ * @param group   index of the group in which the dataset belongs
+ * @param dataset index of the dataset
+ */
+QString Project::Model::datasetExpression(const int group,
+                                          const int dataset) const
+{
+  return getDataset(group, dataset).expression();
+}
+
+/**
+ * Compiles the math expression of the specified dataset and returns a
+ * description of the syntax error or of the first reference to a dataset that
+ * does not exist (if any), so that the user can fix it before saving the
+ * project.
+ *
+ * @param group   index of the group in which the dataset belongs
+ * @param dataset index of the dataset
+ */
+QString Project::Model::datasetExpressionError(const int group,
+                                               const int dataset) const
+{
+  const auto source = datasetExpression(group, dataset);
+  if (source.trimmed().isEmpty())
+    return "";
+
+  JSON::Expression expression;
+  if (!expression.compile(source))
+    return expression.error();
+
+  int g, d;
+  const auto references = expression.references();
+  for (const auto &reference : references)
+  {
+    if (!JSON::Expression::findDataset(reference, m_groups, &g, &d))
+      return tr("Unknown dataset \"%1\"").arg(reference);
+  }
+
+  return "";
+}
+
+/**
+ * Returns the specification of the filters applied to the specified dataset,
+ * or an empty string if the dataset is not filtered.
+ *
+ * @param group   index of the group in which the dataset belongs
+ * @param dataset index of the dataset
+ */
+QString Project::Model::datasetFilter(const int group, const int dataset) const
+{
+  return getDataset(group, dataset).filter();
+}
+
+/**
+ * Compiles the filter specification of the specified dataset and returns a
+ * description of the error (if any), so that the user can fix it before
+ * saving the project.
+ *
+ * @param group   index of the group in which the dataset belongs
+ * @param dataset index of the dataset
+ */
+QString Project::Model::datasetFilterError(const int group,
+                                           const int dataset) const
+{
+  const auto spec = datasetFilter(group, dataset);
+  if (spec.trimmed().isEmpty())
+    return "";
+
+  DSP::FilterChain chain;
+  if (chain.compile(spec, 1))
+    return "";
+
+  return chain.error();
+}
+
 /**
  * Returns the widget string of the specified dataset.
  *
@@ -620,12 +731,92 @@ QString Project::Model::datasetWidgetAlarm(const int group,
 {
   auto set = getDataset(group, dataset);
 
-  if (set.alarm() <= set.min())
+  if (set.alarm() <= set.min() && set.alarmMode() != "rate")
     return QString::number(set.max());
 
   return QString::number(set.alarm());
 }
 
+/**
+ * Returns the alarm condition string of the specified dataset ("none",
+ * "above", "below", "band" or "rate").
+ *
+ * @param group   index of the group in which the dataset belongs
+ * @param dataset index of the dataset
+ */
+QString Project::Model::datasetAlarmMode(const int group,
+                                         const int dataset) const
+{
+  const auto mode = getDataset(group, dataset).alarmMode();
+  if (mode.isEmpty())
+    return "none";
+
+  return mode;
+}
+
+/**
+ * Returns the alarm condition ID of the specified dataset. The ID corresponds
+ * to the list returned by the @c availableAlarmModes() function.
+ *
+ * @param group   index of the group in which the dataset belongs
+ * @param dataset index of the dataset
+ */
+int Project::Model::datasetAlarmModeIndex(const int group,
+                                          const int dataset) const
+{
+  auto mode = datasetAlarmMode(group, dataset);
+
+  if (mode == "above")
+    return 1;
+  if (mode == "below")
+    return 2;
+  if (mode == "band")
+    return 3;
+  if (mode == "rate")
+    return 4;
+
+  return 0;
+}
+
+/**
+ * Returns the low alarm level of the specified dataset, used by the "below"
+ * & "band" alarm conditions.
+ *
+ * @param group   index of the group in which the dataset belongs
+ * @param dataset index of the dataset
+ */
+QString Project::Model::datasetAlarmLow(const int group,
+                                        const int dataset) const
+{
+  return QString::number(getDataset(group, dataset).alarmLow());
+}
+
+/**
+ * Returns the margin that the value of the specified dataset must go back
+ * past the alarm level before the alarm is cleared.
+ *
+ * @param group   index of the group in which the dataset belongs
+ * @param dataset index of the dataset
+ */
+QString Project::Model::datasetAlarmHysteresis(const int group,
+                                               const int dataset) const
+{
+  return QString::number(getDataset(group, dataset).alarmHysteresis());
+}
+
+/**
+ * Returns the number of consecutive frames required to raise or clear the
+ * alarm of the specified dataset.
+ *
+ * @param group   index of the group in which the dataset belongs
+ * @param dataset index of the dataset
+ */
+QString Project::Model::datasetAlarmDebounce(const int group,
+                                             const int dataset) const
+{
+  return QString::number(getDataset(group, dataset).alarmDebounce());
+}
+
 //----------------------------------------------------------------------------------------
 // Public slots
 //----------------------------------------------------------------------------------------
@@ -746,8 +937,11 @@ void Project::Model::openJsonFile(const QString &path)
       setDatasetFftPlot(g, d, dataset.value("fft").toBool());
       setDatasetLogPlot(g, d, dataset.value("log").toBool());
       setDatasetGraph(g, d, dataset.value("graph").toBool());
+      setDatasetWaterfall(g, d, dataset.value("waterfall").toBool());
       setDatasetTitle(g, d, dataset.value("title").toString());
       setDatasetUnits(g, d, dataset.value("units").toString());
+      setDatasetExpression(g, d, dataset.value("expression").toString());
+      setDatasetFilter(g, d, dataset.value("filter").toString());
       setDatasetWidgetData(g, d, dataset.value("widget").toString());
 
       // Get max/min texts
@@ -760,8 +954,20 @@ void Project::Model::openJsonFile(const QString &path)
       setDatasetWidgetMin(g, d, QString::number(min));
       setDatasetWidgetMax(g, d, QString::number(max));
       setDatasetWidgetAlarm(g, d, QString::number(alarm));
-      ;
       setDatasetFFTSamples(g, d, QString::number(fftSamples));
+
+      // Get alarm condition, older projects only had an alarm level
+      auto alarmMode = dataset.value("alarmMode").toString();
+      if (!dataset.contains("alarmMode"))
+        alarmMode = alarm > 0 ? "above" : "none";
+
+      auto alarmLow = dataset.value("alarmLow").toDouble();
+      auto debounce = dataset.value("alarmDebounce").toInt(1);
+      auto hysteresis = dataset.value("alarmHysteresis").toDouble();
+      setDatasetAlarmModeData(g, d, alarmMode);
+      setDatasetAlarmLow(g, d, QString::number(alarmLow));
+      setDatasetAlarmDebounce(g, d, QString::number(debounce));
+      setDatasetAlarmHysteresis(g, d, QString::number(hysteresis));
     }
   }
 
@@ -808,7 +1014,7 @@ void Project::Model::setFrameParserCode(const QString &code)
 
     // Load default code if required
     if (m_frameParserCode.isEmpty())
-      m_frameParserCode = CodeEditor::instance().defaultCode();
+      m_frameParserCode = FrameParser::instance().defaultCode();
 
     // Update UI
     Q_EMIT frameParserCodeChanged();
@@ -1160,6 +1366,59 @@ void Project::Model::setDatasetUnits(const int group, const int dataset,
   }
 }
 
+/**
+ * Updates the math @a expression used to compute the value of the given
+ * @a dataset. An empty expression means that the value is read from the
+ * frame.
+ *
+ * @param group   index of the group in which the dataset belongs
+ * @param dataset index of the dataset
+ */
+void Project::Model::setDatasetExpression(const int group, const int dataset,
+                                          const QString &expression)
+{
+  // Get dataset & group
+  auto grp = getGroup(group);
+  auto set = getDataset(group, dataset);
+
+  // Update dataset & group
+  if (set.m_expression != expression)
+  {
+    set.m_expression = expression;
+    grp.m_datasets.replace(dataset, set);
+    m_groups.replace(group, grp);
+
+    // Update UI
+    Q_EMIT datasetChanged(group, dataset);
+  }
+}
+
+/**
+ * Updates the specification of the @a filter applied to the given
+ * @a dataset. An empty specification means that the value is not filtered.
+ *
+ * @param group   index of the group in which the dataset belongs
+ * @param dataset index of the dataset
+ */
+void Project::Model::setDatasetFilter(const int group, const int dataset,
+                                      const QString &filter)
+{
+  // Get dataset & group
+  auto grp = getGroup(group);
+  auto set = getDataset(group, dataset);
+
+  // Update dataset & group
+  if (set.m_filter != filter)
+  {
+    set.m_filter = filter;
+    grp.m_datasets.replace(dataset, set);
+    m_groups.replace(group, grp);
+
+    // Update UI
+    Q_EMIT datasetChanged(group, dataset);
+  }
+}
+
 /**
  * Updates the @a frameIndex of the given @a dataset.
  *
@@ -1285,6 +1544,31 @@ void Project::Model::setDatasetLogPlot(const int group, const int dataset,
   }
 }
 
+/**
+ * Updates the @a generateWaterfall flag of the given @a dataset.
+ *
+ * @param group   index of the group in which the dataset belongs
+ * @param dataset index of the dataset
+ */
+void Project::Model::setDatasetWaterfall(const int group, const int dataset,
+                                         const bool generateWaterfall)
+{
+  // Get dataset & group
+  auto grp = getGroup(group);
+  auto set = getDataset(group, dataset);
+
+  // Update dataset & group
+  if (set.m_waterfall != generateWaterfall)
+  {
+    set.m_waterfall = generateWaterfall;
+    grp.m_datasets.replace(dataset, set);
+    m_groups.replace(group, grp);
+
+    // Update UI
+    Q_EMIT datasetChanged(group, dataset);
+  }
+}
+
 /**
  * Updates the @a widgetId of the given @a dataset. The widget ID is dependent
  * on the order of the widgets returned by the @c availableDatasetLevelWidgets()
@@ -1431,6 +1715,143 @@ void Project::Model::setDatasetWidgetAlarm(const int group, const int dataset,
   }
 }
 
+/**
+ * Updates the alarm condition of the given @a dataset. The @a modeId is
+ * dependent on the order of the conditions returned by the
+ * @c availableAlarmModes() function.
+ *
+ * @param group   index of the group in which the dataset belongs
+ * @param dataset index of the dataset
+ */
+void Project::Model::setDatasetAlarmMode(const int group, const int dataset,
+                                         const int modeId)
+{
+  // Get alarm condition string
+  QString mode = "none";
+  if (modeId == 1)
+    mode = "above";
+  else if (modeId == 2)
+    mode = "below";
+  else if (modeId == 3)
+    mode = "band";
+  else if (modeId == 4)
+    mode = "rate";
+
+  // Update dataset
+  setDatasetAlarmModeData(group, dataset, mode);
+}
+
+/**
+ * Updates the alarm condition string of the given @a dataset.
+ *
+ * @param group   index of the group in which the dataset belongs
+ * @param dataset index of the dataset
+ */
+void Project::Model::setDatasetAlarmModeData(const int group,
+                                             const int dataset,
+                                             const QString &mode)
+{
+  // Get dataset & group
+  auto grp = getGroup(group);
+  auto set = getDataset(group, dataset);
+
+  // Update dataset & group
+  if (set.m_alarmMode != mode)
+  {
+    set.m_alarmMode = mode;
+    grp.m_datasets.replace(dataset, set);
+    m_groups.replace(group, grp);
+
+    // Update UI
+    Q_EMIT datasetChanged(group, dataset);
+  }
+}
+
+/**
+ * Updates the @a low alarm level of the given @a dataset, used by the "below"
+ * & "band" alarm conditions.
+ *
+ * @param group   index of the group in which the dataset belongs
+ * @param dataset index of the dataset
+ */
+void Project::Model::setDatasetAlarmLow(const int group, const int dataset,
+                                        const QString &low)
+{
+  // Get dataset & group
+  auto grp = getGroup(group);
+  auto set = getDataset(group, dataset);
+
+  // Update dataset & group
+  if (set.m_alarmLow != low.toDouble())
+  {
+    set.m_alarmLow = low.toDouble();
+    grp.m_datasets.replace(dataset, set);
+    m_groups.replace(group, grp);
+
+    // Update UI
+    Q_EMIT datasetChanged(group, dataset);
+  }
+}
+
+/**
+ * Updates the @a hysteresis margin of the alarm of the given @a dataset.
+ *
+ * @param group   index of the group in which the dataset belongs
+ * @param dataset index of the dataset
+ */
+void Project::Model::setDatasetAlarmHysteresis(const int group,
+                                               const int dataset,
+                                               const QString &hysteresis)
+{
+  // Get dataset & group
+  auto grp = getGroup(group);
+  auto set = getDataset(group, dataset);
+
+  // Validate hysteresis
+  auto margin = qMax(0.0, hysteresis.toDouble());
+
+  // Update dataset & group
+  if (set.m_alarmHysteresis != margin)
+  {
+    set.m_alarmHysteresis = margin;
+    grp.m_datasets.replace(dataset, set);
+    m_groups.replace(group, grp);
+
+    // Update UI
+    Q_EMIT datasetChanged(group, dataset);
+  }
+}
+
+/**
+ * Updates the number of consecutive frames (@a debounce) required to raise or
+ * clear the alarm of the given @a dataset.
+ *
+ * @param group   index of the group in which the dataset belongs
+ * @param dataset index of the dataset
+ */
+void Project::Model::setDatasetAlarmDebounce(const int group,
+                                             const int dataset,
+                                             const QString &debounce)
+{
+  // Get dataset & group
+  auto grp = getGroup(group);
+  auto set = getDataset(group, dataset);
+
+  // Validate debounce count
+  auto frames = qMax(1, debounce.toInt());
+
+  // Update dataset & group
+  if (set.m_alarmDebounce != frames)
+  {
+    set.m_alarmDebounce = frames;
+    grp.m_datasets.replace(dataset, set);
+    m_groups.replace(group, grp);
+
+    // Update UI
+    Q_EMIT datasetChanged(group, dataset);
+  }
+}
+
 /**
  * Updates the @a samples used for FFT plotting.
  *
@@ -97,6 +97,7 @@ public:
 
   Q_INVOKABLE StringList availableGroupLevelWidgets();
   Q_INVOKABLE StringList availableDatasetLevelWidgets();
+  Q_INVOKABLE StringList availableAlarmModes();
 
   QString jsonProjectsPath() const;
 
@@ -127,8 +128,16 @@ public:
   Q_INVOKABLE bool datasetGraph(const int group, const int dataset) const;
   Q_INVOKABLE bool datasetFftPlot(const int group, const int dataset) const;
   Q_INVOKABLE bool datasetLogPlot(const int group, const int dataset) const;
+  Q_INVOKABLE bool datasetWaterfall(const int group, const int dataset) const;
   Q_INVOKABLE QString datasetTitle(const int group, const int dataset) const;
   Q_INVOKABLE QString datasetUnits(const int group, const int dataset) const;
+  Q_INVOKABLE QString datasetExpression(const int group,
+                                        const int dataset) const;
+  Q_INVOKABLE QString datasetExpressionError(const int group,
+                                             const int dataset) const;
+  Q_INVOKABLE QString datasetFilter(const int group, const int dataset) const;
+  Q_INVOKABLE QString datasetFilterError(const int group,
+                                         const int dataset) const;
   Q_INVOKABLE QString datasetWidget(const int group, const int dataset) const;
   Q_INVOKABLE int datasetWidgetIndex(const int group, const int dataset) const;
   Q_INVOKABLE QString datasetWidgetMin(const int group,
@@ -139,6 +148,16 @@ public:
                                         const int dataset) const;
   Q_INVOKABLE QString datasetWidgetAlarm(const int group,
                                          const int dataset) const;
+  Q_INVOKABLE QString datasetAlarmMode(const int group,
+                                       const int dataset) const;
+  Q_INVOKABLE int datasetAlarmModeIndex(const int group,
+                                        const int dataset) const;
+  Q_INVOKABLE QString datasetAlarmLow(const int group,
+                                      const int dataset) const;
+  Q_INVOKABLE QString datasetAlarmHysteresis(const int group,
+                                             const int dataset) const;
+  Q_INVOKABLE QString datasetAlarmDebounce(const int group,
+                                           const int dataset) const;
 
   Q_INVOKABLE bool setGroupWidget(const int group, const int widgetId);
 
@@ -165,6 +184,10 @@ public Q_SLOTS:
   void setDatasetWidget(const int group, const int dataset, const int widgetId);
   void setDatasetTitle(const int group, const int dataset,
                        const QString &title);
+  void setDatasetExpression(const int group, const int dataset,
+                            const QString &expression);
+  void setDatasetFilter(const int group, const int dataset,
+                        const QString &filter);
   void setDatasetUnits(const int group, const int dataset,
                        const QString &units);
   void setDatasetIndex(const int group, const int dataset,
@@ -177,6 +200,8 @@ public Q_SLOTS:
                          const bool generateFft);
   void setDatasetLogPlot(const int group, const int dataset,
                          const bool generateLog);
+  void setDatasetWaterfall(const int group, const int dataset,
+                           const bool generateWaterfall);
   void setDatasetWidgetMin(const int group, const int dataset,
                            const QString &minimum);
   void setDatasetWidgetMax(const int group, const int dataset,
@@ -185,6 +210,16 @@ public Q_SLOTS:
                             const QString &widget);
   void setDatasetWidgetAlarm(const int group, const int dataset,
                              const QString &alarm);
+  void setDatasetAlarmMode(const int group, const int dataset,
+                           const int modeId);
+  void setDatasetAlarmModeData(const int group, const int dataset,
+                               const QString &mode);
+  void setDatasetAlarmLow(const int group, const int dataset,
+                          const QString &low);
+  void setDatasetAlarmHysteresis(const int group, const int dataset,
+                                 const QString &hysteresis);
+  void setDatasetAlarmDebounce(const int group, const int dataset,
+                               const QString &debounce);
   void setDatasetFFTSamples(const int group, const int dataset,
                             const QString &samples);
 
@@ -22,10 +22,12 @@
 
 #include <IO/Manager.h>
 #include <IO/Console.h>
+#include <IO/Trigger.h>
 #include <CSV/Player.h>
 #include <UI/Dashboard.h>
 #include <JSON/Generator.h>
 #include <Misc/TimerEvents.h>
+#include <Misc/Instrumentation.h>
 
 //----------------------------------------------------------------------------------------
 // Constructor/deconstructor & singleton
@@ -37,16 +39,24 @@
 UI::Dashboard::Dashboard()
   : m_points(100)
   , m_precision(2)
+  , m_paintBudget(10)
+  , m_sweepMode(false)
+  , m_timeWindow(0)
+  , m_frozen(false)
+  , m_frameTime(0)
+  , m_sampleCount(0)
 {
   // clang-format off
     connect(&CSV::Player::instance(), &CSV::Player::openChanged,
             this, &UI::Dashboard::resetData);
     connect(&IO::Manager::instance(), &IO::Manager::connectedChanged,
             this, &UI::Dashboard::resetData);
-    connect(&JSON::Generator::instance(), &JSON::Generator::jsonChanged,
-            this, &UI::Dashboard::processLatestJSON);
+    connect(&JSON::Generator::instance(), &JSON::Generator::frameChanged,
+            this, &UI::Dashboard::processLatestFrame);
     connect(&JSON::Generator::instance(), &JSON::Generator::jsonFileMapChanged,
             this, &UI::Dashboard::resetData);
+    connect(&IO::Trigger::instance(), &IO::Trigger::captureHeld,
+            this, &UI::Dashboard::setFrozen);
   // clang-format on
 }
 
@@ -78,6 +88,7 @@ const JSON::Group &UI::Dashboard::getGroups(const int index) const        { retu
 const JSON::Dataset &UI::Dashboard::getGauge(const int index) const       { return m_gaugeWidgets.at(index);         }
 const JSON::Group &UI::Dashboard::getGyroscope(const int index) const     { return m_gyroscopeWidgets.at(index);     }
 const JSON::Dataset &UI::Dashboard::getCompass(const int index) const     { return m_compassWidgets.at(index);       }
+const JSON::Dataset &UI::Dashboard::getWaterfall(const int index) const   { return m_waterfallWidgets.at(index);     }
 const JSON::Group &UI::Dashboard::getMultiplot(const int index) const     { return m_multiPlotWidgets.at(index);     }
 const JSON::Group &UI::Dashboard::getAccelerometer(const int index) const { return m_accelerometerWidgets.at(index); }
 // clang-format on
@@ -118,6 +129,53 @@ int UI::Dashboard::precision() const
   return m_precision;
 }
 
+/**
+ * Returns the maximum average time (in milliseconds) that each widget may
+ * spend repainting itself on every refresh cycle. Widgets that exceed this
+ * budget are refreshed less often, so that a single slow widget does not
+ * slow down the rest of the user interface. A value of 0 disables the budget.
+ */
+int UI::Dashboard::paintBudget() const
+{
+  return m_paintBudget;
+}
+
+/**
+ * Returns @c true if the plot widgets shall work like an oscilloscope: new
+ * samples are drawn from left to right, and the plot is cleared when the
+ * sweep reaches its right side. In this mode, only the newest segment of each
+ * curve is painted on every update, instead of replotting all of the samples.
+ */
+bool UI::Dashboard::sweepMode() const
+{
+  return m_sweepMode;
+}
+
+/**
+ * Returns the number of seconds of history displayed by the plot widgets. If
+ * set to 0, plots display the last @c points() samples and their horizontal
+ * axis shows the sample number.
+ *
+ * Otherwise, plots display the samples received during the last
+ * @c timeWindow() seconds (regardless of how often frames are received), and
+ * the plot data is trimmed to the time window instead of to a fixed number of
+ * points.
+ */
+int UI::Dashboard::timeWindow() const
+{
+  return m_timeWindow;
+}
+
+/**
+ * Returns @c true if the dashboard ignores new frames, so that the widgets
+ * keep displaying the data received before the dashboard was frozen (e.g.
+ * after a trigger capture).
+ */
+bool UI::Dashboard::frozen() const
+{
+  return m_frozen;
+}
+
 /**
  * Returns @c true if the current JSON frame is valid and ready-to-use by the
  * QML interface.
@@ -149,6 +207,7 @@ int UI::Dashboard::totalWidgetCount() const
             ledCount() +
             barCount() +
             fftCount() +
+            waterfallCount() +
             plotCount() +
             gaugeCount() +
             groupCount() +
@@ -171,6 +230,7 @@ int UI::Dashboard::gaugeCount() const         { return m_gaugeWidgets.count();
 int UI::Dashboard::groupCount() const         { return m_groupWidgets.count();         }
 int UI::Dashboard::compassCount() const       { return m_compassWidgets.count();       }
 int UI::Dashboard::gyroscopeCount() const     { return m_gyroscopeWidgets.count();     }
+int UI::Dashboard::waterfallCount() const     { return m_waterfallWidgets.count();     }
 int UI::Dashboard::multiPlotCount() const     { return m_multiPlotWidgets.count();     }
 int UI::Dashboard::accelerometerCount() const { return m_accelerometerWidgets.count(); }
 // clang-format on
@@ -196,6 +256,7 @@ StringList UI::Dashboard::widgetTitles()
             multiPlotTitles() +
             ledTitles() +
             fftTitles() +
+            waterfallTitles() +
             plotTitles() +
             barTitles() +
             gaugeTitles() +
@@ -252,8 +313,13 @@ int UI::Dashboard::relativeIndex(const int globalIndex) const
   if (index < fftCount())
     return index;
 
-  // Check if we should return plot widget
+  // Check if we should return waterfall widget
   index -= fftCount();
+  if (index < waterfallCount())
+    return index;
+
+  // Check if we should return plot widget
+  index -= waterfallCount();
   if (index < plotCount())
     return index;
 
@@ -324,6 +390,9 @@ bool UI::Dashboard::widgetVisible(const int globalIndex) const
     case WidgetType::FFT:
       visible = fftVisible(index);
       break;
+    case WidgetType::Waterfall:
+      visible = waterfallVisible(index);
+      break;
     case WidgetType::Plot:
       visible = plotVisible(index);
       break;
@@ -386,6 +455,9 @@ QString UI::Dashboard::widgetIcon(const int globalIndex) const
     case WidgetType::FFT:
       return "qrc:/icons/fft.svg";
       break;
+    case WidgetType::Waterfall:
+      return "qrc:/icons/fft.svg";
+      break;
     case WidgetType::Plot:
       return "qrc:/icons/plot.svg";
       break;
@@ -424,6 +496,7 @@ QString UI::Dashboard::widgetIcon(const int globalIndex) const
  * - @c WidgetType::Group
  * - @c WidgetType::MultiPlot
  * - @c WidgetType::FFT
+ * - @c WidgetType::Waterfall
  * - @c WidgetType::Plot
  * - @c WidgetType::Bar
  * - @c WidgetType::Gauge
@@ -477,8 +550,13 @@ UI::Dashboard::WidgetType UI::Dashboard::widgetType(const int globalIndex) const
   if (index < fftCount())
     return WidgetType::FFT;
 
-  // Check if we should return plot widget
+  // Check if we should return waterfall widget
   index -= fftCount();
+  if (index < waterfallCount())
+    return WidgetType::Waterfall;
+
+  // Check if we should return plot widget
+  index -= waterfallCount();
   if (index < plotCount())
     return WidgetType::Plot;
 
@@ -530,6 +608,7 @@ bool UI::Dashboard::groupVisible(const int index) const         { return getVisi
 bool UI::Dashboard::gaugeVisible(const int index) const         { return getVisibility(m_gaugeVisibility, index);         }
 bool UI::Dashboard::compassVisible(const int index) const       { return getVisibility(m_compassVisibility, index);       }
 bool UI::Dashboard::gyroscopeVisible(const int index) const     { return getVisibility(m_gyroscopeVisibility, index);     }
+bool UI::Dashboard::waterfallVisible(const int index) const     { return getVisibility(m_waterfallVisibility, index);     }
 bool UI::Dashboard::multiPlotVisible(const int index) const     { return getVisibility(m_multiPlotVisibility, index);     }
 bool UI::Dashboard::accelerometerVisible(const int index) const { return getVisibility(m_accelerometerVisibility, index); }
 // clang-format on
@@ -548,6 +627,7 @@ StringList UI::Dashboard::plotTitles()          { return datasetTitles(m_plotWid
 StringList UI::Dashboard::gaugeTitles()         { return datasetTitles(m_gaugeWidgets);       }
 StringList UI::Dashboard::compassTitles()       { return datasetTitles(m_compassWidgets);     }
 StringList UI::Dashboard::gyroscopeTitles()     { return groupTitles(m_gyroscopeWidgets);     }
+StringList UI::Dashboard::waterfallTitles()     { return datasetTitles(m_waterfallWidgets);   }
 StringList UI::Dashboard::multiPlotTitles()     { return groupTitles(m_multiPlotWidgets);     }
 StringList UI::Dashboard::accelerometerTitles() { return groupTitles(m_accelerometerWidgets); }
 // clang-format on
@@ -564,8 +644,10 @@ void UI::Dashboard::setPoints(const int points)
     m_points = points;
 
     // Clear values
+    m_timestamps.clear();
     m_fftPlotValues.clear();
     m_linearPlotValues.clear();
+    m_waterfallPlotValues.clear();
 
     // Regenerate x-axis values
     m_xData.resize(points);
@@ -586,6 +668,62 @@ void UI::Dashboard::setPrecision(const int precision)
   }
 }
 
+/**
+ * Changes the paint budget (in milliseconds) of each widget, check the
+ * @c paintBudget() function for more information.
+ */
+void UI::Dashboard::setPaintBudget(const int budget)
+{
+  const auto value = qMax(0, budget);
+  if (m_paintBudget != value)
+  {
+    m_paintBudget = value;
+    Q_EMIT paintBudgetChanged();
+  }
+}
+
+/**
+ * Enables or disables the sweep mode of the plot widgets, check the
+ * @c sweepMode() function for more information.
+ */
+void UI::Dashboard::setSweepMode(const bool enabled)
+{
+  if (m_sweepMode != enabled)
+  {
+    m_sweepMode = enabled;
+    Q_EMIT sweepModeChanged();
+  }
+}
+
+/**
+ * Changes the number of seconds of history displayed by the plot widgets,
+ * check the @c timeWindow() function for more information.
+ */
+void UI::Dashboard::setTimeWindow(const int seconds)
+{
+  const auto value = qMax(0, seconds);
+  if (m_timeWindow != value)
+  {
+    m_timeWindow = value;
+    m_timestamps.clear();
+    m_linearPlotValues.clear();
+    Q_EMIT timeWindowChanged();
+  }
+}
+
+/**
+ * Freezes or resumes the dashboard, check the @c frozen() function for more
+ * information.
+ */
+void UI::Dashboard::setFrozen(const bool frozen)
+{
+  if (m_frozen != frozen)
+  {
+    m_frozen = frozen;
+    Q_EMIT frozenChanged();
+  }
+}
+
 //----------------------------------------------------------------------------------------
 // Visibility-related slots
 //----------------------------------------------------------------------------------------
@@ -600,6 +738,7 @@ void UI::Dashboard::setGroupVisible(const int i, const bool v)         { setVisi
 void UI::Dashboard::setGaugeVisible(const int i, const bool v)         { setVisibility(m_gaugeVisibility, i, v);         }
 void UI::Dashboard::setCompassVisible(const int i, const bool v)       { setVisibility(m_compassVisibility, i, v);       }
 void UI::Dashboard::setGyroscopeVisible(const int i, const bool v)     { setVisibility(m_gyroscopeVisibility, i, v);     }
+void UI::Dashboard::setWaterfallVisible(const int i, const bool v)     { setVisibility(m_waterfallVisibility, i, v);     }
 void UI::Dashboard::setMultiplotVisible(const int i, const bool v)     { setVisibility(m_multiPlotVisibility, i, v);     }
 void UI::Dashboard::setAccelerometerVisible(const int i, const bool v) { setVisibility(m_accelerometerVisibility, i, v); }
 // clang-format on
@@ -618,8 +757,10 @@ void UI::Dashboard::resetData()
   m_currentFrame.read(QJsonObject{});
 
   // Clear plot data
+  m_timestamps.clear();
   m_fftPlotValues.clear();
   m_linearPlotValues.clear();
+  m_waterfallPlotValues.clear();
 
   // Clear widget data
   m_barWidgets.clear();
@@ -631,6 +772,7 @@ void UI::Dashboard::resetData()
   m_groupWidgets.clear();
   m_compassWidgets.clear();
   m_gyroscopeWidgets.clear();
+  m_waterfallWidgets.clear();
   m_multiPlotWidgets.clear();
   m_accelerometerWidgets.clear();
 
@@ -644,9 +786,13 @@ void UI::Dashboard::resetData()
   m_groupVisibility.clear();
   m_compassVisibility.clear();
   m_gyroscopeVisibility.clear();
+  m_waterfallVisibility.clear();
   m_multiPlotVisibility.clear();
   m_accelerometerVisibility.clear();
 
+  // Resume frame processing
+  setFrozen(false);
+
   // Update UI
   Q_EMIT updated();
   Q_EMIT dataReset();
@@ -664,6 +810,7 @@ void UI::Dashboard::updatePlots()
   // datasets that need to be plotted.
   QVector<JSON::Dataset> fftDatasets;
   QVector<JSON::Dataset> linearDatasets;
+  QVector<JSON::Dataset> waterfallDatasets;
 
   // Create list with datasets that need to be graphed
   for (int i = 0; i < m_currentFrame.groupCount(); ++i)
@@ -676,17 +823,26 @@ void UI::Dashboard::updatePlots()
         fftDatasets.append(dataset);
       if (dataset.graph())
         linearDatasets.append(dataset);
+      if (dataset.waterfall())
+        waterfallDatasets.append(dataset);
     }
   }
 
-  // Check if we need to update dataset points
-  if (m_linearPlotValues.count() != linearDatasets.count())
+  // Check if we need to update dataset points (plots that display a time
+  // window start empty, since the buffers grow as new frames are received)
+  const bool timed = m_timeWindow > 0;
+  if (m_linearPlotValues.count() != linearDatasets.count()
+      || m_timestamps.isEmpty())
   {
+    m_timestamps.clear();
     m_linearPlotValues.clear();
 
     for (int i = 0; i < linearDatasets.count(); ++i)
     {
       m_linearPlotValues.append(PlotData());
+      if (timed)
+        continue;
+
       m_linearPlotValues.last().resize(points());
 
       // clang-format off
@@ -695,6 +851,9 @@ void UI::Dashboard::updatePlots()
                       0.0001);
       // clang-format on
     }
+
+    if (!timed)
+      m_timestamps.resize(points());
   }
 
   // Check if we need to update FFT dataset points
@@ -715,13 +874,61 @@ void UI::Dashboard::updatePlots()
     }
   }
 
-  // Append latest values to linear plot data
-  for (int i = 0; i < linearDatasets.count(); ++i)
+  // Check if we need to update waterfall dataset points
+  if (m_waterfallPlotValues.count() != waterfallDatasets.count())
+  {
+    m_waterfallPlotValues.clear();
+
+    for (int i = 0; i < waterfallDatasets.count(); ++i)
+    {
+      m_waterfallPlotValues.append(PlotData());
+      m_waterfallPlotValues.last().resize(waterfallDatasets[i].fftSamples());
+
+      // clang-format off
+            std::fill(m_waterfallPlotValues.last().begin(),
+                      m_waterfallPlotValues.last().end(),
+                      0);
+      // clang-format on
+    }
+  }
+
+  // Count the samples appended to the plot data, so that widgets that are
+  // updated once for several frames know how many samples are new
+  ++m_sampleCount;
+
+  // Register the time at which the frame was received (in seconds), frames
+  // that did not come from the I/O manager are timestamped now
+  m_frameTime = m_currentFrame.timestamp();
+  if (m_frameTime <= 0)
+    m_frameTime = IO::Manager::instance().timestamp();
+
+  const double now = m_frameTime / 1e6;
+
+  // Append latest values & timestamp to time-based plot data
+  if (timed)
+  {
+    m_timestamps.append(now);
+    for (int i = 0; i < linearDatasets.count(); ++i)
+      m_linearPlotValues[i].append(linearDatasets[i].numericValue());
+
+    trimPlots();
+  }
+
+  // Append latest values & timestamp to linear plot data
+  else
   {
-    auto data = m_linearPlotValues[i].data();
-    auto count = m_linearPlotValues[i].count();
-    memmove(data, data + 1, count * sizeof(double));
-    m_linearPlotValues[i][count - 1] = linearDatasets[i].value().toDouble();
+    auto time = m_timestamps.data();
+    auto samples = m_timestamps.count();
+    memmove(time, time + 1, (samples - 1) * sizeof(double));
+    m_timestamps[samples - 1] = now;
+
+    for (int i = 0; i < linearDatasets.count(); ++i)
+    {
+      auto data = m_linearPlotValues[i].data();
+      auto count = m_linearPlotValues[i].count();
+      memmove(data, data + 1, (count - 1) * sizeof(double));
+      m_linearPlotValues[i][count - 1] = linearDatasets[i].numericValue();
+    }
   }
 
   // Append latest values to FFT plot data
@@ -729,16 +936,63 @@ void UI::Dashboard::updatePlots()
   {
     auto data = m_fftPlotValues[i].data();
     auto count = m_fftPlotValues[i].count();
-    memmove(data, data + 1, count * sizeof(double));
-    m_fftPlotValues[i][count - 1] = fftDatasets[i].value().toDouble();
+    memmove(data, data + 1, (count - 1) * sizeof(double));
+    m_fftPlotValues[i][count - 1] = fftDatasets[i].numericValue();
+  }
+
+  // Append latest values to waterfall plot data
+  for (int i = 0; i < waterfallDatasets.count(); ++i)
+  {
+    auto data = m_waterfallPlotValues[i].data();
+    auto count = m_waterfallPlotValues[i].count();
+    memmove(data, data + 1, (count - 1) * sizeof(double));
+    m_waterfallPlotValues[i][count - 1] = waterfallDatasets[i].numericValue();
+  }
+}
+
+/**
+ * Removes the samples that are older than the time window from the plot
+ * data, or the oldest samples if the plot data has more than
+ * @c kMaxTimeSamples samples.
+ *
+ * Widgets find the first sample of the time window with a binary search, so
+ * stale samples are only removed once they take a quarter of the buffers.
+ * This way, the plot data is not moved in memory every time that a frame is
+ * received.
+ */
+void UI::Dashboard::trimPlots()
+{
+  // Find the first sample inside the time window
+  const auto count = m_timestamps.count();
+  const auto oldest = m_timestamps.last() - m_timeWindow;
+  const auto begin = m_timestamps.constBegin();
+  auto stale = std::lower_bound(begin, m_timestamps.constEnd(), oldest) - begin;
+
+  // Limit the memory used by each dataset
+  if (count - stale > kMaxTimeSamples)
+    stale = count - kMaxTimeSamples;
+
+  // Remove stale samples
+  if (stale > 0 && stale >= count / 4)
+  {
+    m_timestamps.remove(0, stale);
+    for (int i = 0; i < m_linearPlotValues.count(); ++i)
+      m_linearPlotValues[i].remove(0, stale);
   }
 }
 
 /**
  * Regenerates the data displayed on the dashboard widgets
  */
-void UI::Dashboard::processLatestJSON(const QJsonObject &json)
+void UI::Dashboard::processLatestFrame(const JSON::Frame &frame)
 {
+  // Measure time spent updating the dashboard data
+  Misc::Instrumentation::ScopedTimer timer(Misc::Instrumentation::Dashboard);
+
+  // Keep displaying the previous frames
+  if (m_frozen)
+    return;
+
   // Save widget count
   const int barC = barCount();
   const int fftC = fftCount();
@@ -749,15 +1003,15 @@ void UI::Dashboard::processLatestJSON(const QJsonObject &json)
   const int gaugeC = gaugeCount();
   const int compassC = compassCount();
   const int gyroscopeC = gyroscopeCount();
+  const int waterfallC = waterfallCount();
   const int multiPlotC = multiPlotCount();
   const int accelerometerC = accelerometerCount();
 
   // Save previous title
   auto pTitle = title();
 
-  // Try to read latest frame for widget updating
-  if (!m_currentFrame.read(json))
-    return;
+  // Update latest frame for widget updating
+  m_currentFrame = frame;
 
   // Regenerate plot data
   updatePlots();
@@ -766,6 +1020,7 @@ void UI::Dashboard::processLatestJSON(const QJsonObject &json)
   m_fftWidgets = getFFTWidgets();
   m_ledWidgets = getLEDWidgets();
   m_plotWidgets = getPlotWidgets();
+  m_waterfallWidgets = getWaterfallWidgets();
   m_groupWidgets = getWidgetGroups("");
   m_gpsWidgets = getWidgetGroups("map");
   m_barWidgets = getWidgetDatasets("bar");
@@ -798,6 +1053,7 @@ void UI::Dashboard::processLatestJSON(const QJsonObject &json)
   regenerateWidgets |= (groupC != groupCount());
   regenerateWidgets |= (compassC != compassCount());
   regenerateWidgets |= (gyroscopeC != gyroscopeCount());
+  regenerateWidgets |= (waterfallC != waterfallCount());
   regenerateWidgets |= (multiPlotC != multiPlotCount());
   regenerateWidgets |= (accelerometerC != accelerometerCount());
 
@@ -813,6 +1069,7 @@ void UI::Dashboard::processLatestJSON(const QJsonObject &json)
     m_groupVisibility.resize(groupCount());
     m_compassVisibility.resize(compassCount());
     m_gyroscopeVisibility.resize(gyroscopeCount());
+    m_waterfallVisibility.resize(waterfallCount());
     m_multiPlotVisibility.resize(multiPlotCount());
     m_accelerometerVisibility.resize(accelerometerCount());
     std::fill(m_barVisibility.begin(), m_barVisibility.end(), 1);
@@ -824,6 +1081,7 @@ void UI::Dashboard::processLatestJSON(const QJsonObject &json)
     std::fill(m_groupVisibility.begin(), m_groupVisibility.end(), 1);
     std::fill(m_compassVisibility.begin(), m_compassVisibility.end(), 1);
     std::fill(m_gyroscopeVisibility.begin(), m_gyroscopeVisibility.end(), 1);
+    std::fill(m_waterfallVisibility.begin(), m_waterfallVisibility.end(), 1);
     std::fill(m_multiPlotVisibility.begin(), m_multiPlotVisibility.end(), 1);
     std::fill(m_accelerometerVisibility.begin(),
               m_accelerometerVisibility.end(), 1);
@@ -917,6 +1175,28 @@ QVector<JSON::Dataset> UI::Dashboard::getPlotWidgets()
   return widgets;
 }
 
+/**
+ * Returns a vector with all the datasets that need to be shown in the
+ * waterfall widgets.
+ */
+QVector<JSON::Dataset> UI::Dashboard::getWaterfallWidgets()
+{
+  QVector<JSON::Dataset> widgets;
+  Q_FOREACH (auto group, m_currentFrame.groups())
+  {
+    Q_FOREACH (auto dataset, group.datasets())
+    {
+      if (dataset.waterfall())
+      {
+        dataset.setTitle(dataset.title() + " (" + group.title() + ")");
+        widgets.append(dataset);
+      }
+    }
+  }
+
+  return widgets;
+}
+
 /**
  * Returns a vector with all the groups that implement the widget with the
  * specied
@@ -51,7 +51,7 @@ namespace UI
  * - @c Dashboard::getWidgetGroups()
  * - @c Dashboard::getDatasetWidget()
  * - @c Dashboard::getWidgetDatasets()
- * - @c Dashboard::processLatestJSON()
+ * - @c Dashboard::processLatestFrame()
  *
  * The rest of the functions of this class rely on the procedures above in order
  * to implement common functionality features for each widget type.
@@ -74,6 +74,22 @@ class Dashboard : public QObject
                READ precision
                WRITE setPrecision
                NOTIFY precisionChanged)
+    Q_PROPERTY(int paintBudget
+               READ paintBudget
+               WRITE setPaintBudget
+               NOTIFY paintBudgetChanged)
+    Q_PROPERTY(bool sweepMode
+               READ sweepMode
+               WRITE setSweepMode
+               NOTIFY sweepModeChanged)
+    Q_PROPERTY(int timeWindow
+               READ timeWindow
+               WRITE setTimeWindow
+               NOTIFY timeWindowChanged)
+    Q_PROPERTY(bool frozen
+               READ frozen
+               WRITE setFrozen
+               NOTIFY frozenChanged)
     Q_PROPERTY(int totalWidgetCount
                READ totalWidgetCount
                NOTIFY widgetCountChanged)
@@ -104,6 +120,9 @@ class Dashboard : public QObject
     Q_PROPERTY(int gyroscopeCount
                READ gyroscopeCount
                NOTIFY widgetCountChanged)
+    Q_PROPERTY(int waterfallCount
+               READ waterfallCount
+               NOTIFY widgetCountChanged)
     Q_PROPERTY(int multiPlotCount
                READ multiPlotCount
                NOTIFY widgetCountChanged)
@@ -137,6 +156,9 @@ class Dashboard : public QObject
     Q_PROPERTY(StringList gyroscopeTitles
                READ gyroscopeTitles
                NOTIFY widgetCountChanged)
+    Q_PROPERTY(StringList waterfallTitles
+               READ waterfallTitles
+               NOTIFY widgetCountChanged)
     Q_PROPERTY(StringList multiPlotTitles
                READ multiPlotTitles
                NOTIFY widgetCountChanged)
@@ -148,9 +170,13 @@ class Dashboard : public QObject
 Q_SIGNALS:
   void updated();
   void dataReset();
+  void frozenChanged();
   void titleChanged();
   void pointsChanged();
   void precisionChanged();
+  void paintBudgetChanged();
+  void sweepModeChanged();
+  void timeWindowChanged();
   void widgetCountChanged();
   void widgetVisibilityChanged();
 
@@ -167,6 +193,7 @@ public:
     Group,
     MultiPlot,
     FFT,
+    Waterfall,
     Plot,
     Bar,
     Gauge,
@@ -191,6 +218,7 @@ public:
   const JSON::Dataset &getGauge(const int index) const;
   const JSON::Group &getGyroscope(const int index) const;
   const JSON::Dataset &getCompass(const int index) const;
+  const JSON::Dataset &getWaterfall(const int index) const;
   const JSON::Group &getMultiplot(const int index) const;
   const JSON::Group &getAccelerometer(const int index) const;
 
@@ -198,6 +226,10 @@ public:
   bool available();
   int points() const;
   int precision() const;
+  int paintBudget() const;
+  bool sweepMode() const;
+  int timeWindow() const;
+  bool frozen() const;
 
   int totalWidgetCount() const;
   int gpsCount() const;
@@ -209,6 +241,7 @@ public:
   int gaugeCount() const;
   int compassCount() const;
   int gyroscopeCount() const;
+  int waterfallCount() const;
   int multiPlotCount() const;
   int accelerometerCount() const;
 
@@ -228,6 +261,7 @@ public:
   Q_INVOKABLE bool gaugeVisible(const int index) const;
   Q_INVOKABLE bool compassVisible(const int index) const;
   Q_INVOKABLE bool gyroscopeVisible(const int index) const;
+  Q_INVOKABLE bool waterfallVisible(const int index) const;
   Q_INVOKABLE bool multiPlotVisible(const int index) const;
   Q_INVOKABLE bool accelerometerVisible(const int index) const;
 
@@ -240,17 +274,29 @@ public:
   StringList gaugeTitles();
   StringList compassTitles();
   StringList gyroscopeTitles();
+  StringList waterfallTitles();
   StringList multiPlotTitles();
   StringList accelerometerTitles();
 
   const PlotData &xPlotValues() { return m_xData; }
+  const PlotData &plotTimestamps() { return m_timestamps; }
+  qint64 frameTimestamp() const { return m_frameTime; }
+  qint64 sampleCount() const { return m_sampleCount; }
   const JSON::Frame &currentFrame() { return m_currentFrame; }
   const QVector<PlotData> &fftPlotValues() { return m_fftPlotValues; }
   const QVector<PlotData> &linearPlotValues() { return m_linearPlotValues; }
+  const QVector<PlotData> &waterfallPlotValues()
+  {
+    return m_waterfallPlotValues;
+  }
 
 public Q_SLOTS:
   void setPoints(const int points);
   void setPrecision(const int precision);
+  void setPaintBudget(const int budget);
+  void setSweepMode(const bool enabled);
+  void setTimeWindow(const int seconds);
+  void setFrozen(const bool frozen);
   void setBarVisible(const int index, const bool visible);
   void setFFTVisible(const int index, const bool visible);
   void setGpsVisible(const int index, const bool visible);
@@ -260,18 +306,21 @@ public Q_SLOTS:
   void setGaugeVisible(const int index, const bool visible);
   void setCompassVisible(const int index, const bool visible);
   void setGyroscopeVisible(const int index, const bool visible);
+  void setWaterfallVisible(const int index, const bool visible);
   void setMultiplotVisible(const int index, const bool visible);
   void setAccelerometerVisible(const int index, const bool visible);
 
 private Q_SLOTS:
   void resetData();
   void updatePlots();
-  void processLatestJSON(const QJsonObject &json);
+  void processLatestFrame(const JSON::Frame &frame);
 
 private:
+  void trimPlots();
   QVector<JSON::Group> getLEDWidgets();
   QVector<JSON::Dataset> getFFTWidgets();
   QVector<JSON::Dataset> getPlotWidgets();
+  QVector<JSON::Dataset> getWaterfallWidgets();
   QVector<JSON::Group> getWidgetGroups(const QString &handle);
   QVector<JSON::Dataset> getWidgetDatasets(const QString &handle);
 
@@ -283,11 +332,21 @@ private:
                      const bool visible);
 
 private:
+  static constexpr int kMaxTimeSamples = 1 << 18;
+
   int m_points;
   int m_precision;
+  int m_paintBudget;
+  bool m_sweepMode;
+  int m_timeWindow;
+  bool m_frozen;
   PlotData m_xData;
+  PlotData m_timestamps;
+  qint64 m_frameTime;
+  qint64 m_sampleCount;
   QVector<PlotData> m_fftPlotValues;
   QVector<PlotData> m_linearPlotValues;
+  QVector<PlotData> m_waterfallPlotValues;
   QVector<QVector<PlotData>> m_multiplotValues;
 
   QVector<bool> m_barVisibility;
@@ -299,6 +358,7 @@ private:
   QVector<bool> m_gaugeVisibility;
   QVector<bool> m_compassVisibility;
   QVector<bool> m_gyroscopeVisibility;
+  QVector<bool> m_waterfallVisibility;
   QVector<bool> m_multiPlotVisibility;
   QVector<bool> m_accelerometerVisibility;
 
@@ -307,6 +367,7 @@ private:
   QVector<JSON::Dataset> m_plotWidgets;
   QVector<JSON::Dataset> m_gaugeWidgets;
   QVector<JSON::Dataset> m_compassWidgets;
+  QVector<JSON::Dataset> m_waterfallWidgets;
 
   QVector<JSON::Group> m_ledWidgets;
   QVector<JSON::Group> m_gpsWidgets;
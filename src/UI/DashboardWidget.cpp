@@ -20,6 +20,8 @@
  * THE SOFTWARE.
  */
 
+#include <QElapsedTimer>
+
 #include <Misc/ThemeManager.h>
 #include <UI/DashboardWidget.h>
 
@@ -33,6 +35,7 @@
 #include <UI/Widgets/DataGroup.h>
 #include <UI/Widgets/Gyroscope.h>
 #include <UI/Widgets/MultiPlot.h>
+#include <UI/Widgets/Waterfall.h>
 #include <UI/Widgets/Accelerometer.h>
 
 /**
@@ -234,6 +237,9 @@ void UI::DashboardWidget::setWidgetIndex(const int index)
       case UI::Dashboard::WidgetType::FFT:
         m_dbWidget = new Widgets::FFTPlot(relativeIndex());
         break;
+      case UI::Dashboard::WidgetType::Waterfall:
+        m_dbWidget = new Widgets::Waterfall(relativeIndex());
+        break;
       case UI::Dashboard::WidgetType::Plot:
         m_dbWidget = new Widgets::Plot(relativeIndex());
         break;
@@ -270,7 +276,13 @@ void UI::DashboardWidget::setWidgetIndex(const int index)
       updateWidgetVisible();
       connect(m_dbWidget, &Widgets::DashboardWidgetBase::updated, this, [=]() {
         if (!isGpsMap())
+        {
+          QElapsedTimer timer;
+          timer.start();
           update();
+          m_dbWidget->registerPaintTime(timer.nsecsElapsed());
+        }
+
         else
           Q_EMIT gpsDataChanged();
       });
@@ -22,9 +22,11 @@
 
 #pragma once
 
+#include <QElapsedTimer>
 #include <UI/Dashboard.h>
 #include <Misc/TimerEvents.h>
 #include <UI/DeclarativeWidget.h>
+#include <Misc/Instrumentation.h>
 
 namespace Widgets
 {
@@ -39,6 +41,13 @@ namespace Widgets
  * the widgets that inherit this class when they finish updating the displayed
  * data. This function is used to schedule a re-paint at a controlled frequency,
  * which is limited at 20 Hz.
+ *
+ * The time needed to repaint the widget is reported back through the
+ * @c registerPaintTime() function, and the time spent in the queued slots of
+ * the widget (e.g. @c updateData(), which may replot the widget) is measured
+ * by the @c event() function. If the whole update & render cycle exceeds the
+ * paint budget defined by the dashboard, the widget skips refresh cycles so
+ * that its average time per cycle stays within the budget (down to 1 Hz).
  */
 class DashboardWidgetBase : public QWidget
 {
@@ -48,7 +57,16 @@ Q_SIGNALS:
   void updated();
 
 public:
+  static constexpr int kMaxRepaintInterval = 20;
+
   DashboardWidgetBase()
+    : m_repaint(false)
+    , m_ticks(0)
+    , m_interval(1)
+    , m_updates(0)
+    , m_paintTime(0)
+    , m_updateTime(0)
+    , m_pendingTime(0)
   {
     // clang-format off
         connect(&Misc::TimerEvents::instance(), &Misc::TimerEvents::timeout20Hz,
@@ -56,19 +74,96 @@ public:
     // clang-format on
   }
 
+  int repaintInterval() const { return m_interval; }
+
   void repaint()
   {
     if (m_repaint)
     {
+      // Widget is over its paint budget, skip this refresh cycle
+      if (++m_ticks < m_interval)
+        return;
+
+      m_ticks = 0;
       m_repaint = false;
+      Misc::Instrumentation::addQueueDepth(
+          Misc::Instrumentation::PendingRepaints, -1);
       Q_EMIT updated();
     }
   }
 
-  void requestRepaint() { m_repaint = true; }
+  void requestRepaint()
+  {
+    // Widget already waiting to be repainted, previous data is not displayed
+    if (m_repaint && m_interval > 1)
+      Misc::Instrumentation::addDropped(
+          Misc::Instrumentation::ThrottledRepaint);
+    else if (m_repaint)
+      Misc::Instrumentation::addDropped(Misc::Instrumentation::SkippedRepaint);
+    else
+      Misc::Instrumentation::addQueueDepth(
+          Misc::Instrumentation::PendingRepaints, 1);
+
+    m_repaint = true;
+  }
+
+  void registerPaintTime(const qint64 ns)
+  {
+    // Get the average update time since the previous repaint
+    const auto update = m_updates > 0 ? m_pendingTime / m_updates : 0;
+    m_updates = 0;
+    m_pendingTime = 0;
+
+    // Smooth out the times to avoid reacting to isolated spikes
+    if (m_paintTime > 0)
+    {
+      m_paintTime = (m_paintTime * 3 + ns) / 4;
+      m_updateTime = (m_updateTime * 3 + update) / 4;
+    }
+
+    else
+    {
+      m_paintTime = ns;
+      m_updateTime = update;
+    }
+
+    // Data updates run in every cycle, refresh the widget every N cycles so
+    // that updateTime + paintTime / N <= budget
+    const qint64 budget = UI::Dashboard::instance().paintBudget() * 1000000LL;
+    const auto available = budget - m_updateTime;
+    if (budget <= 0)
+      m_interval = 1;
+    else if (available <= 0)
+      m_interval = kMaxRepaintInterval;
+    else
+      m_interval = qBound<qint64>(1, (m_paintTime + available - 1) / available,
+                                  kMaxRepaintInterval);
+  }
+
+protected:
+  bool event(QEvent *event) override
+  {
+    // Not a queued slot call (e.g. updateData()), nothing to measure
+    if (event->type() != QEvent::MetaCall)
+      return QWidget::event(event);
+
+    // Measure the time spent updating the widget data
+    QElapsedTimer timer;
+    timer.start();
+    const bool handled = QWidget::event(event);
+    m_pendingTime += timer.nsecsElapsed();
+    ++m_updates;
+    return handled;
+  }
 
 private:
   bool m_repaint;
+  int m_ticks;
+  int m_interval;
+  int m_updates;
+  qint64 m_paintTime;
+  qint64 m_updateTime;
+  qint64 m_pendingTime;
 };
 } // namespace Widgets
 
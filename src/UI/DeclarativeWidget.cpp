@@ -22,6 +22,7 @@
 
 #include <Misc/ThemeManager.h>
 #include <UI/DeclarativeWidget.h>
+#include <Misc/Instrumentation.h>
 
 /**
  * Creates a subclass of @c QWidget that allows us to call the given
@@ -83,6 +84,7 @@ void UI::DeclarativeWidget::update(const QRect &rect)
 {
   if (widget())
   {
+    Misc::Instrumentation::ScopedTimer timer(Misc::Instrumentation::WidgetGrab);
     m_pixmap = m_widget->grab();
     QQuickPaintedItem::update(rect);
   }
@@ -105,11 +105,11 @@ void Widgets::Accelerometer::updateData()
   {
     auto dataset = accelerometer.getDataset(i);
     if (dataset.widget() == "x")
-      x = dataset.value().toDouble();
+      x = dataset.numericValue();
     if (dataset.widget() == "y")
-      y = dataset.value().toDouble();
+      y = dataset.numericValue();
     if (dataset.widget() == "z")
-      z = dataset.value().toDouble();
+      z = dataset.numericValue();
   }
 
   // Divide accelerations by gravitational constant
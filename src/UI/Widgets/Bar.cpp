@@ -100,7 +100,7 @@ void Widgets::Bar::updateData()
 
   // Update bar level
   auto dataset = dash->getBar(m_index);
-  auto value = dataset.value().toDouble();
+  auto value = dataset.numericValue();
   m_thermo.setValue(value);
   setValue(QString("%1 %2").arg(
       QString::number(value, 'f', UI::Dashboard::instance().precision()),
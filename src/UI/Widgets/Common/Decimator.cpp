@@ -0,0 +1,154 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <algorithm>
+#include <UI/Widgets/Common/Decimator.h>
+
+/**
+ * Fills @a points with the min/max decimation of the given @a data for a plot
+ * with the given number of pixel @a columns. The x-coordinate of each point is
+ * the index of the sample in @a data.
+ *
+ * If the series has fewer than two samples per column, all the samples are
+ * copied to @a points.
+ */
+void Widgets::Decimator::minMax(const PlotData &data, const int columns,
+                                QVector<QPointF> &points)
+{
+  points.clear();
+  const auto count = data.count();
+  const auto values = data.constData();
+
+  // Nothing to decimate
+  if (columns <= 0 || count <= columns * 2)
+  {
+    points.reserve(count);
+    for (int i = 0; i < count; ++i)
+      points.append(QPointF(i, values[i]));
+
+    return;
+  }
+
+  // Find the minimum & maximum sample of each column
+  points.reserve(columns * 2);
+  const double step = static_cast<double>(count) / columns;
+  for (int column = 0; column < columns; ++column)
+  {
+    const auto begin = static_cast<int>(column * step);
+    const auto end = qMin(count, static_cast<int>((column + 1) * step));
+    if (begin >= end)
+      continue;
+
+    int first, second;
+    extremes(values, begin, end, first, second);
+    points.append(QPointF(first, values[first]));
+    if (second != first)
+      points.append(QPointF(second, values[second]));
+  }
+}
+
+/**
+ * Fills @a points with the min/max decimation of the samples of @a data that
+ * were received between @a from and @a to, for a plot with the given number
+ * of pixel @a columns. Each sample of @a data is received at the time stored
+ * in the same position of @a time, which must be sorted.
+ *
+ * The x-coordinate of each point is the time of the sample relative to @a to,
+ * so the newest samples are placed near 0 and older samples are placed at
+ * negative coordinates.
+ */
+void Widgets::Decimator::minMax(const PlotData &time, const PlotData &data,
+                                const double from, const double to,
+                                const int columns, QVector<QPointF> &points)
+{
+  points.clear();
+  const auto count = qMin(time.count(), data.count());
+  const auto values = data.constData();
+  const auto timestamps = time.constData();
+
+  // Find the first sample of the time window with a binary search
+  const auto start = static_cast<int>(
+      std::lower_bound(timestamps, timestamps + count, from) - timestamps);
+
+  // Nothing to decimate
+  if (columns <= 0 || to <= from || count - start <= columns * 2)
+  {
+    points.reserve(count - start);
+    for (int i = start; i < count; ++i)
+      points.append(QPointF(timestamps[i] - to, values[i]));
+
+    return;
+  }
+
+  // Find the minimum & maximum sample of each column
+  int begin = start;
+  points.reserve(columns * 2);
+  const double step = (to - from) / columns;
+  for (int column = 0; column < columns && begin < count; ++column)
+  {
+    // Find the samples received during the column (the last column also
+    // gets any sample received after the end of the time window)
+    int end = count;
+    if (column < columns - 1)
+    {
+      const auto limit = from + (column + 1) * step;
+      end = static_cast<int>(std::lower_bound(timestamps + begin,
+                                              timestamps + count, limit)
+                             - timestamps);
+    }
+
+    if (begin >= end)
+      continue;
+
+    int first, second;
+    extremes(values, begin, end, first, second);
+    points.append(QPointF(timestamps[first] - to, values[first]));
+    if (second != first)
+      points.append(QPointF(timestamps[second] - to, values[second]));
+
+    begin = end;
+  }
+}
+
+/**
+ * Finds the minimum & maximum samples of @a values between @a begin
+ * (inclusive) and @a end (exclusive), and writes their indexes in the order in
+ * which they were received to @a first and @a second, so that the decimated
+ * curve is continuous. Both indexes are the same if the column only has one
+ * distinct extreme.
+ */
+void Widgets::Decimator::extremes(const double *values, const int begin,
+                                  const int end, int &first, int &second)
+{
+  int min = begin;
+  int max = begin;
+  for (int i = begin + 1; i < end; ++i)
+  {
+    if (values[i] < values[min])
+      min = i;
+    else if (values[i] > values[max])
+      max = i;
+  }
+
+  first = qMin(min, max);
+  second = qMax(min, max);
+}
@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <QPointF>
+#include <QVector>
+#include <DataTypes.h>
+
+namespace Widgets
+{
+/**
+ * @brief The Decimator class
+ *
+ * Reduces a plot series to the samples that are actually visible on the
+ * screen. The series is split in one bucket per pixel column, and only the
+ * minimum & maximum values of each bucket are kept (in the order in which they
+ * were received). The resulting curve looks the same as the original one, but
+ * Qwt only needs to process two vertices per pixel column, regardless of the
+ * number of points in the series.
+ *
+ * Time-based series are split in columns of equal duration, so that samples
+ * received at irregular intervals are placed at the correct position.
+ */
+class Decimator
+{
+public:
+  static void minMax(const PlotData &data, const int columns,
+                     QVector<QPointF> &points);
+  static void minMax(const PlotData &time, const PlotData &data,
+                     const double from, const double to, const int columns,
+                     QVector<QPointF> &points);
+
+private:
+  static void extremes(const double *values, const int begin, const int end,
+                       int &first, int &second);
+};
+} // namespace Widgets
@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <UI/Widgets/Common/SlidingExtremum.h>
+
+/**
+ * Constructor function
+ */
+Widgets::SlidingExtremum::SlidingExtremum()
+  : m_window(0)
+  , m_count(0)
+{
+}
+
+/**
+ * Returns the number of samples considered to calculate the extremes
+ */
+int Widgets::SlidingExtremum::window() const
+{
+  return m_window;
+}
+
+/**
+ * Returns the smallest value of the last @c window() samples
+ */
+double Widgets::SlidingExtremum::minimum() const
+{
+  if (m_min.empty())
+    return 0;
+
+  return m_min.front().value;
+}
+
+/**
+ * Returns the largest value of the last @c window() samples
+ */
+double Widgets::SlidingExtremum::maximum() const
+{
+  if (m_max.empty())
+    return 0;
+
+  return m_max.front().value;
+}
+
+/**
+ * Removes all the registered samples
+ */
+void Widgets::SlidingExtremum::clear()
+{
+  m_count = 0;
+  m_window = 0;
+  m_min.clear();
+  m_max.clear();
+}
+
+/**
+ * Sets the window size to the length of @a data and registers all of its
+ * samples, this is needed when samples were skipped or the series changed.
+ */
+void Widgets::SlidingExtremum::reset(const PlotData &data)
+{
+  clear();
+  m_window = data.count();
+  for (const auto value : data)
+    append(value);
+}
+
+/**
+ * Registers a new sample and discards the samples that are no longer inside
+ * the window.
+ */
+void Widgets::SlidingExtremum::append(const double value)
+{
+  const auto index = m_count++;
+
+  // Values that are not smaller/larger than the new one can never be extremes
+  while (!m_min.empty() && m_min.back().value >= value)
+    m_min.pop_back();
+  while (!m_max.empty() && m_max.back().value <= value)
+    m_max.pop_back();
+
+  m_min.push_back({index, value});
+  m_max.push_back({index, value});
+
+  // Remove samples that left the window
+  const auto window = static_cast<quint64>(qMax(1, m_window));
+  const auto oldest = m_count > window ? m_count - window : 0;
+  while (m_min.front().index < oldest)
+    m_min.pop_front();
+  while (m_max.front().index < oldest)
+    m_max.pop_front();
+}
@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <deque>
+#include <DataTypes.h>
+
+namespace Widgets
+{
+/**
+ * @brief The SlidingExtremum class
+ *
+ * Keeps track of the minimum & maximum values of the last N samples of a
+ * series. Each sample is pushed to a monotonic queue, so appending a sample
+ * and querying the extremes takes amortized constant time, instead of
+ * re-scanning the whole window every time that a sample is added.
+ */
+class SlidingExtremum
+{
+public:
+  SlidingExtremum();
+
+  int window() const;
+  double minimum() const;
+  double maximum() const;
+
+  void clear();
+  void reset(const PlotData &data);
+  void append(const double value);
+
+private:
+  struct Sample
+  {
+    quint64 index;
+    double value;
+  };
+
+  int m_window;
+  quint64 m_count;
+  std::deque<Sample> m_min;
+  std::deque<Sample> m_max;
+};
+} // namespace Widgets
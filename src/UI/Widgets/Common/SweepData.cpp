@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <UI/Widgets/Common/SweepData.h>
+
+/**
+ * Returns the bounding rectangle of all the samples of the sweep
+ */
+QRectF Widgets::SweepData::boundingRect() const
+{
+  if (cachedBoundingRect.width() < 0.0)
+    cachedBoundingRect = qwtBoundingRect(*this);
+
+  return cachedBoundingRect;
+}
+
+/**
+ * Removes all the samples of the sweep
+ */
+void Widgets::SweepData::clear()
+{
+  m_samples.clear();
+  cachedBoundingRect = QRectF(0.0, 0.0, -1.0, -1.0);
+}
+
+/**
+ * Pre-allocates memory for @a size samples
+ */
+void Widgets::SweepData::reserve(const int size)
+{
+  m_samples.reserve(size);
+}
+
+/**
+ * Appends the given @a point to the sweep & extends the bounding rectangle
+ * so that it contains the new point.
+ */
+void Widgets::SweepData::append(const QPointF &point)
+{
+  m_samples.append(point);
+
+  if (m_samples.count() == 1)
+    cachedBoundingRect = QRectF(point, QSizeF(0.0, 0.0));
+
+  else if (cachedBoundingRect.width() >= 0.0)
+  {
+    cachedBoundingRect.setLeft(qMin(cachedBoundingRect.left(), point.x()));
+    cachedBoundingRect.setRight(qMax(cachedBoundingRect.right(), point.x()));
+    cachedBoundingRect.setTop(qMin(cachedBoundingRect.top(), point.y()));
+    cachedBoundingRect.setBottom(qMax(cachedBoundingRect.bottom(), point.y()));
+  }
+}
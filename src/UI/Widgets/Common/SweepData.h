@@ -0,0 +1,46 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <QwtSeriesData>
+
+namespace Widgets
+{
+/**
+ * @brief The SweepData class
+ *
+ * Series data used by the plot widgets in sweep mode. Samples are appended
+ * from left to right until the sweep reaches the right side of the plot, and
+ * the bounding rectangle is extended with each new sample, so that the curve
+ * does not need to re-scan all of its samples whenever a new one is added.
+ */
+class SweepData : public QwtArraySeriesData<QPointF>
+{
+public:
+  QRectF boundingRect() const override;
+
+  void clear();
+  void reserve(const int size);
+  void append(const QPointF &point);
+};
+} // namespace Widgets
@@ -91,7 +91,7 @@ void Widgets::Compass::update()
 
   // Get dataset value & set text format
   auto dataset = dash->getCompass(m_index);
-  auto value = dataset.value().toDouble();
+  auto value = dataset.numericValue();
   auto text = QString("%1°").arg(
       QString::number(value, 'f', UI::Dashboard::instance().precision()));
 
@@ -21,9 +21,10 @@
  */
 
 #include <QResizeEvent>
-#include <QRegularExpression>
 
 #include <UI/Dashboard.h>
+#include <DSP/Statistics.h>
+#include <Misc/TimerEvents.h>
 #include <Misc/ThemeManager.h>
 #include <UI/Widgets/DataGroup.h>
 
@@ -44,6 +45,8 @@
  */
 Widgets::DataGroup::DataGroup(const int index)
   : m_index(index)
+  , m_group(-1)
+  , m_precision(-1)
 {
   // Get pointers to serial studio modules
   auto dash = &UI::Dashboard::instance();
@@ -56,10 +59,22 @@ Widgets::DataGroup::DataGroup(const int index)
   // Get group reference
   auto group = dash->getGroups(m_index);
 
+  // Find the position of the group in the frame to obtain its statistics
+  const auto &frame = dash->currentFrame();
+  for (int i = 0, count = 0; i < frame.groupCount(); ++i)
+  {
+    if (frame.getGroup(i).widget().isEmpty() && count++ == m_index)
+    {
+      m_group = i;
+      break;
+    }
+  }
+
   // Generate widget stylesheets
   auto titleQSS = QSS("color:%1", theme->widgetTextPrimary());
   auto unitsQSS = QSS("color:%1", theme->widgetTextSecondary());
   auto valueQSS = QSS("color:%1", theme->widgetForegroundPrimary());
+  auto statsQSS = QSS("color:%1", theme->widgetTextSecondary());
   auto iconsQSS
       = QSS("color:%1; font-weight:600;", theme->widgetTextSecondary());
 
@@ -81,6 +96,7 @@ Widgets::DataGroup::DataGroup(const int index)
   m_icons.reserve(group.datasetCount());
   m_titles.reserve(group.datasetCount());
   m_values.reserve(group.datasetCount());
+  m_stats.reserve(group.datasetCount());
   m_gridLayout = new QGridLayout(m_dataContainer);
   for (int dataset = 0; dataset < group.datasetCount(); ++dataset)
   {
@@ -89,31 +105,37 @@ Widgets::DataGroup::DataGroup(const int index)
     m_icons.append(new QLabel(m_dataContainer));
     m_titles.append(new ElidedLabel(m_dataContainer));
     m_values.append(new ElidedLabel(m_dataContainer));
+    m_stats.append(new ElidedLabel(m_dataContainer));
 
     // Get pointers to labels
     auto dicon = m_icons.last();
     auto units = m_units.last();
     auto title = m_titles.last();
     auto value = m_values.last();
+    auto stats = m_stats.last();
 
-    // Set elide modes for title & value fields
+    // Set elide modes for title, value & statistics fields
     title->setType(Qt::ElideRight);
     value->setType(Qt::ElideRight);
+    stats->setType(Qt::ElideRight);
 
     // Set label alignments
     units->setAlignment(Qt::AlignLeft | Qt::AlignVCenter);
     value->setAlignment(Qt::AlignRight | Qt::AlignVCenter);
     title->setAlignment(Qt::AlignRight | Qt::AlignVCenter);
     dicon->setAlignment(Qt::AlignHCenter | Qt::AlignVCenter);
+    stats->setAlignment(Qt::AlignHCenter | Qt::AlignVCenter);
 
     // Set label styles & fonts
     value->setFont(valueFont);
     title->setFont(dash->monoFont());
     units->setFont(dash->monoFont());
+    stats->setFont(dash->monoFont());
     title->setStyleSheet(titleQSS);
     value->setStyleSheet(valueQSS);
     units->setStyleSheet(unitsQSS);
     dicon->setStyleSheet(iconsQSS);
+    stats->setStyleSheet(statsQSS);
 
     // Set label initial data
     auto set = group.getDataset(dataset);
@@ -124,11 +146,14 @@ Widgets::DataGroup::DataGroup(const int index)
     // Set icon text
     dicon->setText("⤑");
 
-    // Add labels to grid layout
-    m_gridLayout->addWidget(title, dataset, 0);
-    m_gridLayout->addWidget(dicon, dataset, 1);
-    m_gridLayout->addWidget(value, dataset, 2);
-    m_gridLayout->addWidget(units, dataset, 3);
+    // Add labels to grid layout, statistics are shown below each dataset
+    const auto row = dataset * 2;
+    m_gridLayout->addWidget(title, row, 0);
+    m_gridLayout->addWidget(dicon, row, 1);
+    m_gridLayout->addWidget(value, row, 2);
+    m_gridLayout->addWidget(units, row, 3);
+    m_gridLayout->addWidget(stats, row + 1, 0, 1, 4);
+    stats->setVisible(false);
   }
 
   // Load layout into container widget
@@ -155,6 +180,12 @@ Widgets::DataGroup::DataGroup(const int index)
   // React to dashboard events
   connect(dash, SIGNAL(updated()), this, SLOT(updateData()),
           Qt::QueuedConnection);
+
+  // Update the statistics at a human-readable rate
+  connect(&Misc::TimerEvents::instance(), &Misc::TimerEvents::timeout10Hz,
+          this, &Widgets::DataGroup::updateStatistics);
+  connect(&DSP::Statistics::instance(), &DSP::Statistics::enabledChanged,
+          this, &Widgets::DataGroup::updateStatistics);
 }
 
 /**
@@ -174,6 +205,9 @@ Widgets::DataGroup::~DataGroup()
   Q_FOREACH (auto units, m_units)
     delete units;
 
+  Q_FOREACH (auto stats, m_stats)
+    delete stats;
+
   delete m_gridLayout;
   delete m_scrollArea;
   delete m_mainLayout;
@@ -198,25 +232,93 @@ void Widgets::DataGroup::updateData()
     return;
 
   // Get group reference
-  auto group = dash->getGroups(m_index);
+  const auto &group = dash->getGroups(m_index);
 
-  // Regular expresion handler
-  const QRegularExpression regex("^[+-]?(\\d*\\.)?\\d+$");
+  // Format all values again if the number of decimal places changed
+  if (m_precision != dash->precision()
+      || m_rawValues.count() != group.datasetCount())
+  {
+    m_precision = dash->precision();
+    m_rawValues.clear();
+    m_rawValues.resize(group.datasetCount());
+  }
 
   // Update labels
-  for (int i = 0; i < group.datasetCount(); ++i)
+  for (int i = 0; i < group.datasetCount() && i < m_values.count(); ++i)
   {
-    // Get dataset value
-    auto value = group.getDataset(i).value();
+    // Only format the value & update the label if the value changed
+    const auto &dataset = group.getDataset(i);
+    const auto raw = dataset.value();
+    if (raw == m_rawValues.at(i))
+      continue;
 
     // Check if value is a number, if so make sure that
     // we always show a fixed number of decimal places
-    if (regex.match(value).hasMatch())
-      value = QString::number(value.toDouble(), 'f', dash->precision());
+    m_rawValues[i] = raw;
+    if (dataset.isNumeric())
+      m_values.at(i)->setText(
+          QString::number(dataset.numericValue(), 'f', m_precision) + " ");
+    else
+      m_values.at(i)->setText(raw + " ");
+  }
+
+  // Repaint widget
+  requestRepaint();
+}
 
-    // Update label
-    if (m_values.count() > i)
-      m_values.at(i)->setText(value + " ");
+/**
+ * Shows the statistics of each numeric dataset of the group below its value,
+ * or hides them if the statistics module is disabled. If the window
+ * statistics are enabled, the mean & standard deviation of the window are
+ * displayed instead of the ones of the whole session.
+ */
+void Widgets::DataGroup::updateStatistics()
+{
+  // Widget not enabled, do nothing
+  if (!isEnabled())
+    return;
+
+  // Show or hide statistics labels
+  auto statistics = &DSP::Statistics::instance();
+  const auto visible = statistics->enabled();
+  for (int i = 0; i < m_stats.count(); ++i)
+  {
+    if (m_stats.at(i)->isVisibleTo(this) != visible)
+    {
+      m_stats.at(i)->setVisible(visible);
+      requestRepaint();
+    }
+  }
+
+  // Statistics disabled, nothing more to do
+  if (!visible)
+    return;
+
+  // Update statistics labels
+  const auto windowed = statistics->windowSize() > 0;
+  const auto precision = UI::Dashboard::instance().precision();
+  for (int i = 0; i < m_stats.count(); ++i)
+  {
+    // Dataset without numeric values
+    if (!statistics->contains(m_group, i)
+        || statistics->get(m_group, i).count() <= 0)
+    {
+      m_stats.at(i)->setText("");
+      continue;
+    }
+
+    // Format statistics
+    const auto &s = statistics->get(m_group, i);
+    const auto mean = windowed ? s.windowMean() : s.mean();
+    const auto stdDev = windowed ? s.windowStdDev() : s.stdDev();
+    m_stats.at(i)->setText(
+        tr("min %1 · max %2 · μ %3 · σ %4 · p50 %5 · p95 %6")
+            .arg(QString::number(s.minimum(), 'f', precision),
+                 QString::number(s.maximum(), 'f', precision),
+                 QString::number(mean, 'f', precision),
+                 QString::number(stdDev, 'f', precision),
+                 QString::number(s.median(), 'f', precision),
+                 QString::number(s.percentile95(), 'f', precision)));
   }
 
   // Repaint widget
@@ -235,6 +337,8 @@ void Widgets::DataGroup::resizeEvent(QResizeEvent *event)
   icon.setPixelSize(qMax(8, width / 16));
   font.setPixelSize(qMax(8, width / 24));
   valueFont.setPixelSize(font.pixelSize() * 1.3);
+  QFont statsFont = font;
+  statsFont.setPixelSize(qMax(8, font.pixelSize() * 2 / 3));
 
   for (int i = 0; i < m_titles.count(); ++i)
   {
@@ -242,6 +346,7 @@ void Widgets::DataGroup::resizeEvent(QResizeEvent *event)
     m_icons.at(i)->setFont(icon);
     m_titles.at(i)->setFont(font);
     m_values.at(i)->setFont(valueFont);
+    m_stats.at(i)->setFont(statsFont);
   }
 
   event->accept();
@@ -41,6 +41,7 @@ public:
 
 private Q_SLOTS:
   void updateData();
+  void updateStatistics();
 
 protected:
   void resizeEvent(QResizeEvent *event);
@@ -52,11 +53,15 @@ protected:
 
 private:
   int m_index;
+  int m_group;
+  int m_precision;
+  QVector<QString> m_rawValues;
 
   QVector<QLabel *> m_icons;
   QVector<QLabel *> m_units;
   QVector<ElidedLabel *> m_titles;
   QVector<ElidedLabel *> m_values;
+  QVector<ElidedLabel *> m_stats;
 
   QWidget *m_dataContainer;
   QVBoxLayout *m_mainLayout;
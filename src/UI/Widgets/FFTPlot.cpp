@@ -21,23 +21,22 @@
  */
 
 #include <UI/Dashboard.h>
+#include <DSP/SpectrumAnalyzer.h>
 #include <Misc/ThemeManager.h>
+#include <Misc/Instrumentation.h>
 #include <UI/Widgets/FFTPlot.h>
+#include <UI/Widgets/Common/Decimator.h>
 
 /**
  * Constructor function, configures widget style & signal/slot connections.
  */
 Widgets::FFTPlot::FFTPlot(const int index)
-  : m_size(0)
-  , m_index(index)
+  : m_index(index)
 {
   // Get pointers to serial studio modules
   auto dash = &UI::Dashboard::instance();
   auto theme = &Misc::ThemeManager::instance();
-
-  // Initialize pointers to NULL
-  m_fft = Q_NULLPTR;
-  m_samples = Q_NULLPTR;
+  auto analyzer = &DSP::SpectrumAnalyzer::instance();
 
   // Invalid index, abort initialization
   if (m_index < 0 || m_index >= dash->fftCount())
@@ -86,89 +85,80 @@ Widgets::FFTPlot::FFTPlot(const int index)
   // Set curve color & plot style
   m_curve.setPen(QColor(color), 2, Qt::SolidLine);
 
-  // Get dataset max freq. & calculate fft size
+  // Set axis titles & scale magnitudes automatically
   auto dataset = UI::Dashboard::instance().getFFT(m_index);
-  int size = qMax(8, dataset.fftSamples());
-
-  // Ensure that FFT size is valid
-  while (m_transformer.setSize(size) != QFourierTransformer::FixedSize)
-    --size;
-
-  // Set FFT size
-  m_size = size;
-
-  // Initialize samples & FFT arrays
-  m_fft = (float *)calloc(m_size, sizeof(float));
-  m_samples = (float *)calloc(m_size, sizeof(float));
-
-  // Clear Y-axis data
-  PlotData xData;
-  PlotData yData;
-  xData.reserve(m_size);
-  yData.reserve(m_size);
-  for (int i = 0; i < m_size; ++i)
-  {
-    yData.append(0);
-    xData.append(i);
-  }
+  m_plot.setAxisAutoScale(QwtPlot::yLeft, true);
+  m_plot.setAxisTitle(QwtPlot::yLeft,
+                      tr("Magnitude of %1 (dB)").arg(dataset.title()));
+  updateAxis();
 
-  // Set y-scale from -1 to 1
-  m_plot.setAxisScale(QwtPlot::yLeft, -1, 1);
-
-  // Set axis titles
-  m_plot.setAxisTitle(QwtPlot::xBottom, tr("Samples"));
-  m_plot.setAxisTitle(QwtPlot::yLeft, tr("FFT of %1").arg(dataset.title()));
-
-  // Set curve data & replot
-  m_curve.setSamples(xData, yData);
-  m_plot.replot();
-
-  // React to dashboard events
+  // React to dashboard & spectrum analyzer events
   connect(dash, SIGNAL(updated()), this, SLOT(updateData()),
           Qt::QueuedConnection);
+  connect(analyzer, &DSP::SpectrumAnalyzer::spectrumChanged, this,
+          &Widgets::FFTPlot::drawSpectrum);
+  connect(analyzer, &DSP::SpectrumAnalyzer::sampleRateChanged, this,
+          &Widgets::FFTPlot::updateAxis);
 }
 
 /**
- * Destructor function
+ * Checks if the widget is enabled, if so, the spectrum of the latest samples
+ * is requested to the spectrum analyzer, which calculates it in its own
+ * thread & notifies the widget through the @c drawSpectrum() function.
+ *
+ * If the widget is disabled (e.g. the user hides it, or the external
+ * window is hidden), the spectrum is not calculated at all.
  */
-Widgets::FFTPlot::~FFTPlot()
+void Widgets::FFTPlot::updateData()
 {
-  free(m_fft);
-  free(m_samples);
-  m_fft = Q_NULLPTR;
-  m_samples = Q_NULLPTR;
+  if (isEnabled())
+    DSP::SpectrumAnalyzer::instance().request(m_index);
 }
 
 /**
- * Checks if the widget is enabled, if so, the widget shall be updated
- * to display the latest data frame.
- *
- * If the widget is disabled (e.g. the user hides it, or the external
- * window is hidden), then the new data shall be saved to the plot
- * vector, but the widget shall not be redrawn.
+ * Updates the title of the horizontal axis, which shows frequencies if the
+ * sample rate is known, or frequency bins otherwise.
  */
-void Widgets::FFTPlot::updateData()
+void Widgets::FFTPlot::updateAxis()
+{
+  const auto sampleRate = DSP::SpectrumAnalyzer::instance().sampleRate();
+  if (sampleRate > 0)
+    m_plot.setAxisTitle(QwtPlot::xBottom, tr("Frequency (Hz)"));
+  else
+    m_plot.setAxisTitle(QwtPlot::xBottom,
+                        tr("Frequency (Hz, at measured frame rate)"));
+}
+
+/**
+ * Draws the spectrum calculated by the spectrum analyzer for the FFT dataset
+ * with the given @a index, if it belongs to this widget.
+ */
+void Widgets::FFTPlot::drawSpectrum(const int index)
 {
-  // Verify that FFT sample arrays are valid
-  if (!m_samples || !m_fft)
+  // Spectrum of another widget, or widget not visible
+  if (index != m_index || !isEnabled())
     return;
 
-  // Replot
-  auto plotData = UI::Dashboard::instance().fftPlotValues();
-  if (plotData.count() > m_index)
+  // Decimate the spectrum to the width of the plot
+  auto analyzer = &DSP::SpectrumAnalyzer::instance();
+  const auto &spectrum = analyzer->spectrum(m_index);
+  Decimator::minMax(spectrum.magnitudes, m_plot.canvas()->width(), m_points);
+
+  // Convert bin numbers to frequencies
+  const auto sampleRate = analyzer->effectiveSampleRate();
+  const auto resolution = spectrum.size > 0 && sampleRate > 0
+                              ? sampleRate / spectrum.size
+                              : 1.0;
+  for (int i = 0; i < m_points.count(); ++i)
+    m_points[i].setX(m_points.at(i).x() * resolution);
+
+  // Replot graph
+  m_curve.setSamples(m_points);
   {
-    // Copy data to samples array
-    auto data = plotData.at(m_index);
-    for (int i = 0; i < m_size; ++i)
-      m_samples[i] = static_cast<float>(data[i]);
-
-    // Execute FFT
-    m_transformer.forwardTransform(m_samples, m_fft);
-    m_transformer.rescale(m_fft);
-    m_curve.setSamples(m_fft, m_size);
+    Misc::Instrumentation::ScopedTimer timer(Misc::Instrumentation::Replot);
     m_plot.replot();
-
-    // Repaint widget
-    requestRepaint();
   }
+
+  // Repaint widget
+  requestRepaint();
 }
@@ -104,11 +104,11 @@ void Widgets::GPS::updateData()
   {
     auto dataset = group.getDataset(i);
     if (dataset.widget() == "lat")
-      m_latitude = dataset.value().toDouble();
+      m_latitude = dataset.numericValue();
     else if (dataset.widget() == "lon")
-      m_longitude = dataset.value().toDouble();
+      m_longitude = dataset.numericValue();
     else if (dataset.widget() == "alt")
-      m_altitude = dataset.value().toDouble();
+      m_altitude = dataset.numericValue();
   }
 
   // Update the QML user interface with the new data
@@ -91,9 +91,9 @@ void Widgets::Gauge::updateData()
 
   // Update gauge value
   auto dataset = dash->getGauge(m_index);
-  m_gauge.setValue(dataset.value().toDouble());
+  m_gauge.setValue(dataset.numericValue());
   setValue(QString("%1 %2").arg(
-      QString::number(dataset.value().toDouble(), 'f', dash->precision()),
+      QString::number(dataset.numericValue(), 'f', dash->precision()),
       dataset.units()));
 
   // Repaint widget
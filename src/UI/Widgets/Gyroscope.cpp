@@ -94,11 +94,11 @@ void Widgets::Gyroscope::updateData()
   {
     auto dataset = group.getDataset(i);
     if (dataset.widget() == "pitch")
-      p = dataset.value().toDouble();
+      p = dataset.numericValue();
     if (dataset.widget() == "roll")
-      r = dataset.value().toDouble();
+      r = dataset.numericValue();
     if (dataset.widget() == "yaw")
-      y = dataset.value().toDouble();
+      y = dataset.numericValue();
   }
 
   // Construct strings from pitch, roll & yaw
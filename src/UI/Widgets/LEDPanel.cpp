@@ -169,7 +169,7 @@ void Widgets::LEDPanel::updateData()
       break;
 
     // Get dataset value (we compare with 0.1 for low voltages)
-    auto value = group.getDataset(i).value().toDouble();
+    auto value = group.getDataset(i).numericValue();
     if (qAbs(value) < 0.10)
       m_leds.at(i)->off();
     else
@@ -23,13 +23,18 @@
 #include <CSV/Player.h>
 #include <UI/Dashboard.h>
 #include <Misc/ThemeManager.h>
+#include <Misc/Instrumentation.h>
 #include <UI/Widgets/MultiPlot.h>
+#include <UI/Widgets/Common/Decimator.h>
 
 /**
  * Constructor function, configures widget style & signal/slot connections.
  */
 Widgets::MultiPlot::MultiPlot(const int index)
   : m_index(index)
+  , m_window(0)
+  , m_newSamples(0)
+  , m_sweepStart(0)
 {
   // Get pointers to serial studio modules
   auto dash = &UI::Dashboard::instance();
@@ -100,7 +105,6 @@ Widgets::MultiPlot::MultiPlot(const int index)
   // Add plot legend to display curve names
   m_legend.setFrameStyle(QFrame::Plain);
   m_plot.setAxisTitle(QwtPlot::yLeft, group.title());
-  m_plot.setAxisTitle(QwtPlot::xBottom, tr("Samples"));
   m_plot.insertLegend(&m_legend, QwtPlot::BottomLegend);
 
   // Normalize data curves
@@ -114,24 +118,31 @@ Widgets::MultiPlot::MultiPlot(const int index)
 
   // React to dashboard events
   // clang-format off
+    connect(dash, SIGNAL(updated()),
+            this, SLOT(appendData()));
     connect(dash, SIGNAL(updated()),
             this, SLOT(updateData()),
             Qt::QueuedConnection);
     connect(dash, SIGNAL(pointsChanged()),
             this, SLOT(updateRange()),
             Qt::QueuedConnection);
+    connect(dash, SIGNAL(sweepModeChanged()),
+            this, SLOT(updateRange()),
+            Qt::QueuedConnection);
+    connect(dash, SIGNAL(timeWindowChanged()),
+            this, SLOT(updateRange()),
+            Qt::QueuedConnection);
   // clang-format on
 }
 
 /**
- * Checks if the widget is enabled, if so, the widget shall be updated
- * to display the latest data frame.
+ * Appends the values of the latest frame to the plot data.
  *
- * If the widget is disabled (e.g. the user hides it, or the external
- * window is hidden), then the new data shall be saved to the plot
- * vectors, but the widget shall not be redrawn.
+ * This slot is called once for every frame processed by the dashboard, while
+ * the (queued) redraw may handle several frames at once, so the plot data
+ * must be stored here.
  */
-void Widgets::MultiPlot::updateData()
+void Widgets::MultiPlot::appendData()
 {
   // Invalid index, abort update
   auto dash = &UI::Dashboard::instance();
@@ -141,47 +152,175 @@ void Widgets::MultiPlot::updateData()
   // Get group
   auto group = dash->getMultiplot(m_index);
 
-  // Plot each dataset
+  // Get the time at which the frame was received
+  const auto window = m_window;
+  const auto &time = dash->plotTimestamps();
+  const bool timed = window > 0 && !time.isEmpty();
+  const auto now = timed ? time.last() : 0.0;
+  if (timed)
+    m_time.append(now);
+
+  // Add the value of each dataset to the plot data
   for (int i = 0; i < group.datasetCount(); ++i)
   {
     // Check vector size
-    if (m_yData.count() < i)
+    if (m_yData.count() <= i)
       break;
 
     // Get dataset
     auto dataset = group.getDataset(i);
 
-    // Add point to plot data
-    auto data = m_yData[i].data();
-    auto count = m_yData[i].count();
-    memmove(data, data + 1, count * sizeof(double));
-
     // Normalize dataset value
+    double y;
     if (dataset.max() > dataset.min())
     {
       auto vmin = dataset.min();
       auto vmax = dataset.max();
-      auto v = dataset.value().toDouble();
-      m_yData[i][count - 1] = (v - vmin) / (vmax - vmin);
+      auto v = dataset.numericValue();
+      y = (v - vmin) / (vmax - vmin);
     }
 
     // Plot dataset value directly
     else
-      m_yData[i][count - 1] = dataset.value().toDouble();
+      y = dataset.numericValue();
 
-    // Widget not enabled, do not redraw
-    if (!isEnabled())
-      continue;
+    // Add point to plot data
+    if (timed)
+      m_yData[i].append(y);
+    else
+    {
+      auto data = m_yData[i].data();
+      auto count = m_yData[i].count();
+      memmove(data, data + 1, (count - 1) * sizeof(double));
+      m_yData[i][count - 1] = y;
+    }
+  }
+
+  // Remove samples that are no longer inside the time window
+  if (timed)
+    trimData(now - window);
+
+  // Register the new sample for the next redraw
+  ++m_newSamples;
+}
+
+/**
+ * Checks if the widget is enabled, if so, the widget shall be updated
+ * to display the samples received since the last update.
+ *
+ * If the widget is disabled (e.g. the user hides it, or the external
+ * window is hidden), then the new data is only kept in the plot vectors
+ * (see @c appendData()), and the widget shall not be redrawn.
+ */
+void Widgets::MultiPlot::updateData()
+{
+  // Get the number of samples received since the last update
+  const auto available = m_yData.isEmpty() ? 0 : m_yData.first().count();
+  const auto added = qMin(m_newSamples, available);
+  m_newSamples = 0;
+
+  // Widget not enabled or nothing new to draw
+  if (!isEnabled() || added <= 0)
+    return;
+
+  // Sweep mode, only draw the newest segments of each curve
+  if (!m_sweepData.isEmpty())
+    sweep(added);
+
+  // Plot the samples received during the time window, or the complete plot
+  // data, drawing at most two vertices per pixel column
+  else
+  {
+    const auto window = m_window;
+    const bool timed = window > 0 && !m_time.isEmpty();
+    const auto now = timed ? m_time.last() : 0.0;
+    for (int i = 0; i < m_yData.count() && i < m_curves.count(); ++i)
+    {
+      if (timed)
+        Decimator::minMax(m_time, m_yData[i], now - window, now,
+                          m_plot.canvas()->width(), m_points);
+      else
+        Decimator::minMax(m_yData[i], m_plot.canvas()->width(), m_points);
+
+      m_curves.at(i)->setSamples(m_points);
+    }
 
-    // Plot new data
-    m_curves.at(i)->setSamples(m_yData[i]);
+    Misc::Instrumentation::ScopedTimer timer(Misc::Instrumentation::Replot);
+    m_plot.replot();
   }
 
-  // Plot widget again
-  if (isEnabled())
+  // Repaint widget
+  requestRepaint();
+}
+
+/**
+ * Appends the last @a added samples of each dataset to the sweep & paints
+ * the segments that join them with the previous samples directly over the
+ * plot canvas.
+ *
+ * The whole plot is replotted when the sweep reaches the right side of the
+ * plot, or if a sample does not fit in the vertical scale.
+ */
+void Widgets::MultiPlot::sweep(const int added)
+{
+  auto dash = &UI::Dashboard::instance();
+  const auto window = m_window;
+  const auto count = m_yData.first().count();
+  const bool timed = window > 0 && m_time.count() == count;
+  const auto limit = timed ? window : dash->points();
+  const auto curves = qMin(m_sweepData.count(), m_yData.count());
+  const auto autoscale = m_plot.axisAutoScale(QwtPlot::yLeft);
+  const auto interval = m_plot.axisInterval(QwtPlot::yLeft);
+
+  // Add each new sample to the curves, its horizontal position is the number
+  // of seconds since the sweep started for time-based plots or the sample
+  // number
+  bool replot = false;
+  int first = static_cast<int>(m_sweepData.first()->size());
+  for (int s = count - added; s < count; ++s)
   {
+    const auto now = timed ? m_time.at(s) : 0.0;
+    if (m_sweepData.first()->size() == 0)
+      m_sweepStart = now;
+
+    double x = timed ? now - m_sweepStart : m_sweepData.first()->size();
+
+    // Start a new sweep from the left side of the plot
+    if (x >= limit)
+    {
+      for (int i = 0; i < m_sweepData.count(); ++i)
+        m_sweepData.at(i)->clear();
+
+      x = 0;
+      first = 0;
+      replot = true;
+      m_sweepStart = now;
+    }
+
+    // The whole plot must be replotted if the sample does not fit in the
+    // vertical scale
+    for (int i = 0; i < curves; ++i)
+    {
+      const auto y = m_yData[i].at(s);
+      m_sweepData.at(i)->append(QPointF(x, y));
+      if (autoscale)
+        replot |= !interval.contains(y);
+    }
+  }
+
+  // Draw the new segments, or the complete plot if required
+  Misc::Instrumentation::ScopedTimer timer(Misc::Instrumentation::Replot);
+  if (replot)
     m_plot.replot();
-    requestRepaint();
+
+  else
+  {
+    for (int i = 0; i < curves; ++i)
+    {
+      const int last = static_cast<int>(m_sweepData.at(i)->size()) - 1;
+      if (last > 0)
+        m_painter.drawSeries(m_curves.at(i), qMax(0, first - 1), last);
+    }
   }
 }
 
@@ -195,21 +334,88 @@ void Widgets::MultiPlot::updateRange()
   if (m_index < 0 || m_index >= dash->multiPlotCount())
     return;
 
-  // Set number of points
+  // Set number of points (time-based plots start empty, since their data
+  // grows as new frames are received)
+  m_time.clear();
   m_yData.clear();
+  m_newSamples = 0;
+  m_window = dash->timeWindow();
+  const auto window = m_window;
   auto group = UI::Dashboard::instance().getMultiplot(m_index);
   for (int i = 0; i < group.datasetCount(); ++i)
   {
     m_yData.append(PlotData());
+    if (window > 0)
+      continue;
+
     m_yData.last().resize(dash->points());
     std::fill(m_yData.last().begin(), m_yData.last().end(), 0.0001);
   }
 
-  // Create curve from data
-  for (int i = 0; i < group.datasetCount(); ++i)
-    if (m_curves.count() > i)
-      m_curves.at(i)->setSamples(dash->xPlotValues(), m_yData[i]);
+  // Set horizontal axis title
+  if (window > 0)
+    m_plot.setAxisTitle(QwtPlot::xBottom, tr("Time (s)"));
+  else
+    m_plot.setAxisTitle(QwtPlot::xBottom, tr("Samples"));
+
+  // Sweep mode, draw samples from left to right over a fixed horizontal scale
+  m_sweepData.clear();
+  if (dash->sweepMode())
+  {
+    for (int i = 0; i < group.datasetCount() && i < m_curves.count(); ++i)
+    {
+      auto data = new SweepData;
+      data->reserve(dash->points());
+      m_curves.at(i)->setData(data);
+      m_sweepData.append(data);
+    }
+
+    if (window > 0)
+      m_plot.setAxisScale(QwtPlot::xBottom, 0, window);
+    else
+      m_plot.setAxisScale(QwtPlot::xBottom, 0, qMax(1, dash->points() - 1));
+  }
+
+  // Time-based plot, show the samples received during the time window
+  else if (window > 0)
+  {
+    for (int i = 0; i < m_curves.count(); ++i)
+      m_curves.at(i)->setSamples(QVector<QPointF>());
+
+    m_plot.setAxisScale(QwtPlot::xBottom, -window, 0);
+  }
+
+  // Scroll mode, create curve from data
+  else
+  {
+    for (int i = 0; i < group.datasetCount(); ++i)
+      if (m_curves.count() > i)
+        m_curves.at(i)->setSamples(dash->xPlotValues(), m_yData[i]);
+
+    m_plot.setAxisAutoScale(QwtPlot::xBottom, true);
+  }
+
+  // Redraw graph
+  m_plot.replot();
 
   // Repaint widget
   requestRepaint();
 }
+
+/**
+ * Removes the samples received before @a oldest from the plot data. Stale
+ * samples are only removed once they take a quarter of the buffers, since
+ * the decimator skips them with a binary search.
+ */
+void Widgets::MultiPlot::trimData(const double oldest)
+{
+  const auto count = m_time.count();
+  const auto begin = m_time.constBegin();
+  auto stale = std::lower_bound(begin, m_time.constEnd(), oldest) - begin;
+  if (stale > 0 && stale >= count / 4)
+  {
+    m_time.remove(0, stale);
+    for (int i = 0; i < m_yData.count(); ++i)
+      m_yData[i].remove(0, stale);
+  }
+}
@@ -28,9 +28,11 @@
 #include <QVBoxLayout>
 #include <QwtPlotCurve>
 #include <QwtScaleEngine>
+#include <QwtPlotDirectPainter>
 
 #include <UI/Dashboard.h>
 #include <UI/DashboardWidget.h>
+#include <UI/Widgets/Common/SweepData.h>
 
 namespace Widgets
 {
@@ -42,15 +44,27 @@ public:
   MultiPlot(const int index = -1);
 
 private Q_SLOTS:
+  void appendData();
   void updateData();
   void updateRange();
 
+private:
+  void sweep(const int added);
+  void trimData(const double oldest);
+
 private:
   int m_index;
+  int m_window;
+  int m_newSamples;
+  double m_sweepStart;
   QwtPlot m_plot;
   QwtLegend m_legend;
   QVBoxLayout m_layout;
   QVector<QwtPlotCurve *> m_curves;
+  PlotData m_time;
   QVector<PlotData> m_yData;
+  QVector<QPointF> m_points;
+  QVector<SweepData *> m_sweepData;
+  QwtPlotDirectPainter m_painter;
 };
 } // namespace Widgets
@@ -22,8 +22,11 @@
 
 #include <CSV/Player.h>
 #include <UI/Dashboard.h>
+#include <History/Store.h>
 #include <UI/Widgets/Plot.h>
+#include <UI/Widgets/Common/Decimator.h>
 #include <Misc/ThemeManager.h>
+#include <Misc/Instrumentation.h>
 
 /**
  * Constructor function, configures widget style & signal/slot connections.
@@ -33,6 +36,10 @@ Widgets::Plot::Plot(const int index)
   , m_min(INT_MAX)
   , m_max(INT_MIN)
   , m_autoscale(true)
+  , m_resync(true)
+  , m_sweepStart(0)
+  , m_sampleCount(0)
+  , m_sweepData(Q_NULLPTR)
 {
   // Get pointers to serial studio modules
   auto dash = &UI::Dashboard::instance();
@@ -112,7 +119,6 @@ Widgets::Plot::Plot(const int index)
   // clang-format on
 
   // Set axis titles
-  m_plot.setAxisTitle(QwtPlot::xBottom, tr("Samples"));
   m_plot.setAxisTitle(QwtPlot::yLeft, dataset.title());
 
   // React to dashboard events
@@ -123,6 +129,14 @@ Widgets::Plot::Plot(const int index)
     connect(dash, SIGNAL(pointsChanged()),
             this, SLOT(updateRange()),
             Qt::QueuedConnection);
+    connect(dash, SIGNAL(sweepModeChanged()),
+            this, SLOT(updateRange()),
+            Qt::QueuedConnection);
+    connect(dash, SIGNAL(timeWindowChanged()),
+            this, SLOT(updateRange()),
+            Qt::QueuedConnection);
+    connect(dash, &UI::Dashboard::dataReset,
+            this, [=]() { m_resync = true; });
   // clang-format on
 }
 
@@ -138,79 +152,264 @@ void Widgets::Plot::updateData()
 {
   // Widget not enabled, do not redraw
   if (!isEnabled())
+  {
+    m_resync = true;
     return;
+  }
 
   // Get new data
-  auto plotData = UI::Dashboard::instance().linearPlotValues();
+  auto dash = &UI::Dashboard::instance();
+  auto plotData = dash->linearPlotValues();
   if (plotData.count() > m_index)
   {
+    // Time-based plot, decimate the samples received during the time window
+    // (reading them from the history if the plot buffer is too short)
+    const auto &values = plotData.at(m_index);
+    const auto added = newSamples(values.count());
+    const auto &time = dash->plotTimestamps();
+    const bool timed = !m_sweepData && dash->timeWindow() > 0
+                       && time.count() == values.count();
+    if (timed && !time.isEmpty())
+    {
+      const auto end = time.last();
+      const auto begin = end - dash->timeWindow();
+      if (time.first() <= begin || !queryHistory(begin, end))
+        Decimator::minMax(time, values, begin, end, m_plot.canvas()->width(),
+                          m_points);
+    }
+
+    else if (timed)
+      m_points.clear();
+
     // Check if we need to update graph scale
+    bool rescaled = false;
+    const bool resync = m_resync;
     if (m_autoscale)
     {
-      // Scan new values to see if chart should be updated
-      bool changed = false;
-      for (int i = 0; i < plotData.at(m_index).count(); ++i)
+      // The decimated samples of the time window contain its extremes
+      double vmin = 0;
+      double vmax = 0;
+      if (timed)
       {
-        auto v = plotData.at(m_index).at(i);
-        if (v > m_max)
+        m_resync = false;
+        for (int i = 0; i < m_points.count(); ++i)
         {
-          m_max = v + 1;
-          changed = true;
-        }
-
-        if (v < m_min)
-        {
-          m_min = v - 1;
-          changed = true;
+          const auto y = m_points.at(i).y();
+          vmin = i > 0 ? qMin(vmin, y) : y;
+          vmax = i > 0 ? qMax(vmax, y) : y;
         }
       }
 
-      // Update graph scale
-      if (changed)
+      // Track the extremes of the visible samples, adding every sample
+      // received since the last update (only scan them all if samples were
+      // skipped or the number of points changed)
+      else
       {
-        // Get central value
-        double median = qMax<double>(1, (m_max + m_min)) / 2;
-        if (m_max == m_min)
-          median = m_max;
-
-        // Center graph verticaly
-        double mostDiff
-            = qMax<double>(qAbs<double>(m_min), qAbs<double>(m_max));
-        double min = median * (1 - 0.5) - qAbs<double>(median - mostDiff);
-        double max = median * (1 + 0.5) + qAbs<double>(median - mostDiff);
-        if (m_min < 0)
-          min = max * -1;
-
-        // Fix issues when min & max are equal
-        if (min == max)
+        const auto count = values.count();
+        if (m_resync || m_extremes.window() != count || added >= count)
         {
-          max = qAbs<double>(max);
-          min = max * -1;
+          m_resync = false;
+          m_extremes.reset(values);
         }
 
-        // Fix issues on min = max = (0,0)
-        if (min == 0 && max == 0)
+        else
         {
-          max = 1;
-          min = -1;
+          for (int i = count - added; i < count; ++i)
+            m_extremes.append(values.at(i));
         }
 
-        // Update axis scale
-        m_max = max;
-        m_min = min;
+        vmin = m_extremes.minimum();
+        vmax = m_extremes.maximum();
+      }
+
+      // Expand the scale if the samples do not fit in it
+      bool changed = false;
+      if (vmax > m_max)
+      {
+        m_max = vmax + 1;
+        changed = true;
+      }
+
+      if (vmin < m_min)
+      {
+        m_min = vmin - 1;
+        changed = true;
+      }
+
+      // Update axis scale
+      if (changed)
+      {
+        rescaled = true;
+        centerScale(m_min, m_max, m_min, m_max);
         m_plot.setAxisScale(m_plot.yLeft, m_min, m_max);
       }
     }
 
-    // Replot graph
-    m_curve.setSamples(plotData.at(m_index));
-    m_plot.replot();
+    // Sweep mode, only draw the newest segment of the curve
+    if (m_sweepData)
+    {
+      m_resync = false;
+      sweep(values, added, resync || rescaled);
+    }
+
+    // Replot graph, drawing at most two vertices per pixel column
+    else
+    {
+      if (!timed)
+        Decimator::minMax(values, m_plot.canvas()->width(), m_points);
+
+      m_curve.setSamples(m_points);
+
+      Misc::Instrumentation::ScopedTimer timer(Misc::Instrumentation::Replot);
+      m_plot.replot();
+    }
 
     // Repaint widget
     requestRepaint();
   }
 }
 
+/**
+ * Returns the number of samples appended to the plot data since the last
+ * update, limited to the @a available samples.
+ *
+ * The dashboard may process several frames before the queued update reaches
+ * the widget, so the newest sample is not always the only new one.
+ */
+int Widgets::Plot::newSamples(const int available)
+{
+  const auto count = UI::Dashboard::instance().sampleCount();
+  const auto added = qMin<qint64>(count - m_sampleCount, available);
+  m_sampleCount = count;
+  return static_cast<int>(qMax<qint64>(0, added));
+}
+
+/**
+ * Fills the curve points with the decimated history of the plotted dataset
+ * between the @a begin and @a end timestamps (in seconds).
+ *
+ * Returns @c false if the history does not contain samples older than the
+ * plot buffer, in which case the plot buffer should be used instead.
+ */
+bool Widgets::Plot::queryHistory(const double begin, const double end)
+{
+  // Get the history of the dataset
+  auto store = &History::Store::instance();
+  const auto index = store->plotSeries(m_index);
+  if (index < 0)
+    return false;
+
+  // Check if the history goes further back than the plot buffer
+  const auto &series = store->series(index);
+  const auto &time = UI::Dashboard::instance().plotTimestamps();
+  if (series.isEmpty() || series.firstTime() >= qint64(time.first() * 1e6))
+    return false;
+
+  // Decimate the samples of the time window
+  const auto to = qint64(end * 1e6);
+  const auto from = qint64(begin * 1e6);
+  series.query(from, to, m_plot.canvas()->width(), m_history);
+
+  // Convert the samples to curve points relative to the newest sample
+  m_points.resize(m_history.count());
+  for (int i = 0; i < m_history.count(); ++i)
+  {
+    const auto &sample = m_history.at(i);
+    m_points[i] = QPointF((sample.time - to) / 1e6, sample.value);
+  }
+
+  return true;
+}
+
+/**
+ * Appends the last @a added samples of @a values to the sweep & paints the
+ * segment that joins them with the previous samples directly over the plot
+ * canvas, without replotting the rest of the curve.
+ *
+ * The whole plot is only replotted when the sweep reaches the right side of
+ * the plot (and starts again from the left side), or if @a replot is @c true
+ * (e.g. because the vertical scale changed). Resize events are handled by
+ * the canvas itself, which redraws its backing store when its size changes.
+ */
+void Widgets::Plot::sweep(const PlotData &values, const int added,
+                          bool replot)
+{
+  auto dash = &UI::Dashboard::instance();
+  const auto &time = dash->plotTimestamps();
+  const bool timed = dash->timeWindow() > 0 && time.count() == values.count();
+  const auto limit = timed ? dash->timeWindow() : dash->points();
+
+  // Add each new sample to the curve, its horizontal position is the number
+  // of seconds since the sweep started for time-based plots or the sample
+  // number
+  int first = static_cast<int>(m_sweepData->size());
+  for (int i = values.count() - added; i < values.count(); ++i)
+  {
+    const auto now = timed ? time.at(i) : 0.0;
+    if (m_sweepData->size() == 0)
+      m_sweepStart = now;
+
+    double x = timed ? now - m_sweepStart : m_sweepData->size();
+
+    // Start a new sweep from the left side of the plot
+    if (x >= limit)
+    {
+      x = 0;
+      first = 0;
+      replot = true;
+      m_sweepStart = now;
+      m_sweepData->clear();
+    }
+
+    m_sweepData->append(QPointF(x, values.at(i)));
+  }
+
+  // Draw the new segments, or the complete curve if required
+  const int last = static_cast<int>(m_sweepData->size()) - 1;
+  Misc::Instrumentation::ScopedTimer timer(Misc::Instrumentation::Replot);
+  if (replot)
+    m_plot.replot();
+  else if (added > 0 && last > 0)
+    m_painter.drawSeries(&m_curve, qMax(0, first - 1), last);
+}
+
+/**
+ * Calculates a vertical scale centered around the samples that go from
+ * @a dataMin to @a dataMax, and writes it to @a min and @a max.
+ */
+void Widgets::Plot::centerScale(const double dataMin, const double dataMax,
+                                double &min, double &max)
+{
+  // Get central value
+  double median = qMax<double>(1, (dataMax + dataMin)) / 2;
+  if (dataMax == dataMin)
+    median = dataMax;
+
+  // Center graph verticaly
+  double mostDiff = qMax<double>(qAbs<double>(dataMin), qAbs<double>(dataMax));
+  double smin = median * (1 - 0.5) - qAbs<double>(median - mostDiff);
+  double smax = median * (1 + 0.5) + qAbs<double>(median - mostDiff);
+  if (dataMin < 0)
+    smin = smax * -1;
+
+  // Fix issues when min & max are equal
+  if (smin == smax)
+  {
+    smax = qAbs<double>(smax);
+    smin = smax * -1;
+  }
+
+  // Fix issues on min = max = (0,0)
+  if (smin == 0 && smax == 0)
+  {
+    smax = 1;
+    smin = -1;
+  }
+
+  min = smin;
+  max = smax;
+}
+
 /**
  * Updates the number of horizontal divisions of the plot
  */
@@ -219,14 +418,48 @@ void Widgets::Plot::updateRange()
   // Get pointer to dashboard manager
   auto dash = &UI::Dashboard::instance();
 
-  // Clear Y-axis data
-  PlotData tempYData;
-  tempYData.reserve(dash->points());
-  for (int i = 0; i < dash->points(); ++i)
-    tempYData.append(0);
+  // Set horizontal axis title
+  const auto window = dash->timeWindow();
+  if (window > 0)
+    m_plot.setAxisTitle(QwtPlot::xBottom, tr("Time (s)"));
+  else
+    m_plot.setAxisTitle(QwtPlot::xBottom, tr("Samples"));
+
+  // Sweep mode, draw samples from left to right over a fixed horizontal scale
+  if (dash->sweepMode())
+  {
+    m_sweepData = new SweepData;
+    m_sweepData->reserve(dash->points());
+    m_curve.setData(m_sweepData);
+    if (window > 0)
+      m_plot.setAxisScale(QwtPlot::xBottom, 0, window);
+    else
+      m_plot.setAxisScale(QwtPlot::xBottom, 0, qMax(1, dash->points() - 1));
+  }
+
+  // Time-based plot, show the samples received during the time window
+  else if (window > 0)
+  {
+    m_sweepData = Q_NULLPTR;
+    m_curve.setSamples(QVector<QPointF>());
+    m_plot.setAxisScale(QwtPlot::xBottom, -window, 0);
+  }
+
+  // Scroll mode, clear Y-axis data
+  else
+  {
+    PlotData tempYData;
+    tempYData.reserve(dash->points());
+    for (int i = 0; i < dash->points(); ++i)
+      tempYData.append(0);
+
+    m_sweepData = Q_NULLPTR;
+    m_curve.setSamples(dash->xPlotValues(), tempYData);
+    m_plot.setAxisAutoScale(QwtPlot::xBottom, true);
+  }
 
   // Redraw graph
-  m_curve.setSamples(dash->xPlotValues(), tempYData);
+  m_resync = true;
   m_plot.replot();
 
   // Repaint widget
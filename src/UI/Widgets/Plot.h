@@ -27,7 +27,11 @@
 #include <QVBoxLayout>
 #include <QwtPlotCurve>
 #include <QwtScaleEngine>
+#include <QwtPlotDirectPainter>
+#include <History/Block.h>
 #include <UI/DashboardWidget.h>
+#include <UI/Widgets/Common/SweepData.h>
+#include <UI/Widgets/Common/SlidingExtremum.h>
 
 namespace Widgets
 {
@@ -42,14 +46,30 @@ private Q_SLOTS:
   void updateData();
   void updateRange();
 
+private:
+  int newSamples(const int available);
+  void sweep(const PlotData &values, const int added, bool replot);
+  bool queryHistory(const double begin, const double end);
+  static void centerScale(const double dataMin, const double dataMax,
+                          double &min, double &max);
+
 private:
   int m_index;
   double m_min;
   double m_max;
   bool m_autoscale;
+  bool m_resync;
+  double m_sweepStart;
+  qint64 m_sampleCount;
+
+  QVector<QPointF> m_points;
+  QVector<History::Sample> m_history;
+  SlidingExtremum m_extremes;
 
   QwtPlot m_plot;
   QwtPlotCurve m_curve;
+  SweepData *m_sweepData;
+  QwtPlotDirectPainter m_painter;
   QVBoxLayout m_layout;
 };
 } // namespace Widgets
@@ -0,0 +1,291 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <array>
+#include <limits>
+#include <QPainter>
+
+#include <UI/Dashboard.h>
+#include <DSP/SpectrumAnalyzer.h>
+#include <Misc/ThemeManager.h>
+#include <Misc/Instrumentation.h>
+#include <UI/Widgets/Waterfall.h>
+
+/**
+ * Returns a 256-color lookup table that goes from black (weak signals) to
+ * light yellow (strong signals), similar to the "inferno" colormap.
+ */
+static const QRgb *colormap()
+{
+  static const auto table = [] {
+    // clang-format off
+    static const double stops[][4] = {
+      {0.00,   0,   0,   4},
+      {0.25,  87,  16, 110},
+      {0.50, 188,  55,  84},
+      {0.75, 249, 142,   9},
+      {1.00, 252, 255, 164},
+    };
+    // clang-format on
+
+    std::array<QRgb, 256> colors;
+    for (int i = 0; i < 256; ++i)
+    {
+      const double x = i / 255.0;
+      int s = 0;
+      while (s < 3 && x > stops[s + 1][0])
+        ++s;
+
+      const double t = (x - stops[s][0]) / (stops[s + 1][0] - stops[s][0]);
+      const int r = qRound(stops[s][1] + t * (stops[s + 1][1] - stops[s][1]));
+      const int g = qRound(stops[s][2] + t * (stops[s + 1][2] - stops[s][2]));
+      const int b = qRound(stops[s][3] + t * (stops[s + 1][3] - stops[s][3]));
+      colors[i] = qRgb(r, g, b);
+    }
+
+    return colors;
+  }();
+
+  return table.data();
+}
+
+/**
+ * Constructor function, configures signal/slot connections.
+ */
+Widgets::Waterfall::Waterfall(const int index)
+  : m_index(index)
+  , m_head(0)
+  , m_size(0)
+  , m_ceiling(std::numeric_limits<double>::lowest())
+{
+  // Get pointers to serial studio modules
+  auto dash = &UI::Dashboard::instance();
+  auto analyzer = &DSP::SpectrumAnalyzer::instance();
+
+  // Invalid index, abort initialization
+  if (m_index < 0 || m_index >= dash->waterfallCount())
+    return;
+
+  // Get dataset title
+  m_title = dash->getWaterfall(m_index).title();
+
+  // The whole widget is painted by the paintEvent() function
+  setAttribute(Qt::WA_OpaquePaintEvent);
+
+  // React to dashboard & spectrum analyzer events
+  connect(dash, SIGNAL(updated()), this, SLOT(updateData()),
+          Qt::QueuedConnection);
+  connect(analyzer, &DSP::SpectrumAnalyzer::rowsChanged, this,
+          &Widgets::Waterfall::drawRows);
+}
+
+/**
+ * Paints the waterfall image, starting from the newest row (at the top of the
+ * plot area) & wrapping around the ring buffer, together with the title of
+ * the dataset & the frequency labels.
+ */
+void Widgets::Waterfall::paintEvent(QPaintEvent *event)
+{
+  (void)event;
+
+  // Get theme & plot geometry
+  const auto area = plotArea();
+  const auto text = fontMetrics().height() + 4;
+  auto theme = &Misc::ThemeManager::instance();
+
+  // Draw background
+  QPainter painter(this);
+  painter.fillRect(rect(), theme->widgetWindowBackground());
+
+  // Draw the rows of the ring buffer, newest first
+  if (!m_image.isNull() && m_image.size() == area.size())
+  {
+    const auto width = m_image.width();
+    const auto newest = m_image.height() - m_head;
+    painter.drawImage(area.topLeft(), m_image,
+                      QRect(0, m_head, width, newest));
+    if (m_head > 0)
+      painter.drawImage(area.topLeft() + QPoint(0, newest), m_image,
+                        QRect(0, 0, width, m_head));
+  }
+
+  // Draw the title & the strongest level of the displayed range
+  const QRect top(area.left(), area.top() - text, area.width(), text);
+  painter.setPen(theme->widgetTextPrimary());
+  painter.drawText(top, Qt::AlignLeft | Qt::AlignVCenter, m_title);
+  if (m_size > 0)
+  {
+    painter.setPen(theme->widgetTextSecondary());
+    painter.drawText(top, Qt::AlignRight | Qt::AlignVCenter,
+                     tr("%1 dB").arg(m_ceiling, 0, 'f', 0));
+  }
+
+  // Draw the frequency labels
+  const QRect bottom(area.left(), area.bottom() + 1, area.width(), text);
+  auto analyzer = &DSP::SpectrumAnalyzer::instance();
+  const auto sampleRate = analyzer->effectiveSampleRate();
+  painter.setPen(theme->widgetTextSecondary());
+  if (sampleRate > 0)
+  {
+    const auto nyquist = sampleRate / 2;
+    painter.drawText(bottom, Qt::AlignLeft | Qt::AlignVCenter, tr("0 Hz"));
+    painter.drawText(bottom, Qt::AlignHCenter | Qt::AlignVCenter,
+                     tr("%1 Hz").arg(nyquist / 2, 0, 'g', 4));
+    painter.drawText(bottom, Qt::AlignRight | Qt::AlignVCenter,
+                     tr("%1 Hz").arg(nyquist, 0, 'g', 4));
+  }
+}
+
+/**
+ * Reallocates the ring buffer image when the widget is resized
+ */
+void Widgets::Waterfall::resizeEvent(QResizeEvent *event)
+{
+  resetImage();
+  DashboardWidgetBase::resizeEvent(event);
+}
+
+/**
+ * Checks if the widget is enabled, if so, the spectrum rows of the latest
+ * samples are requested to the spectrum analyzer, which calculates them in
+ * its own thread & notifies the widget through the @c drawRows() function.
+ *
+ * If the widget is disabled (e.g. the user hides it, or the external
+ * window is hidden), the spectrum rows are not calculated at all.
+ */
+void Widgets::Waterfall::updateData()
+{
+  if (isEnabled())
+    DSP::SpectrumAnalyzer::instance().requestRows(m_index);
+}
+
+/**
+ * Rasterizes the spectrum rows calculated by the spectrum analyzer for the
+ * waterfall dataset with the given @a index, if it belongs to this widget.
+ *
+ * Each row is written above the previous one in the ring buffer image, so
+ * the cost of adding a row only depends on the width of the widget. Each
+ * column displays the strongest bin that it covers, and the levels are
+ * mapped to the colormap relative to the strongest bin received recently
+ * (which rises immediately & falls slowly).
+ */
+void Widgets::Waterfall::drawRows(const int index)
+{
+  // Rows of another widget, or widget not visible
+  if (index != m_index || !isEnabled() || m_image.isNull())
+    return;
+
+  // Get the new rows
+  const auto &rows = DSP::SpectrumAnalyzer::instance().rows(m_index);
+  const auto bins = rows.size / 2 + 1;
+  const auto count = rows.size > 0 ? rows.magnitudes.count() / bins : 0;
+  if (count <= 0)
+    return;
+
+  // Update the bins displayed by each column
+  if (m_size != rows.size)
+    updateColumns(rows.size);
+
+  // Measure time spent rasterizing the rows
+  Misc::Instrumentation::ScopedTimer timer(Misc::Instrumentation::Replot);
+  const auto lut = colormap();
+  const auto width = m_image.width();
+  const auto height = m_image.height();
+  const auto scale = 255 / kDynamicRange;
+
+  // Skip the rows that would be overwritten by newer rows
+  for (int r = qMax(0, count - height); r < count; ++r)
+  {
+    // Track the strongest bin
+    const auto row = rows.magnitudes.constData() + r * bins;
+    auto peak = row[0];
+    for (int k = 1; k < bins; ++k)
+      peak = qMax(peak, row[k]);
+
+    m_ceiling = qMax(peak, m_ceiling - kCeilingRelease);
+    const auto floor = m_ceiling - kDynamicRange;
+
+    // Write the row above the previous one
+    m_head = (m_head + height - 1) % height;
+    auto line = reinterpret_cast<QRgb *>(m_image.scanLine(m_head));
+    for (int c = 0; c < width; ++c)
+    {
+      const auto begin = m_columns.at(c);
+      const auto end = qMax(begin + 1, m_columns.at(c + 1));
+
+      auto value = row[begin];
+      for (int k = begin + 1; k < end; ++k)
+        value = qMax(value, row[k]);
+
+      const auto level = static_cast<int>((value - floor) * scale);
+      line[c] = lut[qBound(0, level, 255)];
+    }
+  }
+
+  // Repaint widget
+  requestRepaint();
+}
+
+/**
+ * Returns the area of the widget in which the waterfall image is drawn
+ */
+QRect Widgets::Waterfall::plotArea() const
+{
+  const auto margin = 24;
+  const auto text = fontMetrics().height() + 4;
+  return rect().adjusted(margin, margin + text, -margin, -margin - text);
+}
+
+/**
+ * Allocates a ring buffer image with the size of the plot area & fills it
+ * with the color of the weakest level.
+ */
+void Widgets::Waterfall::resetImage()
+{
+  m_head = 0;
+  m_size = 0;
+
+  const auto area = plotArea();
+  if (area.width() <= 0 || area.height() <= 0)
+  {
+    m_image = QImage();
+    return;
+  }
+
+  m_image = QImage(area.size(), QImage::Format_RGB32);
+  m_image.fill(colormap()[0]);
+}
+
+/**
+ * Calculates the first frequency bin displayed by each column of the image,
+ * for spectra of the given FFT @a size.
+ */
+void Widgets::Waterfall::updateColumns(const int size)
+{
+  m_size = size;
+
+  const auto bins = size / 2 + 1;
+  const auto width = m_image.width();
+  m_columns.resize(width + 1);
+  for (int c = 0; c <= width; ++c)
+    m_columns[c] = static_cast<int>(static_cast<qint64>(c) * bins / width);
+}
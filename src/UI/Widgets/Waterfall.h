@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <QImage>
+#include <QWidget>
+
+#include <UI/DashboardWidget.h>
+
+namespace Widgets
+{
+/**
+ * @brief The Waterfall class
+ *
+ * Displays the spectrum of a dataset over time, with the newest spectrum row
+ * at the top of the widget.
+ *
+ * Rows are rasterized into a ring buffer image as they are received from the
+ * spectrum analyzer, so that previous rows are never recalculated or moved in
+ * memory. Painting the widget only requires two unscaled blits of the image.
+ */
+class Waterfall : public DashboardWidgetBase
+{
+  Q_OBJECT
+
+public:
+  Waterfall(const int index = -1);
+
+  static constexpr double kDynamicRange = 90;
+  static constexpr double kCeilingRelease = 0.05;
+
+protected:
+  void paintEvent(QPaintEvent *event) override;
+  void resizeEvent(QResizeEvent *event) override;
+
+private Q_SLOTS:
+  void updateData();
+  void drawRows(const int index);
+
+private:
+  QRect plotArea() const;
+  void resetImage();
+  void updateColumns(const int size);
+
+private:
+  int m_index;
+  int m_head;
+  int m_size;
+  double m_ceiling;
+
+  QString m_title;
+  QImage m_image;
+  QVector<int> m_columns;
+};
+} // namespace Widgets
@@ -28,13 +28,19 @@
 
 #include <AppInfo.h>
 #include <JSON/Frame.h>
+#include <Misc/Headless.h>
 #include <Misc/Utilities.h>
 #include <Misc/ModuleManager.h>
+#include <Misc/StartupTimeline.h>
 
 #ifdef Q_OS_WIN
 #  include <windows.h>
 #endif
 
+#ifdef SERIAL_STUDIO_BENCHMARK
+#  include <Misc/Benchmark.h>
+#endif
+
 /**
  * Prints the current application version to the console
  */
@@ -63,6 +69,9 @@ static void cliResetSettings()
  */
 int main(int argc, char **argv)
 {
+  // Start measuring the startup time as soon as possible
+  auto timeline = &Misc::StartupTimeline::instance();
+
   // Fix console output on Windows (https://stackoverflow.com/a/41701133)
   // This code will only execute if the application is started from the comamnd
   // prompt
@@ -78,6 +87,44 @@ int main(int argc, char **argv)
   }
 #endif
 
+#ifdef SERIAL_STUDIO_BENCHMARK
+  // Run the data pipeline benchmarks using the offscreen platform plugin
+  if (Misc::Benchmark::requested(argc, argv))
+  {
+    Misc::Benchmark benchmark;
+    qputenv("QT_QPA_PLATFORM", "offscreen");
+
+    QApplication app(argc, argv);
+    app.setApplicationName(APP_NAME);
+    app.setApplicationVersion(APP_VERSION);
+    app.setOrganizationName(APP_DEVELOPER);
+    app.setOrganizationDomain(APP_SUPPORT_URL);
+    return benchmark.run(app.arguments());
+  }
+#endif
+
+  // Run without GUI, only the data processing modules are loaded
+  if (Misc::Headless::requested(argc, argv))
+  {
+    QCoreApplication app(argc, argv);
+    app.setApplicationName(APP_NAME);
+    app.setApplicationVersion(APP_VERSION);
+    app.setOrganizationName(APP_DEVELOPER);
+    app.setOrganizationDomain(APP_SUPPORT_URL);
+
+    timeline->setLogEnabled(app.arguments().contains("--profile-startup"));
+    timeline->trackFirstFrame();
+
+    Misc::Headless headless;
+    if (!timeline->measure("Headless mode", [&] {
+          return headless.start(app.arguments());
+        }))
+      return headless.helpRequested() ? EXIT_SUCCESS : EXIT_FAILURE;
+
+    timeline->finish();
+    return app.exec();
+  }
+
   // Set application attributes
 #if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
   QApplication::setAttribute(Qt::AA_EnableHighDpiScaling);
@@ -119,6 +166,10 @@ int main(int argc, char **argv)
     }
   }
 
+  // Print the startup timeline to the console if requested by the user
+  timeline->mark("Application created");
+  timeline->setLogEnabled(app.arguments().contains("--profile-startup"));
+
   // Create module manager
   Misc::ModuleManager moduleManager;
   moduleManager.configureUpdater();
@@ -132,6 +183,10 @@ int main(int argc, char **argv)
     return EXIT_FAILURE;
   }
 
+  // Startup sequence finished, begin tracking time to first frame
+  timeline->finish();
+  timeline->trackFirstFrame();
+
   // Enter application event loop
   return app.exec();
 }
@@ -0,0 +1,461 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/*
+ * Measures the time that it takes for a probe written to one end of a serial
+ * link to be read from the other end. By default, a pseudo-terminal pair is
+ * used so that the overhead of different read strategies (termios thresholds,
+ * poll(), timer-driven reads) can be compared without any hardware. Use the
+ * --device option with a real adapter (TX & RX shorted) to quantify the gain
+ * of the low-latency mode of the serial driver.
+ *
+ * Build with qmake, or simply:
+ *   g++ -O2 -std=c++17 -pthread main.cpp -o serial-latency
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <termios.h>
+#include <sys/ioctl.h>
+
+#ifdef __linux__
+#  include <linux/serial.h>
+#endif
+
+//------------------------------------------------------------------------------
+// Configuration & helpers
+//------------------------------------------------------------------------------
+
+/**
+ * Strategy used to read the probes from the receiving end of the link
+ */
+enum class ReadMode
+{
+  BlockingVmin1,
+  BlockingVtime,
+  Poll,
+  Timer16ms
+};
+
+/**
+ * Command line options
+ */
+struct Options
+{
+  int samples = 1000;
+  int size = 16;
+  int intervalUs = 2000;
+  int baudRate = 115200;
+  bool lowLatency = false;
+  std::string device;
+};
+
+/**
+ * Returns the current value of the monotonic clock in nanoseconds
+ */
+static int64_t nowNs()
+{
+  using namespace std::chrono;
+  const auto t = steady_clock::now().time_since_epoch();
+  return duration_cast<nanoseconds>(t).count();
+}
+
+/**
+ * Returns a human readable name for the given read @a mode
+ */
+static const char *modeName(const ReadMode mode)
+{
+  switch (mode)
+  {
+    case ReadMode::BlockingVmin1:
+      return "blocking VMIN=1 VTIME=0";
+    case ReadMode::BlockingVtime:
+      return "blocking VMIN=255 VTIME=1";
+    case ReadMode::Poll:
+      return "non-blocking + poll()";
+    case ReadMode::Timer16ms:
+      return "non-blocking, 16 ms timer";
+  }
+
+  return "";
+}
+
+/**
+ * Converts a numeric baud rate to the matching termios constant
+ */
+static speed_t baudConstant(const int baudRate)
+{
+  switch (baudRate)
+  {
+    case 9600:
+      return B9600;
+    case 19200:
+      return B19200;
+    case 38400:
+      return B38400;
+    case 57600:
+      return B57600;
+    case 230400:
+      return B230400;
+#ifdef B460800
+    case 460800:
+      return B460800;
+#endif
+#ifdef B921600
+    case 921600:
+      return B921600;
+#endif
+#ifdef B1000000
+    case 1000000:
+      return B1000000;
+#endif
+#ifdef B2000000
+    case 2000000:
+      return B2000000;
+#endif
+    default:
+      return B115200;
+  }
+}
+
+/**
+ * Puts the given file descriptor in raw mode and configures its read
+ * thresholds according to the given read @a mode.
+ */
+static bool configureTty(const int fd, const ReadMode mode, const int baudRate)
+{
+  struct termios tio;
+  if (tcgetattr(fd, &tio) != 0)
+    return false;
+
+  cfmakeraw(&tio);
+  cfsetispeed(&tio, baudConstant(baudRate));
+  cfsetospeed(&tio, baudConstant(baudRate));
+  tio.c_cflag |= CLOCAL | CREAD;
+
+  if (mode == ReadMode::BlockingVtime)
+  {
+    tio.c_cc[VMIN] = 255;
+    tio.c_cc[VTIME] = 1;
+  }
+
+  else
+  {
+    tio.c_cc[VMIN] = 1;
+    tio.c_cc[VTIME] = 0;
+  }
+
+  if (tcsetattr(fd, TCSANOW, &tio) != 0)
+    return false;
+
+  const int flags = fcntl(fd, F_GETFL);
+  const bool blocking = mode == ReadMode::BlockingVmin1
+                        || mode == ReadMode::BlockingVtime;
+  if (blocking)
+    fcntl(fd, F_SETFL, flags & ~O_NONBLOCK);
+  else
+    fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+
+  return true;
+}
+
+/**
+ * Sets the ASYNC_LOW_LATENCY flag of the given serial device (if supported)
+ */
+static void setLowLatency(const int fd)
+{
+#ifdef __linux__
+  struct serial_struct serial;
+  if (ioctl(fd, TIOCGSERIAL, &serial) == 0)
+  {
+    serial.flags |= ASYNC_LOW_LATENCY;
+    if (ioctl(fd, TIOCSSERIAL, &serial) != 0)
+      perror("TIOCSSERIAL");
+  }
+#else
+  (void)fd;
+#endif
+}
+
+//------------------------------------------------------------------------------
+// Measurement
+//------------------------------------------------------------------------------
+
+/**
+ * Writes @c samples probes of @c size bytes to @a fd, each probe starts with
+ * the time at which it was written.
+ */
+static void writer(const int fd, const Options &opt, std::atomic<bool> &stop)
+{
+  std::vector<uint8_t> probe(opt.size, 0x55);
+  for (int i = 0; i < opt.samples && !stop; ++i)
+  {
+    const int64_t t = nowNs();
+    std::memcpy(probe.data(), &t, sizeof(t));
+
+    size_t written = 0;
+    while (written < probe.size() && !stop)
+    {
+      auto ret = ::write(fd, probe.data() + written, probe.size() - written);
+      if (ret > 0)
+        written += static_cast<size_t>(ret);
+      else if (ret < 0 && errno != EAGAIN && errno != EINTR)
+        return;
+    }
+
+    std::this_thread::sleep_for(std::chrono::microseconds(opt.intervalUs));
+  }
+}
+
+/**
+ * Reads probes from @a fd using the given read @a mode and returns the
+ * latency of each probe in nanoseconds.
+ */
+static std::vector<int64_t> reader(const int fd, const ReadMode mode,
+                                   const Options &opt)
+{
+  std::vector<int64_t> latencies;
+  latencies.reserve(opt.samples);
+
+  std::vector<uint8_t> pending;
+  std::vector<uint8_t> buffer(64 * 1024);
+
+  const int64_t deadline
+      = nowNs() + int64_t(opt.samples) * (opt.intervalUs + 5000) * 1000
+        + int64_t(2e9);
+
+  while (int(latencies.size()) < opt.samples && nowNs() < deadline)
+  {
+    if (mode == ReadMode::Poll)
+    {
+      struct pollfd pfd = {fd, POLLIN, 0};
+      if (poll(&pfd, 1, 100) <= 0)
+        continue;
+    }
+
+    else if (mode == ReadMode::Timer16ms)
+      std::this_thread::sleep_for(std::chrono::milliseconds(16));
+
+    const auto ret = ::read(fd, buffer.data(), buffer.size());
+    const int64_t arrival = nowNs();
+    if (ret <= 0)
+      continue;
+
+    pending.insert(pending.end(), buffer.begin(), buffer.begin() + ret);
+    while (pending.size() >= size_t(opt.size))
+    {
+      int64_t sent;
+      std::memcpy(&sent, pending.data(), sizeof(sent));
+      latencies.push_back(arrival - sent);
+      pending.erase(pending.begin(), pending.begin() + opt.size);
+    }
+  }
+
+  return latencies;
+}
+
+/**
+ * Prints the percentiles of the given latency samples
+ */
+static void report(const ReadMode mode, std::vector<int64_t> samples)
+{
+  if (samples.empty())
+  {
+    std::printf("%-28s  no samples received\n", modeName(mode));
+    return;
+  }
+
+  std::sort(samples.begin(), samples.end());
+  auto percentile = [&](const double p) {
+    const auto index = size_t(p * double(samples.size() - 1));
+    return double(samples[index]) / 1000.0;
+  };
+
+  std::printf("%-28s  n=%-6zu p50=%9.1f us  p99=%9.1f us  max=%9.1f us\n",
+              modeName(mode), samples.size(), percentile(0.50),
+              percentile(0.99), double(samples.back()) / 1000.0);
+}
+
+/**
+ * Opens a pseudo-terminal pair, returns @c false on failure
+ */
+static bool openPty(int &master, int &slave)
+{
+  master = posix_openpt(O_RDWR | O_NOCTTY);
+  if (master < 0)
+    return false;
+
+  if (grantpt(master) != 0 || unlockpt(master) != 0)
+  {
+    close(master);
+    return false;
+  }
+
+  slave = open(ptsname(master), O_RDWR | O_NOCTTY);
+  if (slave < 0)
+  {
+    close(master);
+    return false;
+  }
+
+  return true;
+}
+
+/**
+ * Runs a single measurement with the given read @a mode
+ */
+static bool measure(const ReadMode mode, const Options &opt)
+{
+  int txFd = -1;
+  int rxFd = -1;
+
+  // Open a real device (loopback) or a pseudo-terminal pair
+  if (!opt.device.empty())
+  {
+    rxFd = open(opt.device.c_str(), O_RDWR | O_NOCTTY);
+    if (rxFd < 0)
+    {
+      perror(opt.device.c_str());
+      return false;
+    }
+
+    txFd = rxFd;
+    if (opt.lowLatency)
+      setLowLatency(rxFd);
+  }
+
+  else if (!openPty(txFd, rxFd))
+  {
+    perror("posix_openpt");
+    return false;
+  }
+
+  // Configure both ends of the link
+  if (!configureTty(rxFd, mode, opt.baudRate))
+  {
+    perror("tcsetattr");
+    return false;
+  }
+
+  if (txFd != rxFd)
+  {
+    struct termios tio;
+    if (tcgetattr(txFd, &tio) == 0)
+    {
+      cfmakeraw(&tio);
+      tcsetattr(txFd, TCSANOW, &tio);
+    }
+  }
+
+  tcflush(rxFd, TCIOFLUSH);
+
+  // Run the test
+  std::atomic<bool> stop(false);
+  std::thread tx(writer, txFd, std::cref(opt), std::ref(stop));
+  auto samples = reader(rxFd, mode, opt);
+  stop = true;
+  tx.join();
+
+  // Close file descriptors
+  if (txFd != rxFd)
+    close(txFd);
+  close(rxFd);
+
+  report(mode, std::move(samples));
+  return true;
+}
+
+//------------------------------------------------------------------------------
+// Entry point
+//------------------------------------------------------------------------------
+
+/**
+ * Prints the command line usage of the tool
+ */
+static void usage(const char *name)
+{
+  std::printf("Usage: %s [options]\n\n"
+              "  --samples N       number of probes per mode (default 1000)\n"
+              "  --size B          probe size in bytes, min. 8 (default 16)\n"
+              "  --interval-us U   delay between probes (default 2000)\n"
+              "  --device PATH     use a looped-back serial device\n"
+              "  --baud RATE       baud rate for --device (default 115200)\n"
+              "  --low-latency     set ASYNC_LOW_LATENCY on --device\n",
+              name);
+}
+
+/**
+ * Parses the command line & runs the measurement for every read mode
+ */
+int main(int argc, char **argv)
+{
+  Options opt;
+  for (int i = 1; i < argc; ++i)
+  {
+    const std::string arg = argv[i];
+    const bool hasValue = i + 1 < argc;
+
+    if (arg == "--samples" && hasValue)
+      opt.samples = std::max(1, std::atoi(argv[++i]));
+    else if (arg == "--size" && hasValue)
+      opt.size = std::max(8, std::atoi(argv[++i]));
+    else if (arg == "--interval-us" && hasValue)
+      opt.intervalUs = std::max(0, std::atoi(argv[++i]));
+    else if (arg == "--device" && hasValue)
+      opt.device = argv[++i];
+    else if (arg == "--baud" && hasValue)
+      opt.baudRate = std::atoi(argv[++i]);
+    else if (arg == "--low-latency")
+      opt.lowLatency = true;
+    else
+    {
+      usage(argv[0]);
+      return arg == "--help" || arg == "-h" ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+  }
+
+  std::printf("%d probes of %d bytes every %d us via %s\n\n", opt.samples,
+              opt.size, opt.intervalUs,
+              opt.device.empty() ? "pty pair" : opt.device.c_str());
+
+  const ReadMode modes[] = {ReadMode::BlockingVmin1, ReadMode::BlockingVtime,
+                            ReadMode::Poll, ReadMode::Timer16ms};
+  for (const auto mode : modes)
+  {
+    if (!measure(mode, opt))
+      return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}